@@ -42,6 +42,28 @@
 // Maximum distance used in collision ordering calculations.
 #define MAX_COLLISION_DIST      (RENDER_FAR_DIST_M * UNITS_PER_METER)
 
+// Physics level-of-detail, based on distance (in units) from the physics manager's LOD focus (usually the camera).
+// Active bodies tick every step. Reduced bodies tick once every PHYS_LOD_REDUCED_STEP_DIV steps, each on its own phase
+// of the cycle, running the skipped steps back to back (with collision checks after each one). Frozen bodies don't
+// tick at all, but bank their missed steps and work them off, at most PHYS_LOD_REDUCED_STEP_DIV steps at a time, once
+// back in range. A frozen body that falls more than PHYS_LOD_MAX_BANKED_STEPS behind drops its backlog and banks
+// nothing more until it leaves the frozen tier, then resumes from its frozen state. Bodies that can't move (immobile,
+// no update model) never tick, whatever the distance.
+#define PHYS_LOD_ACTIVE_DIST          (0.3 * RENDER_FAR_DIST_M * UNITS_PER_METER)
+#define PHYS_LOD_ACTIVE_DIST_2        (PHYS_LOD_ACTIVE_DIST * PHYS_LOD_ACTIVE_DIST)
+#define PHYS_LOD_REDUCED_DIST         (0.6 * RENDER_FAR_DIST_M * UNITS_PER_METER)
+#define PHYS_LOD_REDUCED_DIST_2       (PHYS_LOD_REDUCED_DIST * PHYS_LOD_REDUCED_DIST)
+#define PHYS_LOD_REDUCED_STEP_DIV     4
+#define PHYS_LOD_MAX_BANKED_STEPS     (5 * 60)
+
+// Level streaming (see LevelStreamer.h). Levels are bucketed into square chunks on the X/Y plane, and chunks are
+// loaded/unloaded based on the distance (in units) from the player to the chunk's bounds. Chunks within
+// LEVEL_CHUNK_REQUIRED_DIST have to be loaded before the scene simulates, the rest stream in the background.
+#define LEVEL_CHUNK_SIZE              (16.0 * UNITS_PER_METER)
+#define LEVEL_CHUNK_REQUIRED_DIST     (LEVEL_CHUNK_SIZE)
+#define LEVEL_CHUNK_LOAD_DIST         (RENDER_FAR_DIST_M * UNITS_PER_METER)
+#define LEVEL_CHUNK_UNLOAD_DIST       (1.25 * LEVEL_CHUNK_LOAD_DIST)
+
 #define PLAYER_HITBOX_W         0.45
 #define PLAYER_HITBOX_H         1.4
 #define PLAYER_HITBOX_D         0.5
@@ -1,12 +1,14 @@
 #ifndef COMMON_TYPES_H
 #define COMMON_TYPES_H
 
-#include <d3dx11.h>
-#include <d3dx10.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Math/Vector.h"
 
 typedef struct Pos2_
 {
-  D3DXVECTOR2 pos;
+  Vec2 pos;
 
   Pos2_()
   {
@@ -23,7 +25,7 @@ typedef struct Pos2_
 
 typedef struct Pos3_
 {
-  D3DXVECTOR3 pos;
+  Vec3 pos;
 
   Pos3_()
   {
@@ -37,12 +39,43 @@ typedef struct Pos3_
     pos.z = z;
   }
 
+  Pos3_(const Vec3 &v) : pos(v)
+  {
+  }
+
+  Pos3_ operator+ (const Pos3_ &other) const
+  {
+    return Pos3_(pos + other.pos);
+  }
+
+  Pos3_ operator- (const Pos3_ &other) const
+  {
+    return Pos3_(pos - other.pos);
+  }
+
+  Pos3_ operator* (float scale) const
+  {
+    return Pos3_(pos * scale);
+  }
+
+  Pos3_& operator+= (const Pos3_ &other)
+  {
+    pos += other.pos;
+    return *this;
+  }
+
+  Pos3_& operator-= (const Pos3_ &other)
+  {
+    pos -= other.pos;
+    return *this;
+  }
+
 } Pos3;
 
 typedef struct Pos3Uv2_
 {
-  D3DXVECTOR3 pos;
-  D3DXVECTOR2 uv;
+  Vec3 pos;
+  Vec2 uv;
 
   Pos3Uv2_()
   {
@@ -70,6 +103,9 @@ typedef struct Pos3Uv2_
 
 } Pos3Uv2;
 
+// Pos3Uv2 is the vertex format, its size is the vertex buffer stride.
+static_assert(sizeof(Pos3Uv2) == 5 * sizeof(float), "Pos3Uv2 must stay tightly packed");
+
 typedef struct OrderingMetric_
 {
   float primary{ 0.0 };    // Primary metric used for ordering.
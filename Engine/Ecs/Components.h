@@ -0,0 +1,38 @@
+#ifndef ECS_COMPONENTS_H
+#define ECS_COMPONENTS_H
+
+#include "../CommonTypes.h"
+#include "../Math/Matrix.h"
+
+class VisualModel;
+class PhysicsModel;
+
+// Plain data components, see EntityRegistry.h. Models are owned by the entity and freed when it's destroyed.
+
+typedef struct TransformComponent_
+{
+  Pos3 pos;
+  Pos3 rot;
+  Mat4 worldMat;                      // For pos and rot, rebuilt by runTransformSystem once bWorldMatDirty is set.
+  bool bWorldMatDirty{ true };
+} TransformComponent;
+
+typedef struct VelocityComponent_
+{
+  Pos3 vel;
+  Pos3 rotVel;
+} VelocityComponent;
+
+typedef struct RenderComponent_
+{
+  VisualModel *pVModel{ NULL };
+  bool         bBatched{ false };   // Drawn as part of the scene's static batch, not on its own (see StaticBatch.h).
+} RenderComponent;
+
+typedef struct PhysicsComponent_
+{
+  PhysicsModel *pPModel{ NULL };
+  uint64_t      uuid{ 0 };    // Key in the PhysicsManager, from the same pool as GameObject UUIDs.
+} PhysicsComponent;
+
+#endif
@@ -0,0 +1,88 @@
+#include "EntityRegistry.h"
+#include "../VisualModel.h"
+#include "../PhysicsModel.h"
+
+Entity EntityRegistry::create()
+{
+  Entity entity;
+  if (!m_freeIndices.empty())
+  {
+    entity.index = m_freeIndices.back();
+    m_freeIndices.pop_back();
+  }
+  else
+  {
+    entity.index = static_cast<uint32_t>(m_generations.size());
+    m_generations.push_back(1);
+    m_alive.push_back(false);
+  }
+
+  entity.generation = m_generations[entity.index];
+  m_alive[entity.index] = true;
+  m_aliveCnt++;
+  return entity;
+}
+
+
+bool EntityRegistry::destroy(const Entity &entity)
+{
+  if (!isAlive(entity))
+  {
+    return false;
+  }
+
+  RenderComponent *pRender = m_renders.get(entity.index);
+  if (pRender && pRender->pVModel)
+  {
+    VisualModel::releaseVModel(pRender->pVModel);
+    delete pRender->pVModel;
+  }
+
+  PhysicsComponent *pPhysics = m_physics.get(entity.index);
+  if (pPhysics && pPhysics->pPModel)
+  {
+    pPhysics->pPModel->release();
+    delete pPhysics->pPModel;
+  }
+
+  m_transforms.remove(entity.index);
+  m_velocities.remove(entity.index);
+  m_renders.remove(entity.index);
+  m_physics.remove(entity.index);
+
+  // Bumping the generation invalidates any other copies of this entity.
+  m_generations[entity.index]++;
+  m_alive[entity.index] = false;
+  m_freeIndices.push_back(entity.index);
+  m_aliveCnt--;
+  return true;
+}
+
+
+void EntityRegistry::clear()
+{
+  for (uint32_t idx = 0; idx < m_generations.size(); idx++)
+  {
+    if (m_alive[idx])
+    {
+      Entity entity;
+      entity.index = idx;
+      entity.generation = m_generations[idx];
+      destroy(entity);
+    }
+  }
+}
+
+
+bool EntityRegistry::isAlive(const Entity &entity)
+{
+  return entity.index < m_generations.size() &&
+    m_alive[entity.index] &&
+    m_generations[entity.index] == entity.generation;
+}
+
+
+uint32_t EntityRegistry::size()
+{
+  return m_aliveCnt;
+}
@@ -0,0 +1,157 @@
+#ifndef ENTITY_REGISTRY_H
+#define ENTITY_REGISTRY_H
+
+#include "Components.h"
+#include <stdint.h>
+#include <vector>
+
+#define ENTITY_INVALID_INDEX  UINT32_MAX
+
+// Generation-checked entity reference. An entity is just an index, its data lives in the component stores.
+typedef struct Entity_
+{
+  uint32_t index{ ENTITY_INVALID_INDEX };
+  uint32_t generation{ 0 };
+} Entity;
+
+// Packed storage for one component type (sparse set). Components sit back to back in entity-add order, removal swaps
+// the last component into the hole. Systems walk data()/entityAt() linearly.
+template <typename T>
+class ComponentStore
+{
+private:
+  std::vector<T>        m_data;
+  std::vector<uint32_t> m_entities;   // Entity index of each component, parallel to m_data.
+  std::vector<uint32_t> m_sparse;     // Entity index -> position in m_data, ENTITY_INVALID_INDEX if none.
+
+public:
+  T* add(uint32_t entityIdx, const T &component)
+  {
+    if (entityIdx >= m_sparse.size())
+    {
+      m_sparse.resize(entityIdx + 1, ENTITY_INVALID_INDEX);
+    }
+
+    if (m_sparse[entityIdx] != ENTITY_INVALID_INDEX)
+    {
+      m_data[m_sparse[entityIdx]] = component;
+      return &m_data[m_sparse[entityIdx]];
+    }
+
+    m_sparse[entityIdx] = static_cast<uint32_t>(m_data.size());
+    m_data.push_back(component);
+    m_entities.push_back(entityIdx);
+    return &m_data.back();
+  }
+
+  T* get(uint32_t entityIdx)
+  {
+    if (entityIdx >= m_sparse.size() || m_sparse[entityIdx] == ENTITY_INVALID_INDEX)
+    {
+      return NULL;
+    }
+
+    return &m_data[m_sparse[entityIdx]];
+  }
+
+  bool remove(uint32_t entityIdx)
+  {
+    if (!get(entityIdx))
+    {
+      return false;
+    }
+
+    uint32_t denseIdx = m_sparse[entityIdx];
+    uint32_t lastIdx = static_cast<uint32_t>(m_data.size() - 1);
+    if (denseIdx != lastIdx)
+    {
+      m_data[denseIdx] = m_data[lastIdx];
+      m_entities[denseIdx] = m_entities[lastIdx];
+      m_sparse[m_entities[denseIdx]] = denseIdx;
+    }
+
+    m_data.pop_back();
+    m_entities.pop_back();
+    m_sparse[entityIdx] = ENTITY_INVALID_INDEX;
+    return true;
+  }
+
+  void clear()
+  {
+    m_data.clear();
+    m_entities.clear();
+    m_sparse.clear();
+  }
+
+  uint32_t size() const
+  {
+    return static_cast<uint32_t>(m_data.size());
+  }
+
+  T* data()
+  {
+    return m_data.data();
+  }
+
+  uint32_t entityAt(uint32_t denseIdx) const
+  {
+    return m_entities[denseIdx];
+  }
+};
+
+// Entity-component storage, an alternative to the GameObject hierarchy for objects that are just data
+// (see ObjectManager::setStoreAsEntity). Systems that run over the component stores are in Systems.h.
+class EntityRegistry
+{
+private:
+  std::vector<uint32_t> m_generations;  // Current generation per entity index.
+  std::vector<bool>     m_alive;
+  std::vector<uint32_t> m_freeIndices;
+  uint32_t              m_aliveCnt{ 0 };
+
+  ComponentStore<TransformComponent>  m_transforms;
+  ComponentStore<VelocityComponent>   m_velocities;
+  ComponentStore<RenderComponent>     m_renders;
+  ComponentStore<PhysicsComponent>    m_physics;
+
+  ComponentStore<TransformComponent>& storeFor(TransformComponent*) { return m_transforms; }
+  ComponentStore<VelocityComponent>&  storeFor(VelocityComponent*)  { return m_velocities; }
+  ComponentStore<RenderComponent>&    storeFor(RenderComponent*)    { return m_renders; }
+  ComponentStore<PhysicsComponent>&   storeFor(PhysicsComponent*)   { return m_physics; }
+
+public:
+  Entity create();
+
+  // Releases the entity's render/physics models along with its components.
+  bool destroy(const Entity &entity);
+  void clear();
+
+  bool isAlive(const Entity &entity);
+  uint32_t size();
+
+  template <typename T>
+  T* add(const Entity &entity, const T &component)
+  {
+    return isAlive(entity) ? storeFor(static_cast<T*>(NULL)).add(entity.index, component) : NULL;
+  }
+
+  template <typename T>
+  T* get(const Entity &entity)
+  {
+    return isAlive(entity) ? storeFor(static_cast<T*>(NULL)).get(entity.index) : NULL;
+  }
+
+  template <typename T>
+  bool remove(const Entity &entity)
+  {
+    return isAlive(entity) && storeFor(static_cast<T*>(NULL)).remove(entity.index);
+  }
+
+  template <typename T>
+  ComponentStore<T>& store()
+  {
+    return storeFor(static_cast<T*>(NULL));
+  }
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include "Systems.h"
+#include "../FrustumCuller.h"
+#include "../GraphicsManager.h"
+#include "../Logger.h"
+#include "../PhysicsMgr.h"
+#include "../PhysicsModels/CollisionModel.h"
+#include "../VisualModels/StaticBatch.h"
+
+bool runPhysicsRegisterSystem(EntityRegistry &entities, PhysicsManager *pPhysicsMgr)
+{
+  ComponentStore<PhysicsComponent> &physics = entities.store<PhysicsComponent>();
+  ComponentStore<TransformComponent> &transforms = entities.store<TransformComponent>();
+  ComponentStore<VelocityComponent> &velocities = entities.store<VelocityComponent>();
+
+  PModelInput tempPmIn;
+  PhysicsComponent *pPhysics = physics.data();
+  for (uint32_t i = 0; i < physics.size(); i++)
+  {
+    uint32_t entityIdx = physics.entityAt(i);
+    TransformComponent *pTransform = transforms.get(entityIdx);
+    VelocityComponent *pVelocity = velocities.get(entityIdx);
+
+    tempPmIn.pModel = pPhysics[i].pPModel;
+    tempPmIn.pos    = pTransform ? pTransform->pos : Pos3();
+    tempPmIn.rot    = pTransform ? pTransform->rot : Pos3();
+    tempPmIn.vel    = pVelocity ? pVelocity->vel : Pos3();
+    tempPmIn.rotVel = pVelocity ? pVelocity->rotVel : Pos3();
+    if (!pPhysicsMgr->registerModel(pPhysics[i].uuid, &tempPmIn))
+    {
+      LOGE("Failed to update entity [%u]", entityIdx);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+// Entities have no collision handlers, the GameObject loop is still the place for those.
+void runPhysicsResultSystem(EntityRegistry &entities, PhysicsManager *pPhysicsMgr)
+{
+  ComponentStore<PhysicsComponent> &physics = entities.store<PhysicsComponent>();
+  ComponentStore<TransformComponent> &transforms = entities.store<TransformComponent>();
+  ComponentStore<VelocityComponent> &velocities = entities.store<VelocityComponent>();
+
+  PModelOutput tempPmOut;
+  PhysicsComponent *pPhysics = physics.data();
+  for (uint32_t i = 0; i < physics.size(); i++)
+  {
+    if (!pPhysicsMgr->getResult(pPhysics[i].uuid, &tempPmOut))
+    {
+      continue;
+    }
+
+    uint32_t entityIdx = physics.entityAt(i);
+    TransformComponent *pTransform = transforms.get(entityIdx);
+    if (pTransform)
+    {
+      if (tempPmOut.pos.pos != pTransform->pos.pos || tempPmOut.rot.pos != pTransform->rot.pos)
+      {
+        pTransform->bWorldMatDirty = true;
+      }
+      pTransform->pos = tempPmOut.pos;
+      pTransform->rot = tempPmOut.rot;
+    }
+
+    VelocityComponent *pVelocity = velocities.get(entityIdx);
+    if (pVelocity)
+    {
+      pVelocity->vel    = tempPmOut.vel;
+      pVelocity->rotVel = tempPmOut.rotVel;
+    }
+  }
+}
+
+
+uint32_t runTransformSystem(EntityRegistry &entities, TransformSystemScratch &scratch)
+{
+  ComponentStore<TransformComponent> &transforms = entities.store<TransformComponent>();
+
+  // Static level geometry never moves, so usually only a handful are dirty. They're gathered so the batch only
+  // covers those.
+  scratch.dirtyIdxs.clear();
+  scratch.positions.clear();
+  scratch.rotations.clear();
+  TransformComponent *pTransform = transforms.data();
+  for (uint32_t i = 0; i < transforms.size(); i++)
+  {
+    if (pTransform[i].bWorldMatDirty)
+    {
+      scratch.dirtyIdxs.push_back(i);
+      scratch.positions.push_back(pTransform[i].pos);
+      scratch.rotations.push_back(pTransform[i].rot);
+    }
+  }
+
+  uint32_t dirtyCnt = static_cast<uint32_t>(scratch.dirtyIdxs.size());
+  scratch.worldMats.resize(dirtyCnt);
+  GraphicsManager::calcWorldMatrices(
+    scratch.positions.data(),
+    scratch.rotations.data(),
+    scratch.worldMats.data(),
+    dirtyCnt);
+  for (uint32_t i = 0; i < dirtyCnt; i++)
+  {
+    pTransform[scratch.dirtyIdxs[i]].worldMat = scratch.worldMats[i];
+    pTransform[scratch.dirtyIdxs[i]].bWorldMatDirty = false;
+  }
+
+  return dirtyCnt;
+}
+
+
+bool runStaticBatchSystem(EntityRegistry &entities, StaticBatch &batch, RenderDevice *dev)
+{
+  ComponentStore<RenderComponent> &renders = entities.store<RenderComponent>();
+  ComponentStore<TransformComponent> &transforms = entities.store<TransformComponent>();
+  ComponentStore<PhysicsComponent> &physics = entities.store<PhysicsComponent>();
+
+  batch.begin();
+  RenderComponent *pRender = renders.data();
+  for (uint32_t i = 0; i < renders.size(); i++)
+  {
+    uint32_t entityIdx = renders.entityAt(i);
+    TransformComponent *pTransform = transforms.get(entityIdx);
+    PhysicsComponent *pPhysics = physics.get(entityIdx);
+    CollisionModel *pCollision = (pPhysics && pPhysics->pPModel) ? pPhysics->pPModel->getCollisionModel() : NULL;
+
+    pRender[i].bBatched = pTransform &&
+      pCollision &&
+      pCollision->getType() == COLLISION_MODEL_AABB_IMMOBILE &&
+      batch.add(pRender[i].pVModel, pTransform->worldMat);
+  }
+
+  if (batch.build(dev))
+  {
+    return true;
+  }
+
+  for (uint32_t i = 0; i < renders.size(); i++)
+  {
+    pRender[i].bBatched = false;
+  }
+  return false;
+}
+
+
+void runRenderSystem(EntityRegistry &entities, FrustumCuller &culler)
+{
+  ComponentStore<RenderComponent> &renders = entities.store<RenderComponent>();
+  ComponentStore<TransformComponent> &transforms = entities.store<TransformComponent>();
+
+  RenderComponent *pRender = renders.data();
+  for (uint32_t i = 0; i < renders.size(); i++)
+  {
+    if (pRender[i].bBatched)
+    {
+      continue;
+    }
+
+    TransformComponent *pTransform = transforms.get(renders.entityAt(i));
+    culler.add(pRender[i].pVModel, pTransform ? pTransform->worldMat : matrixIdentity());
+  }
+}
@@ -0,0 +1,43 @@
+#ifndef ECS_SYSTEMS_H
+#define ECS_SYSTEMS_H
+
+#include "EntityRegistry.h"
+#include <vector>
+
+class FrustumCuller;
+class PhysicsManager;
+class RenderDevice;
+class StaticBatch;
+
+// Systems over the EntityRegistry component stores. Scene::update runs them next to the matching GameObject loops.
+// Each one walks a single packed store front to back and looks up the other components it needs by entity index.
+
+// Registers every entity with a PhysicsComponent, same as the GameObject registration loop.
+bool runPhysicsRegisterSystem(EntityRegistry &entities, PhysicsManager *pPhysicsMgr);
+
+// Copies physics results back into the transform and velocity components. Transforms that moved are flagged for
+// runTransformSystem.
+void runPhysicsResultSystem(EntityRegistry &entities, PhysicsManager *pPhysicsMgr);
+
+// Scratch space for runTransformSystem's batch. The caller keeps it between runs, so a frame only allocates when more
+// transforms are dirty than ever before.
+typedef struct TransformSystemScratch_
+{
+  std::vector<uint32_t> dirtyIdxs;
+  std::vector<Pos3> positions;
+  std::vector<Pos3> rotations;
+  std::vector<Mat4> worldMats;
+} TransformSystemScratch;
+
+// Rebuilds the world matrices of the transforms that changed since the last run, in one batch. Returns how many.
+uint32_t runTransformSystem(EntityRegistry &entities, TransformSystemScratch &scratch);
+
+// Rebuilds the batch from every entity whose model can never move (immobile collision model) and can be batched, and
+// flags those as bBatched. Only the batch's cells whose entities changed are meshed again. If the build fails, nothing is flagged and they render on their own as before.
+bool runStaticBatchSystem(EntityRegistry &entities, StaticBatch &batch, RenderDevice *dev);
+
+// Adds every entity with a RenderComponent to the culler at its transform, apart from the ones drawn by the static
+// batch. The caller culls and renders them, along with the GameObjects.
+void runRenderSystem(EntityRegistry &entities, FrustumCuller &culler);
+
+#endif
@@ -0,0 +1,192 @@
+#include "FrustumCuller.h"
+#include <math.h>
+#include <string.h>
+
+const uint32_t FrustumCuller::PLANE_CNT;
+
+static const uint32_t SIMD_WIDTH = 4;
+
+FrustumCuller::FrustumCuller()
+{
+  m_bEnabled = true;
+  memset(m_planes, 0, sizeof(m_planes));
+}
+
+
+void FrustumCuller::setEnabled(bool bEnabled)
+{
+  m_bEnabled = bEnabled;
+}
+
+
+void FrustumCuller::begin(const Mat4 &viewProjMat)
+{
+  m_items.clear();
+  m_centerX.clear();
+  m_centerY.clear();
+  m_centerZ.clear();
+  m_extentX.clear();
+  m_extentY.clear();
+  m_extentZ.clear();
+  m_bBounded.clear();
+  m_bVisible.clear();
+
+  // Clip space is -w <= x, y <= w and 0 <= z <= w (D3D). With row vectors, clip = v * M, so each plane is a sum or
+  // difference of the matrix columns.
+  const Mat4 &m = viewProjMat;
+  for (uint32_t i = 0; i < 4; i++)
+  {
+    m_planes[0][i] = m.m[i][3] + m.m[i][0];     // Left
+    m_planes[1][i] = m.m[i][3] - m.m[i][0];     // Right
+    m_planes[2][i] = m.m[i][3] + m.m[i][1];     // Bottom
+    m_planes[3][i] = m.m[i][3] - m.m[i][1];     // Top
+    m_planes[4][i] = m.m[i][2];                 // Near
+    m_planes[5][i] = m.m[i][3] - m.m[i][2];     // Far
+  }
+
+  // Normalized, so distances compare against box extents in world units.
+  for (uint32_t plane = 0; plane < PLANE_CNT; plane++)
+  {
+    float *p = m_planes[plane];
+    float len = sqrtf(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+    if (len > 0.0f)
+    {
+      p[0] /= len;
+      p[1] /= len;
+      p[2] /= len;
+      p[3] /= len;
+    }
+  }
+}
+
+
+void FrustumCuller::add(VisualModel *pModel, const Mat4 &worldMat)
+{
+  Item item;
+  item.pModel = pModel;
+  item.worldMat = worldMat;
+  m_items.push_back(item);
+
+  // Screen space models aren't in the world, and models without bounds can't be culled.
+  Vec3 boundsMin;
+  Vec3 boundsMax;
+  bool bBounded =
+    pModel && !pModel->getStaticScreenLoc() && VisualModel::getLocalBounds(pModel, boundsMin, boundsMax);
+
+  // The world box encloses the rotated local box: each world extent sums the local extents along the matrix rows.
+  Vec3 center;
+  Vec3 extent;
+  if (bBounded)
+  {
+    Vec3 localCenter = (boundsMin + boundsMax) * 0.5f;
+    Vec3 localExtent = (boundsMax - boundsMin) * 0.5f;
+    const float (&m)[4][4] = worldMat.m;
+    center = vec3TransformCoord(localCenter, worldMat);
+    extent.x = fabsf(m[0][0]) * localExtent.x + fabsf(m[1][0]) * localExtent.y + fabsf(m[2][0]) * localExtent.z;
+    extent.y = fabsf(m[0][1]) * localExtent.x + fabsf(m[1][1]) * localExtent.y + fabsf(m[2][1]) * localExtent.z;
+    extent.z = fabsf(m[0][2]) * localExtent.x + fabsf(m[1][2]) * localExtent.y + fabsf(m[2][2]) * localExtent.z;
+  }
+
+  m_centerX.push_back(center.x);
+  m_centerY.push_back(center.y);
+  m_centerZ.push_back(center.z);
+  m_extentX.push_back(extent.x);
+  m_extentY.push_back(extent.y);
+  m_extentZ.push_back(extent.z);
+  m_bBounded.push_back(bBounded ? 1 : 0);
+}
+
+
+void FrustumCuller::cull()
+{
+  uint32_t itemCnt = static_cast<uint32_t>(m_items.size());
+  m_stats = FrustumCullStats();
+  m_stats.tested = itemCnt;
+  m_bVisible.assign(itemCnt, 1);
+
+  if (m_bEnabled)
+  {
+    // Pad to whole batches, the padding is never read back.
+    uint32_t paddedCnt = (itemCnt + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    m_centerX.resize(paddedCnt);
+    m_centerY.resize(paddedCnt);
+    m_centerZ.resize(paddedCnt);
+    m_extentX.resize(paddedCnt);
+    m_extentY.resize(paddedCnt);
+    m_extentZ.resize(paddedCnt);
+
+    SimdFloat4 zero = simdSplat(0.0f);
+    for (uint32_t base = 0; base < itemCnt; base += SIMD_WIDTH)
+    {
+      SimdFloat4 cx = simdLoad(&m_centerX[base]);
+      SimdFloat4 cy = simdLoad(&m_centerY[base]);
+      SimdFloat4 cz = simdLoad(&m_centerZ[base]);
+      SimdFloat4 ex = simdLoad(&m_extentX[base]);
+      SimdFloat4 ey = simdLoad(&m_extentY[base]);
+      SimdFloat4 ez = simdLoad(&m_extentZ[base]);
+
+      // A box is outside if even its corner furthest along a plane's normal is behind that plane:
+      // dot(n, center) + dot(|n|, extent) + d < 0.
+      int outsideMask = 0;
+      for (uint32_t plane = 0; plane < PLANE_CNT; plane++)
+      {
+        const float *p = m_planes[plane];
+        SimdFloat4 dist = simdSplat(p[3]);
+        dist = simdMulAdd(simdSplat(p[0]), cx, dist);
+        dist = simdMulAdd(simdSplat(p[1]), cy, dist);
+        dist = simdMulAdd(simdSplat(p[2]), cz, dist);
+        dist = simdMulAdd(simdSplat(fabsf(p[0])), ex, dist);
+        dist = simdMulAdd(simdSplat(fabsf(p[1])), ey, dist);
+        dist = simdMulAdd(simdSplat(fabsf(p[2])), ez, dist);
+        outsideMask |= simdLessMask(dist, zero);
+      }
+
+      for (uint32_t lane = 0; lane < SIMD_WIDTH && base + lane < itemCnt; lane++)
+      {
+        if ((outsideMask & (1 << lane)) && m_bBounded[base + lane])
+        {
+          m_bVisible[base + lane] = 0;
+        }
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < itemCnt; i++)
+  {
+    if (m_bVisible[i])
+    {
+      m_stats.visible++;
+      m_stats.unbounded += m_bBounded[i] ? 0 : 1;
+    }
+  }
+}
+
+
+uint32_t FrustumCuller::getItemCnt()
+{
+  return static_cast<uint32_t>(m_items.size());
+}
+
+
+VisualModel *FrustumCuller::getModel(uint32_t idx)
+{
+  return m_items[idx].pModel;
+}
+
+
+const Mat4 &FrustumCuller::getWorldMatrix(uint32_t idx)
+{
+  return m_items[idx].worldMat;
+}
+
+
+bool FrustumCuller::isVisible(uint32_t idx)
+{
+  return m_bVisible[idx] != 0;
+}
+
+
+FrustumCullStats FrustumCuller::getStats()
+{
+  return m_stats;
+}
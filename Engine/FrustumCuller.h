@@ -0,0 +1,70 @@
+#ifndef FRUSTUM_CULLER_H
+#define FRUSTUM_CULLER_H
+
+#include "Math/Matrix.h"
+#include "VisualModel.h"
+#include <vector>
+
+typedef struct FrustumCullStats_
+{
+  uint32_t tested{ 0 };
+  uint32_t visible{ 0 };
+  uint32_t unbounded{ 0 };      // Of the visible ones, models with no bounds to test (see VisualModel::getLocalBounds).
+} FrustumCullStats;
+
+// Culls a frame's models against the camera's view frustum before they're submitted (see Scene::update).
+//
+// add() turns each model's local bounding box into a world space one, cull() then tests them 4 at a time against the
+// 6 planes of the frustum, using the SIMD backend from MathSimd.h. Boxes are kept as a structure of arrays, so each
+// component of 4 boxes is one load. Conservative: boxes near a frustum corner can pass while being just outside it.
+class FrustumCuller
+{
+private:
+  static const uint32_t PLANE_CNT = 6;
+
+  typedef struct Item_
+  {
+    VisualModel *pModel;
+    Mat4         worldMat;
+  } Item;
+
+  float                 m_planes[PLANE_CNT][4];     // a, b, c, d with the normal pointing in and normalized.
+  bool                  m_bEnabled;
+  std::vector<Item>     m_items;
+
+  // World space box centers and half extents, padded to a multiple of 4 items.
+  std::vector<float>    m_centerX;
+  std::vector<float>    m_centerY;
+  std::vector<float>    m_centerZ;
+  std::vector<float>    m_extentX;
+  std::vector<float>    m_extentY;
+  std::vector<float>    m_extentZ;
+
+  std::vector<uint8_t>  m_bBounded;
+  std::vector<uint8_t>  m_bVisible;
+  FrustumCullStats      m_stats;
+
+public:
+  FrustumCuller();
+
+  // With culling disabled, everything added is visible.
+  void setEnabled(bool bEnabled);
+
+  // Drops what was added for the last frame, and takes the frustum from the frame's view * projection matrix.
+  void begin(const Mat4 &viewProjMat);
+
+  void add(VisualModel *pModel, const Mat4 &worldMat);
+
+  void cull();
+
+  // Items in the order they were added.
+  uint32_t getItemCnt();
+  VisualModel *getModel(uint32_t idx);
+  const Mat4 &getWorldMatrix(uint32_t idx);
+  bool isVisible(uint32_t idx);
+
+  // Counts for the last cull().
+  FrustumCullStats getStats();
+};
+
+#endif
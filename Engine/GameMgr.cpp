@@ -7,6 +7,7 @@
 GameMgr::GameMgr()
 {
   m_pActiveScene = NULL;
+  m_pLoadingScene = NULL;
   memset(&m_sceneIo, 0, sizeof(m_sceneIo));
   memset(&m_inputState, 0, sizeof(m_inputState));
 }
@@ -21,13 +22,11 @@ GameMgr::~GameMgr()
 bool GameMgr::init(
   HINSTANCE hinst,
   HWND hwnd,
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   Scene* pStartingScene,
   uint32_t width,
   uint32_t height)
 {
-  m_pActiveScene = pStartingScene;
   m_width = width;
   m_height = height;
 
@@ -52,13 +51,8 @@ bool GameMgr::init(
     m_sceneIo.pSoundMgr = &m_soundMgr;
   }
 
-  if (m_pActiveScene)
-  {
-    Scene::prelimUpdateScene(m_pActiveScene, dev, devcon, m_sceneIo);
-  }
-
   // Set up camera
-  m_gm.initConstBuffer(dev, devcon);
+  m_gm.initConstBuffer(dev);
   m_gm.setPerspective(
     PHYS_CONST_PI / 2.0f,
     1.0f * m_width / m_height,
@@ -78,21 +72,88 @@ bool GameMgr::init(
   m_sceneIo.pGraphicsMgr = &m_gm;
   m_sceneIo.pPhysicsMgr = &m_pm;
 
+  m_jobs.start();
+  m_sceneIo.pJobSystem = &m_jobs;
+
   DebugOverlay *pDbgOverlay = new DebugOverlay();
-  pDbgOverlay->init(dev, devcon);
+  pDbgOverlay->init(dev);
   m_objs[GMO_DBG_OVERLAY] = pDbgOverlay;
 
-  prelimUpdates(dev, devcon);
+  prelimUpdates(dev);
+
+  // Starting scene is loaded in the background, the debug overlay keeps rendering in the meantime.
+  if (pStartingScene && !loadScene(pStartingScene, dev))
+  {
+    LOGE("Failed to start loading the starting scene");
+    return false;
+  }
+
   return true;
 }
 
 
-bool GameMgr::prelimUpdates(ID3D11Device *dev, ID3D11DeviceContext *devcon)
+bool GameMgr::loadScene(Scene *pScene, RenderDevice *dev)
+{
+  if (m_pLoadingScene)
+  {
+    LOGW("Already loading a scene, ignoring new scene load");
+    return false;
+  }
+
+  auto progressCb = [](const SceneLoadProgress &progress)
+  {
+    LOGD("Scene load stage %d, %u/%u objs ready", progress.stage, progress.readyObjs, progress.parsedObjs);
+  };
+
+  if (!pScene->beginLoad(dev, progressCb))
+  {
+    return false;
+  }
+
+  m_pLoadingScene = pScene;
+  return true;
+}
+
+
+void GameMgr::updateLoadingScene(RenderDevice *dev)
+{
+  if (!m_pLoadingScene || !m_pLoadingScene->pumpLoad(dev))
+  {
+    return;
+  }
+
+  Scene *pLoadedScene = m_pLoadingScene;
+  m_pLoadingScene = NULL;
+
+  if (!pLoadedScene->isLoaded())
+  {
+    LOGE("Background scene load failed, keeping current scene");
+    Scene::releaseScene(pLoadedScene);
+    delete pLoadedScene;
+    return;
+  }
+
+  Scene::prelimUpdateScene(pLoadedScene, dev, m_sceneIo);
+
+  if (m_pActiveScene)
+  {
+    Scene::releaseScene(m_pActiveScene);
+    delete m_pActiveScene;
+
+    // Whatever the new scene didn't reuse of the old scene's objects goes back to the system.
+    LOGI("Released %u pool slabs", ObjectManager::trimPools());
+  }
+
+  m_pActiveScene = pLoadedScene;
+}
+
+
+bool GameMgr::prelimUpdates(RenderDevice *dev)
 {
   bool bSuccess = true;
   for (auto it = m_objs.begin(); it != m_objs.end(); ++it)
   {
-    if (!GameObject::prelimUpdateGameObject(it->second, dev, devcon, m_sceneIo.timeMs, m_sceneIo.input, m_sceneIo.pSoundMgr))
+    if (!GameObject::prelimUpdateGameObject(it->second, dev, m_sceneIo.timeMs, m_sceneIo.input, m_sceneIo.pSoundMgr))
     {
       LOGW("Failed prelim update for GameMgr obj [%u], continuing", it->first);
       bSuccess = false;
@@ -107,15 +168,8 @@ bool GameMgr::prelimUpdates(ID3D11Device *dev, ID3D11DeviceContext *devcon)
 }
 
 
-bool GameMgr::update(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon)
+bool GameMgr::update(RenderDevice *dev)
 {
-  if (!m_pActiveScene)
-  {
-    LOGE("Null active scene");
-  }
-
   if (!m_sceneIo.pGraphicsMgr)
   {
     LOGE("Null Graphic Mgr");
@@ -126,7 +180,26 @@ bool GameMgr::update(
   m_sceneIo.input = m_inputState;
 
   m_sceneIo.timeMs = m_timing.getTimeMs();
-  bool bSuccess = Scene::updateScene(m_pActiveScene, dev, devcon, m_sceneIo);
+
+  // Finish a bit of any background scene load, and swap it in once it's ready.
+  updateLoadingScene(dev);
+
+  // No active scene while the starting scene is still loading.
+  if (m_pActiveScene)
+  {
+    Scene::updateScene(m_pActiveScene, dev, m_sceneIo);
+  }
+
+  if (m_sceneIo.pNextScene)
+  {
+    if (!loadScene(m_sceneIo.pNextScene, dev))
+    {
+      LOGE("Failed to start loading next scene, dropping it");
+      Scene::releaseScene(m_sceneIo.pNextScene);
+      delete m_sceneIo.pNextScene;
+    }
+    m_sceneIo.pNextScene = NULL;
+  }
 
   // Update camera settings
   m_gm.setCamera(
@@ -137,19 +210,34 @@ bool GameMgr::update(
 
   // GameMgr can display some visuals if needed, but won't run the objects physics managers.
   // Physics is handled only within scene updates.
+  bool bSuccess = true;
+  m_culler.begin(m_gm.getViewProjMatrix());
   for (auto it = m_objs.begin(); it != m_objs.end(); ++it)
   {
-    if (!GameObject::updateGameObject(it->second, dev, devcon, m_sceneIo.timeMs, m_sceneIo.input, m_sceneIo.pSoundMgr))
+    if (!GameObject::updateGameObject(it->second, dev, m_sceneIo.timeMs, m_sceneIo.input, m_sceneIo.pSoundMgr))
     {
       LOGE("Failed to update obj [%u], continuing", it->first);
-      return false;
+      bSuccess = false;
+      break;
     }
 
-    m_sceneIo.pGraphicsMgr->setPosAndRot(it->second->getPos(), it->second->getRot());
-    m_sceneIo.pGraphicsMgr->renderModel(it->second->getVModel(), dev, devcon);
+    m_culler.add(it->second->getVModel(), it->second->getWorldMatrix());
   }
 
-  return true;
+  m_culler.cull();
+  for (uint32_t i = 0; i < m_culler.getItemCnt(); i++)
+  {
+    if (m_culler.isVisible(i))
+    {
+      m_sceneIo.pGraphicsMgr->setWorldMatrix(m_culler.getWorldMatrix(i));
+      m_sceneIo.pGraphicsMgr->renderModel(m_culler.getModel(i), dev);
+    }
+  }
+
+  // Everything queued this frame, with this frame's camera. Even on failure, queued models may not outlive the frame.
+  m_gm.flush(dev);
+
+  return bSuccess;
 }
 
 
@@ -165,11 +253,20 @@ bool GameMgr::release()
     }
   }
 
+  if (m_pLoadingScene)
+  {
+    Scene::releaseScene(m_pLoadingScene);
+    delete m_pLoadingScene;
+    m_pLoadingScene = NULL;
+  }
+
   if (!Scene::releaseScene(m_pActiveScene))
   {
     LOGE("Failed to release active scene");
     bSuccess = false;
   }
 
+  m_jobs.stop();
+
   return bSuccess;
 }
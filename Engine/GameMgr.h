@@ -8,6 +8,7 @@
 #include "PhysicsMgr.h"
 #include "InputMgr.h"
 #include "SoundMgr.h"
+#include "JobSystem.h"
 
 class GameMgr
 {
@@ -25,13 +26,16 @@ protected:
   // TODO: Consider moving to ObjectManager framework.
   std::map<uint32_t, GameObject*> m_objs;
   Scene* m_pActiveScene;
+  Scene* m_pLoadingScene;   // Loading in the background, becomes the active scene once done.
   SceneIo m_sceneIo;
 
   Timing m_timing;
 
   GraphicsManager m_gm;
+  FrustumCuller   m_culler;     // For m_objs, scenes cull their own.
   PhysicsManager  m_pm;
   SoundMgr        m_soundMgr;
+  JobSystem       m_jobs;
 
   InputApi m_inputState;
   InputMgr m_inputMgr;
@@ -46,17 +50,18 @@ public:
   bool init(
     HINSTANCE hinst,
     HWND hwnd,
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     Scene *pStartingScene,
     uint32_t width = DEFAULT_WIDTH,
     uint32_t height = DEFAULT_HEIGHT);
 
-  bool prelimUpdates(ID3D11Device *dev, ID3D11DeviceContext *devcon);
+  bool prelimUpdates(RenderDevice *dev);
+
+  // Starts loading pScene in the background. The current scene keeps running until it's ready.
+  bool loadScene(Scene *pScene, RenderDevice *dev);
+  void updateLoadingScene(RenderDevice *dev);
   
-  bool update(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon);
+  bool update(RenderDevice *dev);
 
   bool release();
 };
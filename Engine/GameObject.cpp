@@ -1,6 +1,7 @@
 #include "GameObject.h"
 #include "Util.h"
 #include "Logger.h"
+#include "GraphicsManager.h"
 #include "Objects/DebugOverlay.h"
 #include "Objects/PolyObj.h"
 #include "Objects/ControllableObj.h"
@@ -35,7 +36,42 @@ GameObject::~GameObject()
   DELETE_AND_NULL(m_pVModel);
 }
 
-bool GameObject::init(ID3D11Device *dev, ID3D11DeviceContext *devcon)
+GameObject::GameObject(GameObject &&other) noexcept
+{
+  m_pVModel = NULL;
+  m_pPModel = NULL;
+  *this = std::move(other);
+}
+
+
+GameObject& GameObject::operator=(GameObject &&other) noexcept
+{
+  if (this != &other)
+  {
+    // Anything still held here has already been released by its owner (see ObjectManager::removeObject).
+    DELETE_AND_NULL(m_pVModel);
+    DELETE_AND_NULL(m_pPModel);
+
+    m_uuid    = other.m_uuid;
+    m_type    = other.m_type;
+    m_pos     = other.m_pos;
+    m_vel     = other.m_vel;
+    m_rot     = other.m_rot;
+    m_rotVel  = other.m_rotVel;
+    m_worldMat = other.m_worldMat;
+    m_bWorldMatDirty = other.m_bWorldMatDirty;
+    m_pVModel = other.m_pVModel;
+    m_pPModel = other.m_pPModel;
+
+    other.m_pVModel = NULL;
+    other.m_pPModel = NULL;
+  }
+
+  return *this;
+}
+
+
+bool GameObject::init(RenderDevice *dev)
 {
   return true;
 }
@@ -47,6 +83,12 @@ bool GameObject::release()
 
   VisualModel::releaseVModel(m_pVModel);
   DELETE_AND_NULL(m_pVModel);
+
+  if (m_pPModel)
+  {
+    m_pPModel->release();
+    DELETE_AND_NULL(m_pPModel);
+  }
   return true;
 }
 
@@ -77,8 +119,7 @@ PhysicsModel* GameObject::getPModel()
 
 // General purpose update. VisualModels and PhysicsModels are handled by their respective managers separately.
 bool GameObject::update(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   float timeMs,
   InputApi &input,
   SoundMgr *pSoundMgr)
@@ -88,8 +129,7 @@ bool GameObject::update(
 
 
 bool GameObject::prelimUpdate(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   float timeMs,
   InputApi &input,
   SoundMgr *pSoundMgr)
@@ -110,10 +150,58 @@ uint64_t GameObject::getUuid()
 }
 
 
+bool GameObject::hasUpdate(GameObject *pObj)
+{
+  if (!pObj)
+  {
+    return false;
+  }
+
+  switch (pObj->getType())
+  {
+    case GAME_OBJECT_DEBUG_OVERLAY:
+    case GAME_OBJECT_CONTROLLABLE:
+    case GAME_OBJECT_HOOKSHOT:
+    {
+      return true;
+    }
+    default:
+    {
+      return false;
+    }
+  }
+
+  return false;
+}
+
+
+bool GameObject::isUpdateThreadSafe(GameObject *pObj)
+{
+  if (!pObj)
+  {
+    return false;
+  }
+
+  switch (pObj->getType())
+  {
+    case GAME_OBJECT_CONTROLLABLE:
+    case GAME_OBJECT_POLY_OBJ:
+    {
+      return true;
+    }
+    default:
+    {
+      return false;
+    }
+  }
+
+  return false;
+}
+
+
 bool GameObject::updateGameObject(
   GameObject * pObj,
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   float timeMs,
   InputApi &input,
   SoundMgr *pSoundMgr)
@@ -129,19 +217,19 @@ bool GameObject::updateGameObject(
   {
     case GAME_OBJECT_DEBUG_OVERLAY:
     {
-      return static_cast<DebugOverlay*>(pObj)->update(dev, devcon, timeMs, input, pSoundMgr);
+      return static_cast<DebugOverlay*>(pObj)->update(dev, timeMs, input, pSoundMgr);
     }
     case GAME_OBJECT_CONTROLLABLE:
     {
-      return static_cast<ControllableObj*>(pObj)->update(dev, devcon, timeMs, input, pSoundMgr);
+      return static_cast<ControllableObj*>(pObj)->update(dev, timeMs, input, pSoundMgr);
     }
     case GAME_OBJECT_POLY_OBJ:
     {
-      return static_cast<PolyObj*>(pObj)->update(dev, devcon, timeMs, input, pSoundMgr);
+      return static_cast<PolyObj*>(pObj)->update(dev, timeMs, input, pSoundMgr);
     }
     case GAME_OBJECT_HOOKSHOT:
     {
-      return static_cast<Hookshot*>(pObj)->update(dev, devcon, timeMs, input, pSoundMgr);
+      return static_cast<Hookshot*>(pObj)->update(dev, timeMs, input, pSoundMgr);
     }
     default:
     {
@@ -156,8 +244,7 @@ bool GameObject::updateGameObject(
 
 bool GameObject::prelimUpdateGameObject(
   GameObject * pObj,
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   float timeMs,
   InputApi &input,
   SoundMgr *pSoundMgr)
@@ -173,19 +260,19 @@ bool GameObject::prelimUpdateGameObject(
   {
     case GAME_OBJECT_DEBUG_OVERLAY:
     {
-      return static_cast<DebugOverlay*>(pObj)->prelimUpdate(dev, devcon, timeMs, input, pSoundMgr);
+      return static_cast<DebugOverlay*>(pObj)->prelimUpdate(dev, timeMs, input, pSoundMgr);
     }
     case GAME_OBJECT_CONTROLLABLE:
     {
-      return static_cast<ControllableObj*>(pObj)->prelimUpdate(dev, devcon, timeMs, input, pSoundMgr);
+      return static_cast<ControllableObj*>(pObj)->prelimUpdate(dev, timeMs, input, pSoundMgr);
     }
     case GAME_OBJECT_POLY_OBJ:
     {
-      return static_cast<PolyObj*>(pObj)->prelimUpdate(dev, devcon, timeMs, input, pSoundMgr);
+      return static_cast<PolyObj*>(pObj)->prelimUpdate(dev, timeMs, input, pSoundMgr);
     }
     case GAME_OBJECT_HOOKSHOT:
     {
-      return static_cast<Hookshot*>(pObj)->prelimUpdate(dev, devcon, timeMs, input, pSoundMgr);
+      return static_cast<Hookshot*>(pObj)->prelimUpdate(dev, timeMs, input, pSoundMgr);
     }
     default:
     {
@@ -198,8 +285,13 @@ bool GameObject::prelimUpdateGameObject(
 }
 
 
-void GameObject::setPos(Pos3 &newPos)
+void GameObject::setPos(const Pos3 &newPos)
 {
+  // Physics hands back every object's position each frame, most of them haven't moved.
+  if (newPos.pos != m_pos.pos)
+  {
+    m_bWorldMatDirty = true;
+  }
   m_pos = newPos;
 }
 
@@ -210,7 +302,7 @@ Pos3 GameObject::getPos()
 }
 
 
-void GameObject::setVel(Pos3 &newVel)
+void GameObject::setVel(const Pos3 &newVel)
 {
   m_vel = newVel;
 }
@@ -222,8 +314,12 @@ Pos3 GameObject::getVel()
 }
 
 
-void GameObject::setRot(Pos3 &rot)
+void GameObject::setRot(const Pos3 &rot)
 {
+  if (rot.pos != m_rot.pos)
+  {
+    m_bWorldMatDirty = true;
+  }
   m_rot = rot;
 }
 
@@ -234,7 +330,7 @@ Pos3 GameObject::getRot()
 }
 
 
-void GameObject::setRotVel(Pos3 &rotVel)
+void GameObject::setRotVel(const Pos3 &rotVel)
 {
   m_rotVel = rotVel;
 }
@@ -246,6 +342,29 @@ Pos3 GameObject::getRotVel()
 }
 
 
+bool GameObject::isWorldMatrixDirty()
+{
+  return m_bWorldMatDirty;
+}
+
+
+void GameObject::setWorldMatrix(const Mat4 &worldMat)
+{
+  m_worldMat = worldMat;
+  m_bWorldMatDirty = false;
+}
+
+
+const Mat4 &GameObject::getWorldMatrix()
+{
+  if (m_bWorldMatDirty)
+  {
+    setWorldMatrix(GraphicsManager::calcWorldMatrix(m_pos, m_rot));
+  }
+  return m_worldMat;
+}
+
+
 bool GameObject::releaseGameObject(GameObject * pObj)
 {
   if (!pObj)
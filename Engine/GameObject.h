@@ -4,6 +4,7 @@
 #include "InputMgr.h"
 #include "VisualModel.h"
 #include "PhysicsModel.h"
+#include "Math/Matrix.h"
 
 class SoundMgr;
 
@@ -27,24 +28,33 @@ protected:
   Pos3            m_rot;
   Pos3            m_rotVel;
 
+  // World matrix for m_pos and m_rot, only rebuilt once either one has changed.
+  Mat4            m_worldMat;
+  bool            m_bWorldMatDirty = true;
+
   VisualModel*    m_pVModel;
   PhysicsModel*   m_pPModel;
   
 public:
   static bool releaseGameObject(GameObject *pObj);
 
+  // False for object types with no per-frame logic (ex. static PolyObj blocks), which can skip updateGameObject.
+  static bool hasUpdate(GameObject *pObj);
+
+  // False for object types whose update touches the D3D immediate context (ex. rebuilding text or mesh buffers), those
+  // have to run on the main thread. Others can be updated on job workers (see Scene::update).
+  static bool isUpdateThreadSafe(GameObject *pObj);
+
   static bool updateGameObject(
     GameObject *pObj,
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     float timeMs,
     InputApi &input,
     SoundMgr *pSoundMgr);
 
   static bool prelimUpdateGameObject(
     GameObject *pObj,
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     float timeMs,
     InputApi &input,
     SoundMgr *pSoundMgr);
@@ -54,30 +64,39 @@ public:
   // GameObject takes ownership of any model passed to it and will free memory accordingly during destructor.
   GameObject(VisualModel* pVModel);
   // Don't rely on destructor to free any dynamic memory. This should be handled in the derived class release() method.
-  ~GameObject();
+  virtual ~GameObject();
 
-  void setPos(Pos3 &newPos);
+  // Objects can be moved (ex. into ObjectManager's storage), the models go along with them. No copies.
+  GameObject(GameObject &&other) noexcept;
+  GameObject& operator=(GameObject &&other) noexcept;
+
+  void setPos(const Pos3 &newPos);
   Pos3 getPos();
-  void setVel(Pos3 &newVel);
+  void setVel(const Pos3 &newVel);
   Pos3 getVel();
-  void setRot(Pos3 &newRot);
+  void setRot(const Pos3 &newRot);
   Pos3 getRot();
-  void setRotVel(Pos3 &newRotVel);
+  void setRotVel(const Pos3 &newRotVel);
   Pos3 getRotVel();
 
-  virtual bool init(ID3D11Device *dev, ID3D11DeviceContext *devcon);
+  // Scenes rebuild the dirty world matrices of all their objects in one batch (see
+  // GraphicsManager::calcWorldMatrices) and hand them back with setWorldMatrix(). getWorldMatrix() still rebuilds
+  // a dirty one on its own.
+  bool isWorldMatrixDirty();
+  void setWorldMatrix(const Mat4 &worldMat);
+  const Mat4 &getWorldMatrix();
+
+  virtual bool init(RenderDevice *dev);
 
   // General purpose update. VisualModels and PhysicsModels are handled by their respective managers separately.
   virtual bool update(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     float timeMs,
     InputApi &input,
     SoundMgr *pSoundMgr);
 
   virtual bool prelimUpdate(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     float timeMs,
     InputApi &input,
     SoundMgr *pSoundMgr);
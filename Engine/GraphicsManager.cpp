@@ -4,15 +4,36 @@
 #include "VisualModels/TexPoly.h"
 #include "VisualModels/TexRect.h"
 #include "VisualModels/TexText.h"
+#include <algorithm>
+#include <string.h>
+
+// Sort key fields, see RenderItem. Depth is in view space units, front to back, anything further than
+// SORT_DEPTH_MAX / SORT_DEPTH_SCALE sorts as the same depth.
+static const uint32_t SORT_PASS_SHIFT = 60;
+static const uint32_t SORT_SHADER_SHIFT = 48;
+static const uint32_t SORT_SHADER_MAX = 0xfff;
+static const uint32_t SORT_TEXTURE_SHIFT = 32;
+static const uint32_t SORT_TEXTURE_MAX = 0xffff;
+static const uint32_t SORT_DEPTH_SHIFT = 16;
+static const float SORT_DEPTH_SCALE = 64.0f;
+static const uint32_t SORT_DEPTH_MAX = 0xffff;
+
+// Each draw's constants, padded out to a whole constant buffer range.
+static const uint32_t FRAME_CONST_STRIDE =
+  (sizeof(VS_CONST_BUFFER) + RENDER_CONSTANT_RANGE_ALIGN - 1) / RENDER_CONSTANT_RANGE_ALIGN *
+  RENDER_CONSTANT_RANGE_ALIGN;
 
 GraphicsManager::GraphicsManager()
 {
-  D3DXMatrixIdentity(&m_worldMat);
-  D3DXMatrixIdentity(&m_viewMat);
-  D3DXMatrixIdentity(&m_projMat);
-  D3DXMatrixIdentity(&m_totMat);
+  m_worldMat = matrixIdentity();
+  m_viewMat = matrixIdentity();
+  m_projMat = matrixIdentity();
+  m_totMat = matrixIdentity();
   m_pConstBuffer = NULL;
-  memset(&m_vsConstData, 0, sizeof(m_vsConstData));
+  m_pFrameConstBuffer = NULL;
+  m_frameConstCapacity = 0;
+  m_pDevice = NULL;
+  m_vsConstData = VS_CONST_BUFFER();
 }
 
 
@@ -22,107 +43,302 @@ GraphicsManager::~GraphicsManager()
 }
 
 
-void GraphicsManager::initConstBuffer(ID3D11Device *dev, ID3D11DeviceContext *devcon)
+void GraphicsManager::initConstBuffer(RenderDevice *dev)
 {
-  // Fill in a buffer description.
-  D3D11_BUFFER_DESC cbDesc;
-  ZeroMemory(&cbDesc, sizeof(cbDesc));
-  // If the bind flag is D3D11_BIND_CONSTANT_BUFFER, you must set the ByteWidth value in multiples of 16.
-  cbDesc.ByteWidth = sizeof(VS_CONST_BUFFER);
-  cbDesc.Usage = D3D11_USAGE_DYNAMIC;
-  cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-  cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+  m_pDevice = dev;
 
-  HRESULT err = dev->CreateBuffer(&cbDesc, NULL, &m_pConstBuffer); // Create the buffer.
+  // Constant buffer sizes must be a multiple of 16 bytes.
+  m_pConstBuffer = dev->createBuffer(RENDER_BUFFER_CONSTANT, sizeof(VS_CONST_BUFFER), NULL);
 
-  // Set the buffer. Only need to do once per program per buffer.
-  devcon->VSSetConstantBuffers(0, 1, &m_pConstBuffer);
+  // Set the buffer. flush() sets it again if it was replaced by frame constant ranges.
+  dev->setVsConstantBuffer(0, m_pConstBuffer);
 }
 
 
-void GraphicsManager::setPosAndRot(Pos3 &pos, Pos3 &pitchYawRoll)
+void GraphicsManager::setPosAndRot(const Pos3 &pos, const Pos3 &pitchYawRoll)
 {
-  // https://www.gamedev.net/forums/topic/682063-vector-and-matrix-multiplication-order-in-directx-and-opengl/
+  m_worldMat = calcWorldMatrix(pos, pitchYawRoll);
+}
+
+
+void GraphicsManager::setWorldMatrix(const Mat4 &worldMat)
+{
+  m_worldMat = worldMat;
+}
+
+
+Mat4 GraphicsManager::calcWorldMatrix(const Pos3 &pos, const Pos3 &pitchYawRoll)
+{
+  Mat4 worldMat;
+  calcWorldMatrices(&pos, &pitchYawRoll, &worldMat, 1);
+  return worldMat;
+}
+
 
+void GraphicsManager::calcWorldMatrices(
+  const Pos3 *pPositions,
+  const Pos3 *pPitchYawRolls,
+  Mat4 *pWorldMats,
+  uint32_t cnt)
+{
+  // https://www.gamedev.net/forums/topic/682063-vector-and-matrix-multiplication-order-in-directx-and-opengl/
   // https://msdn.microsoft.com/en-us/library/windows/desktop/bb206365(v=vs.85).aspx
-  D3DXMATRIX MatTemp;  // Temp matrix for rotations.
-  D3DXMATRIX MatRot;   // Final rotation matrix, applied to 
-                       // pMatWorld.
-
-                       // Using the left-to-right order of matrix concatenation,
-                       // apply the translation to the object's world position
-                       // before applying the rotations.
-  D3DXMatrixTranslation(&m_worldMat, pos.pos.x, pos.pos.y, pos.pos.z);
-  D3DXMatrixIdentity(&MatRot);
-
-  // Now, apply the orientation variables to the world matrix
-  if (pitchYawRoll.pos.x || pitchYawRoll.pos.y || pitchYawRoll.pos.z) {
-    // Produce and combine the rotation matrices.
-    D3DXMatrixRotationX(&MatTemp, pitchYawRoll.pos.x);         // Pitch
-    D3DXMatrixMultiply(&MatRot, &MatRot, &MatTemp);
-    D3DXMatrixRotationY(&MatTemp, -pitchYawRoll.pos.y);        // Yaw
-    D3DXMatrixMultiply(&MatRot, &MatRot, &MatTemp);
-    D3DXMatrixRotationZ(&MatTemp, pitchYawRoll.pos.z);         // Roll
-    D3DXMatrixMultiply(&MatRot, &MatRot, &MatTemp);
-
-    // Apply the rotation matrices to complete the world matrix.
-    D3DXMatrixMultiply(&m_worldMat, &MatRot, &m_worldMat);
+
+  // World = RotX(pitch) * RotY(-yaw) * RotZ(roll) * Translation, ie. rotate first and then move to the object's world
+  // position. Multiplied out, the rotation part is (with a = pitch, b = -yaw, c = roll):
+  //   cb*cc               cb*sc               -sb
+  //   sa*sb*cc - ca*sc    sa*sb*sc + ca*cc    sa*cb
+  //   ca*sb*cc + sa*sc    ca*sb*sc - sa*cc    ca*cb
+  // The sines and cosines are scalar, the products are done for 4 objects at a time. Unused lanes get angle 0.
+  static const uint32_t LANES = 4;
+  for (uint32_t base = 0; base < cnt; base += LANES)
+  {
+    uint32_t laneCnt = (cnt - base < LANES) ? cnt - base : LANES;
+
+    float sinA[LANES] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    float cosA[LANES] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    float sinB[LANES] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    float cosB[LANES] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    float sinC[LANES] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    float cosC[LANES] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    for (uint32_t lane = 0; lane < laneCnt; lane++)
+    {
+      const Vec3 &angles = pPitchYawRolls[base + lane].pos;
+      sinA[lane] = sinf(angles.x);
+      cosA[lane] = cosf(angles.x);
+      sinB[lane] = sinf(-angles.y);
+      cosB[lane] = cosf(-angles.y);
+      sinC[lane] = sinf(angles.z);
+      cosC[lane] = cosf(angles.z);
+    }
+
+    SimdFloat4 sa = simdLoad(sinA);
+    SimdFloat4 ca = simdLoad(cosA);
+    SimdFloat4 sb = simdLoad(sinB);
+    SimdFloat4 cb = simdLoad(cosB);
+    SimdFloat4 sc = simdLoad(sinC);
+    SimdFloat4 cc = simdLoad(cosC);
+    SimdFloat4 sasb = simdMul(sa, sb);
+    SimdFloat4 casb = simdMul(ca, sb);
+
+    float rot[3][3][LANES];
+    simdStore(rot[0][0], simdMul(cb, cc));
+    simdStore(rot[0][1], simdMul(cb, sc));
+    simdStore(rot[0][2], simdSub(simdSplat(0.0f), sb));
+    simdStore(rot[1][0], simdSub(simdMul(sasb, cc), simdMul(ca, sc)));
+    simdStore(rot[1][1], simdAdd(simdMul(sasb, sc), simdMul(ca, cc)));
+    simdStore(rot[1][2], simdMul(sa, cb));
+    simdStore(rot[2][0], simdAdd(simdMul(casb, cc), simdMul(sa, sc)));
+    simdStore(rot[2][1], simdSub(simdMul(casb, sc), simdMul(sa, cc)));
+    simdStore(rot[2][2], simdMul(ca, cb));
+
+    for (uint32_t lane = 0; lane < laneCnt; lane++)
+    {
+      const Vec3 &pos = pPositions[base + lane].pos;
+      pWorldMats[base + lane] = Mat4(
+        rot[0][0][lane], rot[0][1][lane], rot[0][2][lane], 0.0f,
+        rot[1][0][lane], rot[1][1][lane], rot[1][2][lane], 0.0f,
+        rot[2][0][lane], rot[2][1][lane], rot[2][2][lane], 0.0f,
+        pos.x,           pos.y,           pos.z,           1.0f);
+    }
   }
 }
 
 
-void GraphicsManager::setCamera(Pos3 &eye, Pos3 &lookAt, Pos3 &up)
+void GraphicsManager::setCamera(const Pos3 &eye, const Pos3 &lookAt, const Pos3 &up)
 {
-  D3DXMatrixLookAtRH(&m_viewMat, &eye.pos, &lookAt.pos, &up.pos);
+  m_viewMat = matrixLookAtRH(eye.pos, lookAt.pos, up.pos);
 }
 
 
 void GraphicsManager::resetCamera()
 {
-  D3DXMatrixIdentity(&m_viewMat);
+  m_viewMat = matrixIdentity();
 }
 
 
 void GraphicsManager::setPerspective(float fovy, float aspect, float nearDist, float farDist)
 {
-  D3DXMatrixPerspectiveFovRH(&m_projMat, fovy, aspect, nearDist, farDist);
+  m_projMat = matrixPerspectiveFovRH(fovy, aspect, nearDist, farDist);
+}
+
+
+Mat4 GraphicsManager::getViewProjMatrix()
+{
+  return matrixMultiply(m_viewMat, m_projMat);
 }
 
 
-void GraphicsManager::renderModel(VisualModel *pModel, ID3D11Device *dev, ID3D11DeviceContext *devcon)
+uint32_t GraphicsManager::getSortId(
+  std::unordered_map<const void*, uint32_t> &ids,
+  const void *pResource,
+  uint32_t maxId)
+{
+  if (!pResource)
+  {
+    return 0;
+  }
+
+  // Past maxId, everything shares the last ID and only keeps its queue order.
+  uint32_t id = std::min(static_cast<uint32_t>(ids.size()) + 1, maxId);
+  return ids.insert(std::make_pair(pResource, id)).first->second;
+}
+
+
+void GraphicsManager::renderModel(VisualModel *pModel, RenderDevice *dev)
 {
   if (!pModel)
   {
     return;
   }
 
-  D3DXMATRIX tempMat;
+  RenderVertexShader *pVs = NULL;
+  RenderTexture *pTexture = NULL;
+  VisualModel::getRenderState(pModel, pVs, pTexture);
+
+  RenderItem item;
+  item.pModel = pModel;
+  item.worldMat = m_worldMat;
+  item.sortKey =
+    (static_cast<uint64_t>(pModel->getStaticScreenLoc() ? RENDER_PASS_SCREEN : RENDER_PASS_WORLD) << SORT_PASS_SHIFT) |
+    (static_cast<uint64_t>(getSortId(m_shaderIds, pVs, SORT_SHADER_MAX)) << SORT_SHADER_SHIFT) |
+    (static_cast<uint64_t>(getSortId(m_textureIds, pTexture, SORT_TEXTURE_MAX)) << SORT_TEXTURE_SHIFT);
+  m_queue.push_back(item);
+}
+
 
+Mat4 GraphicsManager::calcTotMatrix(const RenderItem &item, const Mat4 &viewProjMat)
+{
   // View Matrix can be skipped for objects that should have static locations on the screen, ex. text overlays.
-  if (pModel->getStaticScreenLoc())
+  if (item.pModel->getStaticScreenLoc())
+  {
+    return matrixMultiply(item.worldMat, m_projMat);
+  }
+
+  return matrixMultiply(item.worldMat, viewProjMat);
+}
+
+
+bool GraphicsManager::uploadFrameConstants(RenderDevice *dev, const Mat4 &viewProjMat)
+{
+  uint32_t itemCnt = static_cast<uint32_t>(m_queue.size());
+  if (!itemCnt)
   {
-    D3DXMatrixMultiply(&m_totMat, &m_worldMat, &m_projMat);
+    return true;
   }
-  else
+
+  m_frameConstData.resize(static_cast<size_t>(itemCnt) * FRAME_CONST_STRIDE);
+  for (uint32_t i = 0; i < itemCnt; i++)
   {
-    D3DXMatrixMultiply(&tempMat, &m_worldMat, &m_viewMat);
-    D3DXMatrixMultiply(&m_totMat, &tempMat, &m_projMat);
+    VS_CONST_BUFFER constData;
+    constData.mat = calcTotMatrix(m_queue[i], viewProjMat);
+    memcpy(&m_frameConstData[i * FRAME_CONST_STRIDE], &constData, sizeof(constData));
   }
 
-  // Could directly target m_vsConstData.mat with final D3DXMatrixMultiply above.
-  memcpy(&m_vsConstData.mat, &m_totMat, sizeof(m_totMat));
+  if (itemCnt > m_frameConstCapacity)
+  {
+    RENDER_RELEASE_NON_NULL(dev, m_pFrameConstBuffer);
+    m_frameConstCapacity = itemCnt + itemCnt / 4;
+    m_pFrameConstBuffer = dev->createBuffer(RENDER_BUFFER_CONSTANT, m_frameConstCapacity * FRAME_CONST_STRIDE, NULL);
+  }
 
-  // Need to program buffer values and map them every time they change.
-  D3D11_MAPPED_SUBRESOURCE resource;
-  devcon->Map(m_pConstBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &resource);
-  memcpy(resource.pData, &m_vsConstData, sizeof(m_vsConstData));
-  devcon->Unmap(m_pConstBuffer, 0);
+  uint32_t byteWidth = itemCnt * FRAME_CONST_STRIDE;
+  if (!m_pFrameConstBuffer || !dev->updateBuffer(m_pFrameConstBuffer, m_frameConstData.data(), byteWidth))
+  {
+    LOGE("Failed to upload constants for %u draws", itemCnt);
+    m_frameConstCapacity = 0;
+    return false;
+  }
 
-  VisualModel::renderVModel(pModel, dev, devcon);
+  return true;
+}
+
+
+void GraphicsManager::flush(RenderDevice *dev)
+{
+  Mat4 viewProjMat = getViewProjMatrix();
+
+  // Depth is only known now that the camera is set for the frame.
+  for (size_t i = 0; i < m_queue.size(); i++)
+  {
+    RenderItem &item = m_queue[i];
+    if (item.pModel->getStaticScreenLoc())
+    {
+      continue;
+    }
+
+    Vec3 pos(item.worldMat.m[3][0], item.worldMat.m[3][1], item.worldMat.m[3][2]);
+    float depth = -vec3TransformCoord(pos, m_viewMat).z * SORT_DEPTH_SCALE;
+    uint32_t depthKey = depth <= 0.0f ? 0 : static_cast<uint32_t>(std::min(depth, static_cast<float>(SORT_DEPTH_MAX)));
+    item.sortKey |= static_cast<uint64_t>(depthKey) << SORT_DEPTH_SHIFT;
+  }
+
+  // Stable, so equal keys draw in the order they were queued.
+  std::stable_sort(m_queue.begin(), m_queue.end(), [](const RenderItem &a, const RenderItem &b)
+  {
+    return a.sortKey < b.sortKey;
+  });
+
+  // Whatever was bound before this frame isn't known, anything could have used the device since.
+  if (m_stateFilter.getTarget() != dev)
+  {
+    m_stateFilter.setTarget(dev);
+  }
+  m_stateFilter.invalidate();
+  m_stateFilter.resetStats();
+
+  // One upload for the whole frame where possible, otherwise the single constant buffer is updated for every draw.
+  bool bFrameConsts = dev->supportsConstantBufferRanges() && uploadFrameConstants(dev, viewProjMat);
+  if (!bFrameConsts)
+  {
+    m_stateFilter.setVsConstantBuffer(0, m_pConstBuffer);
+  }
+
+  for (size_t i = 0; i < m_queue.size(); i++)
+  {
+    RenderItem &item = m_queue[i];
+
+    if (bFrameConsts)
+    {
+      uint32_t byteOffset = static_cast<uint32_t>(i) * FRAME_CONST_STRIDE;
+      m_stateFilter.setVsConstantBufferRange(0, m_pFrameConstBuffer, byteOffset, FRAME_CONST_STRIDE);
+    }
+    else
+    {
+      m_totMat = calcTotMatrix(item, viewProjMat);
+      memcpy(&m_vsConstData.mat, &m_totMat, sizeof(m_totMat));
+
+      // Need to program buffer values every time they change.
+      dev->updateBuffer(m_pConstBuffer, &m_vsConstData, sizeof(m_vsConstData));
+    }
+
+    VisualModel::renderVModel(item.pModel, &m_stateFilter);
+  }
+
+  RenderStateStats stateStats = m_stateFilter.getStats();
+  m_frameStats.items = static_cast<uint32_t>(m_queue.size());
+  m_frameStats.stateSets = stateStats.stateSets;
+  m_frameStats.stateChanges = stateStats.stateChanges;
+
+  m_queue.clear();
+  m_shaderIds.clear();
+  m_textureIds.clear();
+}
+
+
+RenderQueueStats GraphicsManager::getFrameStats()
+{
+  return m_frameStats;
 }
 
 
 void GraphicsManager::release()
 {
-  RELEASE_NON_NULL(m_pConstBuffer);
+  m_queue.clear();
+
+  m_frameConstData.clear();
+  m_frameConstCapacity = 0;
+
+  RENDER_RELEASE_NON_NULL(m_pDevice, m_pConstBuffer);
+  RENDER_RELEASE_NON_NULL(m_pDevice, m_pFrameConstBuffer);
 }
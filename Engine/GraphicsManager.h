@@ -2,35 +2,101 @@
 #define GRAPHICS_MANAGER_H
 
 #include "CommonTypes.h"
+#include "Math/Matrix.h"
 #include "VisualModel.h"
+#include "RenderDevices/StateFilterRenderDevice.h"
+#include <unordered_map>
+#include <vector>
 
 typedef struct VS_CONST_BUFFER_T
 {
-  D3DMATRIX mat;
+  Mat4 mat;
 } VS_CONST_BUFFER;
 
+// Render queue passes, drawn in order.
+typedef enum RenderPass_
+{
+  RENDER_PASS_WORLD = 0,
+  RENDER_PASS_SCREEN,         // Models with a static screen location, ex. text overlays.
+  RENDER_PASS_COUNT
+} RenderPass;
+
+typedef struct RenderQueueStats_
+{
+  uint32_t items{ 0 };
+  uint64_t stateSets{ 0 };      // State the models set, before redundant sets were dropped.
+  uint64_t stateChanges{ 0 };   // State that reached the device.
+} RenderQueueStats;
+
 
 class GraphicsManager
 {
 private:
-  D3DXMATRIX m_worldMat;
-  D3DXMATRIX m_viewMat;
-  D3DXMATRIX m_projMat;
-  D3DXMATRIX m_totMat;
+  Mat4 m_worldMat;
+  Mat4 m_viewMat;
+  Mat4 m_projMat;
+  Mat4 m_totMat;
 
-  ID3D11Buffer* m_pConstBuffer;       // Used for passing values to shader(s).
+  RenderDevice *m_pDevice;            // Device the constant buffer came from.
+  RenderBuffer *m_pConstBuffer;       // Used for passing values to shader(s).
   VS_CONST_BUFFER m_vsConstData;
 
+  // Every draw's constants for a frame, uploaded once by flush() when the device can bind constant buffer ranges.
+  // Draw i uses the range at i * FRAME_CONST_STRIDE.
+  RenderBuffer *m_pFrameConstBuffer;
+  uint32_t m_frameConstCapacity;      // In draws.
+  std::vector<uint8_t> m_frameConstData;
+
+  typedef struct RenderItem_
+  {
+    uint64_t     sortKey;       // Pass, shader, texture, depth from the most to the least significant bits.
+    VisualModel *pModel;
+    Mat4         worldMat;
+  } RenderItem;
+
+  // This frame's renderModel() calls. Shaders and textures get small IDs for the sort keys, in the order they're
+  // first queued.
+  std::vector<RenderItem>                     m_queue;
+  std::unordered_map<const void*, uint32_t>   m_shaderIds;
+  std::unordered_map<const void*, uint32_t>   m_textureIds;
+
+  StateFilterRenderDevice m_stateFilter;
+  RenderQueueStats        m_frameStats;
+
+  Mat4 calcTotMatrix(const RenderItem &item, const Mat4 &viewProjMat);
+  bool uploadFrameConstants(RenderDevice *dev, const Mat4 &viewProjMat);
+
+  static uint32_t getSortId(std::unordered_map<const void*, uint32_t> &ids, const void *pResource, uint32_t maxId);
+
 public:
   GraphicsManager();
   ~GraphicsManager();
   void release();
-  void initConstBuffer(ID3D11Device *dev, ID3D11DeviceContext *devcon);
-  void setPosAndRot(Pos3 &position, Pos3 &rollYawPitch);
+  void initConstBuffer(RenderDevice *dev);
+  void setPosAndRot(const Pos3 &position, const Pos3 &rollYawPitch);
+  void setWorldMatrix(const Mat4 &worldMat);
+
+  // The world matrix setPosAndRot() would use.
+  static Mat4 calcWorldMatrix(const Pos3 &position, const Pos3 &pitchYawRoll);
+
+  // calcWorldMatrix for cnt objects at once, 4 at a time with SIMD. Gives the same results as calcWorldMatrix.
+  static void calcWorldMatrices(const Pos3 *pPositions, const Pos3 *pPitchYawRolls, Mat4 *pWorldMats, uint32_t cnt);
   void resetCamera();
-  void setCamera(Pos3 &eye, Pos3 &lookAt, Pos3 &up);
+  void setCamera(const Pos3 &eye, const Pos3 &lookAt, const Pos3 &up);
   void setPerspective(float fovy, float aspect, float nearDist, float farDist);
-  void renderModel(VisualModel *pModel, ID3D11Device *dev, ID3D11DeviceContext *devcon);
+
+  // Current camera's view * projection, ex. for culling (see FrustumCuller).
+  Mat4 getViewProjMatrix();
+
+  // Queues the model at the current world matrix (see setPosAndRot), to be drawn by the next flush().
+  void renderModel(VisualModel *pModel, RenderDevice *dev);
+
+  // Draws everything queued since the last flush, sorted by pass, shader, texture and then front to back, and with
+  // state that's already bound left alone. Once per frame, after the camera is set.
+  void flush(RenderDevice *dev);
+
+  // Counts for the last flush().
+  RenderQueueStats getFrameStats();
 };
 
 #endif
\ No newline at end of file
@@ -5,12 +5,14 @@
 
 // See http ://www.rastertek.com/dx11tut13.html for helpful background.
 
+#ifndef GAME_HEADLESS
 #define DIRECTINPUT_VERSION 0x0800
 
 #pragma comment(lib, "dinput8.lib")
 #pragma comment(lib, "dxguid.lib")
 
 #include <dinput.h>
+#endif
 
 // API to communicate with rest of the program.
 typedef struct InputApi_
@@ -31,6 +33,7 @@ typedef struct InputApi_
 
 } InputApi;
 
+#ifndef GAME_HEADLESS
 class InputMgr
 {
 private:
@@ -50,4 +53,6 @@ public:
   bool getUpdate(InputApi &inputUpdate);
 };
 
+#endif
+
 #endif
\ No newline at end of file
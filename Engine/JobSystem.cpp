@@ -0,0 +1,325 @@
+#include "JobSystem.h"
+#include "Logger.h"
+#include <algorithm>
+
+JobSystem::~JobSystem()
+{
+  stop();
+}
+
+
+bool JobSystem::start(uint32_t numWorkers)
+{
+  stop();
+
+  if (numWorkers == 0)
+  {
+    uint32_t hwThreads = std::thread::hardware_concurrency();
+    numWorkers = hwThreads > 1 ? hwThreads - 1 : 0;
+  }
+
+  m_bStop = false;
+  for (uint32_t i = 0; i < numWorkers; i++)
+  {
+    m_workers.push_back(std::thread(&JobSystem::workerMain, this));
+  }
+
+  LOGI("Job system started, %u workers", numWorkers);
+  return true;
+}
+
+
+void JobSystem::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bStop = true;
+  }
+  m_cv.notify_all();
+
+  for (size_t i = 0; i < m_workers.size(); i++)
+  {
+    m_workers[i].join();
+  }
+  m_workers.clear();
+  m_queue.clear();
+}
+
+
+uint32_t JobSystem::getNumWorkers()
+{
+  return static_cast<uint32_t>(m_workers.size());
+}
+
+
+void JobSystem::push(JobGraph *pGraph, JobId id)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    JobTask task = { pGraph, id };
+    m_queue.push_back(task);
+  }
+  m_cv.notify_one();
+}
+
+
+bool JobSystem::tryPop(JobTask &task)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_queue.empty())
+  {
+    return false;
+  }
+
+  task = m_queue.front();
+  m_queue.pop_front();
+  return true;
+}
+
+
+void JobSystem::workerMain()
+{
+  while (true)
+  {
+    JobTask task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [this]() { return m_bStop || !m_queue.empty(); });
+      if (m_bStop)
+      {
+        return;
+      }
+
+      task = m_queue.front();
+      m_queue.pop_front();
+    }
+
+    task.pGraph->execute(task.id);
+  }
+}
+
+
+JobId JobGraph::addJob(std::function<bool()> fn, bool bMainThread)
+{
+  Job job;
+  job.fn = fn;
+  job.bMainThread = bMainThread;
+  m_jobs.push_back(job);
+  return static_cast<JobId>(m_jobs.size() - 1);
+}
+
+
+bool JobGraph::addDependency(JobId job, JobId dependsOn)
+{
+  if (job >= m_jobs.size() || dependsOn >= m_jobs.size() || job == dependsOn)
+  {
+    LOGE("Bad job dependency %u -> %u", job, dependsOn);
+    return false;
+  }
+
+  m_jobs[dependsOn].dependents.push_back(job);
+  m_jobs[job].depCnt++;
+  return true;
+}
+
+
+void JobGraph::clear()
+{
+  m_jobs.clear();
+}
+
+
+uint32_t JobGraph::size()
+{
+  return static_cast<uint32_t>(m_jobs.size());
+}
+
+
+bool JobGraph::hasCycle()
+{
+  std::vector<uint32_t> remaining(m_jobs.size());
+  std::vector<JobId> ready;
+  for (size_t i = 0; i < m_jobs.size(); i++)
+  {
+    remaining[i] = m_jobs[i].depCnt;
+    if (remaining[i] == 0)
+    {
+      ready.push_back(static_cast<JobId>(i));
+    }
+  }
+
+  size_t visitedCnt = 0;
+  while (!ready.empty())
+  {
+    JobId id = ready.back();
+    ready.pop_back();
+    visitedCnt++;
+
+    const std::vector<JobId> &dependents = m_jobs[id].dependents;
+    for (size_t i = 0; i < dependents.size(); i++)
+    {
+      if (--remaining[dependents[i]] == 0)
+      {
+        ready.push_back(dependents[i]);
+      }
+    }
+  }
+
+  return visitedCnt != m_jobs.size();
+}
+
+
+// In order of addition, as far as dependencies allow, so serial runs are deterministic.
+bool JobGraph::runSerial()
+{
+  std::vector<uint32_t> remaining(m_jobs.size());
+  std::deque<JobId> ready;
+  for (size_t i = 0; i < m_jobs.size(); i++)
+  {
+    remaining[i] = m_jobs[i].depCnt;
+    if (remaining[i] == 0)
+    {
+      ready.push_back(static_cast<JobId>(i));
+    }
+  }
+
+  bool bSuccess = true;
+  while (!ready.empty())
+  {
+    JobId id = ready.front();
+    ready.pop_front();
+    bSuccess = bSuccess && m_jobs[id].fn();
+
+    const std::vector<JobId> &dependents = m_jobs[id].dependents;
+    for (size_t i = 0; i < dependents.size(); i++)
+    {
+      if (--remaining[dependents[i]] == 0)
+      {
+        ready.push_back(dependents[i]);
+      }
+    }
+  }
+
+  return bSuccess;
+}
+
+
+void JobGraph::dispatch(JobId id)
+{
+  if (m_jobs[id].bMainThread)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mainMutex);
+      m_mainQueue.push_back(id);
+    }
+    m_mainCv.notify_one();
+  }
+  else
+  {
+    m_pJobSystem->push(this, id);
+  }
+}
+
+
+void JobGraph::execute(JobId id)
+{
+  if (!m_bFailed.load(std::memory_order_relaxed) && !m_jobs[id].fn())
+  {
+    m_bFailed = true;
+  }
+  finish(id);
+}
+
+
+void JobGraph::finish(JobId id)
+{
+  const std::vector<JobId> &dependents = m_jobs[id].dependents;
+  for (size_t i = 0; i < dependents.size(); i++)
+  {
+    if (--m_remainingDeps[dependents[i]] == 0)
+    {
+      dispatch(dependents[i]);
+    }
+  }
+
+  // Under the lock, so the wakeup can't slip in between run()'s check and its wait, and so run() can't return (and
+  // the graph go away) while this thread is still notifying.
+  std::lock_guard<std::mutex> lock(m_mainMutex);
+  if (--m_pending == 0)
+  {
+    m_mainCv.notify_one();
+  }
+}
+
+
+bool JobGraph::run(JobSystem *pJobSystem)
+{
+  if (m_jobs.empty())
+  {
+    return true;
+  }
+
+  if (hasCycle())
+  {
+    LOGE("Job graph has a dependency cycle, not running it");
+    return false;
+  }
+
+  if (!pJobSystem || pJobSystem->getNumWorkers() == 0)
+  {
+    return runSerial();
+  }
+
+  m_pJobSystem = pJobSystem;
+  m_bFailed = false;
+  m_pending = static_cast<uint32_t>(m_jobs.size());
+  m_mainQueue.clear();
+  m_remainingDeps.reset(new std::atomic<uint32_t>[m_jobs.size()]);
+  for (size_t i = 0; i < m_jobs.size(); i++)
+  {
+    m_remainingDeps[i] = m_jobs[i].depCnt;
+  }
+
+  for (size_t i = 0; i < m_jobs.size(); i++)
+  {
+    if (m_jobs[i].depCnt == 0)
+    {
+      dispatch(static_cast<JobId>(i));
+    }
+  }
+
+  // Run main thread jobs as they become ready, and help out with worker jobs in between.
+  while (m_pending > 0)
+  {
+    JobId mainId = JOB_ID_INVALID;
+    {
+      std::lock_guard<std::mutex> lock(m_mainMutex);
+      if (!m_mainQueue.empty())
+      {
+        mainId = m_mainQueue.front();
+        m_mainQueue.pop_front();
+      }
+    }
+
+    if (mainId != JOB_ID_INVALID)
+    {
+      execute(mainId);
+      continue;
+    }
+
+    JobSystem::JobTask task;
+    if (pJobSystem->tryPop(task))
+    {
+      task.pGraph->execute(task.id);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mainMutex);
+    m_mainCv.wait(lock, [this]() { return m_pending == 0 || !m_mainQueue.empty(); });
+  }
+
+  // The last finish() may still hold the lock.
+  std::lock_guard<std::mutex> lock(m_mainMutex);
+  m_pJobSystem = NULL;
+  return !m_bFailed;
+}
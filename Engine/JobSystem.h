@@ -0,0 +1,102 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef uint32_t JobId;
+#define JOB_ID_INVALID  UINT32_MAX
+
+class JobGraph;
+
+// Worker threads that run JobGraph jobs. One instance is shared by everything that runs graphs, ex. GameMgr owns one
+// and hands it to scenes through SceneIo.
+class JobSystem
+{
+private:
+  typedef struct JobTask_
+  {
+    JobGraph *pGraph;
+    JobId     id;
+  } JobTask;
+
+  std::vector<std::thread> m_workers;
+  std::mutex               m_mutex;
+  std::condition_variable  m_cv;
+  std::deque<JobTask>      m_queue;
+  bool                     m_bStop{ false };
+
+  void workerMain();
+
+  friend class JobGraph;
+  void push(JobGraph *pGraph, JobId id);
+  bool tryPop(JobTask &task);
+
+public:
+  ~JobSystem();
+
+  // 0 workers picks one less than the hardware thread count, leaving a core for the main thread (which also runs
+  // jobs while it waits on a graph).
+  bool start(uint32_t numWorkers = 0);
+  void stop();
+
+  uint32_t getNumWorkers();
+};
+
+// A set of jobs and the dependencies between them, run once (or rebuilt and run every frame). A job only starts
+// once every job it depends on has finished, and jobs without a path between them may run at the same time on
+// different threads. Jobs marked bMainThread (ex. anything touching the D3D immediate context) only run on the thread
+// that called run().
+class JobGraph
+{
+private:
+  typedef struct Job_
+  {
+    std::function<bool()> fn;
+    bool                  bMainThread{ false };
+    std::vector<JobId>    dependents;
+    uint32_t              depCnt{ 0 };
+  } Job;
+
+  std::vector<Job> m_jobs;
+
+  // Run state.
+  std::unique_ptr<std::atomic<uint32_t>[]> m_remainingDeps;
+  std::atomic<uint32_t>   m_pending{ 0 };
+  std::atomic<bool>       m_bFailed{ false };
+  JobSystem              *m_pJobSystem{ NULL };
+  std::mutex              m_mainMutex;
+  std::condition_variable m_mainCv;
+  std::deque<JobId>       m_mainQueue;
+
+  bool hasCycle();
+  void dispatch(JobId id);
+  void finish(JobId id);
+  bool runSerial();
+
+  friend class JobSystem;
+  void execute(JobId id);
+
+public:
+  // fn returns false on failure. Once a job fails, jobs that haven't started yet are skipped.
+  JobId addJob(std::function<bool()> fn, bool bMainThread = false);
+
+  // job won't start until dependsOn has finished.
+  bool addDependency(JobId job, JobId dependsOn);
+
+  void clear();
+  uint32_t size();
+
+  // Runs every job and returns once they're all done. Without a JobSystem (or with no workers), jobs run in order on
+  // the calling thread. Returns false if any job failed, or if the dependencies have a cycle.
+  bool run(JobSystem *pJobSystem);
+};
+
+#endif
@@ -0,0 +1,711 @@
+#include "LevelStreamer.h"
+#include "CommonPhysConsts.h"
+#include "Logger.h"
+#include "VisualModel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+const uint32_t LevelStreamer::RESIDENT_CHUNK;
+const uint32_t LevelStreamer::UPDATE_BUDGET_US;
+
+LevelStreamer::IndexingObjectManager::IndexingObjectManager(LevelStreamer *pStreamer)
+{
+  m_pStreamer = pStreamer;
+}
+
+
+void LevelStreamer::IndexingObjectManager::addPlayer(const Pos3 &loc, RenderDevice *dev)
+{
+  LevelChunk &chunk = m_pStreamer->m_chunks[RESIDENT_CHUNK];
+  chunk.bHasPlayer = true;
+  chunk.playerLoc = loc;
+}
+
+
+void LevelStreamer::IndexingObjectManager::addBlock(
+  uint32_t id,
+  const Pos3 &loc,
+  const Pos3 &dim,
+  std::string &tex,
+  RenderDevice *dev)
+{
+  LevelBlockDesc desc;
+  desc.id   = id;
+  desc.loc  = loc;
+  desc.dim  = dim;
+  desc.tex  = tex;
+  m_pStreamer->addBlockToChunk(desc);
+}
+
+
+LevelStreamer::ChunkBuilder::ChunkBuilder(std::vector<std::pair<uint32_t, GameObject*>> &built) : m_built(built)
+{
+  setDeferGpuInit(true);
+}
+
+
+void LevelStreamer::ChunkBuilder::build(
+  RenderDevice *dev,
+  const std::vector<LevelBlockDesc> &blocks,
+  bool bHasPlayer,
+  const Pos3 &playerLoc)
+{
+  if (bHasPlayer)
+  {
+    addPlayer(playerLoc, dev);
+  }
+
+  for (auto it = blocks.begin(); it != blocks.end(); ++it)
+  {
+    std::string tex = it->tex;
+    addBlock(it->id, it->loc, it->dim, tex, dev);
+  }
+}
+
+
+void LevelStreamer::ChunkBuilder::addObject(uint32_t id, GameObject* pObj)
+{
+  m_built.push_back(std::make_pair(id, pObj));
+}
+
+
+LevelStreamer::LevelStreamer()
+{
+}
+
+
+LevelStreamer::~LevelStreamer()
+{
+  stop();
+}
+
+
+uint64_t LevelStreamer::cellKey(int32_t cellX, int32_t cellY)
+{
+  return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
+
+
+int32_t LevelStreamer::cellCoord(float val)
+{
+  return static_cast<int32_t>(std::floor(val / LEVEL_CHUNK_SIZE));
+}
+
+
+// Squared distance on the X/Y plane from pos to the closest point of the chunk's bounds.
+float LevelStreamer::dist2ToChunk(const Pos3 &pos, const LevelChunk &chunk)
+{
+  float dx = std::fmax(0.0f, std::fmax(chunk.boundsMin.pos.x - pos.pos.x, pos.pos.x - chunk.boundsMax.pos.x));
+  float dy = std::fmax(0.0f, std::fmax(chunk.boundsMin.pos.y - pos.pos.y, pos.pos.y - chunk.boundsMax.pos.y));
+  return dx * dx + dy * dy;
+}
+
+
+// Worker thread while indexing, main thread under m_mutex after.
+LevelChunk& LevelStreamer::chunkForCell(const Pos3 &loc)
+{
+  int32_t cellX = cellCoord(loc.pos.x);
+  int32_t cellY = cellCoord(loc.pos.y);
+  uint64_t key = cellKey(cellX, cellY);
+
+  auto it = m_cellChunks.find(key);
+  if (it != m_cellChunks.end())
+  {
+    return m_chunks[it->second];
+  }
+
+  m_cellChunks[key] = static_cast<uint32_t>(m_chunks.size());
+  m_chunks.push_back(LevelChunk());
+  m_chunks.back().cellX = cellX;
+  m_chunks.back().cellY = cellY;
+  return m_chunks.back();
+}
+
+
+// Same threading rules as chunkForCell().
+void LevelStreamer::addBlockToChunk(const LevelBlockDesc &desc)
+{
+  LevelChunk &chunk = chunkForCell(desc.loc);
+  Pos3 halfDim = desc.dim * 0.5f;
+
+  if (chunk.blocks.empty())
+  {
+    chunk.boundsMin = desc.loc - halfDim;
+    chunk.boundsMax = desc.loc + halfDim;
+  }
+  else
+  {
+    chunk.boundsMin = Pos3(
+      std::fmin(chunk.boundsMin.pos.x, desc.loc.pos.x - halfDim.pos.x),
+      std::fmin(chunk.boundsMin.pos.y, desc.loc.pos.y - halfDim.pos.y),
+      std::fmin(chunk.boundsMin.pos.z, desc.loc.pos.z - halfDim.pos.z));
+    chunk.boundsMax = Pos3(
+      std::fmax(chunk.boundsMax.pos.x, desc.loc.pos.x + halfDim.pos.x),
+      std::fmax(chunk.boundsMax.pos.y, desc.loc.pos.y + halfDim.pos.y),
+      std::fmax(chunk.boundsMax.pos.z, desc.loc.pos.z + halfDim.pos.z));
+  }
+
+  chunk.blocks.push_back(desc);
+  m_blockChunks[desc.id] = m_cellChunks[cellKey(chunk.cellX, chunk.cellY)];
+}
+
+
+void LevelStreamer::updateOverhang(const LevelChunk &chunk)
+{
+  if (chunk.bResident || chunk.blocks.empty())
+  {
+    return;
+  }
+
+  float cellMinX = chunk.cellX * LEVEL_CHUNK_SIZE;
+  float cellMinY = chunk.cellY * LEVEL_CHUNK_SIZE;
+  m_maxOverhang = std::fmax(m_maxOverhang, cellMinX - chunk.boundsMin.pos.x);
+  m_maxOverhang = std::fmax(m_maxOverhang, cellMinY - chunk.boundsMin.pos.y);
+  m_maxOverhang = std::fmax(m_maxOverhang, chunk.boundsMax.pos.x - (cellMinX + LEVEL_CHUNK_SIZE));
+  m_maxOverhang = std::fmax(m_maxOverhang, chunk.boundsMax.pos.y - (cellMinY + LEVEL_CHUNK_SIZE));
+}
+
+
+bool LevelStreamer::start(RenderDevice *dev, const std::string &filename, uint32_t idOffset)
+{
+  if (m_worker.joinable())
+  {
+    LOGE("Level streamer already running, can't start %s", filename.c_str());
+    return false;
+  }
+
+  m_pDevice = dev;
+  m_filename = filename;
+  m_idOffset = idOffset;
+
+  m_chunks.push_back(LevelChunk());
+  m_chunks[RESIDENT_CHUNK].bResident = true;
+
+  m_worker = std::thread(&LevelStreamer::workerMain, this);
+  return true;
+}
+
+
+void LevelStreamer::workerMain()
+{
+  LOGI("Indexing streamed level %s", m_filename.c_str());
+
+  IndexingObjectManager indexer(this);
+  indexer.generateFromFile(m_filename, NULL, m_idOffset);
+
+  for (auto it = m_chunks.begin(); it != m_chunks.end(); ++it)
+  {
+    updateOverhang(*it);
+  }
+
+  LOGI("Indexed %s into %u chunks", m_filename.c_str(), static_cast<uint32_t>(m_chunks.size() - 1));
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bIndexed = true;
+  }
+  m_mainCv.notify_all();
+
+  while (true)
+  {
+    // Chunk contents can be edited by a hot reload, so build from a copy.
+    uint32_t chunkIdx;
+    std::vector<LevelBlockDesc> blocks;
+    bool bHasPlayer;
+    Pos3 playerLoc;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_workerCv.wait(lock, [this] { return m_bStop || !m_requests.empty(); });
+      if (m_bStop)
+      {
+        break;
+      }
+
+      chunkIdx = m_requests.front();
+      m_requests.pop_front();
+
+      blocks = m_chunks[chunkIdx].blocks;
+      bHasPlayer = m_chunks[chunkIdx].bHasPlayer;
+      playerLoc = m_chunks[chunkIdx].playerLoc;
+    }
+
+    BuiltChunk built;
+    built.chunkIdx = chunkIdx;
+    ChunkBuilder builder(built.objs);
+    builder.build(m_pDevice, blocks, bHasPlayer, playerLoc);
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_built.push_back(std::move(built));
+    }
+    m_mainCv.notify_all();
+  }
+}
+
+
+void LevelStreamer::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bStop = true;
+  }
+  m_workerCv.notify_all();
+  m_mainCv.notify_all();
+
+  if (m_worker.joinable())
+  {
+    m_worker.join();
+  }
+
+  // Anything already in the target ObjectManager gets released along with it.
+  for (auto it = m_built.begin(); it != m_built.end(); ++it)
+  {
+    for (auto objIt = it->objs.begin(); objIt != it->objs.end(); ++objIt)
+    {
+      GameObject::releaseGameObject(objIt->second);
+      delete objIt->second;
+    }
+  }
+
+  m_built.clear();
+  m_requests.clear();
+  m_chunks.clear();
+  m_cellChunks.clear();
+  m_blockChunks.clear();
+  m_activeChunks.clear();
+  m_requiredChunks.clear();
+  m_maxOverhang = 0.0f;
+  m_bStop = false;
+  m_bIndexed = false;
+  m_bScanned = false;
+  m_bFocusSet = false;
+  m_stats = LevelStreamStats();
+}
+
+
+void LevelStreamer::setFocus(const Pos3 &focus)
+{
+  m_focus = focus;
+  m_bFocusSet = true;
+}
+
+
+void LevelStreamer::update(RenderDevice *dev, ObjectManager &target, LevelStreamWait wait)
+{
+  if (!m_bIndexed)
+  {
+    if (wait == LEVEL_STREAM_WAIT_NONE || !m_worker.joinable())
+    {
+      return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_mainCv.wait(lock, [this] { return m_bIndexed.load(); });
+  }
+
+  if (!m_bScanned)
+  {
+    if (!m_bFocusSet)
+    {
+      m_focus = m_chunks[RESIDENT_CHUNK].playerLoc;
+    }
+    m_stats.chunks = static_cast<uint32_t>(m_chunks.size() - 1);
+  }
+
+  // Chunk selection only changes when the focus moves to a new cell.
+  uint64_t focusCell = cellKey(cellCoord(m_focus.pos.x), cellCoord(m_focus.pos.y));
+  if (!m_bScanned || focusCell != m_focusCell)
+  {
+    m_focusCell = focusCell;
+    m_bScanned = true;
+    scan(target);
+  }
+
+  // Finish whatever the worker has ready.
+  auto startTime = std::chrono::steady_clock::now();
+  BuiltChunk built;
+  while (popBuilt(built))
+  {
+    finishChunk(built, dev, target);
+
+    auto elapsed = std::chrono::steady_clock::now() - startTime;
+    if (std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() >= UPDATE_BUDGET_US)
+    {
+      break;
+    }
+  }
+
+  while (!isWaitDone(wait) && waitForBuilt(built))
+  {
+    finishChunk(built, dev, target);
+  }
+}
+
+
+// Pick chunks to load/unload around the current focus. Only cells that can hold a chunk within
+// LEVEL_CHUNK_LOAD_DIST are visited, so the cost doesn't depend on the level size.
+void LevelStreamer::scan(ObjectManager &target)
+{
+  auto isUnloaded = [this](uint32_t idx) { return m_chunks[idx].state == LEVEL_CHUNK_UNLOADED; };
+  m_activeChunks.erase(std::remove_if(m_activeChunks.begin(), m_activeChunks.end(), isUnloaded), m_activeChunks.end());
+  m_requiredChunks.clear();
+
+  std::vector<std::pair<float, uint32_t>> requests;
+
+  LevelChunk &resident = m_chunks[RESIDENT_CHUNK];
+  if (resident.state == LEVEL_CHUNK_UNLOADED)
+  {
+    resident.state = LEVEL_CHUNK_LOADING;
+    requests.push_back(std::make_pair(0.0f, RESIDENT_CHUNK));
+    m_activeChunks.push_back(RESIDENT_CHUNK);
+  }
+  m_requiredChunks.push_back(RESIDENT_CHUNK);
+
+  int32_t focusX = cellCoord(m_focus.pos.x);
+  int32_t focusY = cellCoord(m_focus.pos.y);
+  int32_t radius = static_cast<int32_t>(std::ceil((LEVEL_CHUNK_LOAD_DIST + m_maxOverhang) / LEVEL_CHUNK_SIZE));
+
+  for (int32_t cellY = focusY - radius; cellY <= focusY + radius; cellY++)
+  {
+    for (int32_t cellX = focusX - radius; cellX <= focusX + radius; cellX++)
+    {
+      auto it = m_cellChunks.find(cellKey(cellX, cellY));
+      if (it == m_cellChunks.end())
+      {
+        continue;
+      }
+
+      LevelChunk &chunk = m_chunks[it->second];
+      float chunkDist2 = dist2ToChunk(m_focus, chunk);
+      if (chunkDist2 > LEVEL_CHUNK_LOAD_DIST * LEVEL_CHUNK_LOAD_DIST)
+      {
+        continue;
+      }
+
+      if (chunk.state == LEVEL_CHUNK_UNLOADED)
+      {
+        chunk.state = LEVEL_CHUNK_LOADING;
+        requests.push_back(std::make_pair(chunkDist2, it->second));
+        m_activeChunks.push_back(it->second);
+      }
+      else if (chunk.state == LEVEL_CHUNK_CANCELLED)
+      {
+        // Still queued or being built, so just keep it this time.
+        chunk.state = LEVEL_CHUNK_LOADING;
+      }
+
+      if (chunkDist2 <= LEVEL_CHUNK_REQUIRED_DIST * LEVEL_CHUNK_REQUIRED_DIST)
+      {
+        m_requiredChunks.push_back(it->second);
+      }
+    }
+  }
+
+  // Unload distance is a bit further than the load distance, so chunks don't thrash along a boundary.
+  for (auto it = m_activeChunks.begin(); it != m_activeChunks.end(); ++it)
+  {
+    LevelChunk &chunk = m_chunks[*it];
+    if (chunk.bResident || dist2ToChunk(m_focus, chunk) <= LEVEL_CHUNK_UNLOAD_DIST * LEVEL_CHUNK_UNLOAD_DIST)
+    {
+      continue;
+    }
+
+    if (chunk.state == LEVEL_CHUNK_LOADED)
+    {
+      unloadChunk(*it, target);
+    }
+    else if (chunk.state == LEVEL_CHUNK_LOADING)
+    {
+      chunk.state = LEVEL_CHUNK_CANCELLED;
+    }
+  }
+
+  m_activeChunks.erase(std::remove_if(m_activeChunks.begin(), m_activeChunks.end(), isUnloaded), m_activeChunks.end());
+
+  if (!requests.empty())
+  {
+    // Closest chunks first.
+    std::sort(requests.begin(), requests.end());
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (auto it = requests.begin(); it != requests.end(); ++it)
+      {
+        m_requests.push_back(it->second);
+      }
+    }
+    m_workerCv.notify_one();
+  }
+}
+
+
+void LevelStreamer::finishChunk(BuiltChunk &built, RenderDevice *dev, ObjectManager &target)
+{
+  LevelChunk &chunk = m_chunks[built.chunkIdx];
+
+  if (chunk.state == LEVEL_CHUNK_CANCELLED || chunk.bRebuild)
+  {
+    for (auto it = built.objs.begin(); it != built.objs.end(); ++it)
+    {
+      GameObject::releaseGameObject(it->second);
+      delete it->second;
+    }
+
+    if (chunk.state == LEVEL_CHUNK_CANCELLED)
+    {
+      chunk.state = LEVEL_CHUNK_UNLOADED;
+      chunk.bRebuild = false;
+      return;
+    }
+
+    // Edited while it was being built, so build it again from the current contents.
+    chunk.bRebuild = false;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_requests.push_front(built.chunkIdx);
+    }
+    m_workerCv.notify_one();
+    return;
+  }
+
+  for (auto it = built.objs.begin(); it != built.objs.end(); ++it)
+  {
+    if (!VisualModel::createVModelResources(it->second->getVModel(), dev))
+    {
+      LOGW("Failed to create GPU resources for obj [%u], continuing", it->first);
+    }
+
+    target.addObject(it->first, it->second);
+    chunk.loadedIds.push_back(it->first);
+  }
+
+  chunk.state = LEVEL_CHUNK_LOADED;
+  m_stats.loadedObjs += static_cast<uint32_t>(built.objs.size());
+  if (!chunk.bResident)
+  {
+    m_stats.loadedChunks++;
+    m_stats.chunkLoads++;
+  }
+}
+
+
+void LevelStreamer::requestRebuild(uint32_t chunkIdx)
+{
+  if (m_chunks[chunkIdx].state == LEVEL_CHUNK_LOADING)
+  {
+    m_chunks[chunkIdx].bRebuild = true;
+  }
+}
+
+
+bool LevelStreamer::applyDiff(const SceneDiff &diff, RenderDevice *dev, ObjectManager &target)
+{
+  if (!m_bIndexed)
+  {
+    LOGW("Level %s isn't indexed yet, dropping hot reload", m_filename.c_str());
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  // Moves within a chunk keep their object, moves to another chunk are a remove and an add.
+  std::vector<uint32_t> removed = diff.removed;
+  std::vector<LevelBlockDesc> added = diff.added;
+  for (auto it = diff.moved.begin(); it != diff.moved.end(); ++it)
+  {
+    auto chunkIt = m_blockChunks.find(it->id);
+    if (chunkIt == m_blockChunks.end())
+    {
+      added.push_back(*it);
+      continue;
+    }
+
+    LevelChunk &chunk = m_chunks[chunkIt->second];
+    if (cellCoord(it->loc.pos.x) != chunk.cellX || cellCoord(it->loc.pos.y) != chunk.cellY)
+    {
+      removed.push_back(it->id);
+      added.push_back(*it);
+      continue;
+    }
+
+    for (auto blockIt = chunk.blocks.begin(); blockIt != chunk.blocks.end(); ++blockIt)
+    {
+      if (blockIt->id == it->id)
+      {
+        blockIt->loc = it->loc;
+        break;
+      }
+    }
+
+    // Bounds only grow, they just have to cover the chunk's blocks.
+    Pos3 halfDim = it->dim * 0.5f;
+    chunk.boundsMin = Pos3(
+      std::fmin(chunk.boundsMin.pos.x, it->loc.pos.x - halfDim.pos.x),
+      std::fmin(chunk.boundsMin.pos.y, it->loc.pos.y - halfDim.pos.y),
+      std::fmin(chunk.boundsMin.pos.z, it->loc.pos.z - halfDim.pos.z));
+    chunk.boundsMax = Pos3(
+      std::fmax(chunk.boundsMax.pos.x, it->loc.pos.x + halfDim.pos.x),
+      std::fmax(chunk.boundsMax.pos.y, it->loc.pos.y + halfDim.pos.y),
+      std::fmax(chunk.boundsMax.pos.z, it->loc.pos.z + halfDim.pos.z));
+    updateOverhang(chunk);
+
+    if (chunk.state == LEVEL_CHUNK_LOADED)
+    {
+      target.setObjectPos(it->id, it->loc);
+    }
+    requestRebuild(chunkIt->second);
+  }
+
+  for (auto it = removed.begin(); it != removed.end(); ++it)
+  {
+    auto chunkIt = m_blockChunks.find(*it);
+    if (chunkIt == m_blockChunks.end())
+    {
+      continue;
+    }
+
+    LevelChunk &chunk = m_chunks[chunkIt->second];
+    for (size_t i = 0; i < chunk.blocks.size(); i++)
+    {
+      if (chunk.blocks[i].id == *it)
+      {
+        chunk.blocks[i] = chunk.blocks.back();
+        chunk.blocks.pop_back();
+        break;
+      }
+    }
+
+    auto loadedIt = std::find(chunk.loadedIds.begin(), chunk.loadedIds.end(), *it);
+    if (chunk.state == LEVEL_CHUNK_LOADED && loadedIt != chunk.loadedIds.end())
+    {
+      target.removeObject(*it);
+      chunk.loadedIds.erase(loadedIt);
+      m_stats.loadedObjs--;
+    }
+    requestRebuild(chunkIt->second);
+    m_blockChunks.erase(chunkIt);
+  }
+
+  for (auto it = added.begin(); it != added.end(); ++it)
+  {
+    addBlockToChunk(*it);
+    uint32_t chunkIdx = m_blockChunks[it->id];
+    LevelChunk &chunk = m_chunks[chunkIdx];
+    updateOverhang(chunk);
+
+    if (chunk.state == LEVEL_CHUNK_LOADED)
+    {
+      std::string tex = it->tex;
+      target.addBlock(it->id, it->loc, it->dim, tex, dev);
+      chunk.loadedIds.push_back(it->id);
+      m_stats.loadedObjs++;
+    }
+    requestRebuild(chunkIdx);
+  }
+
+  // New chunks may be within range, so pick chunks again on the next update.
+  m_stats.chunks = static_cast<uint32_t>(m_chunks.size() - 1);
+  m_bScanned = false;
+  return true;
+}
+
+
+void LevelStreamer::unloadChunk(uint32_t chunkIdx, ObjectManager &target)
+{
+  LevelChunk &chunk = m_chunks[chunkIdx];
+  for (auto it = chunk.loadedIds.begin(); it != chunk.loadedIds.end(); ++it)
+  {
+    target.removeObject(*it);
+  }
+
+  m_stats.loadedChunks--;
+  m_stats.loadedObjs -= static_cast<uint32_t>(chunk.loadedIds.size());
+  m_stats.chunkUnloads++;
+
+  chunk.loadedIds.clear();
+  chunk.state = LEVEL_CHUNK_UNLOADED;
+}
+
+
+bool LevelStreamer::popBuilt(BuiltChunk &built)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_built.empty())
+  {
+    return false;
+  }
+
+  built = std::move(m_built.front());
+  m_built.pop_front();
+  return true;
+}
+
+
+bool LevelStreamer::waitForBuilt(BuiltChunk &built)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_mainCv.wait(lock, [this] { return m_bStop || !m_built.empty(); });
+  if (m_built.empty())
+  {
+    return false;
+  }
+
+  built = std::move(m_built.front());
+  m_built.pop_front();
+  return true;
+}
+
+
+bool LevelStreamer::isWaitDone(LevelStreamWait wait)
+{
+  switch (wait)
+  {
+    case LEVEL_STREAM_WAIT_REQUIRED:
+    {
+      for (auto it = m_requiredChunks.begin(); it != m_requiredChunks.end(); ++it)
+      {
+        if (m_chunks[*it].state != LEVEL_CHUNK_LOADED)
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+    case LEVEL_STREAM_WAIT_ALL:
+    {
+      for (auto it = m_activeChunks.begin(); it != m_activeChunks.end(); ++it)
+      {
+        if (m_chunks[*it].state == LEVEL_CHUNK_LOADING || m_chunks[*it].state == LEVEL_CHUNK_CANCELLED)
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+    default:
+    {
+      return true;
+    }
+  }
+
+  return true;
+}
+
+
+bool LevelStreamer::isReady()
+{
+  return m_bIndexed && m_bScanned && isWaitDone(LEVEL_STREAM_WAIT_REQUIRED);
+}
+
+
+bool LevelStreamer::isFailed()
+{
+  // Nothing to stream, ex. a missing scene file.
+  return m_bIndexed && m_chunks.size() <= 1 && !m_chunks[RESIDENT_CHUNK].bHasPlayer;
+}
+
+
+const LevelStreamStats& LevelStreamer::getStats()
+{
+  return m_stats;
+}
@@ -0,0 +1,196 @@
+#ifndef LEVEL_STREAMER_H
+#define LEVEL_STREAMER_H
+
+#include "ObjectManager.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+typedef enum LevelChunkState_
+{
+  LEVEL_CHUNK_UNLOADED = 0,
+  LEVEL_CHUNK_LOADING,      // Requested from the worker.
+  LEVEL_CHUNK_LOADED,       // Objects are in the target ObjectManager.
+  LEVEL_CHUNK_CANCELLED     // Went out of range while loading, objects are dropped when the worker hands them back.
+} LevelChunkState;
+
+// How long LevelStreamer::update() is allowed to wait on the worker.
+typedef enum LevelStreamWait_
+{
+  LEVEL_STREAM_WAIT_NONE = 0,   // Never block, ex. while another scene is still running.
+  LEVEL_STREAM_WAIT_REQUIRED,   // Block until chunks within LEVEL_CHUNK_REQUIRED_DIST are loaded.
+  LEVEL_STREAM_WAIT_ALL         // Block until every chunk within LEVEL_CHUNK_LOAD_DIST is loaded.
+} LevelStreamWait;
+
+typedef struct LevelBlockDesc_
+{
+  uint32_t    id;
+  Pos3        loc;
+  Pos3        dim;
+  std::string tex;
+} LevelBlockDesc;
+
+// Block level changes between two versions of a scene file, in terms of live object IDs (see SceneHotReload.h).
+typedef struct SceneDiff_
+{
+  std::vector<uint32_t>       removed;
+  std::vector<LevelBlockDesc> added;    // IDs are newly assigned, not taken from the file.
+  std::vector<LevelBlockDesc> moved;    // Same size and texture, new location.
+
+  bool empty() const
+  {
+    return removed.empty() && added.empty() && moved.empty();
+  }
+} SceneDiff;
+
+typedef struct LevelChunk_
+{
+  int32_t cellX{ 0 };
+  int32_t cellY{ 0 };
+  Pos3 boundsMin;   // Union of the chunk's object boxes, can reach past the chunk's cell.
+  Pos3 boundsMax;
+  bool bResident{ false };    // Always loaded, ex. the player.
+  bool bHasPlayer{ false };
+  Pos3 playerLoc;
+  std::vector<LevelBlockDesc> blocks;
+
+  // Main thread only.
+  LevelChunkState state{ LEVEL_CHUNK_UNLOADED };
+  std::vector<uint32_t> loadedIds;
+  bool bRebuild{ false };     // Edited while loading, the worker's objects are out of date.
+} LevelChunk;
+
+typedef struct LevelStreamStats_
+{
+  uint32_t chunks{ 0 };
+  uint32_t loadedChunks{ 0 };
+  uint32_t loadedObjs{ 0 };
+  uint64_t chunkLoads{ 0 };
+  uint64_t chunkUnloads{ 0 };
+} LevelStreamStats;
+
+// Splits a scene into chunks on the X/Y plane and keeps only the chunks around a focus point (the player) loaded.
+// A worker thread indexes the scene file and builds chunk objects with GPU init deferred. update() runs on the main
+// thread: it picks chunks to load/unload when the focus moves to a new cell, then finishes built chunks (GPU
+// resources) and adds/removes their objects from the target ObjectManager.
+class LevelStreamer
+{
+private:
+  static const uint32_t RESIDENT_CHUNK = 0;
+
+  // Main thread time spent finishing built chunks per update() call, on top of any required waits.
+  static const uint32_t UPDATE_BUDGET_US = 4000;
+
+  // Records the scene's objects into chunks instead of creating them.
+  class IndexingObjectManager : public ObjectManager
+  {
+  private:
+    LevelStreamer *m_pStreamer;
+
+  public:
+    IndexingObjectManager(LevelStreamer *pStreamer);
+    void addPlayer(const Pos3 &loc, RenderDevice *dev);
+    void addBlock(
+      uint32_t id,
+      const Pos3 &loc,
+      const Pos3 &dim,
+      std::string &tex,
+      RenderDevice *dev);
+  };
+
+  // Builds one chunk's objects on the worker thread.
+  class ChunkBuilder : public ObjectManager
+  {
+  private:
+    std::vector<std::pair<uint32_t, GameObject*>> &m_built;
+
+  public:
+    ChunkBuilder(std::vector<std::pair<uint32_t, GameObject*>> &built);
+    void build(
+      RenderDevice *dev,
+      const std::vector<LevelBlockDesc> &blocks,
+      bool bHasPlayer,
+      const Pos3 &playerLoc);
+    void addObject(uint32_t id, GameObject* pObj);
+  };
+
+  typedef struct BuiltChunk_
+  {
+    uint32_t chunkIdx;
+    std::vector<std::pair<uint32_t, GameObject*>> objs;
+  } BuiltChunk;
+
+  RenderDevice *m_pDevice{ NULL };    // Chunks are built off the main thread, only its shader compiler is used there.
+  std::string   m_filename;
+  uint32_t      m_idOffset{ 0 };
+
+  // Written by the worker until m_bIndexed is set. After that, only the main thread writes them, and only under
+  // m_mutex (see applyDiff), the worker reads chunk contents under m_mutex.
+  std::vector<LevelChunk> m_chunks;
+  std::map<uint64_t, uint32_t> m_cellChunks;
+  std::unordered_map<uint32_t, uint32_t> m_blockChunks;   // Block ID -> chunk.
+  float m_maxOverhang{ 0.0f };  // Furthest any chunk's bounds reach past its cell.
+
+  std::thread             m_worker;
+  std::mutex              m_mutex;
+  std::condition_variable m_workerCv;
+  std::condition_variable m_mainCv;
+  std::deque<uint32_t>    m_requests;
+  std::deque<BuiltChunk>  m_built;
+  bool                    m_bStop{ false };
+  std::atomic<bool>       m_bIndexed{ false };
+
+  // Main thread state.
+  Pos3      m_focus;
+  bool      m_bFocusSet{ false };
+  bool      m_bScanned{ false };
+  uint64_t  m_focusCell{ 0 };
+  std::vector<uint32_t> m_activeChunks;     // Chunks not in LEVEL_CHUNK_UNLOADED.
+  std::vector<uint32_t> m_requiredChunks;
+  LevelStreamStats m_stats;
+
+  static uint64_t cellKey(int32_t cellX, int32_t cellY);
+  static int32_t cellCoord(float val);
+  static float dist2ToChunk(const Pos3 &pos, const LevelChunk &chunk);
+
+  LevelChunk& chunkForCell(const Pos3 &loc);
+  void addBlockToChunk(const LevelBlockDesc &desc);
+  void updateOverhang(const LevelChunk &chunk);
+  void requestRebuild(uint32_t chunkIdx);
+  void workerMain();
+  void scan(ObjectManager &target);
+  void finishChunk(BuiltChunk &built, RenderDevice *dev, ObjectManager &target);
+  void unloadChunk(uint32_t chunkIdx, ObjectManager &target);
+  bool waitForBuilt(BuiltChunk &built);
+  bool popBuilt(BuiltChunk &built);
+  bool isWaitDone(LevelStreamWait wait);
+
+public:
+  LevelStreamer();
+  ~LevelStreamer();
+
+  bool start(RenderDevice *dev, const std::string &filename, uint32_t idOffset);
+  void stop();
+
+  // Defaults to the player's start location once the scene is indexed.
+  void setFocus(const Pos3 &focus);
+
+  void update(RenderDevice *dev, ObjectManager &target, LevelStreamWait wait);
+
+  // Applies a hot reload to the chunk index, and to the objects of any loaded chunks. No-op before indexing is done.
+  bool applyDiff(const SceneDiff &diff, RenderDevice *dev, ObjectManager &target);
+
+  // Ready once the resident objects and all required chunks are loaded.
+  bool isReady();
+  bool isFailed();
+  const LevelStreamStats& getStats();
+};
+
+#endif
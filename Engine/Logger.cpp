@@ -5,7 +5,11 @@ Logger gLogger;
 
 void Logger::init()
 {
+#ifdef _WIN32
   fopen_s(&m_fs, LOG_FILENAME, "w+");
+#else
+  m_fs = fopen(LOG_FILENAME, "w+");
+#endif
   m_bActive = true;
   print(LOG_LEVEL_INFO, "Log init, lvl %d\n", LOG_LEVEL);
 }
@@ -15,14 +19,18 @@ void Logger::close()
 {
   print(LOG_LEVEL_INFO, "Log complete\n");
   m_bActive = false;
-  fclose(m_fs);
+  if (m_fs)
+  {
+    fclose(m_fs);
+  }
 }
 
 
 void Logger::print(LogLevel lvl, const char* s, ...)
 {
-  if (m_bActive && lvl >= LOG_LEVEL)
+  if (m_bActive && m_fs && lvl >= LOG_LEVEL)
   {
+    std::lock_guard<std::mutex> lock(m_mutex);
     va_list argptr;
     va_start(argptr, s);
     vfprintf(m_fs, s, argptr);
@@ -1,9 +1,11 @@
 #ifndef DX_GAME_LOGGING_H
 #define DX_GAME_LOGGING_H
 
+#include <stdio.h>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <mutex>
 
 #define LOG_LEVEL LOG_LEVEL_DEBUG
 #define LOG_FILENAME "Logs/log.txt"
@@ -17,16 +19,17 @@ typedef enum LogLevel_
   LOG_LEVEL_NONE
 } LogLevel;
 
-#define LOGD(fstr, ...) gLogger.print(LOG_LEVEL_DEBUG, "<D:%s:%d> " fstr "\n", __FILE__, __LINE__, __VA_ARGS__)
-#define LOGI(fstr, ...) gLogger.print(LOG_LEVEL_INFO, "<I:%s:%d> " fstr "\n", __FILE__, __LINE__, __VA_ARGS__)
-#define LOGW(fstr, ...) gLogger.print(LOG_LEVEL_WARNING, "<W:%s:%d> " fstr "\n", __FILE__, __LINE__, __VA_ARGS__)
-#define LOGE(fstr, ...) gLogger.print(LOG_LEVEL_ERROR, "<E:%s:%d> " fstr "\n", __FILE__, __LINE__, __VA_ARGS__)
+#define LOGD(fstr, ...) gLogger.print(LOG_LEVEL_DEBUG, "<D:%s:%d> " fstr "\n", __FILE__, __LINE__, ##__VA_ARGS__)
+#define LOGI(fstr, ...) gLogger.print(LOG_LEVEL_INFO, "<I:%s:%d> " fstr "\n", __FILE__, __LINE__, ##__VA_ARGS__)
+#define LOGW(fstr, ...) gLogger.print(LOG_LEVEL_WARNING, "<W:%s:%d> " fstr "\n", __FILE__, __LINE__, ##__VA_ARGS__)
+#define LOGE(fstr, ...) gLogger.print(LOG_LEVEL_ERROR, "<E:%s:%d> " fstr "\n", __FILE__, __LINE__, ##__VA_ARGS__)
 
 class Logger
 {
 private:
   bool m_bActive;
   FILE * m_fs;
+  std::mutex m_mutex;  // Background scene loads log from their worker thread.
 
 public:
   void init();
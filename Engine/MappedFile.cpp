@@ -0,0 +1,137 @@
+#include "MappedFile.h"
+#include "Logger.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+  m_pData = NULL;
+  m_size = 0;
+#ifdef _WIN32
+  m_hFile = INVALID_HANDLE_VALUE;
+  m_hMapping = NULL;
+#else
+  m_fd = -1;
+#endif
+}
+
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+
+bool MappedFile::open(const std::string &filename)
+{
+  close();
+
+#ifdef _WIN32
+  m_hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (m_hFile == INVALID_HANDLE_VALUE)
+  {
+    LOGE("Failed to open file for mapping: %s", filename.c_str());
+    return false;
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(m_hFile, &fileSize) || fileSize.QuadPart == 0)
+  {
+    LOGE("Can't map empty or unreadable file: %s", filename.c_str());
+    close();
+    return false;
+  }
+  m_size = static_cast<size_t>(fileSize.QuadPart);
+
+  m_hMapping = CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (!m_hMapping)
+  {
+    LOGE("CreateFileMapping failed: %s", filename.c_str());
+    close();
+    return false;
+  }
+
+  m_pData = static_cast<const uint8_t*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+#else
+  m_fd = ::open(filename.c_str(), O_RDONLY);
+  if (m_fd < 0)
+  {
+    LOGE("Failed to open file for mapping: %s", filename.c_str());
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(m_fd, &st) != 0 || st.st_size == 0)
+  {
+    LOGE("Can't map empty or unreadable file: %s", filename.c_str());
+    close();
+    return false;
+  }
+  m_size = static_cast<size_t>(st.st_size);
+
+  void *pMap = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+  m_pData = (pMap == MAP_FAILED) ? NULL : static_cast<const uint8_t*>(pMap);
+#endif
+
+  if (!m_pData)
+  {
+    LOGE("Failed to map file: %s", filename.c_str());
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+  if (m_pData)
+  {
+    UnmapViewOfFile(m_pData);
+  }
+  if (m_hMapping)
+  {
+    CloseHandle(m_hMapping);
+  }
+  if (m_hFile != INVALID_HANDLE_VALUE)
+  {
+    CloseHandle(m_hFile);
+  }
+  m_hMapping = NULL;
+  m_hFile = INVALID_HANDLE_VALUE;
+#else
+  if (m_pData)
+  {
+    munmap(const_cast<uint8_t*>(m_pData), m_size);
+  }
+  if (m_fd >= 0)
+  {
+    ::close(m_fd);
+  }
+  m_fd = -1;
+#endif
+
+  m_pData = NULL;
+  m_size = 0;
+}
+
+
+const uint8_t* MappedFile::data() const
+{
+  return m_pData;
+}
+
+
+size_t MappedFile::size() const
+{
+  return m_size;
+}
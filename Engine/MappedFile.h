@@ -0,0 +1,33 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+// Read-only memory mapping of a whole file. The mapping stays valid until close() (or destruction).
+class MappedFile
+{
+private:
+  const uint8_t  *m_pData;
+  size_t          m_size;
+
+#ifdef _WIN32
+  void           *m_hFile;
+  void           *m_hMapping;
+#else
+  int             m_fd;
+#endif
+
+public:
+  MappedFile();
+  ~MappedFile();
+
+  bool open(const std::string &filename);
+  void close();
+
+  const uint8_t* data() const;
+  size_t size() const;
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef MATH_SIMD_H
+#define MATH_SIMD_H
+
+// 4-wide float SIMD wrapper used by the math library's hot paths (matrix multiply, batch transforms).
+// Backend is picked at compile time: SSE on x86/x64, NEON on ARM, plain scalar code otherwise.
+// Define GAME_MATH_NO_SIMD to force the scalar backend, ex. when checking results against it.
+
+#if !defined(GAME_MATH_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define GAME_MATH_SSE 1
+#include <xmmintrin.h>
+#elif !defined(GAME_MATH_NO_SIMD) && (defined(__ARM_NEON) || defined(_M_ARM64))
+#define GAME_MATH_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(GAME_MATH_SSE)
+
+typedef __m128 SimdFloat4;
+
+inline SimdFloat4 simdLoad(const float *p)                              { return _mm_loadu_ps(p); }
+inline void       simdStore(float *p, SimdFloat4 a)                     { _mm_storeu_ps(p, a); }
+inline SimdFloat4 simdSplat(float f)                                    { return _mm_set1_ps(f); }
+inline SimdFloat4 simdSet(float x, float y, float z, float w)           { return _mm_setr_ps(x, y, z, w); }
+inline SimdFloat4 simdAdd(SimdFloat4 a, SimdFloat4 b)                   { return _mm_add_ps(a, b); }
+inline SimdFloat4 simdSub(SimdFloat4 a, SimdFloat4 b)                   { return _mm_sub_ps(a, b); }
+inline SimdFloat4 simdMul(SimdFloat4 a, SimdFloat4 b)                   { return _mm_mul_ps(a, b); }
+inline SimdFloat4 simdMin(SimdFloat4 a, SimdFloat4 b)                   { return _mm_min_ps(a, b); }
+inline SimdFloat4 simdMax(SimdFloat4 a, SimdFloat4 b)                   { return _mm_max_ps(a, b); }
+inline SimdFloat4 simdMulAdd(SimdFloat4 a, SimdFloat4 b, SimdFloat4 c)  { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+// Bit i set where a[i] < b[i].
+inline int        simdLessMask(SimdFloat4 a, SimdFloat4 b)              { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+
+#elif defined(GAME_MATH_NEON)
+
+typedef float32x4_t SimdFloat4;
+
+inline SimdFloat4 simdLoad(const float *p)                              { return vld1q_f32(p); }
+inline void       simdStore(float *p, SimdFloat4 a)                     { vst1q_f32(p, a); }
+inline SimdFloat4 simdSplat(float f)                                    { return vdupq_n_f32(f); }
+inline SimdFloat4 simdSet(float x, float y, float z, float w)
+{
+  float v[4] = { x, y, z, w };
+  return vld1q_f32(v);
+}
+inline SimdFloat4 simdAdd(SimdFloat4 a, SimdFloat4 b)                   { return vaddq_f32(a, b); }
+inline SimdFloat4 simdSub(SimdFloat4 a, SimdFloat4 b)                   { return vsubq_f32(a, b); }
+inline SimdFloat4 simdMul(SimdFloat4 a, SimdFloat4 b)                   { return vmulq_f32(a, b); }
+inline SimdFloat4 simdMin(SimdFloat4 a, SimdFloat4 b)                   { return vminq_f32(a, b); }
+inline SimdFloat4 simdMax(SimdFloat4 a, SimdFloat4 b)                   { return vmaxq_f32(a, b); }
+// Keep mul + add separate (no fused vmlaq/vfmaq) so results match the SSE and scalar backends bit for bit.
+inline SimdFloat4 simdMulAdd(SimdFloat4 a, SimdFloat4 b, SimdFloat4 c)  { return vaddq_f32(vmulq_f32(a, b), c); }
+// Bit i set where a[i] < b[i].
+inline int simdLessMask(SimdFloat4 a, SimdFloat4 b)
+{
+  static const uint32_t laneBits[4] = { 1, 2, 4, 8 };
+  uint32x4_t bits = vandq_u32(vcltq_f32(a, b), vld1q_u32(laneBits));
+  return static_cast<int>(vgetq_lane_u32(bits, 0) | vgetq_lane_u32(bits, 1) |
+    vgetq_lane_u32(bits, 2) | vgetq_lane_u32(bits, 3));
+}
+
+#else
+
+typedef struct SimdFloat4_
+{
+  float v[4];
+} SimdFloat4;
+
+inline SimdFloat4 simdLoad(const float *p)
+{
+  SimdFloat4 r = { { p[0], p[1], p[2], p[3] } };
+  return r;
+}
+inline void simdStore(float *p, SimdFloat4 a)
+{
+  p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3];
+}
+inline SimdFloat4 simdSplat(float f)
+{
+  SimdFloat4 r = { { f, f, f, f } };
+  return r;
+}
+inline SimdFloat4 simdSet(float x, float y, float z, float w)
+{
+  SimdFloat4 r = { { x, y, z, w } };
+  return r;
+}
+inline SimdFloat4 simdAdd(SimdFloat4 a, SimdFloat4 b)
+{
+  SimdFloat4 r = { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } };
+  return r;
+}
+inline SimdFloat4 simdSub(SimdFloat4 a, SimdFloat4 b)
+{
+  SimdFloat4 r = { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } };
+  return r;
+}
+inline SimdFloat4 simdMul(SimdFloat4 a, SimdFloat4 b)
+{
+  SimdFloat4 r = { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } };
+  return r;
+}
+inline SimdFloat4 simdMin(SimdFloat4 a, SimdFloat4 b)
+{
+  SimdFloat4 r = { {
+    a.v[0] < b.v[0] ? a.v[0] : b.v[0],
+    a.v[1] < b.v[1] ? a.v[1] : b.v[1],
+    a.v[2] < b.v[2] ? a.v[2] : b.v[2],
+    a.v[3] < b.v[3] ? a.v[3] : b.v[3] } };
+  return r;
+}
+inline SimdFloat4 simdMax(SimdFloat4 a, SimdFloat4 b)
+{
+  SimdFloat4 r = { {
+    a.v[0] > b.v[0] ? a.v[0] : b.v[0],
+    a.v[1] > b.v[1] ? a.v[1] : b.v[1],
+    a.v[2] > b.v[2] ? a.v[2] : b.v[2],
+    a.v[3] > b.v[3] ? a.v[3] : b.v[3] } };
+  return r;
+}
+inline SimdFloat4 simdMulAdd(SimdFloat4 a, SimdFloat4 b, SimdFloat4 c)
+{
+  return simdAdd(simdMul(a, b), c);
+}
+inline int simdLessMask(SimdFloat4 a, SimdFloat4 b)
+{
+  return (a.v[0] < b.v[0] ? 1 : 0) | (a.v[1] < b.v[1] ? 2 : 0) | (a.v[2] < b.v[2] ? 4 : 0) | (a.v[3] < b.v[3] ? 8 : 0);
+}
+
+#endif
+
+#endif
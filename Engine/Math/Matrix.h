@@ -0,0 +1,214 @@
+#ifndef MATH_MATRIX_H
+#define MATH_MATRIX_H
+
+#include "MathSimd.h"
+#include "Vector.h"
+#include <math.h>
+#include <stddef.h>
+
+// 4x4 float matrix with the same conventions as D3DXMATRIX: row-major storage, row vectors (v * M),
+// translation in the last row, right-handed helpers. A Mat4 can be memcpy'd into a constant buffer
+// wherever a D3DXMATRIX was before.
+
+typedef struct Mat4_
+{
+  float m[4][4];
+
+  constexpr Mat4_()
+    : m{ { 0.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 0.0f } }
+  {
+  }
+
+  constexpr Mat4_(
+    float m00, float m01, float m02, float m03,
+    float m10, float m11, float m12, float m13,
+    float m20, float m21, float m22, float m23,
+    float m30, float m31, float m32, float m33)
+    : m{ { m00, m01, m02, m03 }, { m10, m11, m12, m13 }, { m20, m21, m22, m23 }, { m30, m31, m32, m33 } }
+  {
+  }
+
+} Mat4;
+
+static_assert(sizeof(Mat4) == 16 * sizeof(float), "Mat4 must match D3DXMATRIX layout");
+
+
+constexpr Mat4 matrixIdentity()
+{
+  return Mat4(
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+constexpr Mat4 matrixTranslation(float x, float y, float z)
+{
+  return Mat4(
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    x,    y,    z,    1.0f);
+}
+
+constexpr Mat4 matrixScaling(float x, float y, float z)
+{
+  return Mat4(
+    x,    0.0f, 0.0f, 0.0f,
+    0.0f, y,    0.0f, 0.0f,
+    0.0f, 0.0f, z,    0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+constexpr Mat4 matrixTranspose(const Mat4 &a)
+{
+  return Mat4(
+    a.m[0][0], a.m[1][0], a.m[2][0], a.m[3][0],
+    a.m[0][1], a.m[1][1], a.m[2][1], a.m[3][1],
+    a.m[0][2], a.m[1][2], a.m[2][2], a.m[3][2],
+    a.m[0][3], a.m[1][3], a.m[2][3], a.m[3][3]);
+}
+
+inline Mat4 matrixRotationX(float angle)
+{
+  float c = cosf(angle);
+  float s = sinf(angle);
+  return Mat4(
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, c,    s,    0.0f,
+    0.0f, -s,   c,    0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+inline Mat4 matrixRotationY(float angle)
+{
+  float c = cosf(angle);
+  float s = sinf(angle);
+  return Mat4(
+    c,    0.0f, -s,   0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    s,    0.0f, c,    0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+inline Mat4 matrixRotationZ(float angle)
+{
+  float c = cosf(angle);
+  float s = sinf(angle);
+  return Mat4(
+    c,    s,    0.0f, 0.0f,
+    -s,   c,    0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+// Returns a * b, ie. apply a first, then b (same as D3DXMatrixMultiply(&out, &a, &b)).
+// Each output row is a linear combination of b's rows, which maps onto 4-wide mul/add.
+inline Mat4 matrixMultiply(const Mat4 &a, const Mat4 &b)
+{
+  Mat4 out;
+  SimdFloat4 b0 = simdLoad(b.m[0]);
+  SimdFloat4 b1 = simdLoad(b.m[1]);
+  SimdFloat4 b2 = simdLoad(b.m[2]);
+  SimdFloat4 b3 = simdLoad(b.m[3]);
+
+  for (int row = 0; row < 4; row++)
+  {
+    SimdFloat4 r = simdMul(simdSplat(a.m[row][0]), b0);
+    r = simdMulAdd(simdSplat(a.m[row][1]), b1, r);
+    r = simdMulAdd(simdSplat(a.m[row][2]), b2, r);
+    r = simdMulAdd(simdSplat(a.m[row][3]), b3, r);
+    simdStore(out.m[row], r);
+  }
+
+  return out;
+}
+
+// Right-handed view matrix, same as D3DXMatrixLookAtRH.
+inline Mat4 matrixLookAtRH(const Vec3 &eye, const Vec3 &at, const Vec3 &up)
+{
+  Vec3 zAxis = vec3Normalize(eye - at);
+  Vec3 xAxis = vec3Normalize(vec3Cross(up, zAxis));
+  Vec3 yAxis = vec3Cross(zAxis, xAxis);
+
+  return Mat4(
+    xAxis.x,                yAxis.x,                zAxis.x,                0.0f,
+    xAxis.y,                yAxis.y,                zAxis.y,                0.0f,
+    xAxis.z,                yAxis.z,                zAxis.z,                0.0f,
+    -vec3Dot(xAxis, eye),   -vec3Dot(yAxis, eye),   -vec3Dot(zAxis, eye),   1.0f);
+}
+
+// Right-handed perspective projection, same as D3DXMatrixPerspectiveFovRH.
+inline Mat4 matrixPerspectiveFovRH(float fovy, float aspect, float nearDist, float farDist)
+{
+  float yScale = 1.0f / tanf(fovy / 2.0f);
+  float xScale = yScale / aspect;
+  float depth = nearDist - farDist;
+
+  return Mat4(
+    xScale, 0.0f,   0.0f,                           0.0f,
+    0.0f,   yScale, 0.0f,                           0.0f,
+    0.0f,   0.0f,   farDist / depth,                -1.0f,
+    0.0f,   0.0f,   nearDist * farDist / depth,     0.0f);
+}
+
+// (v, 1) * m, same as D3DXVec3Transform.
+inline Vec4 vec3Transform(const Vec3 &v, const Mat4 &m)
+{
+  Vec4 out;
+  SimdFloat4 r = simdLoad(m.m[3]);
+  r = simdMulAdd(simdSplat(v.x), simdLoad(m.m[0]), r);
+  r = simdMulAdd(simdSplat(v.y), simdLoad(m.m[1]), r);
+  r = simdMulAdd(simdSplat(v.z), simdLoad(m.m[2]), r);
+  simdStore(&out.x, r);
+  return out;
+}
+
+// (v, 1) * m projected back to w = 1, same as D3DXVec3TransformCoord.
+inline Vec3 vec3TransformCoord(const Vec3 &v, const Mat4 &m)
+{
+  Vec4 r = vec3Transform(v, m);
+  float invW = r.w != 0.0f ? 1.0f / r.w : 0.0f;
+  return Vec3(r.x * invW, r.y * invW, r.z * invW);
+}
+
+// (v, 0) * m, ie. rotation/scale only, same as D3DXVec3TransformNormal.
+inline Vec3 vec3TransformNormal(const Vec3 &v, const Mat4 &m)
+{
+  return Vec3(
+    v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0],
+    v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1],
+    v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2]);
+}
+
+// Batch version of vec3TransformCoord for vertex-sized loops. Strides are in bytes, like
+// D3DXVec3TransformCoordArray, so it can run directly over interleaved vertex data (ex. Pos3Uv2).
+inline void vec3TransformCoordArray(
+  Vec3 *pOut, size_t outStride, const Vec3 *pIn, size_t inStride, size_t count, const Mat4 &m)
+{
+  SimdFloat4 row0 = simdLoad(m.m[0]);
+  SimdFloat4 row1 = simdLoad(m.m[1]);
+  SimdFloat4 row2 = simdLoad(m.m[2]);
+  SimdFloat4 row3 = simdLoad(m.m[3]);
+  float r[4];
+
+  const unsigned char *pInBytes = reinterpret_cast<const unsigned char*>(pIn);
+  unsigned char *pOutBytes = reinterpret_cast<unsigned char*>(pOut);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    const Vec3 &v = *reinterpret_cast<const Vec3*>(pInBytes + i * inStride);
+    SimdFloat4 acc = simdMulAdd(simdSplat(v.x), row0, row3);
+    acc = simdMulAdd(simdSplat(v.y), row1, acc);
+    acc = simdMulAdd(simdSplat(v.z), row2, acc);
+    simdStore(r, acc);
+
+    float invW = r[3] != 0.0f ? 1.0f / r[3] : 0.0f;
+    Vec3 &out = *reinterpret_cast<Vec3*>(pOutBytes + i * outStride);
+    out.x = r[0] * invW;
+    out.y = r[1] * invW;
+    out.z = r[2] * invW;
+  }
+}
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef MATH_QUATERNION_H
+#define MATH_QUATERNION_H
+
+#include "Matrix.h"
+#include "Vector.h"
+#include <math.h>
+
+// Rotation quaternion with the same conventions as D3DXQUATERNION (x, y, z vector part, w scalar part).
+
+typedef struct Quat_
+{
+  float x, y, z, w;
+
+  constexpr Quat_() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+  constexpr Quat_(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+
+} Quat;
+
+static_assert(sizeof(Quat) == 4 * sizeof(float), "Quat must match D3DXQUATERNION layout");
+
+
+constexpr Quat quaternionIdentity()
+{
+  return Quat(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+constexpr float quaternionDot(const Quat &a, const Quat &b)
+{
+  return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+constexpr Quat quaternionConjugate(const Quat &q)
+{
+  return Quat(-q.x, -q.y, -q.z, q.w);
+}
+
+// Returns the rotation q1 followed by q2, same as D3DXQuaternionMultiply(&out, &q1, &q2).
+constexpr Quat quaternionMultiply(const Quat &q1, const Quat &q2)
+{
+  return Quat(
+    q2.w * q1.x + q2.x * q1.w + q2.y * q1.z - q2.z * q1.y,
+    q2.w * q1.y - q2.x * q1.z + q2.y * q1.w + q2.z * q1.x,
+    q2.w * q1.z + q2.x * q1.y - q2.y * q1.x + q2.z * q1.w,
+    q2.w * q1.w - q2.x * q1.x - q2.y * q1.y - q2.z * q1.z);
+}
+
+inline Quat quaternionNormalize(const Quat &q)
+{
+  float len = sqrtf(quaternionDot(q, q));
+  if (len <= 0.0f)
+  {
+    return quaternionIdentity();
+  }
+
+  float invLen = 1.0f / len;
+  return Quat(q.x * invLen, q.y * invLen, q.z * invLen, q.w * invLen);
+}
+
+inline Quat quaternionRotationAxis(const Vec3 &axis, float angle)
+{
+  Vec3 n = vec3Normalize(axis);
+  float s = sinf(angle / 2.0f);
+  return Quat(n.x * s, n.y * s, n.z * s, cosf(angle / 2.0f));
+}
+
+// Yaw around y, pitch around x, roll around z, same as D3DXQuaternionRotationYawPitchRoll.
+inline Quat quaternionRotationYawPitchRoll(float yaw, float pitch, float roll)
+{
+  float sy = sinf(yaw / 2.0f), cy = cosf(yaw / 2.0f);
+  float sp = sinf(pitch / 2.0f), cp = cosf(pitch / 2.0f);
+  float sr = sinf(roll / 2.0f), cr = cosf(roll / 2.0f);
+
+  return Quat(
+    cy * sp * cr + sy * cp * sr,
+    sy * cp * cr - cy * sp * sr,
+    cy * cp * sr - sy * sp * cr,
+    cy * cp * cr + sy * sp * sr);
+}
+
+inline Quat quaternionSlerp(const Quat &a, const Quat &b, float t)
+{
+  float cosTheta = quaternionDot(a, b);
+  float sign = 1.0f;
+  if (cosTheta < 0.0f)
+  {
+    cosTheta = -cosTheta;
+    sign = -1.0f;
+  }
+
+  float wa = 1.0f - t;
+  float wb = t;
+  // Nearly parallel, plain lerp avoids dividing by sin(~0).
+  if (cosTheta < 0.9995f)
+  {
+    float theta = acosf(cosTheta);
+    float invSin = 1.0f / sinf(theta);
+    wa = sinf((1.0f - t) * theta) * invSin;
+    wb = sinf(t * theta) * invSin;
+  }
+  wb *= sign;
+
+  return Quat(
+    wa * a.x + wb * b.x,
+    wa * a.y + wb * b.y,
+    wa * a.z + wb * b.z,
+    wa * a.w + wb * b.w);
+}
+
+// Same as D3DXMatrixRotationQuaternion; expects a unit quaternion.
+constexpr Mat4 matrixRotationQuaternion(const Quat &q)
+{
+  return Mat4(
+    1.0f - 2.0f * (q.y * q.y + q.z * q.z), 2.0f * (q.x * q.y + q.z * q.w),        2.0f * (q.x * q.z - q.y * q.w),        0.0f,
+    2.0f * (q.x * q.y - q.z * q.w),        1.0f - 2.0f * (q.x * q.x + q.z * q.z), 2.0f * (q.y * q.z + q.x * q.w),        0.0f,
+    2.0f * (q.x * q.z + q.y * q.w),        2.0f * (q.y * q.z - q.x * q.w),        1.0f - 2.0f * (q.x * q.x + q.y * q.y), 0.0f,
+    0.0f,                                  0.0f,                                  0.0f,                                  1.0f);
+}
+
+#endif
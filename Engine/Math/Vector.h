@@ -0,0 +1,119 @@
+#ifndef MATH_VECTOR_H
+#define MATH_VECTOR_H
+
+#include <math.h>
+
+// Plain float vectors. Layouts match D3DXVECTOR2/3/4 so they can be handed straight to vertex and constant buffers.
+// Everything that does not need sqrt/trig is constexpr.
+
+typedef struct Vec2_
+{
+  float x, y;
+
+  constexpr Vec2_() : x(0.0f), y(0.0f) {}
+  constexpr Vec2_(float x_, float y_) : x(x_), y(y_) {}
+
+  constexpr Vec2_ operator+ (const Vec2_ &o) const  { return Vec2_(x + o.x, y + o.y); }
+  constexpr Vec2_ operator- (const Vec2_ &o) const  { return Vec2_(x - o.x, y - o.y); }
+  constexpr Vec2_ operator- () const                { return Vec2_(-x, -y); }
+  constexpr Vec2_ operator* (float s) const         { return Vec2_(x * s, y * s); }
+  constexpr Vec2_ operator/ (float s) const         { return Vec2_(x / s, y / s); }
+  constexpr bool operator== (const Vec2_ &o) const  { return x == o.x && y == o.y; }
+  constexpr bool operator!= (const Vec2_ &o) const  { return !(*this == o); }
+
+  Vec2_& operator+= (const Vec2_ &o)  { x += o.x; y += o.y; return *this; }
+  Vec2_& operator-= (const Vec2_ &o)  { x -= o.x; y -= o.y; return *this; }
+  Vec2_& operator*= (float s)         { x *= s; y *= s; return *this; }
+
+} Vec2;
+
+typedef struct Vec3_
+{
+  float x, y, z;
+
+  constexpr Vec3_() : x(0.0f), y(0.0f), z(0.0f) {}
+  constexpr Vec3_(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
+
+  constexpr Vec3_ operator+ (const Vec3_ &o) const  { return Vec3_(x + o.x, y + o.y, z + o.z); }
+  constexpr Vec3_ operator- (const Vec3_ &o) const  { return Vec3_(x - o.x, y - o.y, z - o.z); }
+  constexpr Vec3_ operator- () const                { return Vec3_(-x, -y, -z); }
+  constexpr Vec3_ operator* (float s) const         { return Vec3_(x * s, y * s, z * s); }
+  constexpr Vec3_ operator/ (float s) const         { return Vec3_(x / s, y / s, z / s); }
+  constexpr bool operator== (const Vec3_ &o) const  { return x == o.x && y == o.y && z == o.z; }
+  constexpr bool operator!= (const Vec3_ &o) const  { return !(*this == o); }
+
+  Vec3_& operator+= (const Vec3_ &o)  { x += o.x; y += o.y; z += o.z; return *this; }
+  Vec3_& operator-= (const Vec3_ &o)  { x -= o.x; y -= o.y; z -= o.z; return *this; }
+  Vec3_& operator*= (float s)         { x *= s; y *= s; z *= s; return *this; }
+
+} Vec3;
+
+typedef struct Vec4_
+{
+  float x, y, z, w;
+
+  constexpr Vec4_() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
+  constexpr Vec4_(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+  constexpr Vec4_(const Vec3 &v, float w_) : x(v.x), y(v.y), z(v.z), w(w_) {}
+
+  constexpr Vec4_ operator+ (const Vec4_ &o) const  { return Vec4_(x + o.x, y + o.y, z + o.z, w + o.w); }
+  constexpr Vec4_ operator- (const Vec4_ &o) const  { return Vec4_(x - o.x, y - o.y, z - o.z, w - o.w); }
+  constexpr Vec4_ operator* (float s) const         { return Vec4_(x * s, y * s, z * s, w * s); }
+  constexpr bool operator== (const Vec4_ &o) const  { return x == o.x && y == o.y && z == o.z && w == o.w; }
+  constexpr bool operator!= (const Vec4_ &o) const  { return !(*this == o); }
+
+} Vec4;
+
+static_assert(sizeof(Vec2) == 2 * sizeof(float), "Vec2 must stay tightly packed");
+static_assert(sizeof(Vec3) == 3 * sizeof(float), "Vec3 must stay tightly packed");
+static_assert(sizeof(Vec4) == 4 * sizeof(float), "Vec4 must stay tightly packed");
+
+
+constexpr float vec2Dot(const Vec2 &a, const Vec2 &b)
+{
+  return a.x * b.x + a.y * b.y;
+}
+
+inline float vec2Length(const Vec2 &v)
+{
+  return sqrtf(vec2Dot(v, v));
+}
+
+constexpr float vec3Dot(const Vec3 &a, const Vec3 &b)
+{
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+constexpr Vec3 vec3Cross(const Vec3 &a, const Vec3 &b)
+{
+  return Vec3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+constexpr float vec3LengthSq(const Vec3 &v)
+{
+  return vec3Dot(v, v);
+}
+
+inline float vec3Length(const Vec3 &v)
+{
+  return sqrtf(vec3LengthSq(v));
+}
+
+// Same as D3DXVec3Normalize: a zero-length vector comes back as zero instead of NaN.
+inline Vec3 vec3Normalize(const Vec3 &v)
+{
+  float len = vec3Length(v);
+  return len > 0.0f ? v * (1.0f / len) : Vec3();
+}
+
+constexpr Vec3 vec3Lerp(const Vec3 &a, const Vec3 &b, float t)
+{
+  return a + (b - a) * t;
+}
+
+constexpr float vec4Dot(const Vec4 &a, const Vec4 &b)
+{
+  return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+#endif
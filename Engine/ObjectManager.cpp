@@ -4,19 +4,24 @@
 #include "CommonPhysConsts.h"
 #include "Logger.h"
 #include "ObjectManager.h"
-#include "Objects/ControllableObj.h"
-#include "Objects/PolyObj.h"
+#include "MappedFile.h"
+#include "SceneBin.h"
 #include "VisualModels/TexBox.h"
 #include "PhysicsModels/CollisionModels/AABB.h"
 
-// Read in a file and parse it into a vector of newly allocated objects.
-// Deleting objects once done with them is the responsibility of the caller.
+// Read in a scene file and add its player and blocks to the manager, which owns them until release().
+// Text scene blocks are numbered by their line, binary ones keep their stored ID, both offset by idOffset.
 void ObjectManager::generateFromFile(
   std::string filename,
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   uint32_t idOffset)
 {
+  if (isBinSceneFile(filename))
+  {
+    generateFromBinFile(filename, dev, idOffset);
+    return;
+  }
+
   std::ifstream fs(filename);
   std::string curLine;
 
@@ -34,7 +39,7 @@ void ObjectManager::generateFromFile(
 
   int lineCnt = 0;
 
-  /* Start by counting the number of objects. */
+  /* Single pass: each line's object is added as soon as the line is parsed. */
   while (std::getline(fs, curLine))
   {
     lineCnt++;
@@ -49,45 +54,14 @@ void ObjectManager::generateFromFile(
     {
       float locX, locY, locZ;
       lineStream >> locX >> locY >> locZ;
-      LOGI("Initializing player at (%f, %f, %f)", locX, locY, locZ);
-
-      TexBox *pVObj = new TexBox;
-      pVObj->init(
-        dev, devcon,
-        PLAYER_HITBOX_W, PLAYER_HITBOX_H, PLAYER_HITBOX_D,
-        std::string("Textures/cat.dds")
-        );
-
-      ControllableObj *pObj = new ControllableObj;
-      pObj->init(dev, devcon);
-      pObj->setPos(Pos3(locX, locY + PLAYER_HITBOX_H / 2, locZ));
-      pObj->setVModel(pVObj);
-
-      // Player object is ID 0 by default.
-      addObject(0, pObj);
+      addPlayer(Pos3(locX, locY, locZ), dev);
     }
     if ("B" == curWord) // Block: 'B {loc} {dim} {texture}'
     {
       std::string tex;
-      float locX, locY, locZ, dimX, dimY, dimZ;
-      lineStream >> locX >> locY >> locZ >> dimX >> dimY >> dimZ >> tex;
-
-      TexBox *pVObj = new TexBox;
-      pVObj->init(
-        dev, devcon,
-        dimX, dimY, dimZ,
-        tex,
-        dimX, dimY, dimZ);
-
-      PolyObj *pObj = new PolyObj;
-      pObj->init(pVObj);
-      pObj->setPos(Pos3(locX, locY, locZ));
-      pObj->setPModel(new PhysicsModel);
-      pObj->getPModel()->setCollisionModel(new AABB(dimX, dimY, dimZ));
-      pObj->getPModel()->getCollisionModel()->setType(COLLISION_MODEL_AABB_IMMOBILE);
-      pObj->getPModel()->getCollisionModel()->setPos(Pos3(0.0, 0.0, 0.0));
-
-      addObject(lineCnt + idOffset, pObj);
+      Pos3 loc, dim;
+      parseBlockLine(curLine, loc, dim, tex);
+      addBlock(lineCnt + idOffset, loc, dim, tex, dev);
     }
     else /* Default case: */
     {
@@ -96,6 +70,145 @@ void ObjectManager::generateFromFile(
   }
 }
 
+bool ObjectManager::isBinSceneFile(const std::string &filename)
+{
+  std::ifstream magicFs(filename, std::ios::binary);
+  uint32_t magic = 0;
+  return magicFs.read(reinterpret_cast<char*>(&magic), sizeof(magic)) && magic == SCENE_BIN_MAGIC;
+}
+
+
+bool ObjectManager::parseBlockLine(const std::string &line, Pos3 &loc, Pos3 &dim, std::string &tex)
+{
+  std::istringstream lineStream(line);
+  std::string curWord;
+  float locX = 0.0f, locY = 0.0f, locZ = 0.0f, dimX = 0.0f, dimY = 0.0f, dimZ = 0.0f;
+  lineStream >> curWord >> locX >> locY >> locZ >> dimX >> dimY >> dimZ >> tex;
+
+  loc = Pos3(locX, locY, locZ);
+  dim = Pos3(dimX, dimY, dimZ);
+  return !lineStream.fail() && "B" == curWord;
+}
+
+
+// Load a binary scene (see SceneBin.h). The file is mapped and its object table is walked in place.
+bool ObjectManager::generateFromBinFile(
+  std::string filename,
+  RenderDevice *dev,
+  uint32_t idOffset)
+{
+  MappedFile file;
+  if (!file.open(filename))
+  {
+    LOGE("Error reading scene: %s", filename.c_str());
+    return false;
+  }
+
+  if (!sceneBinValidate(file.data(), file.size()))
+  {
+    LOGE("Invalid or unsupported binary scene: %s", filename.c_str());
+    return false;
+  }
+
+  LOGI("Loading binary scene: %s", filename.c_str());
+
+  const SceneBinHeader *pHeader = sceneBinHeader(file.data());
+  const SceneBinObject *pObjs = sceneBinObjects(file.data());
+
+  bool bSuccess = true;
+  for (uint32_t i = 0; i < pHeader->objectCount; i++)
+  {
+    const SceneBinObject &obj = pObjs[i];
+    Pos3 loc(obj.loc[0], obj.loc[1], obj.loc[2]);
+
+    switch (obj.type)
+    {
+      case SCENE_BIN_OBJ_PLAYER:
+      {
+        addPlayer(loc, dev);
+        break;
+      }
+      case SCENE_BIN_OBJ_BLOCK:
+      {
+        const char *pTex = sceneBinString(file.data(), obj.textureOffset);
+        if (!pTex)
+        {
+          LOGE("Bad texture offset %u for object %u", obj.textureOffset, i);
+          bSuccess = false;
+          continue;
+        }
+
+        std::string tex(pTex);
+        addBlock(obj.id + idOffset, loc, Pos3(obj.dim[0], obj.dim[1], obj.dim[2]), tex, dev);
+        break;
+      }
+      default:
+      {
+        LOGE("Unknown binary scene object type %u", obj.type);
+        bSuccess = false;
+        break;
+      }
+    }
+  }
+
+  return bSuccess;
+}
+
+
+void ObjectManager::addPlayer(const Pos3 &loc, RenderDevice *dev)
+{
+  LOGI("Initializing player at (%f, %f, %f)", loc.pos.x, loc.pos.y, loc.pos.z);
+
+  std::string tex("Textures/cat.dds");
+  TexBox *pVObj = new TexBox;
+  if (m_bDeferGpuInit)
+  {
+    pVObj->prepare(dev, PLAYER_HITBOX_W, PLAYER_HITBOX_H, PLAYER_HITBOX_D, tex);
+  }
+  else
+  {
+    pVObj->init(dev, PLAYER_HITBOX_W, PLAYER_HITBOX_H, PLAYER_HITBOX_D, tex);
+  }
+
+  ControllableObj *pObj = new ControllableObj;
+  pObj->init(dev);
+  pObj->setPos(Pos3(loc.pos.x, loc.pos.y + PLAYER_HITBOX_H / 2, loc.pos.z));
+  pObj->setVModel(pVObj);
+
+  // Player object is ID 0 by default.
+  addObject(0, pObj);
+}
+
+
+void ObjectManager::addBlock(
+  uint32_t id,
+  const Pos3 &loc,
+  const Pos3 &dim,
+  std::string &tex,
+  RenderDevice *dev)
+{
+  TexBox *pVObj = new TexBox;
+  if (m_bDeferGpuInit)
+  {
+    pVObj->prepare(dev, dim.pos.x, dim.pos.y, dim.pos.z, tex, dim.pos.x, dim.pos.y, dim.pos.z);
+  }
+  else
+  {
+    pVObj->init(dev, dim.pos.x, dim.pos.y, dim.pos.z, tex, dim.pos.x, dim.pos.y, dim.pos.z);
+  }
+
+  PolyObj *pObj = new PolyObj;
+  pObj->init(pVObj);
+  pObj->setPos(loc);
+  pObj->setPModel(new PhysicsModel);
+  pObj->getPModel()->setCollisionModel(new AABB(dim.pos.x, dim.pos.y, dim.pos.z));
+  pObj->getPModel()->getCollisionModel()->setType(COLLISION_MODEL_AABB_IMMOBILE);
+  pObj->getPModel()->getCollisionModel()->setPos(Pos3(0.0, 0.0, 0.0));
+
+  addObject(id, pObj);
+}
+
+
 void ObjectManager::init()
 {
 
@@ -105,67 +218,450 @@ void ObjectManager::init()
 bool ObjectManager::release()
 {
   bool bSuccess = true;
-  for (auto it = m_objs.begin(); it != m_objs.end(); ++it)
+  forEachObject([&bSuccess](uint32_t id, GameObject &obj)
   {
-    if (!GameObject::releaseGameObject(it->second))
+    if (!GameObject::releaseGameObject(&obj))
     {
-      // Don't return yet, can still try to release other objects.
-      LOGE("Failed to release obj [%u], continuing", it->first);
+      // Don't stop yet, can still try to release other objects.
+      LOGE("Failed to release obj [%u], continuing", id);
       bSuccess = false;
     }
+    return true;
+  });
+
+  m_controllableObjs.clear();
+  m_polyObjs.clear();
+  m_hookshots.clear();
+  m_debugOverlays.clear();
+  m_entities.clear();
+  m_entityVersion++;
+  m_ids.clear();
+  for (uint32_t set = 0; set < OBJECT_SET_COUNT; set++)
+  {
+    m_sets[set].clear();
   }
-
+  m_prevStates.clear();
   return bSuccess;
 }
 
 
+void ObjectManager::setDeferGpuInit(bool bDeferGpuInit)
+{
+  m_bDeferGpuInit = bDeferGpuInit;
+}
+
+
+bool ObjectManager::setStoreAsEntity(GameObjectType type, bool bStoreAsEntity)
+{
+  // Object types with their own update logic still need the GameObject hierarchy.
+  switch (type)
+  {
+    case GAME_OBJECT_POLY_OBJ:
+    {
+      break;
+    }
+    default:
+    {
+      LOGE("Object type %d can't be stored as an entity", type);
+      return false;
+    }
+  }
+
+  if (bStoreAsEntity)
+  {
+    m_entityTypeMask |= (1u << type);
+  }
+  else
+  {
+    m_entityTypeMask &= ~(1u << type);
+  }
+  return true;
+}
+
+
+uint32_t ObjectManager::trimPools()
+{
+  return TexBox::trimPool() + PhysicsModel::trimPool() + AABB::trimPool();
+}
+
+
+EntityRegistry& ObjectManager::getEntities()
+{
+  return m_entities;
+}
+
+
+uint32_t ObjectManager::getEntityVersion()
+{
+  return m_entityVersion;
+}
+
+
+// Moves pObj's state and models into a new entity. pObj itself is left empty for the caller to delete.
+bool ObjectManager::addEntity(GameObject *pObj, ObjectHandle &handle)
+{
+  Entity entity = m_entities.create();
+
+  TransformComponent transform;
+  transform.pos = pObj->getPos();
+  transform.rot = pObj->getRot();
+  m_entities.add(entity, transform);
+
+  VelocityComponent velocity;
+  velocity.vel    = pObj->getVel();
+  velocity.rotVel = pObj->getRotVel();
+  m_entities.add(entity, velocity);
+
+  if (pObj->getVModel())
+  {
+    RenderComponent render;
+    render.pVModel = pObj->getVModel();
+    m_entities.add(entity, render);
+    pObj->setVModel(NULL);
+  }
+
+  if (pObj->getPModel())
+  {
+    PhysicsComponent physics;
+    physics.pPModel = pObj->getPModel();
+    physics.uuid    = pObj->getUuid();
+    m_entities.add(entity, physics);
+    pObj->setPModel(NULL);
+  }
+
+  handle.bEntity = true;
+  handle.entity  = entity;
+  m_entityVersion++;
+  return true;
+}
+
+
 void ObjectManager::addObject(uint32_t id, GameObject* pObj)
 {
-  m_objs[id] = pObj;
+  if (!pObj)
+  {
+    LOGW("Null pObj for id [%u]", id);
+    return;
+  }
+
+  removeObject(id);
+
+  ObjectHandle handle;
+  handle.type = pObj->getType();
+  if (m_entityTypeMask & (1u << handle.type))
+  {
+    // Entities are run by the ECS systems, so they're not a member of any object set.
+    addEntity(pObj, handle);
+    delete pObj;
+
+    ObjectRecord &record = m_ids[id];
+    record.handle = handle;
+    for (uint32_t set = 0; set < OBJECT_SET_COUNT; set++)
+    {
+      record.setIdx[set] = POOL_INVALID_SLOT;
+    }
+    return;
+  }
+
+  switch (handle.type)
+  {
+    case GAME_OBJECT_CONTROLLABLE:
+    {
+      handle.poolHandle = m_controllableObjs.add(id, std::move(*static_cast<ControllableObj*>(pObj)));
+      delete static_cast<ControllableObj*>(pObj);
+      break;
+    }
+    case GAME_OBJECT_POLY_OBJ:
+    {
+      handle.poolHandle = m_polyObjs.add(id, std::move(*static_cast<PolyObj*>(pObj)));
+      delete static_cast<PolyObj*>(pObj);
+      break;
+    }
+    case GAME_OBJECT_HOOKSHOT:
+    {
+      handle.poolHandle = m_hookshots.add(id, std::move(*static_cast<Hookshot*>(pObj)));
+      delete static_cast<Hookshot*>(pObj);
+      break;
+    }
+    case GAME_OBJECT_DEBUG_OVERLAY:
+    {
+      handle.poolHandle = m_debugOverlays.add(id, std::move(*static_cast<DebugOverlay*>(pObj)));
+      delete static_cast<DebugOverlay*>(pObj);
+      break;
+    }
+    default:
+    {
+      LOGE("Object type %d can't be stored, dropping obj [%u]", handle.type, id);
+      GameObject::releaseGameObject(pObj);
+      delete pObj;
+      return;
+    }
+  }
+
+  ObjectRecord &record = m_ids[id];
+  record.handle = handle;
+  addToSets(id, record, getObject(handle));
+}
+
+
+void ObjectManager::addToSets(uint32_t id, ObjectRecord &record, GameObject *pObj)
+{
+  bool bMember[OBJECT_SET_COUNT];
+  bMember[OBJECT_SET_UPDATE]  = GameObject::hasUpdate(pObj);
+  bMember[OBJECT_SET_PHYSICS] = pObj->getPModel() != NULL;
+  bMember[OBJECT_SET_RENDER]  = pObj->getVModel() != NULL;
+
+  for (uint32_t set = 0; set < OBJECT_SET_COUNT; set++)
+  {
+    record.setIdx[set] = POOL_INVALID_SLOT;
+    if (bMember[set])
+    {
+      record.setIdx[set] = static_cast<uint32_t>(m_sets[set].size());
+      m_sets[set].push_back(ObjectSetEntry{ id, record.handle });
+    }
+  }
+}
+
+
+void ObjectManager::removeFromSets(ObjectRecord &record)
+{
+  for (uint32_t set = 0; set < OBJECT_SET_COUNT; set++)
+  {
+    uint32_t setIdx = record.setIdx[set];
+    if (setIdx == POOL_INVALID_SLOT)
+    {
+      continue;
+    }
+
+    // Swap the last member into the hole and fix up its record.
+    std::vector<ObjectSetEntry> &entries = m_sets[set];
+    if (setIdx != entries.size() - 1)
+    {
+      entries[setIdx] = entries.back();
+      m_ids[entries[setIdx].id].setIdx[set] = setIdx;
+    }
+    entries.pop_back();
+    record.setIdx[set] = POOL_INVALID_SLOT;
+  }
 }
 
 
 GameObject* ObjectManager::getObject(uint32_t id)
 {
-  return m_objs[id];
+  auto it = m_ids.find(id);
+  if (it == m_ids.end())
+  {
+    return NULL;
+  }
+
+  return getObject(it->second.handle);
 }
 
 
-ObjectManagerObjMap::iterator ObjectManager::begin()
+GameObject* ObjectManager::getObject(const ObjectHandle &handle)
 {
-  return m_objs.begin();
+  if (handle.bEntity)
+  {
+    return NULL;
+  }
+
+  switch (handle.type)
+  {
+    case GAME_OBJECT_CONTROLLABLE:
+    {
+      return m_controllableObjs.get(handle.poolHandle);
+    }
+    case GAME_OBJECT_POLY_OBJ:
+    {
+      return m_polyObjs.get(handle.poolHandle);
+    }
+    case GAME_OBJECT_HOOKSHOT:
+    {
+      return m_hookshots.get(handle.poolHandle);
+    }
+    case GAME_OBJECT_DEBUG_OVERLAY:
+    {
+      return m_debugOverlays.get(handle.poolHandle);
+    }
+    default:
+    {
+      return NULL;
+    }
+  }
+
+  return NULL;
 }
 
 
-ObjectManagerObjMap::iterator ObjectManager::end()
+ObjectHandle ObjectManager::getHandle(uint32_t id)
 {
-  return m_objs.end();
+  auto it = m_ids.find(id);
+  return (it == m_ids.end()) ? ObjectHandle() : it->second.handle;
 }
 
 
-GameObject* ObjectManager::getFirstPObj()
+bool ObjectManager::setObjectPos(uint32_t id, const Pos3 &pos)
 {
-  m_lastPItr = m_objs.begin();
-  return (m_lastPItr == m_objs.end()) ? NULL : m_lastPItr->second;
+  auto it = m_ids.find(id);
+  if (it == m_ids.end())
+  {
+    return false;
+  }
+
+  if (it->second.handle.bEntity)
+  {
+    TransformComponent *pTransform = m_entities.get<TransformComponent>(it->second.handle.entity);
+    if (!pTransform)
+    {
+      return false;
+    }
+
+    pTransform->pos = pos;
+    pTransform->bWorldMatDirty = true;
+    m_entityVersion++;
+    return true;
+  }
+
+  GameObject *pObj = getObject(it->second.handle);
+  if (!pObj)
+  {
+    return false;
+  }
+
+  pObj->setPos(pos);
+  return true;
+}
+
+
+void ObjectManager::captureUpdateStates()
+{
+  std::vector<ObjectSetEntry> &entries = m_sets[OBJECT_SET_UPDATE];
+  m_prevStates.resize(entries.size());
+  for (size_t i = 0; i < entries.size(); i++)
+  {
+    GameObject *pObj = getObject(entries[i].handle);
+    if (pObj)
+    {
+      m_prevStates[i].pos     = pObj->getPos();
+      m_prevStates[i].vel     = pObj->getVel();
+      m_prevStates[i].rot     = pObj->getRot();
+      m_prevStates[i].rotVel  = pObj->getRotVel();
+    }
+  }
+}
+
+
+bool ObjectManager::getPrevState(uint32_t id, ObjectState &state)
+{
+  auto it = m_ids.find(id);
+  if (it == m_ids.end())
+  {
+    return false;
+  }
+
+  const ObjectRecord &record = it->second;
+  uint32_t updateIdx = record.setIdx[OBJECT_SET_UPDATE];
+  if (updateIdx != POOL_INVALID_SLOT && updateIdx < m_prevStates.size())
+  {
+    state = m_prevStates[updateIdx];
+    return true;
+  }
+
+  if (record.handle.bEntity)
+  {
+    TransformComponent *pTransform = m_entities.get<TransformComponent>(record.handle.entity);
+    VelocityComponent *pVelocity = m_entities.get<VelocityComponent>(record.handle.entity);
+    if (!pTransform)
+    {
+      return false;
+    }
+
+    state.pos     = pTransform->pos;
+    state.rot     = pTransform->rot;
+    state.vel     = pVelocity ? pVelocity->vel : Pos3();
+    state.rotVel  = pVelocity ? pVelocity->rotVel : Pos3();
+    return true;
+  }
+
+  GameObject *pObj = getObject(record.handle);
+  if (!pObj)
+  {
+    return false;
+  }
+
+  state.pos     = pObj->getPos();
+  state.vel     = pObj->getVel();
+  state.rot     = pObj->getRot();
+  state.rotVel  = pObj->getRotVel();
+  return true;
 }
 
 
-GameObject* ObjectManager::getNextPObj()
+bool ObjectManager::removeObject(uint32_t id)
 {
-  m_lastPItr++;
-  return (m_lastPItr == m_objs.end()) ? NULL : m_lastPItr->second;
+  auto it = m_ids.find(id);
+  if (it == m_ids.end())
+  {
+    return false;
+  }
+
+  GameObject *pObj = getObject(it->second.handle);
+  if (pObj)
+  {
+    GameObject::releaseGameObject(pObj);
+  }
+
+  removeFromSets(it->second);
+  bool bRemoved = removeFromPool(it->second.handle);
+  m_ids.erase(it);
+  return bRemoved;
+}
+
+
+bool ObjectManager::removeFromPool(const ObjectHandle &handle)
+{
+  // Destroying the entity also releases its models.
+  if (handle.bEntity)
+  {
+    m_entityVersion++;
+    return m_entities.destroy(handle.entity);
+  }
+
+  switch (handle.type)
+  {
+    case GAME_OBJECT_CONTROLLABLE:
+    {
+      return m_controllableObjs.remove(handle.poolHandle);
+    }
+    case GAME_OBJECT_POLY_OBJ:
+    {
+      return m_polyObjs.remove(handle.poolHandle);
+    }
+    case GAME_OBJECT_HOOKSHOT:
+    {
+      return m_hookshots.remove(handle.poolHandle);
+    }
+    case GAME_OBJECT_DEBUG_OVERLAY:
+    {
+      return m_debugOverlays.remove(handle.poolHandle);
+    }
+    default:
+    {
+      return false;
+    }
+  }
+
+  return false;
 }
 
 
-GameObject* ObjectManager::getFirstVObj()
+uint32_t ObjectManager::size()
 {
-  m_lastVItr = m_objs.begin();
-  return (m_lastVItr == m_objs.end()) ? NULL : m_lastVItr->second;
+  return static_cast<uint32_t>(m_ids.size());
 }
 
 
-GameObject* ObjectManager::getNextVObj()
+uint32_t ObjectManager::setSize(ObjectSet set)
 {
-  m_lastVItr++;
-  return (m_lastVItr == m_objs.end()) ? NULL : m_lastVItr->second;
+  return static_cast<uint32_t>(m_sets[set].size());
 }
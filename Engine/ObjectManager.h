@@ -2,39 +2,193 @@
 #define OBJECT_MANAGER_H
 
 #include "GameObject.h"
-#include <map>
+#include "ObjectPool.h"
+#include "Ecs/EntityRegistry.h"
+#include "Objects/ControllableObj.h"
+#include "Objects/DebugOverlay.h"
+#include "Objects/Hookshot.h"
+#include "Objects/PolyObj.h"
 #include <string>
+#include <unordered_map>
 
-typedef std::map<uint32_t, GameObject*> ObjectManagerObjMap;
+// Generation-checked reference to an object in an ObjectManager.
+typedef struct ObjectHandle_
+{
+  GameObjectType type{ GAME_OBJECT_NONE };
+  PoolHandle     poolHandle;
+  bool           bEntity{ false };  // Stored as an entity (see ObjectManager::setStoreAsEntity), poolHandle is unused.
+  Entity         entity;
+} ObjectHandle;
+
+// Membership lists kept by ObjectManager, so per-frame loops only visit the objects they need.
+typedef enum ObjectSet_
+{
+  OBJECT_SET_UPDATE = 0,  // Has per-frame logic (see GameObject::hasUpdate).
+  OBJECT_SET_PHYSICS,     // Has a PhysicsModel.
+  OBJECT_SET_RENDER,      // Has a VisualModel.
+  OBJECT_SET_COUNT
+} ObjectSet;
+
+// Copy of an object's movement state, see ObjectManager::getPrevState().
+typedef struct ObjectState_
+{
+  Pos3 pos;
+  Pos3 vel;
+  Pos3 rot;
+  Pos3 rotVel;
+} ObjectState;
 
 class ObjectManager
 {
 protected:
-  // Map from ID -> Object Ptr.
-  ObjectManagerObjMap m_objs;
-  ObjectManagerObjMap::iterator m_lastPItr;
-  ObjectManagerObjMap::iterator m_lastVItr;
+  // Objects are stored by value, in one dense pool per object type.
+  ObjectPool<ControllableObj> m_controllableObjs;
+  ObjectPool<PolyObj>         m_polyObjs;
+  ObjectPool<Hookshot>        m_hookshots;
+  ObjectPool<DebugOverlay>    m_debugOverlays;
+
+  // Object types that have been migrated to entity-component storage. Their objects only live in m_entities and are
+  // run by the ECS systems, not the object sets.
+  EntityRegistry  m_entities;
+  uint32_t        m_entityTypeMask{ 0 };
+  uint32_t        m_entityVersion{ 0 };
+
+  typedef struct ObjectSetEntry_
+  {
+    uint32_t      id;
+    ObjectHandle  handle;
+  } ObjectSetEntry;
+
+  typedef struct ObjectRecord_
+  {
+    ObjectHandle  handle;
+    uint32_t      setIdx[OBJECT_SET_COUNT];   // Position in each membership list, POOL_INVALID_SLOT if not a member.
+  } ObjectRecord;
+
+  // Map from ID -> Object handle and set membership.
+  std::unordered_map<uint32_t, ObjectRecord> m_ids;
+
+  // Membership is decided when an object is added, based on its type and models.
+  std::vector<ObjectSetEntry> m_sets[OBJECT_SET_COUNT];
+
+  // State of each OBJECT_SET_UPDATE member as of the last captureUpdateStates(), parallel to that set.
+  std::vector<ObjectState> m_prevStates;
+
+  // When set, loaders only prepare() visual models and leave GPU resource creation to the caller.
+  bool m_bDeferGpuInit{ false };
+
+  bool removeFromPool(const ObjectHandle &handle);
+  bool addEntity(GameObject *pObj, ObjectHandle &handle);
+  void addToSets(uint32_t id, ObjectRecord &record, GameObject *pObj);
+  void removeFromSets(ObjectRecord &record);
+
+  template <typename T, typename Fn>
+  static bool forEachInPool(ObjectPool<T> &pool, Fn &fn)
+  {
+    for (uint32_t i = 0; i < pool.size(); i++)
+    {
+      if (!fn(pool.idAt(i), static_cast<GameObject&>(pool.itemAt(i))))
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
 
 public:
   virtual void init();
   virtual bool release();
 
-  void generateFromFile(std::string filename, ID3D11Device *dev, ID3D11DeviceContext *devcon, uint32_t idOffset);
+  // Accepts either a text scene or a binary scene (see SceneBin.h).
+  void generateFromFile(std::string filename, RenderDevice *dev, uint32_t idOffset);
+  bool generateFromBinFile(std::string filename, RenderDevice *dev, uint32_t idOffset);
+
+  // Binary scenes are recognized by their magic number, so scenes can point at either format.
+  static bool isBinSceneFile(const std::string &filename);
 
+  // Parses a text scene block line, 'B {loc} {dim} {texture}'.
+  static bool parseBlockLine(const std::string &line, Pos3 &loc, Pos3 &dim, std::string &tex);
+
+  void setDeferGpuInit(bool bDeferGpuInit);
+
+  // Gives unused memory in the block allocator pools (see PoolAllocator.h) back to the system. Shared by all scenes,
+  // so only worthwhile once a whole scene has been released. Returns the number of slabs released.
+  static uint32_t trimPools();
+
+  // Objects of this type get converted to entities as they're added, instead of being stored as GameObjects. Only
+  // for types with no per-frame logic of their own (see GameObject::hasUpdate). Set before any objects are added.
+  bool setStoreAsEntity(GameObjectType type, bool bStoreAsEntity);
+  EntityRegistry& getEntities();
+
+  // Changes whenever an entity is added, removed or moved through setObjectPos(), ex. so the static batch (see
+  // StaticBatch.h) knows when to rebuild.
+  uint32_t getEntityVersion();
+
+  // Shared by the text and binary scene loaders, and scene hot reload (see SceneHotReload.h).
+  virtual void addPlayer(const Pos3 &loc, RenderDevice *dev);
+  virtual void addBlock(
+    uint32_t id,
+    const Pos3 &loc,
+    const Pos3 &dim,
+    std::string &tex,
+    RenderDevice *dev);
+
+  // Moves the object into the manager's storage and deletes pObj. An existing object with the same ID is released.
   virtual void addObject(uint32_t id, GameObject* pObj);
+
+  // Object pointers are only valid until the next add/remove, keep a handle (or ID) instead.
+  // Objects stored as entities have no GameObject, use getHandle() and getEntities() for those.
   virtual GameObject* getObject(uint32_t id);
+  GameObject* getObject(const ObjectHandle &handle);
+  ObjectHandle getHandle(uint32_t id);
+
+  // Works for objects stored as entities too. Returns false if there's no such object.
+  bool setObjectPos(uint32_t id, const Pos3 &pos);
 
-  // Multiple ways to iterate through objects.
-  // 1) Iterate over all objects.
-  // 2) Iterate over only those objects that need physics processing.
-  // 3) Iterate over only those objects that need visual processing.
+  // Snapshots the objects with per-frame logic, before their updates run (possibly in parallel, see Scene::update).
+  void captureUpdateStates();
+
+  // State of any object that's safe to read from an update job: objects with per-frame logic come from the last
+  // captureUpdateStates(), everything else doesn't change during updates and is read directly. Returns false if
+  // there's no such object.
+  bool getPrevState(uint32_t id, ObjectState &state);
+
+  // Releases and destroys the object. Returns false if there's no such object.
+  virtual bool removeObject(uint32_t id);
+
+  // Counts objects stored as entities too.
+  uint32_t size();
+
+  // Calls fn(uint32_t id, GameObject &obj) for every GameObject, type by type. Stops early, and returns false, if fn does.
   // Don't insert/remove any objects in the middle of iterating.
-  virtual ObjectManagerObjMap::iterator begin();
-  virtual ObjectManagerObjMap::iterator end();
-  virtual GameObject* getFirstPObj();
-  virtual GameObject* getNextPObj();
-  virtual GameObject* getFirstVObj();
-  virtual GameObject* getNextVObj();
+  template <typename Fn>
+  bool forEachObject(Fn fn)
+  {
+    return forEachInPool(m_controllableObjs, fn) &&
+      forEachInPool(m_polyObjs, fn) &&
+      forEachInPool(m_hookshots, fn) &&
+      forEachInPool(m_debugOverlays, fn);
+  }
+
+  // Same as forEachObject(), but only visits the members of one set.
+  template <typename Fn>
+  bool forEachInSet(ObjectSet set, Fn fn)
+  {
+    std::vector<ObjectSetEntry> &entries = m_sets[set];
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+      GameObject *pObj = getObject(entries[i].handle);
+      if (pObj && !fn(entries[i].id, *pObj))
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  uint32_t setSize(ObjectSet set);
 };
 
 #endif
@@ -0,0 +1,131 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+#define POOL_INVALID_SLOT   UINT32_MAX
+
+// Generation-checked reference into an ObjectPool. Stays safe to use after the object is removed, lookups just fail.
+typedef struct PoolHandle_
+{
+  uint32_t slot{ POOL_INVALID_SLOT };
+  uint32_t generation{ 0 };
+} PoolHandle;
+
+// Dense storage for objects of a single type. Items live back to back in one array, so iterating is a linear walk.
+// Removal swaps the last item into the hole, so item addresses (and order) are only stable until the next add/remove,
+// hold on to a PoolHandle instead.
+template <typename T>
+class ObjectPool
+{
+private:
+  typedef struct Slot_
+  {
+    uint32_t denseIdx;
+    uint32_t generation;
+  } Slot;
+
+  std::vector<T>        m_items;
+  std::vector<uint32_t> m_ids;          // External ID of each item, parallel to m_items.
+  std::vector<uint32_t> m_itemSlots;    // Slot of each item, parallel to m_items.
+  std::vector<Slot>     m_slots;
+  std::vector<uint32_t> m_freeSlots;
+
+public:
+  PoolHandle add(uint32_t id, T &&item)
+  {
+    uint32_t slot;
+    if (!m_freeSlots.empty())
+    {
+      slot = m_freeSlots.back();
+      m_freeSlots.pop_back();
+    }
+    else
+    {
+      slot = static_cast<uint32_t>(m_slots.size());
+      m_slots.push_back(Slot{ 0, 1 });
+    }
+
+    m_slots[slot].denseIdx = static_cast<uint32_t>(m_items.size());
+    m_items.push_back(std::move(item));
+    m_ids.push_back(id);
+    m_itemSlots.push_back(slot);
+
+    PoolHandle handle;
+    handle.slot = slot;
+    handle.generation = m_slots[slot].generation;
+    return handle;
+  }
+
+  T* get(const PoolHandle &handle)
+  {
+    if (handle.slot >= m_slots.size() || m_slots[handle.slot].generation != handle.generation)
+    {
+      return NULL;
+    }
+
+    return &m_items[m_slots[handle.slot].denseIdx];
+  }
+
+  bool remove(const PoolHandle &handle)
+  {
+    if (!get(handle))
+    {
+      return false;
+    }
+
+    uint32_t denseIdx = m_slots[handle.slot].denseIdx;
+    uint32_t lastIdx = static_cast<uint32_t>(m_items.size() - 1);
+    if (denseIdx != lastIdx)
+    {
+      m_items[denseIdx] = std::move(m_items[lastIdx]);
+      m_ids[denseIdx] = m_ids[lastIdx];
+      m_itemSlots[denseIdx] = m_itemSlots[lastIdx];
+      m_slots[m_itemSlots[denseIdx]].denseIdx = denseIdx;
+    }
+
+    m_items.pop_back();
+    m_ids.pop_back();
+    m_itemSlots.pop_back();
+
+    // Bumping the generation invalidates any handles still pointing at this slot.
+    m_slots[handle.slot].generation++;
+    m_freeSlots.push_back(handle.slot);
+    return true;
+  }
+
+  void clear()
+  {
+    for (uint32_t slot = 0; slot < m_slots.size(); slot++)
+    {
+      if (m_slots[slot].denseIdx < m_items.size() && m_itemSlots[m_slots[slot].denseIdx] == slot)
+      {
+        m_slots[slot].generation++;
+        m_freeSlots.push_back(slot);
+      }
+    }
+
+    m_items.clear();
+    m_ids.clear();
+    m_itemSlots.clear();
+  }
+
+  uint32_t size() const
+  {
+    return static_cast<uint32_t>(m_items.size());
+  }
+
+  T& itemAt(uint32_t denseIdx)
+  {
+    return m_items[denseIdx];
+  }
+
+  uint32_t idAt(uint32_t denseIdx) const
+  {
+    return m_ids[denseIdx];
+  }
+};
+
+#endif
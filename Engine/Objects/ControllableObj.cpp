@@ -23,15 +23,14 @@ ControllableObj::ControllableObj()
   LOGD("GameObject %lu = type %d", static_cast<unsigned long>(m_uuid), m_type);
 }
 
-bool ControllableObj::init(ID3D11Device *dev, ID3D11DeviceContext *devcon)
+bool ControllableObj::init(RenderDevice *dev)
 {
   return true;
 }
 
 
 bool ControllableObj::prelimUpdate(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   float timeMs,
   InputApi &input,
   SoundMgr *pSoundMgr)
@@ -50,8 +49,7 @@ bool ControllableObj::prelimUpdate(
 
 
 bool ControllableObj::update(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   float timeMs,
   InputApi &input,
   SoundMgr *pSoundMgr)
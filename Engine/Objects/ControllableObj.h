@@ -21,18 +21,16 @@ private:
 public:
   ControllableObj();
 
-  bool init(ID3D11Device *dev, ID3D11DeviceContext *devcon);
+  bool init(RenderDevice *dev);
 
   bool update(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     float timeMs,
     InputApi &input,
     SoundMgr *pSoundMgr);
 
-  bool ControllableObj::prelimUpdate(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+  bool prelimUpdate(
+    RenderDevice *dev,
     float timeMs,
     InputApi &input,
     SoundMgr *pSoundMgr);
@@ -15,7 +15,7 @@ DebugOverlay::DebugOverlay()
   LOGD("GameObject %lu = type %d", static_cast<unsigned long>(m_uuid), m_type);
 }
 
-bool DebugOverlay::init(ID3D11Device *dev, ID3D11DeviceContext *devcon)
+bool DebugOverlay::init(RenderDevice *dev)
 {
   if (!m_pVModel)
   {
@@ -25,7 +25,7 @@ bool DebugOverlay::init(ID3D11Device *dev, ID3D11DeviceContext *devcon)
 
   TexText *pTexText = static_cast<TexText*>(m_pVModel);
   if (!pTexText->init(
-    dev, devcon,
+    dev,
     std::string("---"),
     std::string("Engine/Fonts/RobotoMono.txt"),
     Pos3(-0.8f, 0.45f, -0.5f),
@@ -41,8 +41,7 @@ bool DebugOverlay::init(ID3D11Device *dev, ID3D11DeviceContext *devcon)
 
 
 bool DebugOverlay::update(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   float timeMs,
   InputApi &input,
   SoundMgr *pSoundMgr)
@@ -89,7 +88,7 @@ bool DebugOverlay::update(
 
   static_cast<TexText*>(m_pVModel)->updateText(
     dbgString,
-    dev, devcon);
+    dev);
 
   return true;
 }
@@ -21,11 +21,10 @@ private:
 
 public:
   DebugOverlay();
-  bool init(ID3D11Device *dev, ID3D11DeviceContext *devcon);
+  bool init(RenderDevice *dev);
 
   bool update(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     float timeMs,
     InputApi &input,
     SoundMgr *pSoundMgr);
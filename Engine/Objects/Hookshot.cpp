@@ -13,8 +13,7 @@ Hookshot::Hookshot()
 
 
 bool Hookshot::init(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   std::string &texFile,
   double length,
   double radius,
@@ -22,7 +21,7 @@ bool Hookshot::init(
   bool bStaticScreenLoc)
 {
   TexCylinder* pTexCylinder = new TexCylinder;
-  if(!pTexCylinder->init(dev, devcon, radius, length, texFile, numFaces, 1.0, 1.0, bStaticScreenLoc))
+  if(!pTexCylinder->init(dev, radius, length, texFile, numFaces, 1.0, 1.0, bStaticScreenLoc))
   {
     LOGE("Failed to init TexCylinder for Hookshot");
     return false;
@@ -34,11 +33,10 @@ bool Hookshot::init(
 
 
 void Hookshot::updateLength(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   double L)
 {
-  static_cast<TexCylinder*>(m_pVModel)->updateLength(dev, devcon, L);
+  static_cast<TexCylinder*>(m_pVModel)->updateLength(dev, L);
 }
 
 
@@ -92,12 +90,11 @@ void Hookshot::setHookPos(Pos3 &pos)
 }
 
 bool Hookshot::update(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   float timeMs,
   InputApi &input,
   SoundMgr *pSoundMgr)
 {
-  updateLength(dev, devcon, m_length);
+  updateLength(dev, m_length);
   return true;
 }
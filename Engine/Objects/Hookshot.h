@@ -15,8 +15,7 @@ public:
   Hookshot();
 
   bool init(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     std::string &texFile,
     double length,
     double radius,
@@ -24,8 +23,7 @@ public:
     bool bStaticScreenLoc = false);
 
   void updateLength(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     double L);
 
   void updateLength(double L);
@@ -36,8 +34,7 @@ public:
   void setHookPos(Pos3 &pos);
 
   bool update(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     float timeMs,
     InputApi &input,
     SoundMgr *pSoundMgr);
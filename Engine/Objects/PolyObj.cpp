@@ -11,14 +11,13 @@ PolyObj::PolyObj()
 
 
 bool PolyObj::init(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   std::string &texFile,
   std::vector<Pos3Uv2> &verts,
   bool bStaticScreenLoc)
 {
   TexPoly* pTexPoly = new TexPoly;
-  if(!pTexPoly->init(dev, devcon, texFile, verts, bStaticScreenLoc))
+  if(!pTexPoly->init(dev, texFile, verts, bStaticScreenLoc))
   {
     LOGE("Failed to init TexPoly for PolyObj");
     return false;
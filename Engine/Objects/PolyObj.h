@@ -12,8 +12,7 @@ public:
   PolyObj();
 
   bool init(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     std::string &texFile,
     std::vector<Pos3Uv2> &verts,
     bool bStaticScreenLoc = false);
@@ -2,6 +2,7 @@
 #include "CommonPhysConsts.h"
 #include <algorithm>
 #include "Logger.h"
+#include "Util.h"
 #include "PhysicsModels/CollisionModel.h"
 
 PhysicsManager::PhysicsManager()
@@ -10,6 +11,8 @@ PhysicsManager::PhysicsManager()
   m_maxStepsPerFrame  = MAX_STEPS_PER_FRAME;
   m_lastTimeMs        = 0.0;
   m_accumTimeMs       = 0.0;
+  m_bLodEn            = false;
+  m_lodStepCnt        = 0;
 }
 
 
@@ -48,12 +51,120 @@ bool PhysicsManager::registerModel(uint64_t uuid, PModelInput *pModelInput)
   return true;
 }
 
-// Second entry in the input pair is the collision ordering metric.
-bool _collisionCompare(CollisionVectorEntry &i, CollisionVectorEntry &j)
+// Use focus (usually the camera location) as the reference point for physics level-of-detail tiers.
+void PhysicsManager::setLodFocus(const Pos3 &focus)
 {
-  return i.second < j.second;
+  m_bLodEn = true;
+  m_lodFocus = focus;
 }
 
+
+void PhysicsManager::updateLodTier(PmModelStorage &storage)
+{
+  if (!m_bLodEn)
+  {
+    storage.lodTier = PHYS_LOD_TIER_ACTIVE;
+    return;
+  }
+
+  PhysicsModel *pModel = storage.in.pModel;
+  CollisionModel *pCollision = pModel ? pModel->getCollisionModel() : NULL;
+  if (pModel && !pModel->getPuModel() && pCollision && pCollision->getType() == COLLISION_MODEL_AABB_IMMOBILE)
+  {
+    storage.lodTier = PHYS_LOD_TIER_STATIC;
+    return;
+  }
+
+  float focusDist2 = dist2(storage.in.pos, m_lodFocus);
+  if (focusDist2 <= PHYS_LOD_ACTIVE_DIST_2)
+  {
+    storage.lodTier = PHYS_LOD_TIER_ACTIVE;
+  }
+  else if (focusDist2 <= PHYS_LOD_REDUCED_DIST_2)
+  {
+    storage.lodTier = PHYS_LOD_TIER_REDUCED;
+  }
+  else
+  {
+    storage.lodTier = PHYS_LOD_TIER_FROZEN;
+  }
+
+  if (storage.lodTier != PHYS_LOD_TIER_FROZEN)
+  {
+    storage.bLodBacklogDropped = false;
+  }
+}
+
+
+// Account for one more step of simulation time and decide if the model runs during this step.
+// If it does, lodStepScale is set to the number of owed steps it should cover. Models catching up from
+// a frozen/reduced tier work off their backlog a few steps at a time instead of all at once.
+bool PhysicsManager::lodTick(uint64_t uuid, PmModelStorage &storage)
+{
+  storage.lodStepScale = 1;
+
+  switch (storage.lodTier)
+  {
+    case PHYS_LOD_TIER_STATIC:
+    {
+      return false;
+    }
+    case PHYS_LOD_TIER_FROZEN:
+    {
+      // Frozen for too long to catch up believably. Drop the whole backlog and stop banking steps until the model
+      // leaves the frozen tier, so it resumes from where it was frozen rather than simulating an arbitrary part of
+      // the time it missed.
+      if (!storage.bLodBacklogDropped && ++storage.lodOwedSteps > PHYS_LOD_MAX_BANKED_STEPS)
+      {
+        storage.lodOwedSteps = 0;
+        storage.bLodBacklogDropped = true;
+        m_stats.lodResets++;
+      }
+      return false;
+    }
+    case PHYS_LOD_TIER_REDUCED:
+    {
+      // Each model ticks on its own phase of the cycle, so the tier's work is spread over the steps rather than all
+      // landing on the same one.
+      storage.lodOwedSteps++;
+      if ((m_lodStepCnt + uuid) % PHYS_LOD_REDUCED_STEP_DIV != 0)
+      {
+        return false;
+      }
+      break;
+    }
+    default:
+    {
+      storage.lodOwedSteps++;
+      break;
+    }
+  }
+
+  storage.lodStepScale = std::min<uint32_t>(storage.lodOwedSteps, PHYS_LOD_REDUCED_STEP_DIV);
+  storage.lodOwedSteps -= storage.lodStepScale;
+  return true;
+}
+
+void PhysicsManager::checkCollision(PmModelStorage &first, PmModelStorage &second)
+{
+  // Should run in order of collisions, i.e. handle the first hit, so that any subsequent hits
+  // get handled using the result of the earlier ones.
+  // Note that this doesn't account for any new objects that might be hit due to altered trajectories
+  // from earlier hit handling.
+  OrderingMetric collisionOrderMetric;
+  m_stats.pairChecks++;
+  if (CollisionModel::modelsCollide(&first, &second, &collisionOrderMetric))
+  {
+    m_stats.collisions++;
+
+    // Add each other to the collisions list for later object-level processing.
+    // Lists are kept in time-order as entries are added.
+    first.out.collisions.insert(std::make_pair(&second, collisionOrderMetric));
+    second.out.collisions.insert(std::make_pair(&first, collisionOrderMetric));
+  }
+}
+
+
 bool PhysicsManager::run(double timeMs)
 {
   // Clean old models
@@ -67,6 +178,7 @@ bool PhysicsManager::run(double timeMs)
     {
       // Clear old collision info.
       it->second.out.collisions.clear();
+      updateLodTier(it->second);
       ++it;
     }
   }
@@ -78,7 +190,7 @@ bool PhysicsManager::run(double timeMs)
 
   //LOGD("timeMs %f, lastTimeMs %f, deltaMs %f, accumMs %f", timeMs, m_lastTimeMs, deltaMs, m_accumTimeMs);
   uint32_t stepsToRun = m_accumTimeMs / m_stepSizeMs;
-  stepsToRun = min(stepsToRun, m_maxStepsPerFrame);
+  stepsToRun = std::min<uint32_t>(stepsToRun, m_maxStepsPerFrame);
   m_accumTimeMs -= stepsToRun * m_stepSizeMs;
 
   // If there's still a large backlog, just process what we can and start fresh for the next frame.
@@ -95,69 +207,117 @@ bool PhysicsManager::run(double timeMs)
     bool bLastStep = stepsCompleted + 1 >= stepsToRun;
     bool bSkipProc = stepsCompleted >= stepsToRun;  //Should catch the case of 0 steps.
 
+    if (!bSkipProc)
+    {
+      m_stats.steps++;
+    }
+
+    // Models covering several steps at once (physics LOD) run them as back-to-back sub-steps, so update models only
+    // ever see normal step sizes. Collisions are checked after every sub-step, so a model can't skip past something
+    // thinner than its whole movement. Sub-steps are lined up to end together: a model covering N steps runs in the
+    // last N, so every model that ticks moves during the last sub-step and ends the step at the same time. Steps with
+    // only active models have a single sub-step.
+    uint32_t subStepCnt = 1;
     for (std::map<uint64_t, PmModelStorage>::iterator it = m_registeredModelMap.begin(); it != m_registeredModelMap.end(); ++it)
     {
       // Copy input into output, i.e. NULL operation is default in case processing doesn't do anything (either by choice or mistake).
       PhysicsModel::prePhysInputToOutputTransfer(&it->second.in, &it->second.out);
 
-      if (!bSkipProc)
+      it->second.bLodTick = !bSkipProc && lodTick(it->first, it->second);
+      if (it->second.bLodTick)
       {
-        // Currently not passing any other objects during processing.
-        PhysicsModel::runPuModel(it->second.in, NULL, it->second.out);
+        subStepCnt = std::max<uint32_t>(subStepCnt, it->second.lodStepScale);
       }
     }
 
-    // 2nd loop: Now run collision checks on the updated locations, run any physics - model level collision handling.
-    for (std::map<uint64_t, PmModelStorage>::iterator itFirst = m_registeredModelMap.begin(); itFirst != m_registeredModelMap.end(); ++itFirst)
+    for (uint32_t subStep = 0; subStep < subStepCnt; subStep++)
     {
-      if (!bSkipProc)
+      bool bLastSubStep = subStep + 1 >= subStepCnt;
+
+      m_subStepTickers.clear();
+      for (std::map<uint64_t, PmModelStorage>::iterator it = m_registeredModelMap.begin(); it != m_registeredModelMap.end(); ++it)
       {
-        std::map<uint64_t, PmModelStorage>::iterator itSecond = itFirst;
-        ++itSecond;
-        for (; itSecond != m_registeredModelMap.end(); ++itSecond)
+        uint32_t firstSubStep = subStepCnt - it->second.lodStepScale;
+        it->second.bSubStepTick = it->second.bLodTick && subStep >= firstSubStep;
+        if (it->second.bSubStepTick)
         {
-          //LOGD("DBG: Checking collision, obj %u and %u", itFirst->first, itSecond->first);
-
-          // Should run in order of collisions, i.e. handle the first hit, so that any subsequent hits
-          // get handled using the result of the earlier ones.
-          // Note that this doesn't account for any new objects that might be hit due to altered trajectories
-          // from earlier hit handling.
-          OrderingMetric collisionOrderMetric;
-          if (CollisionModel::modelsCollide(&(itFirst->second), &(itSecond->second), &collisionOrderMetric))
-          {
-            //LOGD("DBG: Model collision, obj %u and %u", itFirst->first, itSecond->first);
+          m_subStepTickers.push_back(it);
 
-            // Add each other to the collisions list for later object-level processing.
-            // Set will automatically check that collision info isn't already present,
-            // ex. from a previous step in the same frame processing.
-            itFirst->second.out.collisions.push_back(std::make_pair(&(itSecond->second), collisionOrderMetric));
-            itSecond->second.out.collisions.push_back(std::make_pair(&(itFirst->second), collisionOrderMetric));
+          if (subStep > firstSubStep)
+          {
+            PhysicsModel::interStepOutputToInputTransfer(&it->second.out, &it->second.in);
+            PhysicsModel::prePhysInputToOutputTransfer(&it->second.in, &it->second.out);
           }
+
+          // Currently not passing any other objects during processing.
+          PhysicsModel::runPuModel(it->second.in, NULL, it->second.out);
+          m_stats.modelSteps++;
         }
       }
 
-      // Sort collisions in time-order.
-      std::sort(itFirst->second.out.collisions.begin(), itFirst->second.out.collisions.end(), _collisionCompare);
-
-      int cnt = 0;
-      for (auto itColl = itFirst->second.out.collisions.begin(); itColl != itFirst->second.out.collisions.end(); ++itColl)
+      // 2nd loop: Now run collision checks on the updated locations, run any physics - model level collision handling.
+      // Pairs are checked in map order. Models that didn't move this sub-step only need checking against the ones
+      // that did, which are only models catching up before the last sub-step.
+      size_t nextTicker = 0;
+      for (std::map<uint64_t, PmModelStorage>::iterator itFirst = m_registeredModelMap.begin(); itFirst != m_registeredModelMap.end(); ++itFirst)
       {
-        CollisionModel::handleCollision(&(itFirst->second), itColl->first, cnt++);
-      }
+        while (nextTicker < m_subStepTickers.size() && m_subStepTickers[nextTicker]->first <= itFirst->first)
+        {
+          nextTicker++;
+        }
 
-      if (!bLastStep)
-      {
-        // Copy over output into input in case we're running multiple steps.
-        PhysicsModel::interStepOutputToInputTransfer(&itFirst->second.out, &itFirst->second.in);
-      }
-      else
-      {
-        // On last step (or nonexistent step in case we run 0 steps this frame), clear active flag.
-        // If we have further processing for this object, it'll re-register for the next frame.
-        itFirst->second.bActive = false;
+        if (!bSkipProc && itFirst->second.bSubStepTick)
+        {
+          std::map<uint64_t, PmModelStorage>::iterator itSecond = itFirst;
+          ++itSecond;
+          for (; itSecond != m_registeredModelMap.end(); ++itSecond)
+          {
+            checkCollision(itFirst->second, itSecond->second);
+          }
+        }
+        else if (!bSkipProc)
+        {
+          // Neither model moved for any of the pairs with the rest, so nothing new to check there.
+          for (size_t ticker = nextTicker; ticker < m_subStepTickers.size(); ticker++)
+          {
+            checkCollision(itFirst->second, m_subStepTickers[ticker]->second);
+          }
+        }
+
+        // Models handle their hits after each of their own sub-steps, so the next one starts from the resolved
+        // position. Models that didn't tick handle theirs once, at the end of the step.
+        if (itFirst->second.bSubStepTick || bLastSubStep)
+        {
+          int cnt = 0;
+          for (auto itColl = itFirst->second.out.collisions.begin(); itColl != itFirst->second.out.collisions.end(); ++itColl)
+          {
+            CollisionModel::handleCollision(&(itFirst->second), itColl->first, cnt++);
+          }
+        }
+
+        if (!bLastSubStep)
+        {
+          continue;
+        }
+
+        if (!bLastStep)
+        {
+          // Copy over output into input in case we're running multiple steps.
+          PhysicsModel::interStepOutputToInputTransfer(&itFirst->second.out, &itFirst->second.in);
+        }
+        else
+        {
+          // On last step (or nonexistent step in case we run 0 steps this frame), clear active flag.
+          // If we have further processing for this object, it'll re-register for the next frame.
+          itFirst->second.bActive = false;
+        }
       }
     }
 
+    if (!bSkipProc)
+    {
+      m_lodStepCnt++;
+    }
     stepsCompleted++;
   } while (stepsCompleted < stepsToRun);
 
@@ -178,4 +338,16 @@ bool PhysicsManager::getResult(uint64_t uuid, PModelOutput *pModelOutput)
 
   *pModelOutput = it->second.out;
   return true;
+}
+
+
+const PhysicsStats& PhysicsManager::getStats()
+{
+  return m_stats;
+}
+
+
+void PhysicsManager::resetStats()
+{
+  m_stats = PhysicsStats();
 }
\ No newline at end of file
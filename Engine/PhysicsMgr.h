@@ -4,16 +4,55 @@
 #include "CommonTypes.h"
 #include "PhysicsModel.h"
 #include <map>
+#include <vector>
 
 
+// Simulation tier for a registered model, based on its distance from the LOD focus.
+typedef enum PhysLodTier_
+{
+  PHYS_LOD_TIER_ACTIVE = 0,
+  PHYS_LOD_TIER_REDUCED,
+  PHYS_LOD_TIER_FROZEN,
+  PHYS_LOD_TIER_STATIC      // Can't move at all, only checked against models that do.
+} PhysLodTier;
+
 class PmModelStorage
 {
 public:
   bool          bActive;  // Mark active when registered, cleared after run (so we can remove/reuse entries from model map.
   PModelInput   in;
   PModelOutput  out;
+
+  // LOD state. Persists across frames as long as the model keeps re-registering.
+  PhysLodTier   lodTier;
+  uint32_t      lodOwedSteps;   // Steps this model hasn't simulated yet.
+  bool          bLodBacklogDropped; // Set once a frozen model drops its backlog, until it leaves the frozen tier.
+  uint32_t      lodStepScale;   // Number of base steps (sub-steps) covered by the model's current step (1 = normal step).
+  bool          bLodTick;       // Set if the model is simulated during the current step.
+  bool          bSubStepTick;   // Set if the model is simulated during the current sub-step.
+
+  PmModelStorage()
+  {
+    bActive       = false;
+    lodTier       = PHYS_LOD_TIER_ACTIVE;
+    lodOwedSteps  = 0;
+    bLodBacklogDropped = false;
+    lodStepScale  = 1;
+    bLodTick      = false;
+    bSubStepTick  = false;
+  }
 };
 
+// Running counters, useful for profiling/benchmarking the collision path.
+typedef struct PhysicsStats_
+{
+  uint64_t steps{ 0 };        // Physics steps run.
+  uint64_t pairChecks{ 0 };   // Model pairs run through a collision check.
+  uint64_t collisions{ 0 };   // Pair checks that found a collision.
+  uint64_t modelSteps{ 0 };   // Update model runs, one per model per (sub-)step it's simulated for.
+  uint64_t lodResets{ 0 };    // Frozen models that fell more than PHYS_LOD_MAX_BANKED_STEPS behind and dropped them.
+} PhysicsStats;
+
 class PhysicsManager
 {
 private:
@@ -22,15 +61,33 @@ private:
   double    m_lastTimeMs;
   double    m_accumTimeMs;
 
+  // LOD is disabled until a focus point is provided, i.e. every model runs in the active tier.
+  bool      m_bLodEn;
+  Pos3      m_lodFocus;
+  uint64_t  m_lodStepCnt;   // Steps run so far, picks which reduced models tick during a step.
+
   std::map<uint64_t, PmModelStorage> m_registeredModelMap;
 
+  // Models simulated during the current sub-step, in map order.
+  std::vector<std::map<uint64_t, PmModelStorage>::iterator> m_subStepTickers;
+
+  PhysicsStats m_stats;
+
+  void updateLodTier(PmModelStorage &storage);
+  bool lodTick(uint64_t uuid, PmModelStorage &storage);
+  void checkCollision(PmModelStorage &first, PmModelStorage &second);
+
 public:
   PhysicsManager();
   ~PhysicsManager();
   bool release();
   bool registerModel(uint64_t uuid, PModelInput *pModelInput);
+  void setLodFocus(const Pos3 &focus);
   bool run(double timeMs);
   bool getResult(uint64_t uuid, PModelOutput *pModelOutput);
+
+  const PhysicsStats& getStats();
+  void resetStats();
 };
 
 #endif
\ No newline at end of file
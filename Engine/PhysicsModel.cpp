@@ -4,6 +4,8 @@
 #include "Logger.h"
 #include "PhysicsModels/CollisionModel.h"
 
+DEFINE_POOL_ALLOCATED(PhysicsModel)
+
 
 PhysicsModel::PhysicsModel()
 {
@@ -12,6 +14,11 @@ PhysicsModel::PhysicsModel()
 }
 
 
+PhysicsModel::~PhysicsModel()
+{
+}
+
+
 void PhysicsModel::setPuModel(PhysicsUpdateModel *pUpdateModel)
 {
   m_pUpdateModel = pUpdateModel;
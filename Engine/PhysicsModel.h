@@ -2,6 +2,8 @@
 #define PHYSICS_MODEL_H
 
 #include "CommonTypes.h"
+#include "PoolAllocator.h"
+#include <stdint.h>
 #include <vector>
 
 class CollisionModel;
@@ -27,6 +29,94 @@ public:
 
 typedef std::pair<PmModelStorage*, OrderingMetric> CollisionVectorEntry;
 
+// Collision entries for one model, always kept in OrderingMetric order.
+// Entries are placed with an insertion step as they're added (equal metrics keep arrival order), so there's no separate
+// sort pass. Within a frame the list keeps growing across steps; the already-ordered entries from earlier steps are
+// reused as-is and new ones usually land at the tail.
+// Most models have a handful of contacts, so those live in an inline array; larger lists spill to the heap.
+class CollisionList
+{
+public:
+  static const uint32_t INLINE_CAPACITY = 4;
+
+private:
+  CollisionVectorEntry              m_inline[INLINE_CAPACITY];
+  std::vector<CollisionVectorEntry> m_spill;
+  uint32_t                          m_size{ 0 };
+
+public:
+  CollisionVectorEntry* begin()
+  {
+    return m_size > INLINE_CAPACITY ? m_spill.data() : m_inline;
+  }
+
+  CollisionVectorEntry* end()
+  {
+    return begin() + m_size;
+  }
+
+  const CollisionVectorEntry* begin() const
+  {
+    return m_size > INLINE_CAPACITY ? m_spill.data() : m_inline;
+  }
+
+  const CollisionVectorEntry* end() const
+  {
+    return begin() + m_size;
+  }
+
+  uint32_t size() const
+  {
+    return m_size;
+  }
+
+  bool empty() const
+  {
+    return m_size == 0;
+  }
+
+  CollisionVectorEntry& operator[] (uint32_t idx)
+  {
+    return begin()[idx];
+  }
+
+  // Keeps spilled capacity around so steady-state frames don't reallocate.
+  void clear()
+  {
+    m_spill.clear();
+    m_size = 0;
+  }
+
+  void insert(const CollisionVectorEntry &entry)
+  {
+    if (m_size == INLINE_CAPACITY)
+    {
+      m_spill.assign(m_inline, m_inline + INLINE_CAPACITY);
+    }
+
+    CollisionVectorEntry *pEntries;
+    if (m_size >= INLINE_CAPACITY)
+    {
+      m_spill.push_back(entry);
+      pEntries = m_spill.data();
+    }
+    else
+    {
+      m_inline[m_size] = entry;
+      pEntries = m_inline;
+    }
+
+    // Shift the new entry down past anything with a larger metric. Already in order (the common case) costs one compare.
+    uint32_t idx = m_size++;
+    while (idx > 0 && entry.second < pEntries[idx - 1].second)
+    {
+      pEntries[idx] = pEntries[idx - 1];
+      idx--;
+    }
+    pEntries[idx] = entry;
+  }
+};
+
 class PModelOutput
 {
 public:
@@ -36,9 +126,9 @@ public:
   Pos3  rotVel;
 
   // Collection of other objects (via their PmModelStorage ptrs) that this object collided with.
-  // Collisions should be stored temporally in terms of when the collision happened.
+  // Collisions are stored temporally in terms of when the collision happened.
   // The pair is <pModel, collisionTimeInPastMs>.
-  std::vector<CollisionVectorEntry> collisions;
+  CollisionList collisions;
 };
 
 // Base class for physics (including user input) handling.
@@ -49,7 +139,11 @@ protected:
   CollisionModel     *m_pCollisionModel;
 
 public:
+  DECLARE_POOL_ALLOCATED()
+
   PhysicsModel();
+  // Models are deleted through PhysicsModel pointers (see GameObject::release and EntityRegistry::destroy).
+  virtual ~PhysicsModel();
 
   static void prePhysInputToOutputTransfer(PModelInput *pIn, PModelOutput *pOut);
   static void interStepOutputToInputTransfer(PModelOutput *pOut, PModelInput *pIn);
@@ -5,6 +5,7 @@
 #include "CollisionModels/AABB.h"
 #include "CollisionModels/AABBControllable.h"
 #include "../Util.h"
+#include <cmath>
 
 CollisionModel::CollisionModel()
 {
@@ -12,6 +13,11 @@ CollisionModel::CollisionModel()
 }
 
 
+CollisionModel::~CollisionModel()
+{
+}
+
+
 CollisionModelType CollisionModel::getType()
 {
   return m_type;
@@ -116,16 +122,8 @@ bool CollisionModel::modelsCollideAabbAabb(PmModelStorage *pFirst, PmModelStorag
   AABB *pFirstModelAabb = static_cast<AABB*>(firstModel);
   AABB *pSecondModelAabb = static_cast<AABB*>(secondModel);
 
-  // TODO: Implement +/- operator for Pos3
-  firstBoxPos = pFirstModelAabb->getPos();
-  firstBoxPos.pos.x += firstObjPos.pos.x;
-  firstBoxPos.pos.y += firstObjPos.pos.y;
-  firstBoxPos.pos.z += firstObjPos.pos.z;
-
-  secondBoxPos = pSecondModelAabb->getPos();
-  secondBoxPos.pos.x += secondObjPos.pos.x;
-  secondBoxPos.pos.y += secondObjPos.pos.y;
-  secondBoxPos.pos.z += secondObjPos.pos.z;
+  firstBoxPos = pFirstModelAabb->getPos() + firstObjPos;
+  secondBoxPos = pSecondModelAabb->getPos() + secondObjPos;
 
   Pos3 firstDim = pFirstModelAabb->getDim();
   Pos3 secondDim = pSecondModelAabb->getDim();
@@ -158,9 +156,9 @@ bool CollisionModel::modelsCollideAabbAabb(PmModelStorage *pFirst, PmModelStorag
       distZ);
 
     float timeInPast = 0.0;
-    if (firstObjVel.pos.x != 0.0) timeInPast = std::fminf(timeInPast, -distX / firstObjVel.pos.x);
-    if (firstObjVel.pos.y != 0.0) timeInPast = std::fminf(timeInPast, -distY / firstObjVel.pos.y);
-    if (firstObjVel.pos.z != 0.0) timeInPast = std::fminf(timeInPast, -distZ / firstObjVel.pos.z);
+    if (firstObjVel.pos.x != 0.0) timeInPast = std::fmin(timeInPast, -distX / firstObjVel.pos.x);
+    if (firstObjVel.pos.y != 0.0) timeInPast = std::fmin(timeInPast, -distY / firstObjVel.pos.y);
+    if (firstObjVel.pos.z != 0.0) timeInPast = std::fmin(timeInPast, -distZ / firstObjVel.pos.z);
 
     pCollisionOrderMetric->primary = timeInPast;
 
@@ -177,9 +175,9 @@ bool CollisionModel::modelsCollideAabbAabb(PmModelStorage *pFirst, PmModelStorag
       clearTimeInFutureZ);
 
     float minClearTime = MAX_COLLISION_DIST;
-    if (firstObjVel.pos.x != 0.0) minClearTime = std::fminf(minClearTime, clearTimeInFutureX);
-    if (firstObjVel.pos.y != 0.0) minClearTime = std::fminf(minClearTime, clearTimeInFutureY);
-    if (firstObjVel.pos.z != 0.0) minClearTime = std::fminf(minClearTime, clearTimeInFutureZ);
+    if (firstObjVel.pos.x != 0.0) minClearTime = std::fmin(minClearTime, clearTimeInFutureX);
+    if (firstObjVel.pos.y != 0.0) minClearTime = std::fmin(minClearTime, clearTimeInFutureY);
+    if (firstObjVel.pos.z != 0.0) minClearTime = std::fmin(minClearTime, clearTimeInFutureZ);
 
     pCollisionOrderMetric->secondary = minClearTime;
 
@@ -247,7 +245,9 @@ void CollisionModel::handleCollision(PmModelStorage *pFirstIo, PmModelStorage *p
 }
 
 
+// Frees the model, which is owned by the PhysicsModel it was set on.
 bool CollisionModel::releaseCollisionModel(CollisionModel *pModel)
 {
+  delete pModel;
   return true;
 }
@@ -38,6 +38,8 @@ public:
   virtual void onCollision(PmModelStorage *pPrimaryIo, PmModelStorage *pOtherModelIo, int cnt);
 
   CollisionModel();
+  // Models are deleted through CollisionModel pointers (see releaseCollisionModel).
+  virtual ~CollisionModel();
   CollisionModelType getType();
   void setType(CollisionModelType type);
 };
@@ -1,6 +1,8 @@
 #include "AABB.h"
 #include "../../Logger.h"
 
+DEFINE_POOL_ALLOCATED(AABB)
+
 
 AABB::AABB()
 {
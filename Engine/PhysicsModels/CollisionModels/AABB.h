@@ -2,6 +2,7 @@
 #define AXIS_ALIGNED_BOUNDING_BOX_H
 
 #include "../CollisionModel.h"
+#include "../../PoolAllocator.h"
 
 class AABB : public CollisionModel
 {
@@ -11,6 +12,9 @@ protected:
   float m_depth;
 
 public:
+  // Immobile blocks all use a plain AABB. AABBControllable is a different size and uses the global heap.
+  DECLARE_POOL_ALLOCATED()
+
   AABB();
   AABB(float width, float height, float depth);
 
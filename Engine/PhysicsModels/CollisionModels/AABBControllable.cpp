@@ -41,13 +41,13 @@ void AABBControllable::onCollision(PmModelStorage *pPrimaryIo, PmModelStorage *p
 // Check if objects collide on the (input's) z axis.
 // This calculation makes use of the main objects velocity.
 void AABBControllable::CheckHitWImmobileBasedOnVel(
-  Pos3 &vel,
-  Pos3 &mainPos,
-  Pos3 &mainPosAabb,
-  Pos3 &mainDimAabb,
-  Pos3 &otherPos,
-  Pos3 &otherPosAabb,
-  Pos3 &otherDimAabb,
+  const Pos3 &vel,
+  const Pos3 &mainPos,
+  const Pos3 &mainPosAabb,
+  const Pos3 &mainDimAabb,
+  const Pos3 &otherPos,
+  const Pos3 &otherPosAabb,
+  const Pos3 &otherDimAabb,
   bool &bHitZ,
   float &distZ
   )
@@ -163,13 +163,13 @@ void AABBControllable::CheckHitsWImmobileBasedOnVel(
 // This calculation makes use of the main objects velocity.
 // Result is useful for object collision ordering.
 void AABBControllable::CheckClearWImmobileBasedOnVel(
-  Pos3 &vel,
-  Pos3 &mainPos,
-  Pos3 &mainPosAabb,
-  Pos3 &mainDimAabb,
-  Pos3 &otherPos,
-  Pos3 &otherPosAabb,
-  Pos3 &otherDimAabb,
+  const Pos3 &vel,
+  const Pos3 &mainPos,
+  const Pos3 &mainPosAabb,
+  const Pos3 &mainDimAabb,
+  const Pos3 &otherPos,
+  const Pos3 &otherPosAabb,
+  const Pos3 &otherDimAabb,
   float &clearTimeInFutureZ
   )
 {
@@ -346,7 +346,7 @@ bool AABBControllable::getJumpEn()
 }
 
 
-void AABBControllable::setWallJumpNormal(Pos2 &normal)
+void AABBControllable::setWallJumpNormal(const Pos2 &normal)
 {
   m_wallJumpNormal = normal;
 }
@@ -24,13 +24,13 @@ public:
   AABBControllable(float w, float h, float d);
 
   static void CheckHitWImmobileBasedOnVel(
-    Pos3 &vel,
-    Pos3 &mainPos,
-    Pos3 &mainPosAabb,
-    Pos3 &mainDimAabb,
-    Pos3 &otherPos,
-    Pos3 &otherPosAabb,
-    Pos3 &otherDimAabb,
+    const Pos3 &vel,
+    const Pos3 &mainPos,
+    const Pos3 &mainPosAabb,
+    const Pos3 &mainDimAabb,
+    const Pos3 &otherPos,
+    const Pos3 &otherPosAabb,
+    const Pos3 &otherDimAabb,
     bool &bHitZ,
     float &distZ);
 
@@ -48,13 +48,13 @@ public:
     float &distZ);
 
   static void CheckClearWImmobileBasedOnVel(
-    Pos3 &vel,
-    Pos3 &mainPos,
-    Pos3 &mainPosAabb,
-    Pos3 &mainDimAabb,
-    Pos3 &otherPos,
-    Pos3 &otherPosAabb,
-    Pos3 &otherDimAabb,
+    const Pos3 &vel,
+    const Pos3 &mainPos,
+    const Pos3 &mainPosAabb,
+    const Pos3 &mainDimAabb,
+    const Pos3 &otherPos,
+    const Pos3 &otherPosAabb,
+    const Pos3 &otherDimAabb,
     float &clearTimeInFutureZ);
 
   static void CheckClearsWImmobileBasedOnVel(
@@ -70,7 +70,7 @@ public:
   virtual void setJumpEn(bool bJumpEn);
   virtual bool getJumpEn();
 
-  virtual void setWallJumpNormal(Pos2 &normal);
+  virtual void setWallJumpNormal(const Pos2 &normal);
   virtual Pos2 getWallJumpNormal();
 
   virtual void onCollision(PmModelStorage *pPrimaryIo, PmModelStorage *pOtherModelIo, int cnt);
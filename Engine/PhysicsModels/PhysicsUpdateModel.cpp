@@ -1,6 +1,11 @@
 #include "PhysicsUpdateModel.h"
 #include "../Logger.h"
-#include "PhysicsUpdateModels\GravityModel.h"
+#include "PhysicsUpdateModels/GravityModel.h"
+
+PhysicsUpdateModel::~PhysicsUpdateModel()
+{
+}
+
 
 PhysicsUpdateModelType PhysicsUpdateModel::getType()
 {
@@ -67,23 +72,7 @@ bool PhysicsUpdateModel::releasePuModel(PhysicsUpdateModel *pModel)
     return true;
   }
 
-  PhysicsUpdateModelType pmType = pModel->getType();
-  switch (pmType)
-  {
-    case PHYSICS_UPDATE_MODEL_NONE:
-    {
-      return pModel->release();
-    }
-    case PHYSICS_UPDATE_MODEL_GRAVITY:
-    {
-      return static_cast<GravityModel*>(pModel)->release();
-    }
-    default:
-    {
-      LOGE("PuModel type not recognized: %d", pmType);
-      return false;
-    }
-  }
-
-  return false;
+  bool bSuccess = pModel->release();
+  delete pModel;
+  return bSuccess;
 }
@@ -27,6 +27,9 @@ public:
     PModelInput *otherModels[],
     PModelOutput &output);
 
+  // Models are deleted through PhysicsUpdateModel pointers (see releasePuModel).
+  virtual ~PhysicsUpdateModel();
+
   PhysicsUpdateModelType getType();
 
   virtual bool run(
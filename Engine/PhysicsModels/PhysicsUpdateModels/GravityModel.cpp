@@ -1,6 +1,7 @@
 #include "GravityModel.h"
 #include "../../CommonPhysConsts.h"
 #include "../../Logger.h"
+#include <cmath>
 
 
 GravityModel::GravityModel()
@@ -16,8 +17,8 @@ bool GravityModel::run(
 {
   float yVel = pModelInput.vel.pos.y;
   yVel += (GRAVITY_MODEL_G_MPSPS * MPSPS_TO_UNIT_PER_STEP_PER_STEP);
-  yVel = max(yVel, GRAVITY_MODEL_MIN_V_MPS * MPS_TO_UNITS_PER_STEP);
-  yVel = min(yVel, GRAVITY_MODEL_MAX_V_MPS * MPS_TO_UNITS_PER_STEP);
+  yVel = std::fmax(yVel, GRAVITY_MODEL_MIN_V_MPS * MPS_TO_UNITS_PER_STEP);
+  yVel = std::fmin(yVel, GRAVITY_MODEL_MAX_V_MPS * MPS_TO_UNITS_PER_STEP);
   
   // Everything is in terms of units / step now.
   output.vel.pos.y = yVel;
@@ -0,0 +1,232 @@
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#define POOL_ALLOCATOR_SLAB_ITEMS  1024
+
+typedef struct PoolAllocatorStats_
+{
+  uint32_t slabs{ 0 };
+  uint32_t capacity{ 0 };     // Items that fit in the current slabs.
+  uint32_t liveItems{ 0 };
+  uint64_t allocs{ 0 };
+  uint64_t slabAllocs{ 0 };   // Trips to the system allocator.
+} PoolAllocatorStats;
+
+// Fixed size allocator for one class, used through class-level operator new/delete (see DECLARE_POOL_ALLOCATED).
+// Items are carved out of large slabs and recycled through a free list, so a scene's worth of objects only costs a
+// few system allocations, and they end up next to each other instead of spread across the heap. Freed items stay in
+// the pool for the next load or streamed chunk, trim() gives whole empty slabs back to the system.
+//
+// Derived classes inherit operator new, those are a different size and fall through to the global heap. A disabled
+// pool sends everything there, which is how benchmarks tell each pool's share of the win apart.
+// Scene loading and streaming build objects on worker threads, so alloc/free are locked.
+template <typename T>
+class PoolAllocator
+{
+private:
+  typedef union Item_
+  {
+    union Item_  *pNext;
+    alignas(T) unsigned char storage[sizeof(T)];
+  } Item;
+
+  std::vector<Item*>  m_slabs;
+  Item               *m_pFreeList{ NULL };
+  PoolAllocatorStats  m_stats;
+  std::mutex          m_mutex;
+  bool                m_bEnabled{ true };
+  uint32_t            m_heapItems{ 0 };     // Allocated from the global heap while disabled, and still live.
+
+  void addSlab()
+  {
+    Item *pSlab = static_cast<Item*>(::operator new(sizeof(Item) * POOL_ALLOCATOR_SLAB_ITEMS));
+    m_slabs.push_back(pSlab);
+
+    // Thread the free list in address order, so consecutive allocations are adjacent.
+    for (uint32_t i = POOL_ALLOCATOR_SLAB_ITEMS; i > 0; i--)
+    {
+      pSlab[i - 1].pNext = m_pFreeList;
+      m_pFreeList = &pSlab[i - 1];
+    }
+
+    m_stats.slabs++;
+    m_stats.capacity += POOL_ALLOCATOR_SLAB_ITEMS;
+    m_stats.slabAllocs++;
+  }
+
+  // Only valid with m_slabs sorted.
+  size_t slabIdx(Item *pItem)
+  {
+    return std::upper_bound(m_slabs.begin(), m_slabs.end(), pItem) - m_slabs.begin() - 1;
+  }
+
+public:
+  ~PoolAllocator()
+  {
+    for (size_t i = 0; i < m_slabs.size(); i++)
+    {
+      ::operator delete(m_slabs[i]);
+    }
+  }
+
+  void* alloc(size_t size)
+  {
+    if (size != sizeof(T))
+    {
+      return ::operator new(size);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_bEnabled)
+    {
+      m_heapItems++;
+      return ::operator new(size);
+    }
+
+    if (!m_pFreeList)
+    {
+      addSlab();
+    }
+
+    Item *pItem = m_pFreeList;
+    m_pFreeList = pItem->pNext;
+    m_stats.liveItems++;
+    m_stats.allocs++;
+    return pItem;
+  }
+
+  void free(void *p, size_t size)
+  {
+    if (!p)
+    {
+      return;
+    }
+
+    if (size != sizeof(T))
+    {
+      ::operator delete(p);
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_bEnabled)
+    {
+      m_heapItems--;
+      ::operator delete(p);
+      return;
+    }
+
+    Item *pItem = static_cast<Item*>(p);
+    pItem->pNext = m_pFreeList;
+    m_pFreeList = pItem;
+
+    m_stats.liveItems--;
+  }
+
+  // Only switches while nothing is allocated, so every item is freed the same way it was allocated. Returns false if
+  // it couldn't.
+  bool setEnabled(bool bEnabled)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stats.liveItems || m_heapItems)
+    {
+      return bEnabled == m_bEnabled;
+    }
+
+    m_bEnabled = bEnabled;
+    return true;
+  }
+
+  // Hands slabs with no live items back to the system, ex. once the previous scene is gone. Returns slabs released.
+  uint32_t trim()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_slabs.empty())
+    {
+      return 0;
+    }
+
+    // Count free items per slab. Slabs are sorted so an item's slab can be found with a binary search.
+    std::sort(m_slabs.begin(), m_slabs.end());
+    std::vector<uint32_t> freeCnts(m_slabs.size(), 0);
+    for (Item *pItem = m_pFreeList; pItem; pItem = pItem->pNext)
+    {
+      freeCnts[slabIdx(pItem)]++;
+    }
+
+    // Keep the free items of the surviving slabs, in address order, before releasing the rest.
+    std::vector<Item*> freeItems;
+    for (Item *pItem = m_pFreeList; pItem; pItem = pItem->pNext)
+    {
+      if (freeCnts[slabIdx(pItem)] != POOL_ALLOCATOR_SLAB_ITEMS)
+      {
+        freeItems.push_back(pItem);
+      }
+    }
+    std::sort(freeItems.begin(), freeItems.end());
+
+    std::vector<Item*> keptSlabs;
+    uint32_t releasedCnt = 0;
+    for (size_t i = 0; i < m_slabs.size(); i++)
+    {
+      if (freeCnts[i] == POOL_ALLOCATOR_SLAB_ITEMS)
+      {
+        ::operator delete(m_slabs[i]);
+        releasedCnt++;
+      }
+      else
+      {
+        keptSlabs.push_back(m_slabs[i]);
+      }
+    }
+
+    m_pFreeList = NULL;
+    for (size_t i = freeItems.size(); i > 0; i--)
+    {
+      freeItems[i - 1]->pNext = m_pFreeList;
+      m_pFreeList = freeItems[i - 1];
+    }
+
+    m_slabs.swap(keptSlabs);
+    m_stats.slabs = static_cast<uint32_t>(m_slabs.size());
+    m_stats.capacity = m_stats.slabs * POOL_ALLOCATOR_SLAB_ITEMS;
+    return releasedCnt;
+  }
+
+  PoolAllocatorStats getStats()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+  }
+};
+
+// In the class declaration, routes new/delete of that class through a PoolAllocator.
+#define DECLARE_POOL_ALLOCATED() \
+  static void* operator new(size_t size); \
+  static void operator delete(void *p, size_t size); \
+  static PoolAllocatorStats getPoolStats(); \
+  static uint32_t trimPool(); \
+  static bool setPoolEnabled(bool bEnabled);
+
+// In the class's .cpp. The pool is a function-local static so it's in place before any other static initializer
+// could allocate from it.
+#define DEFINE_POOL_ALLOCATED(Type) \
+  static PoolAllocator<Type>& get##Type##Pool() \
+  { \
+    static PoolAllocator<Type> pool; \
+    return pool; \
+  } \
+  void* Type::operator new(size_t size) { return get##Type##Pool().alloc(size); } \
+  void Type::operator delete(void *p, size_t size) { get##Type##Pool().free(p, size); } \
+  PoolAllocatorStats Type::getPoolStats() { return get##Type##Pool().getStats(); } \
+  uint32_t Type::trimPool() { return get##Type##Pool().trim(); } \
+  bool Type::setPoolEnabled(bool bEnabled) { return get##Type##Pool().setEnabled(bEnabled); }
+
+#endif
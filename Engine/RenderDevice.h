@@ -0,0 +1,146 @@
+#ifndef RENDER_DEVICE_H
+#define RENDER_DEVICE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Resource handles. Only ever used as pointers, each backend decides what they point at (the D3D11 backend hands out
+// the D3D interfaces themselves).
+struct RenderBuffer;
+struct RenderVertexShader;
+struct RenderPixelShader;
+struct RenderInputLayout;
+struct RenderTexture;
+struct RenderSampler;
+
+typedef enum RenderBufferType_
+{
+  RENDER_BUFFER_VERTEX = 0,
+  RENDER_BUFFER_CONSTANT,
+  RENDER_BUFFER_INDEX           // 32 bit indices
+} RenderBufferType;
+
+typedef enum RenderVertexFormat_
+{
+  RENDER_VERTEX_POS3_UV2 = 0,     // Pos3Uv2
+  RENDER_VERTEX_BOX_INSTANCED     // BoxVertex per vertex, BoxInstance per instance (see BoxInstancer.h)
+} RenderVertexFormat;
+
+typedef enum RenderTopology_
+{
+  RENDER_TOPOLOGY_TRIANGLE_LIST = 0,
+  RENDER_TOPOLOGY_TRIANGLE_STRIP
+} RenderTopology;
+
+typedef enum RenderFilter_
+{
+  RENDER_FILTER_LINEAR = 0,
+  RENDER_FILTER_POINT
+} RenderFilter;
+
+typedef enum RenderAddressMode_
+{
+  RENDER_ADDRESS_WRAP = 0,
+  RENDER_ADDRESS_CLAMP
+} RenderAddressMode;
+
+// Constant buffer ranges (see setVsConstantBufferRange) must start at and span multiples of this many bytes.
+static const uint32_t RENDER_CONSTANT_RANGE_ALIGN = 256;
+
+typedef struct RenderSamplerDesc_
+{
+  RenderFilter      filter{ RENDER_FILTER_LINEAR };
+  RenderAddressMode address{ RENDER_ADDRESS_WRAP };
+} RenderSamplerDesc;
+
+// Everything the engine needs from a graphics API: resource creation, buffer uploads, pipeline state and draws.
+// D3D11RenderDevice is the game's backend, RecordingRenderDevice stands in for it in headless runs and counts what
+// rendering would have cost.
+//
+// Apart from compileShader, which needs no device and may run on loader threads, only call into a device from the
+// thread that owns it.
+class RenderDevice
+{
+protected:
+  virtual void releaseResource(void *pResource) = 0;
+
+  // For devices that wrap another device (see StateFilterRenderDevice) to pass releases on.
+  static void forwardRelease(RenderDevice *dev, void *pResource) { dev->releaseResource(pResource); }
+
+public:
+  virtual ~RenderDevice() {}
+
+  // Names what compileShader produces, so bytecode cached from one backend is never handed to another.
+  virtual const char *getShaderFormat() = 0;
+
+  // Compiles entryPoint in fileName for profile (ex. "vs_4_0") to bytecode for createVertexShader and friends.
+  // Models get their bytecode through gShaderCache instead of calling this directly.
+  virtual bool compileShader(
+    const std::string &fileName,
+    const char *entryPoint,
+    const char *profile,
+    std::vector<uint8_t> &bytecode) = 0;
+
+  virtual RenderVertexShader *createVertexShader(const std::vector<uint8_t> &bytecode) = 0;
+  virtual RenderPixelShader *createPixelShader(const std::vector<uint8_t> &bytecode) = 0;
+  virtual RenderInputLayout *createInputLayout(RenderVertexFormat format, const std::vector<uint8_t> &vsBytecode) = 0;
+
+  // Takes the contents of a texture file (dds, png, ...).
+  virtual RenderTexture *createTexture(const uint8_t *pFileData, size_t size) = 0;
+  virtual bool getTextureSize(RenderTexture *pTexture, uint32_t &width, uint32_t &height) = 0;
+  virtual RenderSampler *createSampler(const RenderSamplerDesc &desc) = 0;
+
+  // Buffers are CPU writable, pInitData may be NULL.
+  virtual RenderBuffer *createBuffer(RenderBufferType type, uint32_t byteWidth, const void *pInitData) = 0;
+
+  // Replaces the whole buffer (the old contents are discarded).
+  virtual bool updateBuffer(RenderBuffer *pBuffer, const void *pData, uint32_t byteWidth) = 0;
+
+  void release(RenderBuffer *pBuffer)             { releaseResource(pBuffer); }
+  void release(RenderVertexShader *pShader)       { releaseResource(pShader); }
+  void release(RenderPixelShader *pShader)        { releaseResource(pShader); }
+  void release(RenderInputLayout *pLayout)        { releaseResource(pLayout); }
+  void release(RenderTexture *pTexture)           { releaseResource(pTexture); }
+  void release(RenderSampler *pSampler)           { releaseResource(pSampler); }
+
+  virtual void setVertexShader(RenderVertexShader *pShader) = 0;
+  virtual void setPixelShader(RenderPixelShader *pShader) = 0;
+  virtual void setInputLayout(RenderInputLayout *pLayout) = 0;
+  virtual void setVsConstantBuffer(uint32_t slot, RenderBuffer *pBuffer) = 0;
+
+  // Binds byteSize bytes of pBuffer from byteOffset, so draws can each use their own part of one buffer that was
+  // uploaded once. Only if supportsConstantBufferRanges(), D3D11 needs 11.1 for it.
+  virtual bool supportsConstantBufferRanges() = 0;
+  virtual void setVsConstantBufferRange(
+    uint32_t slot,
+    RenderBuffer *pBuffer,
+    uint32_t byteOffset,
+    uint32_t byteSize) = 0;
+  virtual void setPsTexture(uint32_t slot, RenderTexture *pTexture) = 0;
+  virtual void setPsSampler(uint32_t slot, RenderSampler *pSampler) = 0;
+  virtual void setVertexBuffer(RenderBuffer *pBuffer, uint32_t stride) = 0;
+  virtual void setIndexBuffer(RenderBuffer *pBuffer) = 0;
+
+  // Per-instance data for instanced draws, read alongside the vertex buffer.
+  virtual void setInstanceBuffer(RenderBuffer *pBuffer, uint32_t stride) = 0;
+  virtual void setTopology(RenderTopology topology) = 0;
+
+  virtual void draw(uint32_t vertexCnt, uint32_t startVertex) = 0;
+
+  // Indices are into the whole bound vertex buffer.
+  virtual void drawIndexed(uint32_t indexCnt, uint32_t startIndex) = 0;
+
+  // Draws the whole index buffer instanceCnt times, with instances startInstance onwards of the instance buffer.
+  virtual void drawIndexedInstanced(uint32_t indexCnt, uint32_t instanceCnt, uint32_t startInstance) = 0;
+};
+
+// Releases x through dev and NULLs it, like RELEASE_NON_NULL does for D3D interfaces.
+#define RENDER_RELEASE_NON_NULL(dev, x) \
+{                                       \
+  if(x) (dev)->release(x);              \
+  x = NULL;                             \
+}
+
+#endif
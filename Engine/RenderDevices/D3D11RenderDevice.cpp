@@ -0,0 +1,375 @@
+#include "D3D11RenderDevice.h"
+#include "../Util.h"
+#include "../Logger.h"
+
+// Handles are the D3D interfaces, cast back and forth.
+#define D3D_HANDLE(type, x)     reinterpret_cast<type*>(x)
+
+D3D11RenderDevice::D3D11RenderDevice()
+{
+  m_pDev = NULL;
+  m_pDevcon = NULL;
+  m_pDevcon1 = NULL;
+}
+
+
+D3D11RenderDevice::~D3D11RenderDevice()
+{
+  RELEASE_NON_NULL(m_pDevcon1);
+}
+
+
+void D3D11RenderDevice::init(ID3D11Device *dev, ID3D11DeviceContext *devcon)
+{
+  m_pDev = dev;
+  m_pDevcon = devcon;
+
+  // Constant buffer ranges need the 11.1 context, and a driver that does offsets.
+  RELEASE_NON_NULL(m_pDevcon1);
+  D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+  if (SUCCEEDED(dev->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) &&
+    options.ConstantBufferOffsetting &&
+    SUCCEEDED(devcon->QueryInterface(__uuidof(ID3D11DeviceContext1), reinterpret_cast<void**>(&m_pDevcon1))))
+  {
+    LOGI("Constant buffer ranges supported");
+  }
+  else
+  {
+    m_pDevcon1 = NULL;
+    LOGI("Constant buffer ranges not supported, constants are uploaded per draw");
+  }
+}
+
+
+void D3D11RenderDevice::releaseResource(void *pResource)
+{
+  // Every handle is some ID3D11DeviceChild.
+  IUnknown *pUnknown = static_cast<IUnknown*>(pResource);
+  RELEASE_NON_NULL(pUnknown);
+}
+
+
+const char *D3D11RenderDevice::getShaderFormat()
+{
+  return "dxbc";
+}
+
+
+bool D3D11RenderDevice::compileShader(
+  const std::string &fileName,
+  const char *entryPoint,
+  const char *profile,
+  std::vector<uint8_t> &bytecode)
+{
+  ID3D10Blob *pBlob = NULL;
+  ID3D10Blob *pErrors = NULL;
+  D3DX11CompileFromFile(fileName.c_str(), 0, 0, entryPoint, profile, 0, 0, 0, &pBlob, &pErrors, 0);
+
+  if (!pBlob)
+  {
+    LOGE("Failed to compile %s %s from %s: %s",
+      entryPoint,
+      profile,
+      fileName.c_str(),
+      pErrors ? static_cast<const char*>(pErrors->GetBufferPointer()) : "unknown error");
+    RELEASE_NON_NULL(pErrors);
+    return false;
+  }
+
+  const uint8_t *pCode = static_cast<const uint8_t*>(pBlob->GetBufferPointer());
+  bytecode.assign(pCode, pCode + pBlob->GetBufferSize());
+
+  RELEASE_NON_NULL(pBlob);
+  RELEASE_NON_NULL(pErrors);
+  return true;
+}
+
+
+RenderVertexShader *D3D11RenderDevice::createVertexShader(const std::vector<uint8_t> &bytecode)
+{
+  ID3D11VertexShader *pVs = NULL;
+  m_pDev->CreateVertexShader(bytecode.data(), bytecode.size(), NULL, &pVs);
+  return D3D_HANDLE(RenderVertexShader, pVs);
+}
+
+
+RenderPixelShader *D3D11RenderDevice::createPixelShader(const std::vector<uint8_t> &bytecode)
+{
+  ID3D11PixelShader *pPs = NULL;
+  m_pDev->CreatePixelShader(bytecode.data(), bytecode.size(), NULL, &pPs);
+  return D3D_HANDLE(RenderPixelShader, pPs);
+}
+
+
+RenderInputLayout *D3D11RenderDevice::createInputLayout(RenderVertexFormat format, const std::vector<uint8_t> &vsBytecode)
+{
+  D3D11_INPUT_ELEMENT_DESC pos3Uv2Ied[] =
+  {
+    { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+  };
+
+  // Slot 0 is the shared BoxVertex mesh, slot 1 one BoxInstance per instance.
+  D3D11_INPUT_ELEMENT_DESC boxInstancedIed[] =
+  {
+    { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "TEXCOORD", 1, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "TEXCOORD", 2, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "DIMENSIONS", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "UVSCALE", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 }
+  };
+
+  D3D11_INPUT_ELEMENT_DESC *pIed = NULL;
+  UINT iedCnt = 0;
+  switch (format)
+  {
+    case RENDER_VERTEX_POS3_UV2:
+      pIed = pos3Uv2Ied;
+      iedCnt = COUNT_OF(pos3Uv2Ied);
+      break;
+    case RENDER_VERTEX_BOX_INSTANCED:
+      pIed = boxInstancedIed;
+      iedCnt = COUNT_OF(boxInstancedIed);
+      break;
+    default:
+      LOGE("Unexpected vertex format %d", format);
+      return NULL;
+  }
+
+  ID3D11InputLayout *pLayout = NULL;
+  m_pDev->CreateInputLayout(pIed, iedCnt, vsBytecode.data(), vsBytecode.size(), &pLayout);
+  return D3D_HANDLE(RenderInputLayout, pLayout);
+}
+
+
+RenderTexture *D3D11RenderDevice::createTexture(const uint8_t *pFileData, size_t size)
+{
+  ID3D11ShaderResourceView *pTexture = NULL;
+  D3DX11CreateShaderResourceViewFromMemory(m_pDev, pFileData, size, NULL, NULL, &pTexture, NULL);
+  return D3D_HANDLE(RenderTexture, pTexture);
+}
+
+
+bool D3D11RenderDevice::getTextureSize(RenderTexture *pTexture, uint32_t &width, uint32_t &height)
+{
+  if (!pTexture)
+  {
+    return false;
+  }
+
+  // https://stackoverflow.com/questions/17658392/dimensions-of-id3d11shaderresourceview
+  ID3D11Resource *pResource = NULL;
+  D3D_HANDLE(ID3D11ShaderResourceView, pTexture)->GetResource(&pResource);
+  ID3D11Texture2D *pTex2d = static_cast<ID3D11Texture2D*>(pResource);
+  D3D11_TEXTURE2D_DESC desc;
+  pTex2d->GetDesc(&desc);
+
+  width = desc.Width;
+  height = desc.Height;
+
+  RELEASE_NON_NULL(pResource);
+  return true;
+}
+
+
+RenderSampler *D3D11RenderDevice::createSampler(const RenderSamplerDesc &desc)
+{
+  D3D11_TEXTURE_ADDRESS_MODE address = desc.address == RENDER_ADDRESS_CLAMP ?
+    D3D11_TEXTURE_ADDRESS_CLAMP : D3D11_TEXTURE_ADDRESS_WRAP;
+
+  D3D11_SAMPLER_DESC samplerDesc;
+  // Create a texture sampler state description.
+  samplerDesc.Filter = desc.filter == RENDER_FILTER_POINT ? D3D11_FILTER_MIN_MAG_MIP_POINT : D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+  samplerDesc.AddressU = address;
+  samplerDesc.AddressV = address;
+  samplerDesc.AddressW = address;
+  samplerDesc.MipLODBias = 0.0f;
+  samplerDesc.MaxAnisotropy = 1;
+  samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+  samplerDesc.BorderColor[0] = 0;
+  samplerDesc.BorderColor[1] = 0;
+  samplerDesc.BorderColor[2] = 0;
+  samplerDesc.BorderColor[3] = 0;
+  samplerDesc.MinLOD = 0;
+  samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+
+  ID3D11SamplerState *pSampler = NULL;
+  m_pDev->CreateSamplerState(&samplerDesc, &pSampler);
+  return D3D_HANDLE(RenderSampler, pSampler);
+}
+
+
+RenderBuffer *D3D11RenderDevice::createBuffer(RenderBufferType type, uint32_t byteWidth, const void *pInitData)
+{
+  D3D11_BUFFER_DESC bd;
+  ZeroMemory(&bd, sizeof(bd));
+
+  // If the bind flag is D3D11_BIND_CONSTANT_BUFFER, you must set the ByteWidth value in multiples of 16.
+  bd.Usage = D3D11_USAGE_DYNAMIC;                // Write access by CPU and GPU
+  bd.ByteWidth = byteWidth;
+  switch (type)
+  {
+    case RENDER_BUFFER_CONSTANT:
+    {
+      bd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+      break;
+    }
+    case RENDER_BUFFER_INDEX:
+    {
+      bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
+      break;
+    }
+    default:
+    {
+      bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+      break;
+    }
+  }
+  bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;    // Allow CPU to write in buffer
+
+  D3D11_SUBRESOURCE_DATA initData;
+  ZeroMemory(&initData, sizeof(initData));
+  initData.pSysMem = pInitData;
+
+  ID3D11Buffer *pBuffer = NULL;
+  if (HR_FAILED(m_pDev->CreateBuffer(&bd, pInitData ? &initData : NULL, &pBuffer)))
+  {
+    LOGE("Failed to create %u byte buffer", byteWidth);
+    return NULL;
+  }
+
+  return D3D_HANDLE(RenderBuffer, pBuffer);
+}
+
+
+bool D3D11RenderDevice::updateBuffer(RenderBuffer *pBuffer, const void *pData, uint32_t byteWidth)
+{
+  ID3D11Buffer *pD3dBuffer = D3D_HANDLE(ID3D11Buffer, pBuffer);
+
+  D3D11_MAPPED_SUBRESOURCE ms;
+  if (HR_FAILED(m_pDevcon->Map(pD3dBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &ms)))
+  {
+    return false;
+  }
+
+  memcpy(ms.pData, pData, byteWidth);
+  m_pDevcon->Unmap(pD3dBuffer, 0);
+  return true;
+}
+
+
+void D3D11RenderDevice::setVertexShader(RenderVertexShader *pShader)
+{
+  m_pDevcon->VSSetShader(D3D_HANDLE(ID3D11VertexShader, pShader), 0, 0);
+}
+
+
+void D3D11RenderDevice::setPixelShader(RenderPixelShader *pShader)
+{
+  m_pDevcon->PSSetShader(D3D_HANDLE(ID3D11PixelShader, pShader), 0, 0);
+}
+
+
+void D3D11RenderDevice::setInputLayout(RenderInputLayout *pLayout)
+{
+  m_pDevcon->IASetInputLayout(D3D_HANDLE(ID3D11InputLayout, pLayout));
+}
+
+
+void D3D11RenderDevice::setVsConstantBuffer(uint32_t slot, RenderBuffer *pBuffer)
+{
+  ID3D11Buffer *pD3dBuffer = D3D_HANDLE(ID3D11Buffer, pBuffer);
+  m_pDevcon->VSSetConstantBuffers(slot, 1, &pD3dBuffer);
+}
+
+
+bool D3D11RenderDevice::supportsConstantBufferRanges()
+{
+  return m_pDevcon1 != NULL;
+}
+
+
+void D3D11RenderDevice::setVsConstantBufferRange(
+  uint32_t slot,
+  RenderBuffer *pBuffer,
+  uint32_t byteOffset,
+  uint32_t byteSize)
+{
+  if (!m_pDevcon1)
+  {
+    LOGE("Constant buffer ranges not supported");
+    return;
+  }
+
+  // Offsets and sizes are in 16 byte constants.
+  ID3D11Buffer *pD3dBuffer = D3D_HANDLE(ID3D11Buffer, pBuffer);
+  UINT firstConstant = byteOffset / 16;
+  UINT numConstants = byteSize / 16;
+  m_pDevcon1->VSSetConstantBuffers1(slot, 1, &pD3dBuffer, &firstConstant, &numConstants);
+}
+
+
+void D3D11RenderDevice::setPsTexture(uint32_t slot, RenderTexture *pTexture)
+{
+  ID3D11ShaderResourceView *pSrv = D3D_HANDLE(ID3D11ShaderResourceView, pTexture);
+  m_pDevcon->PSSetShaderResources(slot, 1, &pSrv);
+}
+
+
+void D3D11RenderDevice::setPsSampler(uint32_t slot, RenderSampler *pSampler)
+{
+  ID3D11SamplerState *pSamplerState = D3D_HANDLE(ID3D11SamplerState, pSampler);
+  m_pDevcon->PSSetSamplers(slot, 1, &pSamplerState);
+}
+
+
+void D3D11RenderDevice::setVertexBuffer(RenderBuffer *pBuffer, uint32_t stride)
+{
+  ID3D11Buffer *pD3dBuffer = D3D_HANDLE(ID3D11Buffer, pBuffer);
+  UINT offset = 0;
+  m_pDevcon->IASetVertexBuffers(0, 1, &pD3dBuffer, &stride, &offset);
+}
+
+
+void D3D11RenderDevice::setIndexBuffer(RenderBuffer *pBuffer)
+{
+  m_pDevcon->IASetIndexBuffer(D3D_HANDLE(ID3D11Buffer, pBuffer), DXGI_FORMAT_R32_UINT, 0);
+}
+
+
+void D3D11RenderDevice::setInstanceBuffer(RenderBuffer *pBuffer, uint32_t stride)
+{
+  ID3D11Buffer *pD3dBuffer = D3D_HANDLE(ID3D11Buffer, pBuffer);
+  UINT offset = 0;
+  m_pDevcon->IASetVertexBuffers(1, 1, &pD3dBuffer, &stride, &offset);
+}
+
+
+void D3D11RenderDevice::setTopology(RenderTopology topology)
+{
+  m_pDevcon->IASetPrimitiveTopology(topology == RENDER_TOPOLOGY_TRIANGLE_STRIP ?
+    D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP : D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+
+void D3D11RenderDevice::draw(uint32_t vertexCnt, uint32_t startVertex)
+{
+  m_pDevcon->Draw(vertexCnt, startVertex);
+}
+
+
+void D3D11RenderDevice::drawIndexed(uint32_t indexCnt, uint32_t startIndex)
+{
+  m_pDevcon->DrawIndexed(indexCnt, startIndex, 0);
+}
+
+
+void D3D11RenderDevice::drawIndexedInstanced(uint32_t indexCnt, uint32_t instanceCnt, uint32_t startInstance)
+{
+  m_pDevcon->DrawIndexedInstanced(indexCnt, instanceCnt, 0, 0, startInstance);
+}
@@ -0,0 +1,62 @@
+#ifndef D3D11_RENDER_DEVICE_H
+#define D3D11_RENDER_DEVICE_H
+
+#include "../RenderDevice.h"
+#include <d3d11.h>
+#include <d3d11_1.h>
+#include <d3dx11.h>
+
+// Passes straight through to an existing device and immediate context, which stay owned by the caller (see main.cpp).
+// Handles are the D3D interfaces themselves.
+class D3D11RenderDevice : public RenderDevice
+{
+private:
+  ID3D11Device        *m_pDev;
+  ID3D11DeviceContext *m_pDevcon;
+  ID3D11DeviceContext1 *m_pDevcon1;     // Only on 11.1 runtimes with constant buffer offsetting, otherwise NULL.
+
+protected:
+  void releaseResource(void *pResource);
+
+public:
+  D3D11RenderDevice();
+  ~D3D11RenderDevice();
+
+  void init(ID3D11Device *dev, ID3D11DeviceContext *devcon);
+
+  const char *getShaderFormat();
+
+  bool compileShader(
+    const std::string &fileName,
+    const char *entryPoint,
+    const char *profile,
+    std::vector<uint8_t> &bytecode);
+
+  RenderVertexShader *createVertexShader(const std::vector<uint8_t> &bytecode);
+  RenderPixelShader *createPixelShader(const std::vector<uint8_t> &bytecode);
+  RenderInputLayout *createInputLayout(RenderVertexFormat format, const std::vector<uint8_t> &vsBytecode);
+  RenderTexture *createTexture(const uint8_t *pFileData, size_t size);
+  bool getTextureSize(RenderTexture *pTexture, uint32_t &width, uint32_t &height);
+  RenderSampler *createSampler(const RenderSamplerDesc &desc);
+  RenderBuffer *createBuffer(RenderBufferType type, uint32_t byteWidth, const void *pInitData);
+  bool updateBuffer(RenderBuffer *pBuffer, const void *pData, uint32_t byteWidth);
+
+  void setVertexShader(RenderVertexShader *pShader);
+  void setPixelShader(RenderPixelShader *pShader);
+  void setInputLayout(RenderInputLayout *pLayout);
+  void setVsConstantBuffer(uint32_t slot, RenderBuffer *pBuffer);
+  bool supportsConstantBufferRanges();
+  void setVsConstantBufferRange(uint32_t slot, RenderBuffer *pBuffer, uint32_t byteOffset, uint32_t byteSize);
+  void setPsTexture(uint32_t slot, RenderTexture *pTexture);
+  void setPsSampler(uint32_t slot, RenderSampler *pSampler);
+  void setVertexBuffer(RenderBuffer *pBuffer, uint32_t stride);
+  void setIndexBuffer(RenderBuffer *pBuffer);
+  void setInstanceBuffer(RenderBuffer *pBuffer, uint32_t stride);
+  void setTopology(RenderTopology topology);
+
+  void draw(uint32_t vertexCnt, uint32_t startVertex);
+  void drawIndexed(uint32_t indexCnt, uint32_t startIndex);
+  void drawIndexedInstanced(uint32_t indexCnt, uint32_t instanceCnt, uint32_t startInstance);
+};
+
+#endif
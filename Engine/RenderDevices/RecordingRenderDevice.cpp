@@ -0,0 +1,487 @@
+#include "RecordingRenderDevice.h"
+#include "../Logger.h"
+#include "../Util.h"
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+
+const uint32_t RecordingRenderDevice::MAX_SLOTS;
+
+#define RECORDED_RESOURCE(x)    reinterpret_cast<Resource*>(x)
+
+RecordingRenderDevice::RecordingRenderDevice(bool bRecordCommands)
+{
+  m_bRecordCommands = bRecordCommands;
+  m_nextId = 1;
+  m_liveCnt = 0;
+
+  m_pVs = NULL;
+  m_pPs = NULL;
+  m_pLayout = NULL;
+  m_pVBuffer = NULL;
+  m_pIBuffer = NULL;
+  m_pInstBuffer = NULL;
+  m_vbStride = 0;
+  m_instStride = 0;
+  m_topology = RENDER_TOPOLOGY_TRIANGLE_LIST;
+  m_bTopologySet = false;
+  memset(m_vsConstBuffers, 0, sizeof(m_vsConstBuffers));
+  memset(m_vsConstOffsets, 0, sizeof(m_vsConstOffsets));
+  memset(m_vsConstSizes, 0, sizeof(m_vsConstSizes));
+  memset(m_psTextures, 0, sizeof(m_psTextures));
+  memset(m_psSamplers, 0, sizeof(m_psSamplers));
+}
+
+
+RecordingRenderDevice::~RecordingRenderDevice()
+{
+  if (m_liveCnt)
+  {
+    LOGW("Recording render device destroyed with %u live resources", m_liveCnt);
+  }
+}
+
+
+RecordingRenderDevice::Resource *RecordingRenderDevice::newResource(RenderCommandType createCmd, uint32_t size)
+{
+  Resource *pResource = new Resource();
+  pResource->id = m_nextId++;
+  pResource->width = 0;
+  pResource->height = 0;
+
+  m_liveCnt++;
+  m_stats.resourcesCreated++;
+  record(createCmd, pResource, size);
+  return pResource;
+}
+
+
+void RecordingRenderDevice::record(
+  RenderCommandType type,
+  Resource *pResource,
+  uint32_t arg0,
+  uint32_t arg1,
+  uint32_t arg2)
+{
+  if (!m_bRecordCommands)
+  {
+    return;
+  }
+
+  RenderCommand cmd = { type, pResource ? pResource->id : 0, arg0, arg1, arg2 };
+  m_commands.push_back(cmd);
+}
+
+
+void RecordingRenderDevice::setState(RenderCommandType type, Resource *&pBound, Resource *pResource, uint32_t slot)
+{
+  m_stats.stateSets++;
+  if (pBound != pResource)
+  {
+    m_stats.stateChanges++;
+    pBound = pResource;
+  }
+  record(type, pResource, slot);
+}
+
+
+void RecordingRenderDevice::releaseResource(void *pHandle)
+{
+  Resource *pResource = RECORDED_RESOURCE(pHandle);
+  if (!pResource)
+  {
+    return;
+  }
+
+  record(RENDER_CMD_RELEASE, pResource);
+  m_stats.resourcesReleased++;
+  m_liveCnt--;
+
+  // A later resource can land at the same address, it mustn't look like it's already bound.
+  Resource **boundLists[] = { m_vsConstBuffers, m_psTextures, m_psSamplers };
+  for (uint32_t list = 0; list < COUNT_OF(boundLists); list++)
+  {
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++)
+    {
+      if (boundLists[list][slot] == pResource)
+      {
+        boundLists[list][slot] = NULL;
+      }
+    }
+  }
+  Resource **boundSingles[] = { &m_pVs, &m_pPs, &m_pLayout, &m_pVBuffer, &m_pIBuffer, &m_pInstBuffer };
+  for (uint32_t i = 0; i < COUNT_OF(boundSingles); i++)
+  {
+    if (*boundSingles[i] == pResource)
+    {
+      *boundSingles[i] = NULL;
+    }
+  }
+
+  delete pResource;
+}
+
+
+const char *RecordingRenderDevice::getShaderFormat()
+{
+  return "recorded";
+}
+
+
+bool RecordingRenderDevice::compileShader(
+  const std::string &fileName,
+  const char *entryPoint,
+  const char *profile,
+  std::vector<uint8_t> &bytecode)
+{
+  std::ifstream fs(fileName, std::ios::binary);
+  if (!fs)
+  {
+    LOGE("Failed to read shader: %s", fileName.c_str());
+    return false;
+  }
+
+  bytecode.assign(std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>());
+  m_shaderCompiles++;
+  return true;
+}
+
+
+RenderVertexShader *RecordingRenderDevice::createVertexShader(const std::vector<uint8_t> &bytecode)
+{
+  return reinterpret_cast<RenderVertexShader*>(
+    newResource(RENDER_CMD_CREATE_VERTEX_SHADER, static_cast<uint32_t>(bytecode.size())));
+}
+
+
+RenderPixelShader *RecordingRenderDevice::createPixelShader(const std::vector<uint8_t> &bytecode)
+{
+  return reinterpret_cast<RenderPixelShader*>(
+    newResource(RENDER_CMD_CREATE_PIXEL_SHADER, static_cast<uint32_t>(bytecode.size())));
+}
+
+
+RenderInputLayout *RecordingRenderDevice::createInputLayout(RenderVertexFormat format, const std::vector<uint8_t> &vsBytecode)
+{
+  return reinterpret_cast<RenderInputLayout*>(newResource(RENDER_CMD_CREATE_INPUT_LAYOUT, format));
+}
+
+
+RenderTexture *RecordingRenderDevice::createTexture(const uint8_t *pFileData, size_t size)
+{
+  static const uint8_t DDS_MAGIC[] = { 'D', 'D', 'S', ' ' };
+  static const uint8_t PNG_MAGIC[] = { 0x89, 'P', 'N', 'G' };
+
+  Resource *pResource = newResource(RENDER_CMD_CREATE_TEXTURE, static_cast<uint32_t>(size));
+  pResource->width = 1;
+  pResource->height = 1;
+
+  if (size >= 20 && memcmp(pFileData, DDS_MAGIC, sizeof(DDS_MAGIC)) == 0)
+  {
+    // Little endian dwHeight, dwWidth after the magic and dwSize, dwFlags.
+    memcpy(&pResource->height, pFileData + 12, sizeof(uint32_t));
+    memcpy(&pResource->width, pFileData + 16, sizeof(uint32_t));
+  }
+  else if (size >= 24 && memcmp(pFileData, PNG_MAGIC, sizeof(PNG_MAGIC)) == 0)
+  {
+    // Big endian width, height at the start of the IHDR chunk.
+    const uint8_t *pIhdr = pFileData + 16;
+    pResource->width = (pIhdr[0] << 24) | (pIhdr[1] << 16) | (pIhdr[2] << 8) | pIhdr[3];
+    pResource->height = (pIhdr[4] << 24) | (pIhdr[5] << 16) | (pIhdr[6] << 8) | pIhdr[7];
+  }
+
+  m_stats.bytesUploaded += size;
+  return reinterpret_cast<RenderTexture*>(pResource);
+}
+
+
+bool RecordingRenderDevice::getTextureSize(RenderTexture *pTexture, uint32_t &width, uint32_t &height)
+{
+  if (!pTexture)
+  {
+    return false;
+  }
+
+  width = RECORDED_RESOURCE(pTexture)->width;
+  height = RECORDED_RESOURCE(pTexture)->height;
+  return true;
+}
+
+
+RenderSampler *RecordingRenderDevice::createSampler(const RenderSamplerDesc &desc)
+{
+  return reinterpret_cast<RenderSampler*>(newResource(RENDER_CMD_CREATE_SAMPLER, (desc.filter << 8) | desc.address));
+}
+
+
+RenderBuffer *RecordingRenderDevice::createBuffer(RenderBufferType type, uint32_t byteWidth, const void *pInitData)
+{
+  if (pInitData)
+  {
+    m_stats.bytesUploaded += byteWidth;
+  }
+
+  return reinterpret_cast<RenderBuffer*>(newResource(RENDER_CMD_CREATE_BUFFER, byteWidth));
+}
+
+
+bool RecordingRenderDevice::updateBuffer(RenderBuffer *pBuffer, const void *pData, uint32_t byteWidth)
+{
+  if (!pBuffer)
+  {
+    return false;
+  }
+
+  m_stats.bufferUpdates++;
+  m_stats.bytesUploaded += byteWidth;
+  record(RENDER_CMD_UPDATE_BUFFER, RECORDED_RESOURCE(pBuffer), byteWidth);
+  return true;
+}
+
+
+void RecordingRenderDevice::setVertexShader(RenderVertexShader *pShader)
+{
+  setState(RENDER_CMD_SET_VERTEX_SHADER, m_pVs, RECORDED_RESOURCE(pShader));
+}
+
+
+void RecordingRenderDevice::setPixelShader(RenderPixelShader *pShader)
+{
+  setState(RENDER_CMD_SET_PIXEL_SHADER, m_pPs, RECORDED_RESOURCE(pShader));
+}
+
+
+void RecordingRenderDevice::setInputLayout(RenderInputLayout *pLayout)
+{
+  setState(RENDER_CMD_SET_INPUT_LAYOUT, m_pLayout, RECORDED_RESOURCE(pLayout));
+}
+
+
+void RecordingRenderDevice::setVsConstantBuffer(uint32_t slot, RenderBuffer *pBuffer)
+{
+  if (slot >= MAX_SLOTS)
+  {
+    LOGE("Constant buffer slot %u out of range", slot);
+    return;
+  }
+
+  // Rebinding the whole of a buffer that was bound as a range is still a change.
+  if (m_vsConstOffsets[slot] || m_vsConstSizes[slot])
+  {
+    m_vsConstOffsets[slot] = 0;
+    m_vsConstSizes[slot] = 0;
+    m_vsConstBuffers[slot] = NULL;
+  }
+  setState(RENDER_CMD_SET_VS_CONSTANT_BUFFER, m_vsConstBuffers[slot], RECORDED_RESOURCE(pBuffer), slot);
+}
+
+
+bool RecordingRenderDevice::supportsConstantBufferRanges()
+{
+  return true;
+}
+
+
+void RecordingRenderDevice::setVsConstantBufferRange(
+  uint32_t slot,
+  RenderBuffer *pBuffer,
+  uint32_t byteOffset,
+  uint32_t byteSize)
+{
+  if (slot >= MAX_SLOTS)
+  {
+    LOGE("Constant buffer slot %u out of range", slot);
+    return;
+  }
+  if (byteOffset % RENDER_CONSTANT_RANGE_ALIGN || byteSize % RENDER_CONSTANT_RANGE_ALIGN || !byteSize)
+  {
+    LOGE("Constant buffer range %u+%u not aligned to %u", byteOffset, byteSize, RENDER_CONSTANT_RANGE_ALIGN);
+    return;
+  }
+
+  // Same buffer at a new offset is a change, like a stride change.
+  if (byteOffset != m_vsConstOffsets[slot] || byteSize != m_vsConstSizes[slot])
+  {
+    m_vsConstOffsets[slot] = byteOffset;
+    m_vsConstSizes[slot] = byteSize;
+    m_vsConstBuffers[slot] = NULL;
+  }
+
+  m_stats.stateSets++;
+  if (m_vsConstBuffers[slot] != RECORDED_RESOURCE(pBuffer))
+  {
+    m_stats.stateChanges++;
+    m_vsConstBuffers[slot] = RECORDED_RESOURCE(pBuffer);
+  }
+  record(RENDER_CMD_SET_VS_CONSTANT_BUFFER_RANGE, RECORDED_RESOURCE(pBuffer), slot, byteOffset, byteSize);
+}
+
+
+void RecordingRenderDevice::setPsTexture(uint32_t slot, RenderTexture *pTexture)
+{
+  if (slot >= MAX_SLOTS)
+  {
+    LOGE("Texture slot %u out of range", slot);
+    return;
+  }
+  setState(RENDER_CMD_SET_PS_TEXTURE, m_psTextures[slot], RECORDED_RESOURCE(pTexture), slot);
+}
+
+
+void RecordingRenderDevice::setPsSampler(uint32_t slot, RenderSampler *pSampler)
+{
+  if (slot >= MAX_SLOTS)
+  {
+    LOGE("Sampler slot %u out of range", slot);
+    return;
+  }
+  setState(RENDER_CMD_SET_PS_SAMPLER, m_psSamplers[slot], RECORDED_RESOURCE(pSampler), slot);
+}
+
+
+void RecordingRenderDevice::setVertexBuffer(RenderBuffer *pBuffer, uint32_t stride)
+{
+  // A stride change alone is still a change.
+  if (stride != m_vbStride)
+  {
+    m_vbStride = stride;
+    m_pVBuffer = NULL;
+  }
+  setState(RENDER_CMD_SET_VERTEX_BUFFER, m_pVBuffer, RECORDED_RESOURCE(pBuffer), stride);
+}
+
+
+void RecordingRenderDevice::setIndexBuffer(RenderBuffer *pBuffer)
+{
+  setState(RENDER_CMD_SET_INDEX_BUFFER, m_pIBuffer, RECORDED_RESOURCE(pBuffer));
+}
+
+
+void RecordingRenderDevice::setInstanceBuffer(RenderBuffer *pBuffer, uint32_t stride)
+{
+  if (stride != m_instStride)
+  {
+    m_instStride = stride;
+    m_pInstBuffer = NULL;
+  }
+  setState(RENDER_CMD_SET_INSTANCE_BUFFER, m_pInstBuffer, RECORDED_RESOURCE(pBuffer), stride);
+}
+
+
+void RecordingRenderDevice::setTopology(RenderTopology topology)
+{
+  m_stats.stateSets++;
+  if (!m_bTopologySet || topology != m_topology)
+  {
+    m_stats.stateChanges++;
+    m_topology = topology;
+    m_bTopologySet = true;
+  }
+  record(RENDER_CMD_SET_TOPOLOGY, NULL, topology);
+}
+
+
+void RecordingRenderDevice::draw(uint32_t vertexCnt, uint32_t startVertex)
+{
+  m_stats.draws++;
+  m_stats.verticesDrawn += vertexCnt;
+  record(RENDER_CMD_DRAW, NULL, vertexCnt, startVertex);
+}
+
+
+void RecordingRenderDevice::drawIndexed(uint32_t indexCnt, uint32_t startIndex)
+{
+  m_stats.draws++;
+  m_stats.verticesDrawn += indexCnt;
+  record(RENDER_CMD_DRAW_INDEXED, NULL, indexCnt, startIndex);
+}
+
+
+void RecordingRenderDevice::drawIndexedInstanced(uint32_t indexCnt, uint32_t instanceCnt, uint32_t startInstance)
+{
+  m_stats.draws++;
+  m_stats.verticesDrawn += static_cast<uint64_t>(indexCnt) * instanceCnt;
+  m_stats.instancesDrawn += instanceCnt;
+  record(RENDER_CMD_DRAW_INDEXED_INSTANCED, NULL, indexCnt, instanceCnt, startInstance);
+}
+
+
+RenderStats RecordingRenderDevice::getStats()
+{
+  RenderStats stats = m_stats;
+  stats.shaderCompiles = m_shaderCompiles;
+  return stats;
+}
+
+
+uint32_t RecordingRenderDevice::getLiveResourceCnt()
+{
+  return m_liveCnt;
+}
+
+
+const std::vector<RenderCommand> &RecordingRenderDevice::getCommands()
+{
+  return m_commands;
+}
+
+
+void RecordingRenderDevice::resetStats()
+{
+  m_stats = RenderStats();
+  m_shaderCompiles = 0;
+  m_commands.clear();
+}
+
+
+bool RecordingRenderDevice::writeCommandLog(const std::string &fileName)
+{
+  FILE *pFile = fopen(fileName.c_str(), "w");
+  if (!pFile)
+  {
+    LOGE("Failed to open render command log: %s", fileName.c_str());
+    return false;
+  }
+
+  for (size_t i = 0; i < m_commands.size(); i++)
+  {
+    const RenderCommand &cmd = m_commands[i];
+    fprintf(pFile, "%s %u %u %u %u\n", getCommandName(cmd.type), cmd.resourceId, cmd.arg0, cmd.arg1, cmd.arg2);
+  }
+
+  fclose(pFile);
+  return true;
+}
+
+
+const char *RecordingRenderDevice::getCommandName(RenderCommandType type)
+{
+  static const char *COMMAND_NAMES[RENDER_CMD_COUNT] =
+  {
+    "createVertexShader",
+    "createPixelShader",
+    "createInputLayout",
+    "createTexture",
+    "createSampler",
+    "createBuffer",
+    "updateBuffer",
+    "release",
+    "setVertexShader",
+    "setPixelShader",
+    "setInputLayout",
+    "setVsConstantBuffer",
+    "setPsTexture",
+    "setPsSampler",
+    "setVertexBuffer",
+    "setTopology",
+    "draw",
+    "setIndexBuffer",
+    "drawIndexed",
+    "setInstanceBuffer",
+    "drawIndexedInstanced",
+    "setVsConstantBufferRange"
+  };
+
+  return type < RENDER_CMD_COUNT ? COMMAND_NAMES[type] : "unknown";
+}
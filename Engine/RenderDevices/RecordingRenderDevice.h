@@ -0,0 +1,159 @@
+#ifndef RECORDING_RENDER_DEVICE_H
+#define RECORDING_RENDER_DEVICE_H
+
+#include "../RenderDevice.h"
+#include <atomic>
+
+typedef struct RenderStats_
+{
+  uint64_t draws{ 0 };
+  uint64_t verticesDrawn{ 0 };      // Indices for indexed draws, times the instance count for instanced ones.
+  uint64_t instancesDrawn{ 0 };     // Only counts instanced draws.
+  uint64_t stateSets{ 0 };          // Every set*() call.
+  uint64_t stateChanges{ 0 };       // set*() calls that changed what was bound, the rest were redundant.
+  uint64_t bufferUpdates{ 0 };
+  uint64_t bytesUploaded{ 0 };      // Buffer init data, buffer updates and texture file data.
+  uint64_t resourcesCreated{ 0 };
+  uint64_t resourcesReleased{ 0 };
+  uint64_t shaderCompiles{ 0 };
+} RenderStats;
+
+typedef enum RenderCommandType_
+{
+  RENDER_CMD_CREATE_VERTEX_SHADER = 0,
+  RENDER_CMD_CREATE_PIXEL_SHADER,
+  RENDER_CMD_CREATE_INPUT_LAYOUT,
+  RENDER_CMD_CREATE_TEXTURE,
+  RENDER_CMD_CREATE_SAMPLER,
+  RENDER_CMD_CREATE_BUFFER,
+  RENDER_CMD_UPDATE_BUFFER,
+  RENDER_CMD_RELEASE,
+  RENDER_CMD_SET_VERTEX_SHADER,
+  RENDER_CMD_SET_PIXEL_SHADER,
+  RENDER_CMD_SET_INPUT_LAYOUT,
+  RENDER_CMD_SET_VS_CONSTANT_BUFFER,
+  RENDER_CMD_SET_PS_TEXTURE,
+  RENDER_CMD_SET_PS_SAMPLER,
+  RENDER_CMD_SET_VERTEX_BUFFER,
+  RENDER_CMD_SET_TOPOLOGY,
+  RENDER_CMD_DRAW,
+  RENDER_CMD_SET_INDEX_BUFFER,
+  RENDER_CMD_DRAW_INDEXED,
+  RENDER_CMD_SET_INSTANCE_BUFFER,
+  RENDER_CMD_DRAW_INDEXED_INSTANCED,
+  RENDER_CMD_SET_VS_CONSTANT_BUFFER_RANGE,
+  RENDER_CMD_COUNT
+} RenderCommandType;
+
+// Resources are referred to by creation order (starting at 1, 0 for NULL), so streams from two runs of the same
+// content can be diffed.
+typedef struct RenderCommand_
+{
+  RenderCommandType type;
+  uint32_t          resourceId;
+  uint32_t          arg0;         // Slot, size, stride, topology or vertex/index count, depending on type.
+  uint32_t          arg1;         // Start vertex (or index) for draws, instance count for instanced draws, byte
+                                  // offset for constant buffer ranges.
+  uint32_t          arg2;         // Start instance for instanced draws, byte size for constant buffer ranges.
+} RenderCommand;
+
+// Stand-in device for headless runs. Creates no GPU resources, but tracks bound state the way a driver would and
+// keeps counts of draws, state changes and uploads. With bRecordCommands it also keeps the whole command stream.
+class RecordingRenderDevice : public RenderDevice
+{
+private:
+  static const uint32_t MAX_SLOTS = 16;
+
+  typedef struct Resource_
+  {
+    uint32_t id;
+    uint32_t width;       // Textures only.
+    uint32_t height;
+  } Resource;
+
+  bool                       m_bRecordCommands;
+  std::vector<RenderCommand> m_commands;
+  RenderStats                m_stats;
+  std::atomic<uint64_t>      m_shaderCompiles{ 0 };
+  uint32_t                   m_nextId;
+  uint32_t                   m_liveCnt;
+
+  // Bound state.
+  Resource       *m_pVs;
+  Resource       *m_pPs;
+  Resource       *m_pLayout;
+  Resource       *m_pVBuffer;
+  Resource       *m_pIBuffer;
+  Resource       *m_pInstBuffer;
+  uint32_t        m_vbStride;
+  uint32_t        m_instStride;
+  RenderTopology  m_topology;
+  bool            m_bTopologySet;
+  Resource       *m_vsConstBuffers[MAX_SLOTS];
+  uint32_t        m_vsConstOffsets[MAX_SLOTS];      // Byte offset and size of ranges, 0 and 0 for whole buffers.
+  uint32_t        m_vsConstSizes[MAX_SLOTS];
+  Resource       *m_psTextures[MAX_SLOTS];
+  Resource       *m_psSamplers[MAX_SLOTS];
+
+  Resource *newResource(RenderCommandType createCmd, uint32_t size);
+  void record(RenderCommandType type, Resource *pResource, uint32_t arg0 = 0, uint32_t arg1 = 0, uint32_t arg2 = 0);
+  void setState(RenderCommandType type, Resource *&pBound, Resource *pResource, uint32_t slot = 0);
+
+protected:
+  void releaseResource(void *pResource);
+
+public:
+  RecordingRenderDevice(bool bRecordCommands = false);
+  ~RecordingRenderDevice();
+
+  const char *getShaderFormat();
+
+  // Doesn't compile, the shader source itself stands in for the bytecode.
+  bool compileShader(
+    const std::string &fileName,
+    const char *entryPoint,
+    const char *profile,
+    std::vector<uint8_t> &bytecode);
+
+  RenderVertexShader *createVertexShader(const std::vector<uint8_t> &bytecode);
+  RenderPixelShader *createPixelShader(const std::vector<uint8_t> &bytecode);
+  RenderInputLayout *createInputLayout(RenderVertexFormat format, const std::vector<uint8_t> &vsBytecode);
+
+  // Reads the size from dds and png headers, anything else comes out 1x1.
+  RenderTexture *createTexture(const uint8_t *pFileData, size_t size);
+  bool getTextureSize(RenderTexture *pTexture, uint32_t &width, uint32_t &height);
+  RenderSampler *createSampler(const RenderSamplerDesc &desc);
+  RenderBuffer *createBuffer(RenderBufferType type, uint32_t byteWidth, const void *pInitData);
+  bool updateBuffer(RenderBuffer *pBuffer, const void *pData, uint32_t byteWidth);
+
+  void setVertexShader(RenderVertexShader *pShader);
+  void setPixelShader(RenderPixelShader *pShader);
+  void setInputLayout(RenderInputLayout *pLayout);
+  void setVsConstantBuffer(uint32_t slot, RenderBuffer *pBuffer);
+  bool supportsConstantBufferRanges();
+  void setVsConstantBufferRange(uint32_t slot, RenderBuffer *pBuffer, uint32_t byteOffset, uint32_t byteSize);
+  void setPsTexture(uint32_t slot, RenderTexture *pTexture);
+  void setPsSampler(uint32_t slot, RenderSampler *pSampler);
+  void setVertexBuffer(RenderBuffer *pBuffer, uint32_t stride);
+  void setIndexBuffer(RenderBuffer *pBuffer);
+  void setInstanceBuffer(RenderBuffer *pBuffer, uint32_t stride);
+  void setTopology(RenderTopology topology);
+
+  void draw(uint32_t vertexCnt, uint32_t startVertex);
+  void drawIndexed(uint32_t indexCnt, uint32_t startIndex);
+  void drawIndexedInstanced(uint32_t indexCnt, uint32_t instanceCnt, uint32_t startInstance);
+
+  RenderStats getStats();
+  uint32_t getLiveResourceCnt();
+  const std::vector<RenderCommand> &getCommands();
+
+  // Clears stats and recorded commands. Resources and bound state are kept.
+  void resetStats();
+
+  // One command per line, ex. "draw 0 36 0 0", for diffing against a known good run.
+  bool writeCommandLog(const std::string &fileName);
+
+  static const char *getCommandName(RenderCommandType type);
+};
+
+#endif
@@ -0,0 +1,346 @@
+#include "StateFilterRenderDevice.h"
+#include "../Util.h"
+
+const uint32_t StateFilterRenderDevice::MAX_SLOTS;
+
+// Never a real handle (or topology), so whatever gets set next goes through.
+static const void *const STATE_UNKNOWN = reinterpret_cast<const void*>(~static_cast<uintptr_t>(0));
+static const uint32_t TOPOLOGY_UNKNOWN = ~0u;
+
+StateFilterRenderDevice::StateFilterRenderDevice()
+{
+  m_pTarget = NULL;
+  invalidate();
+}
+
+
+void StateFilterRenderDevice::setTarget(RenderDevice *pTarget)
+{
+  m_pTarget = pTarget;
+  invalidate();
+}
+
+
+RenderDevice *StateFilterRenderDevice::getTarget()
+{
+  return m_pTarget;
+}
+
+
+void StateFilterRenderDevice::invalidate()
+{
+  m_pVs = STATE_UNKNOWN;
+  m_pPs = STATE_UNKNOWN;
+  m_pLayout = STATE_UNKNOWN;
+  m_pVBuffer = STATE_UNKNOWN;
+  m_vbStride = 0;
+  m_pIBuffer = STATE_UNKNOWN;
+  m_pInstBuffer = STATE_UNKNOWN;
+  m_instStride = 0;
+  m_topology = TOPOLOGY_UNKNOWN;
+  for (uint32_t slot = 0; slot < MAX_SLOTS; slot++)
+  {
+    m_vsConstBuffers[slot] = STATE_UNKNOWN;
+    m_vsConstOffsets[slot] = 0;
+    m_vsConstSizes[slot] = 0;
+    m_psTextures[slot] = STATE_UNKNOWN;
+    m_psSamplers[slot] = STATE_UNKNOWN;
+  }
+}
+
+
+RenderStateStats StateFilterRenderDevice::getStats()
+{
+  return m_stats;
+}
+
+
+void StateFilterRenderDevice::resetStats()
+{
+  m_stats = RenderStateStats();
+}
+
+
+bool StateFilterRenderDevice::filter(const void *&pBound, const void *pResource)
+{
+  m_stats.stateSets++;
+  if (pBound == pResource)
+  {
+    return false;
+  }
+
+  pBound = pResource;
+  m_stats.stateChanges++;
+  return true;
+}
+
+
+void StateFilterRenderDevice::forget(const void *pResource)
+{
+  // A later resource can land at the same address, it mustn't look like it's already bound.
+  const void **boundLists[] = { m_vsConstBuffers, m_psTextures, m_psSamplers };
+  for (uint32_t list = 0; list < COUNT_OF(boundLists); list++)
+  {
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++)
+    {
+      if (boundLists[list][slot] == pResource)
+      {
+        boundLists[list][slot] = STATE_UNKNOWN;
+      }
+    }
+  }
+  const void **boundSingles[] = { &m_pVs, &m_pPs, &m_pLayout, &m_pVBuffer, &m_pIBuffer, &m_pInstBuffer };
+  for (uint32_t i = 0; i < COUNT_OF(boundSingles); i++)
+  {
+    if (*boundSingles[i] == pResource)
+    {
+      *boundSingles[i] = STATE_UNKNOWN;
+    }
+  }
+}
+
+
+void StateFilterRenderDevice::releaseResource(void *pResource)
+{
+  if (pResource)
+  {
+    forget(pResource);
+    forwardRelease(m_pTarget, pResource);
+  }
+}
+
+
+const char *StateFilterRenderDevice::getShaderFormat()
+{
+  return m_pTarget->getShaderFormat();
+}
+
+
+bool StateFilterRenderDevice::compileShader(
+  const std::string &fileName,
+  const char *entryPoint,
+  const char *profile,
+  std::vector<uint8_t> &bytecode)
+{
+  return m_pTarget->compileShader(fileName, entryPoint, profile, bytecode);
+}
+
+
+RenderVertexShader *StateFilterRenderDevice::createVertexShader(const std::vector<uint8_t> &bytecode)
+{
+  return m_pTarget->createVertexShader(bytecode);
+}
+
+
+RenderPixelShader *StateFilterRenderDevice::createPixelShader(const std::vector<uint8_t> &bytecode)
+{
+  return m_pTarget->createPixelShader(bytecode);
+}
+
+
+RenderInputLayout *StateFilterRenderDevice::createInputLayout(
+  RenderVertexFormat format,
+  const std::vector<uint8_t> &vsBytecode)
+{
+  return m_pTarget->createInputLayout(format, vsBytecode);
+}
+
+
+RenderTexture *StateFilterRenderDevice::createTexture(const uint8_t *pFileData, size_t size)
+{
+  return m_pTarget->createTexture(pFileData, size);
+}
+
+
+bool StateFilterRenderDevice::getTextureSize(RenderTexture *pTexture, uint32_t &width, uint32_t &height)
+{
+  return m_pTarget->getTextureSize(pTexture, width, height);
+}
+
+
+RenderSampler *StateFilterRenderDevice::createSampler(const RenderSamplerDesc &desc)
+{
+  return m_pTarget->createSampler(desc);
+}
+
+
+RenderBuffer *StateFilterRenderDevice::createBuffer(RenderBufferType type, uint32_t byteWidth, const void *pInitData)
+{
+  return m_pTarget->createBuffer(type, byteWidth, pInitData);
+}
+
+
+bool StateFilterRenderDevice::updateBuffer(RenderBuffer *pBuffer, const void *pData, uint32_t byteWidth)
+{
+  return m_pTarget->updateBuffer(pBuffer, pData, byteWidth);
+}
+
+
+void StateFilterRenderDevice::setVertexShader(RenderVertexShader *pShader)
+{
+  if (filter(m_pVs, pShader))
+  {
+    m_pTarget->setVertexShader(pShader);
+  }
+}
+
+
+void StateFilterRenderDevice::setPixelShader(RenderPixelShader *pShader)
+{
+  if (filter(m_pPs, pShader))
+  {
+    m_pTarget->setPixelShader(pShader);
+  }
+}
+
+
+void StateFilterRenderDevice::setInputLayout(RenderInputLayout *pLayout)
+{
+  if (filter(m_pLayout, pLayout))
+  {
+    m_pTarget->setInputLayout(pLayout);
+  }
+}
+
+
+void StateFilterRenderDevice::setVsConstantBuffer(uint32_t slot, RenderBuffer *pBuffer)
+{
+  // Out of range slots are the target's to complain about.
+  if (slot >= MAX_SLOTS)
+  {
+    m_pTarget->setVsConstantBuffer(slot, pBuffer);
+    return;
+  }
+
+  if (m_vsConstOffsets[slot] || m_vsConstSizes[slot])
+  {
+    m_vsConstOffsets[slot] = 0;
+    m_vsConstSizes[slot] = 0;
+    m_vsConstBuffers[slot] = STATE_UNKNOWN;
+  }
+
+  if (filter(m_vsConstBuffers[slot], pBuffer))
+  {
+    m_pTarget->setVsConstantBuffer(slot, pBuffer);
+  }
+}
+
+
+bool StateFilterRenderDevice::supportsConstantBufferRanges()
+{
+  return m_pTarget->supportsConstantBufferRanges();
+}
+
+
+void StateFilterRenderDevice::setVsConstantBufferRange(
+  uint32_t slot,
+  RenderBuffer *pBuffer,
+  uint32_t byteOffset,
+  uint32_t byteSize)
+{
+  if (slot >= MAX_SLOTS)
+  {
+    m_pTarget->setVsConstantBufferRange(slot, pBuffer, byteOffset, byteSize);
+    return;
+  }
+
+  if (byteOffset != m_vsConstOffsets[slot] || byteSize != m_vsConstSizes[slot])
+  {
+    m_vsConstOffsets[slot] = byteOffset;
+    m_vsConstSizes[slot] = byteSize;
+    m_vsConstBuffers[slot] = STATE_UNKNOWN;
+  }
+
+  if (filter(m_vsConstBuffers[slot], pBuffer))
+  {
+    m_pTarget->setVsConstantBufferRange(slot, pBuffer, byteOffset, byteSize);
+  }
+}
+
+
+void StateFilterRenderDevice::setPsTexture(uint32_t slot, RenderTexture *pTexture)
+{
+  if (slot >= MAX_SLOTS || filter(m_psTextures[slot], pTexture))
+  {
+    m_pTarget->setPsTexture(slot, pTexture);
+  }
+}
+
+
+void StateFilterRenderDevice::setPsSampler(uint32_t slot, RenderSampler *pSampler)
+{
+  if (slot >= MAX_SLOTS || filter(m_psSamplers[slot], pSampler))
+  {
+    m_pTarget->setPsSampler(slot, pSampler);
+  }
+}
+
+
+void StateFilterRenderDevice::setVertexBuffer(RenderBuffer *pBuffer, uint32_t stride)
+{
+  // A stride change alone is still a change.
+  if (stride != m_vbStride)
+  {
+    m_vbStride = stride;
+    m_pVBuffer = STATE_UNKNOWN;
+  }
+
+  if (filter(m_pVBuffer, pBuffer))
+  {
+    m_pTarget->setVertexBuffer(pBuffer, stride);
+  }
+}
+
+
+void StateFilterRenderDevice::setIndexBuffer(RenderBuffer *pBuffer)
+{
+  if (filter(m_pIBuffer, pBuffer))
+  {
+    m_pTarget->setIndexBuffer(pBuffer);
+  }
+}
+
+
+void StateFilterRenderDevice::setInstanceBuffer(RenderBuffer *pBuffer, uint32_t stride)
+{
+  if (stride != m_instStride)
+  {
+    m_instStride = stride;
+    m_pInstBuffer = STATE_UNKNOWN;
+  }
+
+  if (filter(m_pInstBuffer, pBuffer))
+  {
+    m_pTarget->setInstanceBuffer(pBuffer, stride);
+  }
+}
+
+
+void StateFilterRenderDevice::setTopology(RenderTopology topology)
+{
+  m_stats.stateSets++;
+  if (m_topology != static_cast<uint32_t>(topology))
+  {
+    m_topology = topology;
+    m_stats.stateChanges++;
+    m_pTarget->setTopology(topology);
+  }
+}
+
+
+void StateFilterRenderDevice::draw(uint32_t vertexCnt, uint32_t startVertex)
+{
+  m_pTarget->draw(vertexCnt, startVertex);
+}
+
+
+void StateFilterRenderDevice::drawIndexed(uint32_t indexCnt, uint32_t startIndex)
+{
+  m_pTarget->drawIndexed(indexCnt, startIndex);
+}
+
+
+void StateFilterRenderDevice::drawIndexedInstanced(uint32_t indexCnt, uint32_t instanceCnt, uint32_t startInstance)
+{
+  m_pTarget->drawIndexedInstanced(indexCnt, instanceCnt, startInstance);
+}
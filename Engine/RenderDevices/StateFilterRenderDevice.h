@@ -0,0 +1,94 @@
+#ifndef STATE_FILTER_RENDER_DEVICE_H
+#define STATE_FILTER_RENDER_DEVICE_H
+
+#include "../RenderDevice.h"
+
+typedef struct RenderStateStats_
+{
+  uint64_t stateSets{ 0 };        // set*() calls made by the models.
+  uint64_t stateChanges{ 0 };     // The ones passed on, the rest were already bound.
+} RenderStateStats;
+
+// Sits in front of another device and drops set*() calls for state that's already bound, everything else is passed
+// straight through. Models bind all of their state on every render(), so draws that share shaders, layouts, samplers
+// and textures (see GraphicsManager's sorted render queue) only pay for what actually differs.
+//
+// Only knows about state set through it, invalidate() whenever the target may have been bound directly.
+class StateFilterRenderDevice : public RenderDevice
+{
+private:
+  static const uint32_t MAX_SLOTS = 16;
+
+  RenderDevice        *m_pTarget;
+  RenderStateStats     m_stats;
+
+  // Bound state, as far as this filter knows. invalidate() sets everything to STATE_UNKNOWN.
+  const void          *m_pVs;
+  const void          *m_pPs;
+  const void          *m_pLayout;
+  const void          *m_pVBuffer;
+  uint32_t             m_vbStride;
+  const void          *m_pIBuffer;
+  const void          *m_pInstBuffer;
+  uint32_t             m_instStride;
+  uint32_t             m_topology;
+  const void          *m_vsConstBuffers[MAX_SLOTS];
+  uint32_t             m_vsConstOffsets[MAX_SLOTS];     // Byte offset and size of ranges, 0 and 0 for whole buffers.
+  uint32_t             m_vsConstSizes[MAX_SLOTS];
+  const void          *m_psTextures[MAX_SLOTS];
+  const void          *m_psSamplers[MAX_SLOTS];
+
+  // Counts the set, returns true if it has to be passed on.
+  bool filter(const void *&pBound, const void *pResource);
+  void forget(const void *pResource);
+
+protected:
+  void releaseResource(void *pResource);
+
+public:
+  StateFilterRenderDevice();
+
+  void setTarget(RenderDevice *pTarget);
+  RenderDevice *getTarget();
+
+  // Forgets what's bound, so the next set of everything goes through.
+  void invalidate();
+
+  RenderStateStats getStats();
+  void resetStats();
+
+  const char *getShaderFormat();
+  bool compileShader(
+    const std::string &fileName,
+    const char *entryPoint,
+    const char *profile,
+    std::vector<uint8_t> &bytecode);
+
+  RenderVertexShader *createVertexShader(const std::vector<uint8_t> &bytecode);
+  RenderPixelShader *createPixelShader(const std::vector<uint8_t> &bytecode);
+  RenderInputLayout *createInputLayout(RenderVertexFormat format, const std::vector<uint8_t> &vsBytecode);
+  RenderTexture *createTexture(const uint8_t *pFileData, size_t size);
+  bool getTextureSize(RenderTexture *pTexture, uint32_t &width, uint32_t &height);
+  RenderSampler *createSampler(const RenderSamplerDesc &desc);
+  RenderBuffer *createBuffer(RenderBufferType type, uint32_t byteWidth, const void *pInitData);
+  bool updateBuffer(RenderBuffer *pBuffer, const void *pData, uint32_t byteWidth);
+
+  void setVertexShader(RenderVertexShader *pShader);
+  void setPixelShader(RenderPixelShader *pShader);
+  void setInputLayout(RenderInputLayout *pLayout);
+  void setVsConstantBuffer(uint32_t slot, RenderBuffer *pBuffer);
+  bool supportsConstantBufferRanges();
+  void setVsConstantBufferRange(uint32_t slot, RenderBuffer *pBuffer, uint32_t byteOffset, uint32_t byteSize);
+  void setPsTexture(uint32_t slot, RenderTexture *pTexture);
+  void setPsSampler(uint32_t slot, RenderSampler *pSampler);
+  void setVertexBuffer(RenderBuffer *pBuffer, uint32_t stride);
+  void setIndexBuffer(RenderBuffer *pBuffer);
+  void setInstanceBuffer(RenderBuffer *pBuffer, uint32_t stride);
+  void setTopology(RenderTopology topology);
+
+  void draw(uint32_t vertexCnt, uint32_t startVertex);
+  void drawIndexed(uint32_t indexCnt, uint32_t startIndex);
+  void drawIndexedInstanced(uint32_t indexCnt, uint32_t instanceCnt, uint32_t startInstance);
+};
+
+#endif
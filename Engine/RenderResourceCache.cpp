@@ -0,0 +1,277 @@
+#include "RenderResourceCache.h"
+#include "Logger.h"
+#include "Util.h"
+#include <stdio.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+RenderResourceCache gRenderCache;
+
+std::string RenderResourceCache::getTexturePathKey(const std::string &path)
+{
+  // Scene files are written by hand, "Textures\cat.dds" and "Textures/cat.dds" are the same file.
+  std::string key = "tex:" + path;
+  std::replace(key.begin(), key.end(), '\\', '/');
+  return key;
+}
+
+
+std::string RenderResourceCache::getBytecodeKey(const char *kind, const ShaderBytecode &pBytecode)
+{
+  // gShaderCache returns the same object for the same shader, the entry holds a reference so the address stays unique.
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%s:%p", kind, static_cast<const void*>(pBytecode.get()));
+  return buf;
+}
+
+
+void *RenderResourceCache::find(RenderDevice *dev, const std::string &key)
+{
+  DeviceCache &cache = m_devices[dev];
+  auto it = cache.byKey.find(key);
+  if (it == cache.byKey.end())
+  {
+    return NULL;
+  }
+
+  cache.byHandle[it->second].refCnt++;
+  m_stats.hits++;
+  return it->second;
+}
+
+
+void RenderResourceCache::add(RenderDevice *dev, const std::string &key, void *pHandle, uint64_t bytes)
+{
+  DeviceCache &cache = m_devices[dev];
+  cache.byKey[key] = pHandle;
+
+  Entry &entry = cache.byHandle[pHandle];
+  entry.key = key;
+  entry.refCnt = 1;
+  entry.bytes = bytes;
+
+  m_stats.misses++;
+  m_stats.liveResources++;
+  m_stats.textureBytes += bytes;
+}
+
+
+void RenderResourceCache::releaseHandle(RenderDevice *dev, void *pHandle)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  DeviceCache &cache = m_devices[dev];
+  auto it = cache.byHandle.find(pHandle);
+  if (it == cache.byHandle.end())
+  {
+    LOGE("Releasing a render resource the cache doesn't own");
+    return;
+  }
+
+  Entry &entry = it->second;
+  if (--entry.refCnt > 0)
+  {
+    return;
+  }
+
+  cache.byKey.erase(entry.key);
+  for (size_t i = 0; i < entry.texPaths.size(); i++)
+  {
+    cache.byKey.erase(getTexturePathKey(entry.texPaths[i]));
+  }
+  m_stats.liveResources--;
+  m_stats.textureBytes -= entry.bytes;
+  cache.byHandle.erase(it);
+
+  // All the handle types are the same underneath, the overload only picks the type for the compiler.
+  dev->release(static_cast<RenderTexture*>(pHandle));
+}
+
+
+RenderTexture *RenderResourceCache::failTexture(
+  RenderDevice *dev,
+  const std::string &pathKey,
+  const char *reason,
+  const std::string &path)
+{
+  LOGW("Failed to %s texture: %s", reason, path.c_str());
+  m_devices[dev].failedTexPaths.insert(pathKey);
+  return NULL;
+}
+
+
+void RenderResourceCache::textureReadFailed(RenderDevice *dev, const std::string &path)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::string pathKey = getTexturePathKey(path);
+  if (!m_devices[dev].failedTexPaths.count(pathKey))
+  {
+    failTexture(dev, pathKey, "read", path);
+  }
+}
+
+
+bool RenderResourceCache::needsTextureData(RenderDevice *dev, const std::string &path)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  DeviceCache &cache = m_devices[dev];
+  std::string pathKey = getTexturePathKey(path);
+  return cache.byKey.find(pathKey) == cache.byKey.end() &&
+    cache.failedTexPaths.find(pathKey) == cache.failedTexPaths.end();
+}
+
+
+RenderTexture *RenderResourceCache::acquireTexture(
+  RenderDevice *dev,
+  const std::string &path,
+  const std::vector<uint8_t> &fileData)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  std::string pathKey = getTexturePathKey(path);
+  void *pHandle = find(dev, pathKey);
+  if (pHandle)
+  {
+    return static_cast<RenderTexture*>(pHandle);
+  }
+
+  if (m_devices[dev].failedTexPaths.count(pathKey))
+  {
+    return NULL;
+  }
+
+  // The caller can skip the read when needsTextureData() said no, but the last user may have released it since.
+  std::vector<uint8_t> readData;
+  const std::vector<uint8_t> *pData = &fileData;
+  if (fileData.empty())
+  {
+    std::ifstream fs(path, std::ios::binary);
+    readData.assign(std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>());
+    pData = &readData;
+  }
+
+  if (pData->empty())
+  {
+    return failTexture(dev, pathKey, "read", path);
+  }
+
+  // Same content under a new path.
+  char contentKey[64];
+  snprintf(contentKey, sizeof(contentKey), "texdata:%016llx:%zu",
+    static_cast<unsigned long long>(hashFnv1a(pData->data(), pData->size())),
+    pData->size());
+
+  DeviceCache &cache = m_devices[dev];
+  pHandle = find(dev, contentKey);
+  if (pHandle)
+  {
+    m_stats.textureContentHits++;
+  }
+  else
+  {
+    pHandle = dev->createTexture(pData->data(), pData->size());
+    if (!pHandle)
+    {
+      return failTexture(dev, pathKey, "create", path);
+    }
+    add(dev, contentKey, pHandle, pData->size());
+  }
+
+  cache.byKey[pathKey] = pHandle;
+  cache.byHandle[pHandle].texPaths.push_back(path);
+  return static_cast<RenderTexture*>(pHandle);
+}
+
+
+RenderSampler *RenderResourceCache::acquireSampler(RenderDevice *dev, const RenderSamplerDesc &desc)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  char key[32];
+  snprintf(key, sizeof(key), "smp:%d:%d", desc.filter, desc.address);
+  void *pHandle = find(dev, key);
+  if (!pHandle)
+  {
+    pHandle = dev->createSampler(desc);
+    if (pHandle)
+    {
+      add(dev, key, pHandle, 0);
+    }
+  }
+
+  return static_cast<RenderSampler*>(pHandle);
+}
+
+
+RenderInputLayout *RenderResourceCache::acquireInputLayout(
+  RenderDevice *dev,
+  RenderVertexFormat format,
+  const ShaderBytecode &pVsBytecode)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  // The layout is checked against the vertex shader's input signature, so it's only shared for the same shader.
+  char formatStr[16];
+  snprintf(formatStr, sizeof(formatStr), "ial%d", format);
+  std::string key = getBytecodeKey(formatStr, pVsBytecode);
+  void *pHandle = find(dev, key);
+  if (!pHandle)
+  {
+    pHandle = dev->createInputLayout(format, *pVsBytecode);
+    if (pHandle)
+    {
+      add(dev, key, pHandle, 0);
+      m_devices[dev].byHandle[pHandle].pBytecode = pVsBytecode;
+    }
+  }
+
+  return static_cast<RenderInputLayout*>(pHandle);
+}
+
+
+RenderVertexShader *RenderResourceCache::acquireVertexShader(RenderDevice *dev, const ShaderBytecode &pBytecode)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  std::string key = getBytecodeKey("vs", pBytecode);
+  void *pHandle = find(dev, key);
+  if (!pHandle)
+  {
+    pHandle = dev->createVertexShader(*pBytecode);
+    if (pHandle)
+    {
+      add(dev, key, pHandle, 0);
+      m_devices[dev].byHandle[pHandle].pBytecode = pBytecode;
+    }
+  }
+
+  return static_cast<RenderVertexShader*>(pHandle);
+}
+
+
+RenderPixelShader *RenderResourceCache::acquirePixelShader(RenderDevice *dev, const ShaderBytecode &pBytecode)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  std::string key = getBytecodeKey("ps", pBytecode);
+  void *pHandle = find(dev, key);
+  if (!pHandle)
+  {
+    pHandle = dev->createPixelShader(*pBytecode);
+    if (pHandle)
+    {
+      add(dev, key, pHandle, 0);
+      m_devices[dev].byHandle[pHandle].pBytecode = pBytecode;
+    }
+  }
+
+  return static_cast<RenderPixelShader*>(pHandle);
+}
+
+
+RenderResourceCacheStats RenderResourceCache::getStats()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_stats;
+}
@@ -0,0 +1,100 @@
+#ifndef RENDER_RESOURCE_CACHE_H
+#define RENDER_RESOURCE_CACHE_H
+
+#include "RenderDevice.h"
+#include "ShaderCache.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+typedef struct RenderResourceCacheStats_
+{
+  uint32_t hits{ 0 };               // Acquires served by an existing resource.
+  uint32_t misses{ 0 };             // Acquires that had to create one.
+  uint32_t textureContentHits{ 0 }; // Texture hits found by content under a different path, part of hits.
+  uint32_t liveResources{ 0 };
+  uint64_t textureBytes{ 0 };       // File size of the live textures.
+} RenderResourceCacheStats;
+
+// Reference-counted, per-device sharing of the resources that were created per model: textures (by path, then by
+// content hash, so copies of a file under another name share too), samplers (by description), input layouts (by
+// vertex format and vertex shader) and shader objects (by bytecode). Resource count and texture memory grow with
+// the unique assets in a scene rather than its object count.
+//
+// Shader bytecode is keyed by the ShaderBytecode object gShaderCache hands out, which is already one per unique
+// shader, so acquiring never hashes it. Texture paths that fail to load are remembered, later models using the same
+// missing file don't open it again.
+//
+// Everything acquired must be released through the cache, not straight through the device, and the same number of
+// times. Like the device itself, acquire and release only from the thread that owns the device, except
+// needsTextureData and textureReadFailed, which loader threads use to skip reading files that are already loaded or
+// known to be missing.
+class RenderResourceCache
+{
+private:
+  typedef struct Entry_
+  {
+    std::string key;
+    uint32_t    refCnt;
+    uint64_t    bytes;
+    std::vector<std::string> texPaths;    // Every path a texture was acquired under.
+    ShaderBytecode pBytecode;             // Keeps the object a shader key names alive, so its address isn't reused.
+  } Entry;
+
+  // What one device has created through the cache. Keys are by resource kind ("tex:", "smp:", ...), handles are
+  // unique across kinds since each one is a separate device object.
+  typedef struct DeviceCache_
+  {
+    std::unordered_map<std::string, void*> byKey;
+    std::unordered_map<void*, Entry>       byHandle;
+    std::unordered_set<std::string>        failedTexPaths;    // Path keys that couldn't be read or created.
+  } DeviceCache;
+
+  std::mutex m_mutex;
+  std::unordered_map<RenderDevice*, DeviceCache> m_devices;
+  RenderResourceCacheStats m_stats;
+
+  static std::string getTexturePathKey(const std::string &path);
+  static std::string getBytecodeKey(const char *kind, const ShaderBytecode &pBytecode);
+
+  void *find(RenderDevice *dev, const std::string &key);
+  void add(RenderDevice *dev, const std::string &key, void *pHandle, uint64_t bytes);
+  RenderTexture *failTexture(RenderDevice *dev, const std::string &pathKey, const char *reason, const std::string &path);
+  void releaseHandle(RenderDevice *dev, void *pHandle);
+
+public:
+  // False if path is already loaded as a texture on dev, or already failed to load, either way there's nothing to
+  // read. Thread safe.
+  bool needsTextureData(RenderDevice *dev, const std::string &path);
+
+  // For callers that read the file themselves, records that path couldn't be read. Thread safe.
+  void textureReadFailed(RenderDevice *dev, const std::string &path);
+
+  // fileData is the file's contents, it may be left empty if needsTextureData() was false, the file's read if needed.
+  RenderTexture *acquireTexture(RenderDevice *dev, const std::string &path, const std::vector<uint8_t> &fileData);
+  RenderSampler *acquireSampler(RenderDevice *dev, const RenderSamplerDesc &desc);
+  RenderInputLayout *acquireInputLayout(RenderDevice *dev, RenderVertexFormat format, const ShaderBytecode &pVsBytecode);
+  RenderVertexShader *acquireVertexShader(RenderDevice *dev, const ShaderBytecode &pBytecode);
+  RenderPixelShader *acquirePixelShader(RenderDevice *dev, const ShaderBytecode &pBytecode);
+
+  void release(RenderDevice *dev, RenderTexture *pTexture)          { releaseHandle(dev, pTexture); }
+  void release(RenderDevice *dev, RenderSampler *pSampler)          { releaseHandle(dev, pSampler); }
+  void release(RenderDevice *dev, RenderInputLayout *pLayout)       { releaseHandle(dev, pLayout); }
+  void release(RenderDevice *dev, RenderVertexShader *pShader)      { releaseHandle(dev, pShader); }
+  void release(RenderDevice *dev, RenderPixelShader *pShader)       { releaseHandle(dev, pShader); }
+
+  RenderResourceCacheStats getStats();
+};
+
+extern RenderResourceCache gRenderCache;
+
+// Releases x through gRenderCache and NULLs it, the cached counterpart of RENDER_RELEASE_NON_NULL.
+#define RENDER_CACHE_RELEASE_NON_NULL(dev, x) \
+{                                             \
+  if(x) gRenderCache.release(dev, x);         \
+  x = NULL;                                   \
+}
+
+#endif
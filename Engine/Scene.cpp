@@ -3,6 +3,8 @@
 #include "../Scenes/TestScene.h"
 #include "GraphicsManager.h"
 #include "PhysicsMgr.h"
+#include "Ecs/Systems.h"
+#include <unordered_set>
 
 Scene::Scene()
 {
@@ -12,12 +14,313 @@ Scene::~Scene()
 {
 }
 
-bool Scene::init(ID3D11Device *dev, ID3D11DeviceContext *devcon)
+bool Scene::init(RenderDevice *dev)
 {
   return true;
 }
 
-bool Scene::update(ID3D11Device *dev, ID3D11DeviceContext *devcon, SceneIo &sceneIo)
+
+bool Scene::loadSceneFile(RenderDevice *dev)
+{
+  if (m_bHotReload)
+  {
+    m_hotReloader.start(m_sceneFile, m_sceneIdOffset);
+  }
+
+  if (!m_bStreamLevel)
+  {
+    m_objMgr.generateFromFile(m_sceneFile, dev, m_sceneIdOffset);
+    return true;
+  }
+
+  // Everything within load range is in place before the first update, later chunks stream in.
+  if (!m_streamer.start(dev, m_sceneFile, m_sceneIdOffset))
+  {
+    return false;
+  }
+
+  m_streamer.update(dev, m_objMgr, LEVEL_STREAM_WAIT_ALL);
+  return !m_streamer.isFailed();
+}
+
+
+bool Scene::beginLoad(RenderDevice *dev, SceneLoadProgressCb progressCb)
+{
+  if (m_sceneFile.empty())
+  {
+    LOGE("Scene type %d has no scene file to load", m_type);
+    return false;
+  }
+
+  if (m_bHotReload)
+  {
+    m_hotReloader.start(m_sceneFile, m_sceneIdOffset);
+  }
+
+  // Streamed levels only load the chunks around the start location, the streamer's worker handles that.
+  if (m_bStreamLevel)
+  {
+    return m_streamer.start(dev, m_sceneFile, m_sceneIdOffset);
+  }
+
+  return m_loader.start(dev, m_sceneFile, m_sceneIdOffset, progressCb);
+}
+
+
+bool Scene::pumpLoad(RenderDevice *dev)
+{
+  if (m_bStreamLevel)
+  {
+    m_streamer.update(dev, m_objMgr, LEVEL_STREAM_WAIT_NONE);
+    return m_streamer.isReady() || m_streamer.isFailed();
+  }
+
+  return m_loader.pump(dev, m_objMgr);
+}
+
+
+bool Scene::isLoaded()
+{
+  if (m_bStreamLevel)
+  {
+    return m_streamer.isReady();
+  }
+
+  return m_loader.isDone();
+}
+
+void Scene::applyHotReload(RenderDevice *dev, double timeMs)
+{
+  SceneDiff diff;
+  if (!m_hotReloader.poll(timeMs, diff))
+  {
+    return;
+  }
+
+  // Streamed levels also have to update their chunk index, and only have the loaded chunks' objects to touch.
+  if (m_bStreamLevel)
+  {
+    m_streamer.applyDiff(diff, dev, m_objMgr);
+    return;
+  }
+
+  for (auto it = diff.removed.begin(); it != diff.removed.end(); ++it)
+  {
+    m_objMgr.removeObject(*it);
+  }
+
+  for (auto it = diff.moved.begin(); it != diff.moved.end(); ++it)
+  {
+    m_objMgr.setObjectPos(it->id, it->loc);
+  }
+
+  for (auto it = diff.added.begin(); it != diff.added.end(); ++it)
+  {
+    std::string tex = it->tex;
+    m_objMgr.addBlock(it->id, it->loc, it->dim, tex, dev);
+  }
+}
+
+
+void Scene::setStaticBatching(bool bStaticBatch)
+{
+  m_bStaticBatch = bStaticBatch;
+}
+
+
+void Scene::setStaticMeshOptimization(bool bOptimize)
+{
+  m_staticBatch.setOptimize(bOptimize);
+}
+
+
+StaticBatch &Scene::getStaticBatch()
+{
+  return m_staticBatch;
+}
+
+
+void Scene::setBoxInstancing(bool bInstanceBoxes)
+{
+  m_bInstanceBoxes = bInstanceBoxes;
+}
+
+
+void Scene::setFrustumCulling(bool bCull)
+{
+  m_culler.setEnabled(bCull);
+}
+
+
+FrustumCullStats Scene::getCullStats()
+{
+  return m_culler.getStats();
+}
+
+
+uint32_t Scene::getWorldMatrixUpdates()
+{
+  return m_worldMatUpdates;
+}
+
+
+void Scene::updateWorldMatrices()
+{
+  m_worldMatUpdates = runTransformSystem(m_objMgr.getEntities(), m_transformScratch);
+
+  m_dirtyObjs.clear();
+  m_dirtyPositions.clear();
+  m_dirtyRotations.clear();
+  m_objMgr.forEachInSet(OBJECT_SET_RENDER, [&](uint32_t id, GameObject &obj)
+  {
+    if (obj.isWorldMatrixDirty())
+    {
+      m_dirtyObjs.push_back(&obj);
+      m_dirtyPositions.push_back(obj.getPos());
+      m_dirtyRotations.push_back(obj.getRot());
+    }
+    return true;
+  });
+
+  uint32_t dirtyCnt = static_cast<uint32_t>(m_dirtyObjs.size());
+  m_dirtyWorldMats.resize(dirtyCnt);
+  GraphicsManager::calcWorldMatrices(
+    m_dirtyPositions.data(),
+    m_dirtyRotations.data(),
+    m_dirtyWorldMats.data(),
+    dirtyCnt);
+  for (uint32_t i = 0; i < dirtyCnt; i++)
+  {
+    m_dirtyObjs[i]->setWorldMatrix(m_dirtyWorldMats[i]);
+  }
+  m_worldMatUpdates += dirtyCnt;
+}
+
+
+void Scene::renderStaticBatch(RenderDevice *dev, SceneIo &sceneIo)
+{
+  uint32_t entityVersion = m_objMgr.getEntityVersion();
+  if (!m_bStaticBatchBuilt || entityVersion != m_staticBatchVersion)
+  {
+    if (!runStaticBatchSystem(m_objMgr.getEntities(), m_staticBatch, dev))
+    {
+      LOGW("Static batch build failed, drawing blocks one by one");
+    }
+    m_bStaticBatchBuilt = true;
+    m_staticBatchVersion = entityVersion;
+  }
+
+  // Vertices are already in world space.
+  sceneIo.pGraphicsMgr->setPosAndRot(Pos3(), Pos3());
+  sceneIo.pGraphicsMgr->renderModel(&m_staticBatch, dev);
+}
+
+
+void Scene::setUpdateDependency(uint32_t id, uint32_t dependsOnId)
+{
+  m_updateDeps.push_back(std::make_pair(id, dependsOnId));
+}
+
+
+JobId Scene::getUpdateJob(uint32_t id)
+{
+  auto it = m_objUpdateJobs.find(id);
+  return (it != m_objUpdateJobs.end()) ? it->second : JOB_ID_INVALID;
+}
+
+
+void Scene::addUpdateJobs(RenderDevice *dev, SceneIo &sceneIo, JobGraph &graph)
+{
+}
+
+
+// Each object's update only writes to that object (and its models), so objects can update in parallel. Types that
+// need the immediate context are pinned to the main thread.
+bool Scene::runUpdateJobs(RenderDevice *dev, SceneIo &sceneIo)
+{
+  m_objMgr.captureUpdateStates();
+  m_updateJobs.clear();
+  m_objUpdateJobs.clear();
+
+  std::unordered_set<uint32_t> depIds;
+  for (auto it = m_updateDeps.begin(); it != m_updateDeps.end(); ++it)
+  {
+    depIds.insert(it->first);
+    depIds.insert(it->second);
+  }
+
+  auto updateObj = [dev, &sceneIo](GameObject *pObj)
+  {
+    if (!GameObject::updateGameObject(pObj, dev, sceneIo.timeMs, sceneIo.input, sceneIo.pSoundMgr))
+    {
+      LOGE("Failed to update object [%u]", pObj->getUuid());
+      return false;
+    }
+    return true;
+  };
+
+  std::vector<std::pair<uint32_t, GameObject*>> batch;
+  auto addBatchJob = [&]()
+  {
+    JobId job = m_updateJobs.addJob([batch, updateObj]()
+    {
+      for (auto it = batch.begin(); it != batch.end(); ++it)
+      {
+        if (!updateObj(it->second))
+        {
+          return false;
+        }
+      }
+      return true;
+    });
+
+    for (auto it = batch.begin(); it != batch.end(); ++it)
+    {
+      m_objUpdateJobs[it->first] = job;
+    }
+    batch.clear();
+  };
+
+  // Object pointers stay valid while the jobs run, nothing is added or removed until they're done.
+  m_objMgr.forEachInSet(OBJECT_SET_UPDATE, [&](uint32_t id, GameObject &obj)
+  {
+    GameObject *pObj = &obj;
+    bool bThreadSafe = GameObject::isUpdateThreadSafe(pObj);
+    if (bThreadSafe && !depIds.count(id))
+    {
+      batch.push_back(std::make_pair(id, pObj));
+      if (batch.size() == UPDATE_JOB_BATCH_SIZE)
+      {
+        addBatchJob();
+      }
+      return true;
+    }
+
+    m_objUpdateJobs[id] = m_updateJobs.addJob([pObj, updateObj]() { return updateObj(pObj); }, !bThreadSafe);
+    return true;
+  });
+
+  if (!batch.empty())
+  {
+    addBatchJob();
+  }
+
+  for (auto it = m_updateDeps.begin(); it != m_updateDeps.end(); ++it)
+  {
+    JobId job = getUpdateJob(it->first);
+    JobId dependsOn = getUpdateJob(it->second);
+    if (job != JOB_ID_INVALID && dependsOn != JOB_ID_INVALID)
+    {
+      m_updateJobs.addDependency(job, dependsOn);
+    }
+  }
+
+  addUpdateJobs(dev, sceneIo, m_updateJobs);
+  return m_updateJobs.run(sceneIo.pJobSystem);
+}
+
+
+bool Scene::update(RenderDevice *dev, SceneIo &sceneIo)
 {
   //LOGD("~~~~~~~~~~ New Scene Update ~~~~~~~~~~");
 
@@ -33,79 +336,149 @@ bool Scene::update(ID3D11Device *dev, ID3D11DeviceContext *devcon, SceneIo &scen
     return false;
   }
 
+  if (m_bHotReload)
+  {
+    applyHotReload(dev, sceneIo.timeMs);
+  }
+
+  // Stream level chunks around the focus. Nearby chunks have to be in place before they get simulated.
+  if (m_bStreamLevel)
+  {
+    m_streamer.update(dev, m_objMgr, LEVEL_STREAM_WAIT_REQUIRED);
+  }
+
   // 1st loop: Register objects with physics manager
   PModelInput tempPmIn;
-  for (auto pObj = m_objMgr.getFirstPObj(); pObj != NULL; pObj = m_objMgr.getNextPObj())
+  bool bRegistered = m_objMgr.forEachInSet(OBJECT_SET_PHYSICS, [&](uint32_t id, GameObject &obj)
   {
-    tempPmIn.pModel = pObj->getPModel();
-    tempPmIn.pos    = pObj->getPos();
-    tempPmIn.vel    = pObj->getVel();
-    tempPmIn.rot    = pObj->getRot();
-    tempPmIn.rotVel = pObj->getRotVel();
-    if (!sceneIo.pPhysicsMgr->registerModel(pObj->getUuid(), &tempPmIn))
+    tempPmIn.pModel = obj.getPModel();
+    tempPmIn.pos    = obj.getPos();
+    tempPmIn.vel    = obj.getVel();
+    tempPmIn.rot    = obj.getRot();
+    tempPmIn.rotVel = obj.getRotVel();
+    if (!sceneIo.pPhysicsMgr->registerModel(obj.getUuid(), &tempPmIn))
     {
-      LOGE("Failed to update object [%u]", pObj->getUuid());
+      LOGE("Failed to update object [%u]", obj.getUuid());
       return false;
     }
+    return true;
+  });
+
+  if (!bRegistered || !runPhysicsRegisterSystem(m_objMgr.getEntities(), sceneIo.pPhysicsMgr))
+  {
+    return false;
   }
 
-  // Run physics
+  // Run physics. Bodies far from the camera are simulated at a lower level-of-detail.
+  sceneIo.pPhysicsMgr->setLodFocus(sceneIo.camEye);
   sceneIo.pPhysicsMgr->run(sceneIo.timeMs);
 
   // 2nd loop: get physics results
   PModelOutput tempPmOut;
-  for (auto pObj = m_objMgr.getFirstPObj(); pObj != NULL; pObj = m_objMgr.getNextPObj())
+  m_objMgr.forEachInSet(OBJECT_SET_PHYSICS, [&](uint32_t id, GameObject &obj)
   {
-    sceneIo.pPhysicsMgr->getResult(pObj->getUuid(), &tempPmOut);
+    sceneIo.pPhysicsMgr->getResult(obj.getUuid(), &tempPmOut);
    
-    //LOGD("Handling obj %u", pObj>getUuid());
+    //LOGD("Handling obj %u", obj.getUuid());
 
     // Default update, ex. for controllable obj even if no collisions happened.
-    pObj->setPos(tempPmOut.pos);
-    pObj->setVel(tempPmOut.vel);
-    pObj->setRot(tempPmOut.rot);
-    pObj->setRotVel(tempPmOut.rotVel);
+    obj.setPos(tempPmOut.pos);
+    obj.setVel(tempPmOut.vel);
+    obj.setRot(tempPmOut.rot);
+    obj.setRotVel(tempPmOut.rotVel);
 
     // Object and Scene level collision handling.
     int cnt = 0;
     for (auto collIt = tempPmOut.collisions.begin(); collIt != tempPmOut.collisions.end(); ++collIt)
     {
       // Object level handling
-      pObj->handleCollision(collIt->first, cnt++);
+      obj.handleCollision(collIt->first, cnt++);
 
       // Scene level handling
       // Leaving out cnt for now - overall object order within a scene isn't well-definined, so collision ordering only has meaning within a particular object, not a scene-wide level.
-      handleCollision(pObj, &tempPmOut);
+      handleCollision(&obj, &tempPmOut);
 
       // Assign back to object.
       // Do this every loop so that any position resets applied from one collision handling can be accounted for in the next collision.
       // Ex) If first collision changes position/vel of object, the second collision handling can run based on the updated position/vel.
-      pObj->setPos(tempPmOut.pos);
-      pObj->setVel(tempPmOut.vel);
-      pObj->setRot(tempPmOut.rot);
-      pObj->setRotVel(tempPmOut.rotVel);
+      obj.setPos(tempPmOut.pos);
+      obj.setVel(tempPmOut.vel);
+      obj.setRot(tempPmOut.rot);
+      obj.setRotVel(tempPmOut.rotVel);
     }
+    return true;
+  });
+  runPhysicsResultSystem(m_objMgr.getEntities(), sceneIo.pPhysicsMgr);
+
+  // 3rd loop: (non-physics) update routines, only for objects with per-frame logic. Runs as parallel jobs, nothing
+  // gets rendered until all of them are done.
+  if (!runUpdateJobs(dev, sceneIo))
+  {
+    return false;
+  }
+
+  // 4th loop: render visible objects and entities, with the world matrices of whatever moved rebuilt first.
+  updateWorldMatrices();
+  if (m_bStaticBatch)
+  {
+    renderStaticBatch(dev, sceneIo);
+  }
+
+  BoxInstancer *pInstancer = NULL;
+  if (m_bInstanceBoxes)
+  {
+    pInstancer = &m_boxInstancer;
+    pInstancer->begin();
   }
 
-  // 3rd loop: (non-physics) update routines for visible objects.
-  // TODO: Consider separating set of updateable objects from visible objects. Not necessarily the same.
-  for (auto pObj = m_objMgr.getFirstVObj(); pObj != NULL; pObj = m_objMgr.getNextVObj())
+  // Updates have placed the camera for this frame, cull against it. GameMgr sets it again before drawing.
+  sceneIo.pGraphicsMgr->setCamera(sceneIo.camEye, sceneIo.camLookAt, sceneIo.camUp);
+  m_culler.begin(sceneIo.pGraphicsMgr->getViewProjMatrix());
+
+  runRenderSystem(m_objMgr.getEntities(), m_culler);
+  bool bSuccess = m_objMgr.forEachInSet(OBJECT_SET_RENDER, [&](uint32_t id, GameObject &obj)
+  {
+    m_culler.add(obj.getVModel(), obj.getWorldMatrix());
+    return true;
+  });
+
+  m_culler.cull();
+  for (uint32_t i = 0; i < m_culler.getItemCnt(); i++)
   {
-    if (!GameObject::updateGameObject(pObj, dev, devcon, sceneIo.timeMs, sceneIo.input, sceneIo.pSoundMgr))
+    if (!m_culler.isVisible(i))
     {
-      LOGE("Failed to update object [%u]", pObj->getUuid());
-      return false;
+      continue;
+    }
+
+    VisualModel *pModel = m_culler.getModel(i);
+    const Mat4 &worldMat = m_culler.getWorldMatrix(i);
+    if (pInstancer && pInstancer->add(pModel, worldMat))
+    {
+      continue;
     }
 
-    sceneIo.pGraphicsMgr->setPosAndRot(pObj->getPos(), pObj->getRot());
-    sceneIo.pGraphicsMgr->renderModel(pObj->getVModel(), dev, devcon);
+    sceneIo.pGraphicsMgr->setWorldMatrix(worldMat);
+    sceneIo.pGraphicsMgr->renderModel(pModel, dev);
   }
 
-  return true;
+  // Instances carry their own world matrix.
+  if (pInstancer && pInstancer->build(dev))
+  {
+    sceneIo.pGraphicsMgr->setPosAndRot(Pos3(), Pos3());
+    sceneIo.pGraphicsMgr->renderModel(pInstancer, dev);
+  }
+
+  return bSuccess;
 }
 
 bool Scene::release()
 {
+  m_loader.cancel();
+  m_streamer.stop();
+  m_hotReloader.stop();
+  m_staticBatch.release();
+  m_bStaticBatchBuilt = false;
+  m_boxInstancer.release();
   return m_objMgr.release();
 }
 
@@ -122,7 +495,7 @@ SceneType Scene::getType()
 }
 
 
-bool Scene::updateScene(Scene* pScene, ID3D11Device *dev, ID3D11DeviceContext *devcon, SceneIo &sceneIo)
+bool Scene::updateScene(Scene* pScene, RenderDevice *dev, SceneIo &sceneIo)
 {
   if (!pScene)
   {
@@ -135,7 +508,7 @@ bool Scene::updateScene(Scene* pScene, ID3D11Device *dev, ID3D11DeviceContext *d
   {
     case SCENE_TYPE_TEST:
     {
-      static_cast<TestScene*>(pScene)->update(dev, devcon, sceneIo);
+      static_cast<TestScene*>(pScene)->update(dev, sceneIo);
       return false;
     }
     default:
@@ -175,28 +548,29 @@ bool Scene::releaseScene(Scene* pScene)
 }
 
 
-bool Scene::prelimUpdate(ID3D11Device *dev, ID3D11DeviceContext *devcon, SceneIo &sceneIo)
+bool Scene::prelimUpdate(RenderDevice *dev, SceneIo &sceneIo)
 {
   // Each object belonging to the scene should also run its prelimUpdate processing.
   bool bSuccess = true;
-  for (auto it = m_objMgr.begin(); it != m_objMgr.end(); ++it)
+  m_objMgr.forEachObject([&](uint32_t id, GameObject &obj)
   {
-    if (!GameObject::prelimUpdateGameObject(it->second, dev, devcon, sceneIo.timeMs, sceneIo.input, sceneIo.pSoundMgr))
+    if (!GameObject::prelimUpdateGameObject(&obj, dev, sceneIo.timeMs, sceneIo.input, sceneIo.pSoundMgr))
     {
-      LOGW("Prelim update failed for obj [%u], continuing", it->first);
+      LOGW("Prelim update failed for obj [%u], continuing", id);
       bSuccess = false;
     }
     else
     {
-      LOGD("Ran prelim update for obj [%u]", it->first);
+      LOGD("Ran prelim update for obj [%u]", id);
     }
-  }
+    return true;
+  });
 
   return bSuccess;
 }
 
 
-bool Scene::prelimUpdateScene(Scene* pScene, ID3D11Device *dev, ID3D11DeviceContext *devcon, SceneIo &sceneIo)
+bool Scene::prelimUpdateScene(Scene* pScene, RenderDevice *dev, SceneIo &sceneIo)
 {
   if (!pScene)
   {
@@ -209,7 +583,7 @@ bool Scene::prelimUpdateScene(Scene* pScene, ID3D11Device *dev, ID3D11DeviceCont
   {
     case SCENE_TYPE_TEST:
     {
-      static_cast<TestScene*>(pScene)->prelimUpdate(dev, devcon, sceneIo);
+      static_cast<TestScene*>(pScene)->prelimUpdate(dev, sceneIo);
       return false;
     }
     default:
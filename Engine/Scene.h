@@ -2,7 +2,18 @@
 #define GAME_SCENE_H
 
 #include "ObjectManager.h"
+#include "SceneLoader.h"
+#include "LevelStreamer.h"
+#include "SceneHotReload.h"
+#include "JobSystem.h"
+#include "FrustumCuller.h"
+#include "VisualModels/StaticBatch.h"
+#include "VisualModels/BoxInstancer.h"
+#include "Ecs/Systems.h"
 #include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 class Scene;
 class GraphicsManager;
@@ -22,6 +33,7 @@ typedef struct SceneIo_
   GraphicsManager *pGraphicsMgr;
   PhysicsManager  *pPhysicsMgr;
   SoundMgr        *pSoundMgr;
+  JobSystem       *pJobSystem;    // Runs object updates in parallel, optional.
   InputApi input;
 
   // Outputs:
@@ -38,6 +50,7 @@ typedef struct SceneIo_
     pGraphicsMgr  = NULL;
     pPhysicsMgr   = NULL;
     pSoundMgr     = NULL;
+    pJobSystem    = NULL;
     pNextScene    = NULL;
   }
 
@@ -50,18 +63,79 @@ protected:
   SceneType m_type = SCENE_TYPE_NONE;
   ObjectManager m_objMgr;
 
+  // Scene file loaded into m_objMgr, and the ID that its objects start at.
+  std::string m_sceneFile;
+  uint32_t m_sceneIdOffset = 0;
+  SceneLoader m_loader;
+
+  // Streamed scenes only keep the chunks around the focus (see LevelStreamer.h) loaded, instead of the whole file.
+  bool m_bStreamLevel = false;
+  LevelStreamer m_streamer;
+
+  // Watch m_sceneFile and apply edits to the live scene as they're saved.
+  bool m_bHotReload = false;
+  SceneHotReloader m_hotReloader;
+
+  void applyHotReload(RenderDevice *dev, double timeMs);
+
+  // Immobile entities (level blocks) are drawn from one pre-transformed batch, see StaticBatch.h. It's rebuilt in the
+  // render pass whenever entities were added, removed or moved since the last build, which only meshes and uploads
+  // the chunk sized cells that changed.
+  bool m_bStaticBatch = false;
+  bool m_bStaticBatchBuilt = false;
+  uint32_t m_staticBatchVersion = 0;
+  StaticBatch m_staticBatch;
+
+  void renderStaticBatch(RenderDevice *dev, SceneIo &sceneIo);
+
+  // World matrices are cached with the objects and entities, and only the ones that moved are rebuilt, in one batch
+  // per frame (see GraphicsManager::calcWorldMatrices). Scratch space for both batches is kept between frames.
+  uint32_t m_worldMatUpdates = 0;
+  TransformSystemScratch m_transformScratch;
+  std::vector<GameObject*> m_dirtyObjs;
+  std::vector<Pos3> m_dirtyPositions;
+  std::vector<Pos3> m_dirtyRotations;
+  std::vector<Mat4> m_dirtyWorldMats;
+
+  void updateWorldMatrices();
+
+  // Boxes that aren't in the static batch are drawn as instances of one shared mesh, see BoxInstancer.h. Collected
+  // again every frame, since they may have moved.
+  bool m_bInstanceBoxes = false;
+  BoxInstancer m_boxInstancer;
+
+  // Objects and entities outside the camera's view aren't submitted at all.
+  FrustumCuller m_culler;
+
+  // Object updates run as a job graph, rebuilt every frame. Objects that nothing depends on (and that depend on
+  // nothing) are batched UPDATE_JOB_BATCH_SIZE to a job.
+  static const uint32_t UPDATE_JOB_BATCH_SIZE = 32;
+  JobGraph m_updateJobs;
+  std::unordered_map<uint32_t, JobId> m_objUpdateJobs;
+  std::vector<std::pair<uint32_t, uint32_t>> m_updateDeps;   // (object ID, ID of the object it depends on)
+
+  bool runUpdateJobs(RenderDevice *dev, SceneIo &sceneIo);
+
+  // The object's update won't start until dependsOnId's update is done, so it can read that object's state for this
+  // frame. Any other object should only be read through ObjectManager::getPrevState() during updates.
+  void setUpdateDependency(uint32_t id, uint32_t dependsOnId);
+
+  // Job running the object's update this frame, JOB_ID_INVALID if it has none. For use in addUpdateJobs().
+  JobId getUpdateJob(uint32_t id);
+
+  // Lets scenes add their own per-frame jobs (ex. a camera following the player) to the update graph.
+  virtual void addUpdateJobs(RenderDevice *dev, SceneIo &sceneIo, JobGraph &graph);
+
 public:
   static bool updateScene(
     Scene* pScene,
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     SceneIo &sceneIo);
 
   // Happens before the first update is called, useful for loading sounds, other resources that'll be used later.
   static bool prelimUpdateScene(
     Scene* pScene,
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     SceneIo &sceneIo);
 
   static bool releaseScene(Scene* pScene);
@@ -69,11 +143,36 @@ public:
   SceneType getType();
 
   Scene();
-  ~Scene();
-  virtual bool init(ID3D11Device *dev, ID3D11DeviceContext *devcon);
+  virtual ~Scene();
+  virtual bool init(RenderDevice *dev);
+
+  // Loads m_sceneFile, either in full or as a streamed level.
+  bool loadSceneFile(RenderDevice *dev);
+
+  // Background alternative to init(): loads the scene file on a worker thread.
+  // pumpLoad() has to be called from the main thread until it returns true.
+  bool beginLoad(RenderDevice *dev, SceneLoadProgressCb progressCb = SceneLoadProgressCb());
+  bool pumpLoad(RenderDevice *dev);
+  bool isLoaded();
+
+  // Set before the scene loads.
+  void setStaticBatching(bool bStaticBatch);
+  void setStaticMeshOptimization(bool bOptimize);
+  void setBoxInstancing(bool bInstanceBoxes);
+  void setFrustumCulling(bool bCull);
+
+  // For stats, ex. how many triangles its mesher removed.
+  StaticBatch &getStaticBatch();
+
+  // Last frame's culling counts.
+  FrustumCullStats getCullStats();
+
+  // How many world matrices the last frame had to rebuild.
+  uint32_t getWorldMatrixUpdates();
+
   virtual bool release();
-  virtual bool update(ID3D11Device *dev, ID3D11DeviceContext *devcon, SceneIo &sceneIo);
-  virtual bool prelimUpdate(ID3D11Device *dev, ID3D11DeviceContext *devcon, SceneIo &sceneIo);
+  virtual bool update(RenderDevice *dev, SceneIo &sceneIo);
+  virtual bool prelimUpdate(RenderDevice *dev, SceneIo &sceneIo);
   virtual void handleCollision(GameObject* obj, PModelOutput *pModelOut);
 };
 
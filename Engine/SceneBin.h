@@ -0,0 +1,106 @@
+#ifndef SCENE_BIN_H
+#define SCENE_BIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary scene format, the load-ready counterpart to the 'P'/'B' text scenes (Tools/SceneBinConverter.py converts).
+// Layout, all little-endian:
+//   SceneBinHeader
+//   SceneBinObject[objectCount]  at objectTableOffset
+//   string table                 at stringTableOffset, NUL-terminated strings referenced by byte offset
+// The file is meant to be mmap'd and walked in place, so every struct is fixed size and 4-byte aligned.
+// Bump SCENE_BIN_VERSION on any layout change; the loader rejects other versions.
+
+#define SCENE_BIN_MAGIC       0x4E435344  // "DSCN"
+#define SCENE_BIN_VERSION     1
+
+typedef enum SceneBinObjectType_
+{
+  SCENE_BIN_OBJ_PLAYER = 0,   // 'P {loc}'
+  SCENE_BIN_OBJ_BLOCK         // 'B {loc} {dim} {texture}'
+} SceneBinObjectType;
+
+typedef struct SceneBinHeader_
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t headerSize;          // sizeof(SceneBinHeader), lets newer readers skip fields they don't know.
+  uint32_t objectCount;
+  uint32_t objectTableOffset;   // Byte offset from the start of the file.
+  uint32_t stringTableOffset;   // Byte offset from the start of the file.
+  uint32_t stringTableSize;     // In bytes.
+  uint32_t reserved;
+} SceneBinHeader;
+
+typedef struct SceneBinObject_
+{
+  uint32_t type;            // SceneBinObjectType.
+  uint32_t id;              // Object ID before the scene's idOffset is applied (text line number for blocks).
+  float    loc[3];
+  float    dim[3];          // Unused for the player.
+  uint32_t textureOffset;   // Offset into the string table.
+  uint32_t reserved;
+} SceneBinObject;
+
+static_assert(sizeof(SceneBinHeader) == 32, "SceneBinHeader layout changed, bump SCENE_BIN_VERSION");
+static_assert(sizeof(SceneBinObject) == 40, "SceneBinObject layout changed, bump SCENE_BIN_VERSION");
+
+
+// Checks the header and table bounds of a mapped scene. On success the object table and string table can be read
+// directly out of pData.
+inline bool sceneBinValidate(const uint8_t *pData, size_t size)
+{
+  if (!pData || size < sizeof(SceneBinHeader))
+  {
+    return false;
+  }
+
+  const SceneBinHeader *pHeader = reinterpret_cast<const SceneBinHeader*>(pData);
+  if (pHeader->magic != SCENE_BIN_MAGIC ||
+      pHeader->version != SCENE_BIN_VERSION ||
+      pHeader->headerSize < sizeof(SceneBinHeader))
+  {
+    return false;
+  }
+
+  uint64_t objTableEnd = static_cast<uint64_t>(pHeader->objectTableOffset) +
+    static_cast<uint64_t>(pHeader->objectCount) * sizeof(SceneBinObject);
+  uint64_t strTableEnd = static_cast<uint64_t>(pHeader->stringTableOffset) + pHeader->stringTableSize;
+
+  if (pHeader->objectTableOffset % 4 != 0 || objTableEnd > size || strTableEnd > size)
+  {
+    return false;
+  }
+
+  // String table must end with a terminator so no lookup can run off the end of the mapping.
+  if (pHeader->stringTableSize > 0 && pData[strTableEnd - 1] != '\0')
+  {
+    return false;
+  }
+
+  return true;
+}
+
+inline const SceneBinHeader* sceneBinHeader(const uint8_t *pData)
+{
+  return reinterpret_cast<const SceneBinHeader*>(pData);
+}
+
+inline const SceneBinObject* sceneBinObjects(const uint8_t *pData)
+{
+  return reinterpret_cast<const SceneBinObject*>(pData + sceneBinHeader(pData)->objectTableOffset);
+}
+
+// Returns NULL for offsets outside the string table.
+inline const char* sceneBinString(const uint8_t *pData, uint32_t offset)
+{
+  const SceneBinHeader *pHeader = sceneBinHeader(pData);
+  if (offset >= pHeader->stringTableSize)
+  {
+    return NULL;
+  }
+  return reinterpret_cast<const char*>(pData + pHeader->stringTableOffset + offset);
+}
+
+#endif
@@ -0,0 +1,303 @@
+#include "SceneHotReload.h"
+#include "Logger.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <system_error>
+#include <unordered_set>
+
+const uint32_t SceneHotReloader::POLL_INTERVAL_MS;
+
+SceneHotReloader::BlockRecorder::BlockRecorder(std::vector<SceneBlockEntry> &entries) : m_entries(entries)
+{
+}
+
+
+void SceneHotReloader::BlockRecorder::addPlayer(const Pos3 &loc, RenderDevice *dev)
+{
+}
+
+
+void SceneHotReloader::BlockRecorder::addBlock(
+  uint32_t id,
+  const Pos3 &loc,
+  const Pos3 &dim,
+  std::string &tex,
+  RenderDevice *dev)
+{
+  SceneBlockEntry entry;
+  entry.desc.id   = id;
+  entry.desc.loc  = loc;
+  entry.desc.dim  = dim;
+  entry.desc.tex  = tex;
+  entry.bParsed   = true;
+
+  // Exact content, so blocks only match if nothing about them changed.
+  float vals[6] = { loc.pos.x, loc.pos.y, loc.pos.z, dim.pos.x, dim.pos.y, dim.pos.z };
+  entry.key.assign(reinterpret_cast<const char*>(vals), sizeof(vals));
+  entry.key += tex;
+  m_entries.push_back(entry);
+}
+
+
+static void hashCombine(size_t &seed, size_t val)
+{
+  seed ^= val + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+
+size_t SceneHotReloader::shapeHash(const LevelBlockDesc &desc)
+{
+  size_t seed = std::hash<std::string>()(desc.tex);
+  hashCombine(seed, std::hash<float>()(desc.dim.pos.x));
+  hashCombine(seed, std::hash<float>()(desc.dim.pos.y));
+  hashCombine(seed, std::hash<float>()(desc.dim.pos.z));
+  return seed;
+}
+
+
+bool SceneHotReloader::isSameShape(const LevelBlockDesc &a, const LevelBlockDesc &b)
+{
+  return a.tex == b.tex &&
+    a.dim.pos.x == b.dim.pos.x &&
+    a.dim.pos.y == b.dim.pos.y &&
+    a.dim.pos.z == b.dim.pos.z;
+}
+
+
+// Text scenes only collect the block lines here, they're parsed later if they turn out to have changed.
+bool SceneHotReloader::readFile(std::vector<SceneBlockEntry> &entries)
+{
+  if (ObjectManager::isBinSceneFile(m_filename))
+  {
+    BlockRecorder recorder(entries);
+    return recorder.generateFromBinFile(m_filename, NULL, m_idOffset);
+  }
+
+  std::ifstream fs(m_filename);
+  if (!fs)
+  {
+    return false;
+  }
+
+  // Same IDs as ObjectManager::generateFromFile().
+  std::string curLine;
+  uint32_t lineCnt = 0;
+  while (std::getline(fs, curLine))
+  {
+    lineCnt++;
+    if (curLine.size() < 2 || curLine[0] != 'B' || (curLine[1] != ' ' && curLine[1] != '\t'))
+    {
+      continue;
+    }
+
+    entries.push_back(SceneBlockEntry());
+    entries.back().key.swap(curLine);
+    entries.back().desc.id = lineCnt + m_idOffset;
+  }
+
+  return true;
+}
+
+
+void SceneHotReloader::addLive(const SceneBlockEntry &entry)
+{
+  LiveBlock &live = m_live[entry.desc.id];
+  live.key = entry.key;
+  live.desc = entry.desc;
+  live.bParsed = entry.bParsed;
+  m_liveByKey.insert(std::make_pair(entry.key, entry.desc.id));
+}
+
+
+void SceneHotReloader::removeLive(uint32_t id)
+{
+  auto it = m_live.find(id);
+  if (it == m_live.end())
+  {
+    return;
+  }
+
+  auto range = m_liveByKey.equal_range(it->second.key);
+  for (auto keyIt = range.first; keyIt != range.second; ++keyIt)
+  {
+    if (keyIt->second == id)
+    {
+      m_liveByKey.erase(keyIt);
+      break;
+    }
+  }
+  m_live.erase(it);
+}
+
+
+bool SceneHotReloader::start(const std::string &filename, uint32_t idOffset)
+{
+  stop();
+
+  std::error_code err;
+  m_lastWriteTime = std::filesystem::last_write_time(filename, err);
+  if (err)
+  {
+    LOGE("Can't watch scene file %s", filename.c_str());
+    return false;
+  }
+
+  m_filename = filename;
+  m_idOffset = idOffset;
+
+  std::vector<SceneBlockEntry> entries;
+  readFile(entries);
+  for (auto it = entries.begin(); it != entries.end(); ++it)
+  {
+    addLive(*it);
+    m_nextId = std::max(m_nextId, it->desc.id + 1);
+  }
+
+  m_bStarted = true;
+  LOGI("Watching scene file %s, %u blocks", filename.c_str(), static_cast<uint32_t>(m_live.size()));
+  return true;
+}
+
+
+void SceneHotReloader::stop()
+{
+  m_live.clear();
+  m_liveByKey.clear();
+  m_nextId = 0;
+  m_lastPollMs = 0.0;
+  m_bStarted = false;
+}
+
+
+bool SceneHotReloader::poll(double timeMs, SceneDiff &diff)
+{
+  if (!m_bStarted || timeMs - m_lastPollMs < POLL_INTERVAL_MS)
+  {
+    return false;
+  }
+  m_lastPollMs = timeMs;
+
+  std::error_code err;
+  std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(m_filename, err);
+  if (err || writeTime == m_lastWriteTime)
+  {
+    return false;
+  }
+  m_lastWriteTime = writeTime;
+
+  std::vector<SceneBlockEntry> entries;
+  if (!readFile(entries) || (entries.empty() && !m_live.empty()))
+  {
+    // Most likely caught the file half written, the finished save bumps the write time again.
+    LOGW("Couldn't read blocks from %s, skipping reload", m_filename.c_str());
+    return false;
+  }
+
+  diff = SceneDiff();
+  computeDiff(entries, diff);
+  LOGI("Reloaded %s: %u added, %u removed, %u moved",
+    m_filename.c_str(),
+    static_cast<uint32_t>(diff.added.size()),
+    static_cast<uint32_t>(diff.removed.size()),
+    static_cast<uint32_t>(diff.moved.size()));
+  return !diff.empty();
+}
+
+
+void SceneHotReloader::computeDiff(std::vector<SceneBlockEntry> &entries, SceneDiff &diff)
+{
+  // Match unchanged blocks by key. Duplicate keys are fine, each live block is only claimed once.
+  std::unordered_set<uint32_t> claimed;
+  claimed.reserve(m_live.size());
+  std::vector<SceneBlockEntry*> unmatchedNew;
+  for (auto it = entries.begin(); it != entries.end(); ++it)
+  {
+    bool bFound = false;
+    auto range = m_liveByKey.equal_range(it->key);
+    for (auto liveIt = range.first; liveIt != range.second; ++liveIt)
+    {
+      if (claimed.insert(liveIt->second).second)
+      {
+        bFound = true;
+        break;
+      }
+    }
+
+    if (!bFound)
+    {
+      unmatchedNew.push_back(&*it);
+    }
+  }
+
+  // Whatever's left on both sides is the edit.
+  std::unordered_multimap<size_t, uint32_t> unmatchedLiveByShape;
+  for (auto it = m_live.begin(); it != m_live.end(); ++it)
+  {
+    if (claimed.count(it->first))
+    {
+      continue;
+    }
+
+    LiveBlock &live = it->second;
+    if (!live.bParsed)
+    {
+      ObjectManager::parseBlockLine(live.key, live.desc.loc, live.desc.dim, live.desc.tex);
+      live.bParsed = true;
+    }
+    unmatchedLiveByShape.insert(std::make_pair(shapeHash(live.desc), it->first));
+  }
+
+  // Pair up blocks of the same shape as moves, closest first, anything else is added.
+  for (auto it = unmatchedNew.begin(); it != unmatchedNew.end(); ++it)
+  {
+    SceneBlockEntry &entry = **it;
+    if (!entry.bParsed && !ObjectManager::parseBlockLine(entry.key, entry.desc.loc, entry.desc.dim, entry.desc.tex))
+    {
+      LOGW("Skipping bad block line: %s", entry.key.c_str());
+      continue;
+    }
+
+    auto range = unmatchedLiveByShape.equal_range(shapeHash(entry.desc));
+    auto bestIt = unmatchedLiveByShape.end();
+    float bestDist2 = 0.0f;
+    for (auto liveIt = range.first; liveIt != range.second; ++liveIt)
+    {
+      const LevelBlockDesc &live = m_live[liveIt->second].desc;
+      if (!isSameShape(live, entry.desc))
+      {
+        continue;
+      }
+
+      Pos3 delta = live.loc - entry.desc.loc;
+      float dist2 = delta.pos.x * delta.pos.x + delta.pos.y * delta.pos.y + delta.pos.z * delta.pos.z;
+      if (bestIt == unmatchedLiveByShape.end() || dist2 < bestDist2)
+      {
+        bestIt = liveIt;
+        bestDist2 = dist2;
+      }
+    }
+
+    entry.bParsed = true;
+    if (bestIt != unmatchedLiveByShape.end())
+    {
+      entry.desc.id = bestIt->second;
+      unmatchedLiveByShape.erase(bestIt);
+      removeLive(entry.desc.id);
+      diff.moved.push_back(entry.desc);
+    }
+    else
+    {
+      // IDs in the file may already be taken by live blocks, so new blocks get fresh ones.
+      entry.desc.id = m_nextId++;
+      diff.added.push_back(entry.desc);
+    }
+    addLive(entry);
+  }
+
+  for (auto it = unmatchedLiveByShape.begin(); it != unmatchedLiveByShape.end(); ++it)
+  {
+    diff.removed.push_back(it->second);
+    removeLive(it->second);
+  }
+}
@@ -0,0 +1,85 @@
+#ifndef SCENE_HOT_RELOAD_H
+#define SCENE_HOT_RELOAD_H
+
+#include "LevelStreamer.h"
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Watches a scene file and diffs each saved version against the blocks that are live in the scene, so edits (ex. a
+// re-run of MapParser.py) can be applied without reloading the level.
+//
+// Blocks are matched by content, not by ID: text scene IDs are line numbers, so inserting one block would otherwise
+// renumber everything after it. Unchanged blocks keep their objects, and unmatched blocks with the same size and
+// texture are paired up as moves. Text scenes are compared line by line and only changed lines get parsed, so apart
+// from reading the file, reload cost (parsing, objects, GPU resources) is proportional to the size of the edit.
+// The player line is ignored after the initial load.
+class SceneHotReloader
+{
+private:
+  static const uint32_t POLL_INTERVAL_MS = 500;
+
+  // A block as read from the file. key is the raw line for text scenes, or the packed content for binary scenes.
+  typedef struct SceneBlockEntry_
+  {
+    std::string     key;
+    LevelBlockDesc  desc;
+    bool            bParsed{ false };
+  } SceneBlockEntry;
+
+  // Records a binary scene's blocks instead of creating them.
+  class BlockRecorder : public ObjectManager
+  {
+  private:
+    std::vector<SceneBlockEntry> &m_entries;
+
+  public:
+    BlockRecorder(std::vector<SceneBlockEntry> &entries);
+    void addPlayer(const Pos3 &loc, RenderDevice *dev);
+    void addBlock(
+      uint32_t id,
+      const Pos3 &loc,
+      const Pos3 &dim,
+      std::string &tex,
+      RenderDevice *dev);
+  };
+
+  // Text blocks are only parsed once they're part of an edit.
+  typedef struct LiveBlock_
+  {
+    std::string     key;
+    LevelBlockDesc  desc;
+    bool            bParsed{ false };
+  } LiveBlock;
+
+  std::string m_filename;
+  uint32_t    m_idOffset{ 0 };
+  bool        m_bStarted{ false };
+  double      m_lastPollMs{ 0.0 };
+  std::filesystem::file_time_type m_lastWriteTime;
+
+  // Blocks as they are in the scene right now, by object ID and by key.
+  std::unordered_map<uint32_t, LiveBlock> m_live;
+  std::unordered_multimap<std::string, uint32_t> m_liveByKey;
+  uint32_t m_nextId{ 0 };
+
+  static size_t shapeHash(const LevelBlockDesc &desc);
+  static bool isSameShape(const LevelBlockDesc &a, const LevelBlockDesc &b);
+
+  bool readFile(std::vector<SceneBlockEntry> &entries);
+  void addLive(const SceneBlockEntry &entry);
+  void removeLive(uint32_t id);
+  void computeDiff(std::vector<SceneBlockEntry> &entries, SceneDiff &diff);
+
+public:
+  // Records the file's current blocks as the live state, the scene itself loads them as usual.
+  bool start(const std::string &filename, uint32_t idOffset);
+  void stop();
+
+  // Checks the file every POLL_INTERVAL_MS of scene time. Returns true, with the changes in diff, if a new version
+  // of the file was saved. The diff is taken as applied.
+  bool poll(double timeMs, SceneDiff &diff);
+};
+
+#endif
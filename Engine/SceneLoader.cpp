@@ -0,0 +1,221 @@
+#include "SceneLoader.h"
+#include "Logger.h"
+#include "VisualModel.h"
+#include <chrono>
+
+SceneLoader::StagingObjectManager::StagingObjectManager(SceneLoader *pLoader)
+{
+  m_pLoader = pLoader;
+  setDeferGpuInit(true);
+}
+
+
+void SceneLoader::StagingObjectManager::addObject(uint32_t id, GameObject* pObj)
+{
+  m_pLoader->enqueue(id, pObj);
+}
+
+
+SceneLoader::SceneLoader()
+{
+}
+
+
+SceneLoader::~SceneLoader()
+{
+  cancel();
+}
+
+
+bool SceneLoader::start(
+  RenderDevice *dev,
+  const std::string &filename,
+  uint32_t idOffset,
+  SceneLoadProgressCb progressCb)
+{
+  if (isBusy())
+  {
+    LOGE("Scene load already in progress, can't start %s", filename.c_str());
+    return false;
+  }
+
+  // Clear out any leftovers from a previous load.
+  cancel();
+
+  m_bCancel = false;
+  m_bParseDone = false;
+  m_bParseFailed = false;
+  m_parsedObjs = 0;
+  m_progress = SceneLoadProgress();
+  m_progressCb = progressCb;
+
+  setStage(SCENE_LOAD_STAGE_PARSE);
+  m_worker = std::thread(&SceneLoader::workerMain, this, dev, filename, idOffset);
+  return true;
+}
+
+
+void SceneLoader::workerMain(RenderDevice *dev, std::string filename, uint32_t idOffset)
+{
+  LOGI("Background load of %s started", filename.c_str());
+
+  // Only the device's shader compiler is used while GPU init is deferred.
+  StagingObjectManager stagingMgr(this);
+  stagingMgr.generateFromFile(filename, dev, idOffset);
+
+  if (m_parsedObjs == 0)
+  {
+    LOGE("Background load of %s produced no objects", filename.c_str());
+    m_bParseFailed = true;
+  }
+
+  LOGI("Background load of %s parsed %u objects", filename.c_str(), m_parsedObjs.load());
+  m_bParseDone = true;
+}
+
+
+void SceneLoader::enqueue(uint32_t id, GameObject* pObj)
+{
+  if (m_bCancel)
+  {
+    GameObject::releaseGameObject(pObj);
+    delete pObj;
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_queueMutex);
+  m_queue.push_back(std::make_pair(id, pObj));
+  m_parsedObjs++;
+}
+
+
+bool SceneLoader::pump(RenderDevice *dev, ObjectManager &target)
+{
+  if (m_progress.stage == SCENE_LOAD_STAGE_IDLE ||
+    m_progress.stage == SCENE_LOAD_STAGE_DONE ||
+    m_progress.stage == SCENE_LOAD_STAGE_FAILED)
+  {
+    return m_progress.stage != SCENE_LOAD_STAGE_IDLE;
+  }
+
+  // Check before draining, so anything queued ahead of the flag is guaranteed to be handled this pump.
+  bool bParseDone = m_bParseDone;
+
+  auto startTime = std::chrono::steady_clock::now();
+  bool bProgress = false;
+  bool bQueueEmpty = false;
+  while (!bQueueEmpty)
+  {
+    std::pair<uint32_t, GameObject*> entry;
+    {
+      std::lock_guard<std::mutex> lock(m_queueMutex);
+      if (m_queueHead >= m_queue.size())
+      {
+        m_queue.clear();
+        m_queueHead = 0;
+        bQueueEmpty = true;
+        continue;
+      }
+      entry = m_queue[m_queueHead++];
+    }
+
+    if (!VisualModel::createVModelResources(entry.second->getVModel(), dev))
+    {
+      LOGW("Failed to create GPU resources for obj [%u], continuing", entry.first);
+    }
+
+    target.addObject(entry.first, entry.second);
+    m_progress.readyObjs++;
+    bProgress = true;
+
+    auto elapsed = std::chrono::steady_clock::now() - startTime;
+    if (std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() >= PUMP_BUDGET_US)
+    {
+      break;
+    }
+  }
+
+  m_progress.parsedObjs = m_parsedObjs;
+  if (bParseDone && bQueueEmpty)
+  {
+    m_worker.join();
+    setStage(m_bParseFailed ? SCENE_LOAD_STAGE_FAILED : SCENE_LOAD_STAGE_DONE);
+    return true;
+  }
+
+  if (bParseDone && m_progress.stage == SCENE_LOAD_STAGE_PARSE)
+  {
+    setStage(SCENE_LOAD_STAGE_GPU);
+  }
+  else if (bProgress && m_progressCb)
+  {
+    m_progressCb(m_progress);
+  }
+
+  return false;
+}
+
+
+bool SceneLoader::isBusy()
+{
+  return m_progress.stage == SCENE_LOAD_STAGE_PARSE || m_progress.stage == SCENE_LOAD_STAGE_GPU;
+}
+
+
+bool SceneLoader::isDone()
+{
+  return m_progress.stage == SCENE_LOAD_STAGE_DONE;
+}
+
+
+bool SceneLoader::isFailed()
+{
+  return m_progress.stage == SCENE_LOAD_STAGE_FAILED;
+}
+
+
+const SceneLoadProgress& SceneLoader::getProgress()
+{
+  return m_progress;
+}
+
+
+void SceneLoader::cancel()
+{
+  m_bCancel = true;
+  if (m_worker.joinable())
+  {
+    m_worker.join();
+  }
+
+  releaseQueued();
+  if (isBusy())
+  {
+    m_progress.stage = SCENE_LOAD_STAGE_IDLE;
+  }
+}
+
+
+void SceneLoader::releaseQueued()
+{
+  std::lock_guard<std::mutex> lock(m_queueMutex);
+  for (size_t i = m_queueHead; i < m_queue.size(); i++)
+  {
+    GameObject::releaseGameObject(m_queue[i].second);
+    delete m_queue[i].second;
+  }
+
+  m_queue.clear();
+  m_queueHead = 0;
+}
+
+
+void SceneLoader::setStage(SceneLoadStage stage)
+{
+  m_progress.stage = stage;
+  m_progress.parsedObjs = m_parsedObjs;
+  if (m_progressCb)
+  {
+    m_progressCb(m_progress);
+  }
+}
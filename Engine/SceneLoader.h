@@ -0,0 +1,91 @@
+#ifndef SCENE_LOADER_H
+#define SCENE_LOADER_H
+
+#include "ObjectManager.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+typedef enum SceneLoadStage_
+{
+  SCENE_LOAD_STAGE_IDLE = 0,
+  SCENE_LOAD_STAGE_PARSE,   // Worker is reading the scene file and building objects.
+  SCENE_LOAD_STAGE_GPU,     // Main thread is creating GPU resources for the parsed objects.
+  SCENE_LOAD_STAGE_DONE,
+  SCENE_LOAD_STAGE_FAILED
+} SceneLoadStage;
+
+typedef struct SceneLoadProgress_
+{
+  SceneLoadStage stage{ SCENE_LOAD_STAGE_IDLE };
+  uint32_t parsedObjs{ 0 };   // Objects built by the worker so far.
+  uint32_t readyObjs{ 0 };    // Objects with GPU resources, handed over to the target ObjectManager.
+} SceneLoadProgress;
+
+// Progress callbacks are only ever called from pump(), i.e. on the main thread.
+typedef std::function<void(const SceneLoadProgress&)> SceneLoadProgressCb;
+
+// Loads a scene file on a worker thread. The worker does the file IO, parsing, shader compiles and object setup,
+// pump() finishes each object's GPU resources on the main thread and hands it to the target ObjectManager.
+class SceneLoader
+{
+private:
+  // Main thread time spent creating GPU resources per pump() call, so a running scene keeps its frame rate.
+  static const uint32_t PUMP_BUDGET_US = 4000;
+
+  // Object manager used by the worker. Objects are queued for the main thread instead of being stored.
+  class StagingObjectManager : public ObjectManager
+  {
+  private:
+    SceneLoader *m_pLoader;
+
+  public:
+    StagingObjectManager(SceneLoader *pLoader);
+    void addObject(uint32_t id, GameObject* pObj);
+  };
+
+  std::thread m_worker;
+  std::mutex  m_queueMutex;
+  std::vector<std::pair<uint32_t, GameObject*>> m_queue;
+  size_t      m_queueHead{ 0 };
+
+  std::atomic<bool>     m_bCancel{ false };
+  std::atomic<bool>     m_bParseDone{ false };
+  std::atomic<bool>     m_bParseFailed{ false };
+  std::atomic<uint32_t> m_parsedObjs{ 0 };
+
+  SceneLoadProgress   m_progress;
+  SceneLoadProgressCb m_progressCb;
+
+  void workerMain(RenderDevice *dev, std::string filename, uint32_t idOffset);
+  void enqueue(uint32_t id, GameObject* pObj);
+  void releaseQueued();
+  void setStage(SceneLoadStage stage);
+
+public:
+  SceneLoader();
+  ~SceneLoader();
+
+  bool start(
+    RenderDevice *dev,
+    const std::string &filename,
+    uint32_t idOffset,
+    SceneLoadProgressCb progressCb = SceneLoadProgressCb());
+
+  // Run from the main thread (once per frame while loading). Returns true once the load has finished.
+  bool pump(RenderDevice *dev, ObjectManager &target);
+
+  bool isBusy();
+  bool isDone();
+  bool isFailed();
+  const SceneLoadProgress& getProgress();
+
+  // Stops the worker and releases anything that wasn't handed over yet.
+  void cancel();
+};
+
+#endif
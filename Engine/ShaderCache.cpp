@@ -0,0 +1,182 @@
+#include "ShaderCache.h"
+#include "Logger.h"
+#include "Util.h"
+#include <stdio.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+ShaderCache gShaderCache;
+
+static const uint32_t SHADER_CACHE_MAGIC = 0x43444853;   // "SHDC"
+static const uint32_t SHADER_CACHE_VERSION = 1;
+
+typedef struct ShaderCacheFileHeader_
+{
+  uint32_t magic;
+  uint32_t version;
+  uint64_t sourceHash;
+  uint64_t size;
+} ShaderCacheFileHeader;
+
+
+void ShaderCache::setCacheDir(const std::string &dir)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_cacheDir = dir;
+}
+
+
+bool ShaderCache::hashSource(const std::string &fileName, uint64_t &hash)
+{
+  auto it = m_sourceHashes.find(fileName);
+  if (it != m_sourceHashes.end())
+  {
+    hash = it->second;
+    return true;
+  }
+
+  std::ifstream fs(fileName, std::ios::binary);
+  if (!fs)
+  {
+    LOGE("Failed to read shader: %s", fileName.c_str());
+    return false;
+  }
+
+  std::vector<uint8_t> source((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+  hash = hashFnv1a(source.data(), source.size());
+  m_sourceHashes[fileName] = hash;
+  return true;
+}
+
+
+std::string ShaderCache::getCachePath(const std::string &key)
+{
+  return m_cacheDir + "/" + key + ".bin";
+}
+
+
+bool ShaderCache::readCacheFile(const std::string &path, uint64_t sourceHash, std::vector<uint8_t> &bytecode)
+{
+  std::ifstream fs(path, std::ios::binary);
+  if (!fs)
+  {
+    return false;
+  }
+
+  ShaderCacheFileHeader header;
+  if (!fs.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+    header.magic != SHADER_CACHE_MAGIC ||
+    header.version != SHADER_CACHE_VERSION ||
+    header.sourceHash != sourceHash ||
+    header.size == 0)
+  {
+    LOGW("Ignoring bad shader cache file: %s", path.c_str());
+    return false;
+  }
+
+  bytecode.resize(static_cast<size_t>(header.size));
+  if (!fs.read(reinterpret_cast<char*>(bytecode.data()), bytecode.size()))
+  {
+    LOGW("Ignoring truncated shader cache file: %s", path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+
+void ShaderCache::writeCacheFile(const std::string &path, uint64_t sourceHash, const std::vector<uint8_t> &bytecode)
+{
+  std::error_code err;
+  std::filesystem::create_directories(m_cacheDir, err);
+
+  // Written to the side and renamed into place, so another instance of the game never reads half a file.
+  std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream fs(tmpPath, std::ios::binary | std::ios::trunc);
+    ShaderCacheFileHeader header = { SHADER_CACHE_MAGIC, SHADER_CACHE_VERSION, sourceHash, bytecode.size() };
+    if (!fs ||
+      !fs.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+      !fs.write(reinterpret_cast<const char*>(bytecode.data()), bytecode.size()))
+    {
+      LOGW("Failed to write shader cache file: %s", tmpPath.c_str());
+      return;
+    }
+  }
+
+  std::filesystem::rename(tmpPath, path, err);
+  if (err)
+  {
+    LOGW("Failed to write shader cache file: %s", path.c_str());
+    std::filesystem::remove(tmpPath, err);
+  }
+}
+
+
+ShaderBytecode ShaderCache::getBytecode(
+  RenderDevice *dev,
+  const std::string &fileName,
+  const char *entryPoint,
+  const char *profile)
+{
+  // Held through the compile, two loaders asking for the same shader shouldn't both compile it.
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  uint64_t sourceHash;
+  if (!hashSource(fileName, sourceHash))
+  {
+    return NULL;
+  }
+
+  char hashStr[17];
+  snprintf(hashStr, sizeof(hashStr), "%016llx", static_cast<unsigned long long>(sourceHash));
+  std::string key = std::string(dev->getShaderFormat()) + "_" + hashStr + "_" + entryPoint + "_" + profile;
+
+  auto it = m_bytecode.find(key);
+  if (it != m_bytecode.end())
+  {
+    m_stats.memoryHits++;
+    return it->second;
+  }
+
+  std::shared_ptr<std::vector<uint8_t>> pBytecode = std::make_shared<std::vector<uint8_t>>();
+  std::string cachePath = getCachePath(key);
+  if (!m_cacheDir.empty() && readCacheFile(cachePath, sourceHash, *pBytecode))
+  {
+    m_stats.diskHits++;
+  }
+  else
+  {
+    LOGD("Compiling %s %s from %s", entryPoint, profile, fileName.c_str());
+    if (!dev->compileShader(fileName, entryPoint, profile, *pBytecode))
+    {
+      return NULL;
+    }
+    m_stats.compiles++;
+
+    if (!m_cacheDir.empty())
+    {
+      writeCacheFile(cachePath, sourceHash, *pBytecode);
+    }
+  }
+
+  m_bytecode[key] = pBytecode;
+  return pBytecode;
+}
+
+
+ShaderCacheStats ShaderCache::getStats()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_stats;
+}
+
+
+void ShaderCache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_bytecode.clear();
+  m_sourceHashes.clear();
+}
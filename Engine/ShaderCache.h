@@ -0,0 +1,62 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include "RenderDevice.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define SHADER_CACHE_DIR "ShaderCache"
+
+typedef std::shared_ptr<const std::vector<uint8_t>> ShaderBytecode;
+
+typedef struct ShaderCacheStats_
+{
+  uint32_t compiles{ 0 };
+  uint32_t diskHits{ 0 };
+  uint32_t memoryHits{ 0 };
+} ShaderCacheStats;
+
+// Process-wide cache of compiled shaders, keyed by the device's shader format, a hash of the source, the entry point
+// and the profile. Every model used to compile its own copy of the same two shaders. Now each is compiled at most
+// once per process, and the bytecode is written to the cache dir, so once that's warm startup compiles nothing.
+// Editing the source changes its hash, stale entries are just never looked up again.
+//
+// Sources are hashed the first time they're asked for, edits made while the process runs aren't picked up.
+class ShaderCache
+{
+private:
+  std::mutex      m_mutex;        // Scene loader workers compile from their own threads.
+  std::string     m_cacheDir{ SHADER_CACHE_DIR };
+  ShaderCacheStats m_stats;
+
+  std::unordered_map<std::string, ShaderBytecode> m_bytecode;
+  std::unordered_map<std::string, uint64_t>       m_sourceHashes;
+
+  bool hashSource(const std::string &fileName, uint64_t &hash);
+  std::string getCachePath(const std::string &key);
+  bool readCacheFile(const std::string &path, uint64_t sourceHash, std::vector<uint8_t> &bytecode);
+  void writeCacheFile(const std::string &path, uint64_t sourceHash, const std::vector<uint8_t> &bytecode);
+
+public:
+  // Empty to keep the cache in memory only.
+  void setCacheDir(const std::string &dir);
+
+  // Returns NULL if the shader fails to compile. Thread safe.
+  ShaderBytecode getBytecode(
+    RenderDevice *dev,
+    const std::string &fileName,
+    const char *entryPoint,
+    const char *profile);
+
+  ShaderCacheStats getStats();
+
+  // Drops everything held in memory, the cache dir is left alone.
+  void clear();
+};
+
+extern ShaderCache gShaderCache;
+
+#endif
@@ -11,6 +11,22 @@ struct VIn
   float2 tex : TEXCOORD0;
 };
 
+// Shared unit box mesh (see BoxInstancer.h) plus one box per instance. uSel/vSel pick which of the instance's UV
+// scales (U, V, W) the face's texture coordinates are stretched by.
+struct VInInstanced
+{
+  float3 position : POSITION;
+  float2 tex : TEXCOORD0;
+  float3 uSel : TEXCOORD1;
+  float3 vSel : TEXCOORD2;
+  float4 world0 : WORLD0;
+  float4 world1 : WORLD1;
+  float4 world2 : WORLD2;
+  float4 world3 : WORLD3;
+  float3 dimensions : DIMENSIONS;
+  float3 uvScale : UVSCALE;
+};
+
 struct PIn
 {
   float4 position : SV_POSITION;
@@ -32,6 +48,19 @@ PIn VShader(VIn input)
 }
 
 
+// totMat is only the view and projection here, each instance brings its own world matrix.
+PIn VShaderInstanced(VInInstanced input)
+{
+    PIn output;
+    float4x4 world = float4x4(input.world0, input.world1, input.world2, input.world3);
+    float4 worldPos = mul(float4(input.position * input.dimensions, 1.0), world);
+    output.position = mul(totMat, worldPos);
+    output.tex = input.tex * float2(dot(input.uSel, input.uvScale), dot(input.vSel, input.uvScale));
+
+    return output;
+}
+
+
 float4 PShader(PIn input) : SV_TARGET
 {
     float4 textureColor;
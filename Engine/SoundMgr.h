@@ -3,6 +3,12 @@
 
 // http ://www.rastertek.com/dx11tut14.html
 
+#ifdef GAME_HEADLESS
+// Headless builds stub out playback (see Headless/HeadlessStubs.cpp), only the interface pointers are needed.
+struct IDirectSound8;
+struct IDirectSoundBuffer;
+struct IDirectSoundBuffer8;
+#else
 #pragma comment(lib, "dsound.lib")
 #pragma comment(lib, "dxguid.lib")
 #pragma comment(lib, "winmm.lib")
@@ -10,8 +16,11 @@
 #include <windows.h>
 #include <mmsystem.h>
 #include <dsound.h>
+#endif
+#include <stdint.h>
 #include <stdio.h>
 #include <map>
+#include <string>
 
 struct WaveHeaderType
 {
@@ -45,13 +54,16 @@ public:
   SoundMgr();
   ~SoundMgr();
 
+#ifndef GAME_HEADLESS
   bool init(HWND hwnd);
+#endif
   bool release();
 
   // Register a file into the sound manager. Scenes, or anything else that uses this interface, can
   // then use the handle when issuing commands related to this file, ex. stop, play, etc.
   bool registerSound(std::string filename, uint32_t &handle);
 
+  // Safe to call from update jobs (see Scene::update), sounds are only registered before updates start.
   bool playSound(uint32_t handle, bool bLoop=false);
 };
 
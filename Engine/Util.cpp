@@ -1,15 +1,32 @@
 #include "Util.h"
 #include "Logger.h"
+#include <math.h>
+#include <atomic>
 
 
 uint64_t genUUID(void)
 {
   // If we generate one every micro-sec, we won't overflow for over 500 thousand years.
-  static uint64_t uuidCnt = 0;
+  // Atomic since objects can also be created by background scene loads.
+  static std::atomic<uint64_t> uuidCnt(0);
   return uuidCnt++;
 }
 
 
+uint64_t hashFnv1a(const void *pData, size_t size)
+{
+  const uint8_t *pBytes = static_cast<const uint8_t*>(pData);
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < size; i++)
+  {
+    hash ^= pBytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+
+#ifdef _WIN32
 // Relies on Logger already being initialized.
 bool HR_FAILED(HRESULT hr)
 {
@@ -21,8 +38,9 @@ bool HR_FAILED(HRESULT hr)
 
   return false;
 }
+#endif
 
-bool squaresOverlap(Pos2 &center0, Pos2 &wh0, Pos2 &center1, Pos2 &wh1)
+bool squaresOverlap(const Pos2 &center0, const Pos2 &wh0, const Pos2 &center1, const Pos2 &wh1)
 {
   bool intersects;
   float firstVal, secondVal, lowVal;
@@ -59,7 +77,7 @@ bool squaresOverlap(Pos2 &center0, Pos2 &wh0, Pos2 &center1, Pos2 &wh1)
 }
 
 // Note: Could probably speed things up slightly by rewriting the checks in 3D, but better to have SPOT, at least for early dev.
-bool cubesOverlap(Pos3 &center0, Pos3 &wh0, Pos3 &center1, Pos3 &wh1)
+bool cubesOverlap(const Pos3 &center0, const Pos3 &wh0, const Pos3 &center1, const Pos3 &wh1)
 {
   bool bOverlap = squaresOverlap(
     Pos2(center0.pos.x, center0.pos.y),
@@ -77,7 +95,7 @@ bool cubesOverlap(Pos3 &center0, Pos3 &wh0, Pos3 &center1, Pos3 &wh1)
 }
 
 // Find the squared distance between two Pos3 points.
-float dist2(Pos3 &first, Pos3 &second)
+float dist2(const Pos3 &first, const Pos3 &second)
 {
   return
     (first.pos.x - second.pos.x) * (first.pos.x - second.pos.x) +
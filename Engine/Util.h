@@ -1,7 +1,10 @@
 #ifndef UTIL_H
 #define UTIL_H
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
+#include <stddef.h>
 #include <stdint.h>
 #include "CommonTypes.h"
 
@@ -21,12 +24,17 @@
 
 uint64_t genUUID(void);
 
+// FNV-1a, stable across runs and builds, so it's fine for keys that end up on disk.
+uint64_t hashFnv1a(const void *pData, size_t size);
+
+#ifdef _WIN32
 // Relies on Logger already being initialized.
 bool HR_FAILED(HRESULT hr);
+#endif
 
-bool squaresOverlap(Pos2 &center0, Pos2 &wh0, Pos2 &center1, Pos2 &wh1);
-bool cubesOverlap(Pos3 &center0, Pos3 &wh0, Pos3 &center1, Pos3 &wh1);
+bool squaresOverlap(const Pos2 &center0, const Pos2 &wh0, const Pos2 &center1, const Pos2 &wh1);
+bool cubesOverlap(const Pos3 &center0, const Pos3 &wh0, const Pos3 &center1, const Pos3 &wh1);
 
-float dist2(Pos3 &first, Pos3 &second);
+float dist2(const Pos3 &first, const Pos3 &second);
 
 #endif
\ No newline at end of file
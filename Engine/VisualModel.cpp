@@ -5,6 +5,8 @@
 #include "VisualModels/TexRect.h"
 #include "VisualModels/TexBox.h"
 #include "VisualModels/TexCylinder.h"
+#include "VisualModels/StaticBatch.h"
+#include "VisualModels/BoxInstancer.h"
 
 VisualModelType VisualModel::getType()
 {
@@ -24,9 +26,7 @@ bool VisualModel::getStaticScreenLoc()
 }
 
 
-void VisualModel::render(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon)
+void VisualModel::render(RenderDevice *dev)
 {
 }
 
@@ -36,10 +36,14 @@ bool VisualModel::release()
 }
 
 
+VisualModel::~VisualModel()
+{
+}
+
+
 bool VisualModel::renderVModel(
   VisualModel *pModel,
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon)
+  RenderDevice *dev)
 {
   if (!pModel)
   {
@@ -52,32 +56,42 @@ bool VisualModel::renderVModel(
   {
     case VISUAL_MODEL_NONE:
     {
-      pModel->render(dev, devcon);
+      pModel->render(dev);
       break;
     }
     case VISUAL_MODEL_TEX_POLY:
     {
-      static_cast<TexPoly*>(pModel)->render(dev, devcon);
+      static_cast<TexPoly*>(pModel)->render(dev);
       break;
     }
     case VISUAL_MODEL_TEX_RECT:
     {
-      static_cast<TexRect*>(pModel)->render(dev, devcon);
+      static_cast<TexRect*>(pModel)->render(dev);
       break;
     }
     case VISUAL_MODEL_TEX_BOX:
     {
-      static_cast<TexBox*>(pModel)->render(dev, devcon);
+      static_cast<TexBox*>(pModel)->render(dev);
       break;
     }
     case VISUAL_MODEL_TEX_CYLINDER:
     {
-      static_cast<TexCylinder*>(pModel)->render(dev, devcon);
+      static_cast<TexCylinder*>(pModel)->render(dev);
       break;
     }
     case VISUAL_MODEL_TEX_TEXT:
     {
-      static_cast<TexText*>(pModel)->render(dev, devcon);
+      static_cast<TexText*>(pModel)->render(dev);
+      break;
+    }
+    case VISUAL_MODEL_STATIC_BATCH:
+    {
+      static_cast<StaticBatch*>(pModel)->render(dev);
+      break;
+    }
+    case VISUAL_MODEL_BOX_INSTANCER:
+    {
+      static_cast<BoxInstancer*>(pModel)->render(dev);
       break;
     }
     default:
@@ -91,6 +105,112 @@ bool VisualModel::renderVModel(
   return true;
 }
 
+void VisualModel::getRenderState(
+  VisualModel *pModel,
+  RenderVertexShader *&pVs,
+  RenderTexture *&pTexture)
+{
+  pVs = NULL;
+  pTexture = NULL;
+  if (!pModel)
+  {
+    return;
+  }
+
+  switch (pModel->getType())
+  {
+    case VISUAL_MODEL_TEX_POLY:
+    case VISUAL_MODEL_TEX_RECT:
+    case VISUAL_MODEL_TEX_BOX:
+    case VISUAL_MODEL_TEX_CYLINDER:
+    {
+      TexPoly *pPoly = static_cast<TexPoly*>(pModel);
+      pVs = pPoly->getVertexShader();
+      pTexture = pPoly->getTexture();
+      break;
+    }
+    case VISUAL_MODEL_TEX_TEXT:
+    {
+      TexText *pText = static_cast<TexText*>(pModel);
+      pVs = pText->getVertexShader();
+      pTexture = pText->getTexture();
+      break;
+    }
+    case VISUAL_MODEL_STATIC_BATCH:
+    {
+      pVs = static_cast<StaticBatch*>(pModel)->getVertexShader();
+      break;
+    }
+    case VISUAL_MODEL_BOX_INSTANCER:
+    {
+      pVs = static_cast<BoxInstancer*>(pModel)->getVertexShader();
+      break;
+    }
+    default:
+    {
+      break;
+    }
+  }
+}
+
+
+bool VisualModel::getLocalBounds(
+  VisualModel *pModel,
+  Vec3 &boundsMin,
+  Vec3 &boundsMax)
+{
+  if (!pModel)
+  {
+    return false;
+  }
+
+  switch (pModel->getType())
+  {
+    case VISUAL_MODEL_TEX_POLY:
+    case VISUAL_MODEL_TEX_RECT:
+    case VISUAL_MODEL_TEX_BOX:
+    case VISUAL_MODEL_TEX_CYLINDER:
+    {
+      return static_cast<TexPoly*>(pModel)->getLocalBounds(boundsMin, boundsMax);
+    }
+    default:
+    {
+      return false;
+    }
+  }
+}
+
+
+bool VisualModel::createVModelResources(
+  VisualModel *pModel,
+  RenderDevice *dev)
+{
+  if (!pModel)
+  {
+    return true;
+  }
+
+  int modelType = pModel->getType();
+  switch (modelType)
+  {
+    case VISUAL_MODEL_TEX_POLY:
+    case VISUAL_MODEL_TEX_RECT:
+    case VISUAL_MODEL_TEX_BOX:
+    case VISUAL_MODEL_TEX_CYLINDER:
+    {
+      return static_cast<TexPoly*>(pModel)->createResources(dev);
+    }
+    default:
+    {
+      LOGE("Deferred resource creation not supported for model type %d", modelType);
+      return false;
+    }
+  }
+
+  return false;
+}
+
+
 bool VisualModel::releaseVModel(VisualModel *pModel)
 {
   if (!pModel)
@@ -126,6 +246,14 @@ bool VisualModel::releaseVModel(VisualModel *pModel)
     {
       return static_cast<TexBox*>(pModel)->release();
     }
+    case VISUAL_MODEL_STATIC_BATCH:
+    {
+      return static_cast<StaticBatch*>(pModel)->release();
+    }
+    case VISUAL_MODEL_BOX_INSTANCER:
+    {
+      return static_cast<BoxInstancer*>(pModel)->release();
+    }
     default:
     {
       LOGE("VModel type not recognized: %d", vmType);
@@ -2,6 +2,8 @@
 #define VISUAL_MODEL_H
 
 #include "CommonTypes.h"
+#include "RenderDevice.h"
+#include <string>
 #include <vector>
 
 typedef enum VisualModelType_
@@ -11,7 +13,9 @@ typedef enum VisualModelType_
   VISUAL_MODEL_TEX_RECT,
   VISUAL_MODEL_TEX_BOX,
   VISUAL_MODEL_TEX_CYLINDER,
-  VISUAL_MODEL_TEX_TEXT
+  VISUAL_MODEL_TEX_TEXT,
+  VISUAL_MODEL_STATIC_BATCH,
+  VISUAL_MODEL_BOX_INSTANCER
 } VisualModelType;
 
 // Base class for visual/graphics thangs.
@@ -25,20 +29,39 @@ public:
   static bool releaseVModel(VisualModel *pModel);
   static bool renderVModel(
     VisualModel *pModel,
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon);
+    RenderDevice *dev);
+
+  // Shader and texture the model binds, for sorting draws (see GraphicsManager::flush). Models that bind several
+  // textures report NULL.
+  static void getRenderState(
+    VisualModel *pModel,
+    RenderVertexShader *&pVs,
+    RenderTexture *&pTexture);
+
+  // Model space bounding box, for culling (see FrustumCuller). False for models that have none, ex. batches that are
+  // already in world space.
+  static bool getLocalBounds(
+    VisualModel *pModel,
+    Vec3 &boundsMin,
+    Vec3 &boundsMax);
+
+  // Finishes a model that was only prepare()'d, ex. by a background scene load.
+  static bool createVModelResources(
+    VisualModel *pModel,
+    RenderDevice *dev);
 
   VisualModelType getType();
 
   virtual void setStaticScreenLoc(bool bStaticScreenLoc);
   virtual bool getStaticScreenLoc();
 
-  virtual void render(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon);
+  virtual void render(RenderDevice *dev);
 
   // Any derived class that has new dynamic memory should implement its own release().
   virtual bool release();
+
+  // Models are deleted through VisualModel pointers (see GameObject::release).
+  virtual ~VisualModel();
 };
 
 #endif
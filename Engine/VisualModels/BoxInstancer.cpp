@@ -0,0 +1,287 @@
+#include "BoxInstancer.h"
+#include "TexBox.h"
+#include "../Logger.h"
+#include "../RenderResourceCache.h"
+#include <string.h>
+
+static const uint32_t BOX_FACES = 6;
+static const uint32_t BOX_FACE_VERTICES = 4;
+static const uint32_t BOX_FACE_INDICES = 6;
+
+BoxInstancer::BoxInstancer()
+{
+  m_type                = VISUAL_MODEL_BOX_INSTANCER;
+  m_pDevice             = NULL;
+  m_pVs                 = NULL;
+  m_pPs                 = NULL;
+  m_pLayout             = NULL;
+  m_pSampleState        = NULL;
+  m_pVBuffer            = NULL;
+  m_pIBuffer            = NULL;
+  m_pInstBuffer         = NULL;
+  m_instBufferCapacity  = 0;
+  m_instanceCnt         = 0;
+  m_bBuilt              = false;
+}
+
+
+void BoxInstancer::begin()
+{
+  for (size_t i = 0; i < m_groups.size(); i++)
+  {
+    m_groups[i].instances.clear();
+  }
+  m_instanceCnt = 0;
+  m_bBuilt = false;
+}
+
+
+bool BoxInstancer::add(VisualModel *pModel, const Mat4 &world)
+{
+  if (!pModel || pModel->getType() != VISUAL_MODEL_TEX_BOX || pModel->getStaticScreenLoc())
+  {
+    return false;
+  }
+
+  TexBox *pBox = static_cast<TexBox*>(pModel);
+  RenderTexture *pTexture = pBox->getTexture();
+  if (!pTexture)
+  {
+    return false;
+  }
+
+  auto it = m_groupIdx.find(pTexture);
+  if (it == m_groupIdx.end())
+  {
+    Group group;
+    group.pTexture = pTexture;
+    group.startInstance = 0;
+    it = m_groupIdx.insert(std::make_pair(pTexture, static_cast<uint32_t>(m_groups.size()))).first;
+    m_groups.push_back(group);
+  }
+
+  BoxInstance instance;
+  instance.world = world;
+  instance.dim = pBox->getDimensions().pos;
+  instance.uvScale = pBox->getTexScale().pos;
+  m_groups[it->second].instances.push_back(instance);
+
+  m_instanceCnt++;
+  return true;
+}
+
+
+bool BoxInstancer::createShared(RenderDevice *dev)
+{
+  if (m_pVs)
+  {
+    return m_pVBuffer && m_pIBuffer;
+  }
+
+  ShaderBytecode pVsBytecode =
+    gShaderCache.getBytecode(dev, "Engine/Shaders/shaders.shader", "VShaderInstanced", "vs_4_0");
+  ShaderBytecode pPsBytecode = gShaderCache.getBytecode(dev, "Engine/Shaders/shaders.shader", "PShader", "ps_4_0");
+  if (!pVsBytecode || !pPsBytecode)
+  {
+    LOGE("Failed to compile shaders for BoxInstancer");
+    return false;
+  }
+
+  // Same corners as TexBox::prepare, for a 1x1x1 box.
+  Vec3 pt0(-0.5f,  0.5f,  0.5f);
+  Vec3 pt1( 0.5f,  0.5f,  0.5f);
+  Vec3 pt2(-0.5f, -0.5f,  0.5f);
+  Vec3 pt3( 0.5f, -0.5f,  0.5f);
+  Vec3 pt4(-0.5f,  0.5f, -0.5f);
+  Vec3 pt5( 0.5f,  0.5f, -0.5f);
+  Vec3 pt6(-0.5f, -0.5f, -0.5f);
+  Vec3 pt7( 0.5f, -0.5f, -0.5f);
+
+  Vec3 selU(1.0f, 0.0f, 0.0f);
+  Vec3 selV(0.0f, 1.0f, 0.0f);
+  Vec3 selW(0.0f, 0.0f, 1.0f);
+
+  // Front, back, right, left, top, bottom. Each face is a strip of 4, its UVs scaled by (U, V), (W, V) or (U, W).
+  const Vec3 faceCorners[BOX_FACES][BOX_FACE_VERTICES] =
+  {
+    { pt0, pt1, pt2, pt3 },
+    { pt5, pt4, pt7, pt6 },
+    { pt1, pt5, pt3, pt7 },
+    { pt4, pt0, pt6, pt2 },
+    { pt4, pt5, pt0, pt1 },
+    { pt2, pt3, pt6, pt7 }
+  };
+  const Vec3 faceUSel[BOX_FACES] = { selU, selU, selW, selW, selU, selU };
+  const Vec3 faceVSel[BOX_FACES] = { selV, selV, selV, selV, selW, selW };
+  const Vec2 cornerUvs[BOX_FACE_VERTICES] = { Vec2(0.0f, 0.0f), Vec2(1.0f, 0.0f), Vec2(0.0f, 1.0f), Vec2(1.0f, 1.0f) };
+
+  BoxVertex vertices[BOX_FACES * BOX_FACE_VERTICES];
+  uint32_t indices[BOX_FACES * BOX_FACE_INDICES];
+  for (uint32_t face = 0; face < BOX_FACES; face++)
+  {
+    for (uint32_t corner = 0; corner < BOX_FACE_VERTICES; corner++)
+    {
+      BoxVertex &vertex = vertices[face * BOX_FACE_VERTICES + corner];
+      vertex.pos = faceCorners[face][corner];
+      vertex.uv = cornerUvs[corner];
+      vertex.uSel = faceUSel[face];
+      vertex.vSel = faceVSel[face];
+    }
+
+    // The strip as a triangle list, same as StaticBatch.
+    uint32_t base = face * BOX_FACE_VERTICES;
+    uint32_t faceIndices[BOX_FACE_INDICES] = { base, base + 1, base + 2, base + 2, base + 1, base + 3 };
+    memcpy(&indices[face * BOX_FACE_INDICES], faceIndices, sizeof(faceIndices));
+  }
+
+  m_pDevice = dev;
+  m_pVs = gRenderCache.acquireVertexShader(dev, pVsBytecode);
+  m_pPs = gRenderCache.acquirePixelShader(dev, pPsBytecode);
+  m_pLayout = gRenderCache.acquireInputLayout(dev, RENDER_VERTEX_BOX_INSTANCED, pVsBytecode);
+  m_pSampleState = gRenderCache.acquireSampler(dev, RenderSamplerDesc());
+  m_pVBuffer = dev->createBuffer(RENDER_BUFFER_VERTEX, sizeof(vertices), vertices);
+  m_pIBuffer = dev->createBuffer(RENDER_BUFFER_INDEX, sizeof(indices), indices);
+
+  if (!m_pVBuffer || !m_pIBuffer)
+  {
+    LOGE("Failed to create BoxInstancer mesh");
+    return false;
+  }
+
+  return true;
+}
+
+
+bool BoxInstancer::build(RenderDevice *dev)
+{
+  if (m_pDevice && m_pDevice != dev)
+  {
+    LOGE("BoxInstancer built on a different device");
+    return false;
+  }
+
+  // Drop the groups that had no instances this frame, their textures may not be around much longer.
+  std::vector<Group> groups;
+  m_groupIdx.clear();
+  m_uploadData.clear();
+  for (size_t i = 0; i < m_groups.size(); i++)
+  {
+    Group &group = m_groups[i];
+    if (group.instances.empty())
+    {
+      continue;
+    }
+
+    group.startInstance = static_cast<uint32_t>(m_uploadData.size());
+    m_uploadData.insert(m_uploadData.end(), group.instances.begin(), group.instances.end());
+
+    m_groupIdx[group.pTexture] = static_cast<uint32_t>(groups.size());
+    groups.push_back(Group());
+    groups.back().pTexture = group.pTexture;
+    groups.back().startInstance = group.startInstance;
+    groups.back().instances.swap(group.instances);
+  }
+  m_groups.swap(groups);
+
+  if (m_uploadData.empty())
+  {
+    return true;
+  }
+
+  if (!createShared(dev))
+  {
+    return false;
+  }
+
+  uint32_t instanceCnt = static_cast<uint32_t>(m_uploadData.size());
+  if (instanceCnt > m_instBufferCapacity)
+  {
+    RENDER_RELEASE_NON_NULL(dev, m_pInstBuffer);
+    m_instBufferCapacity = instanceCnt + instanceCnt / 4;
+    m_pInstBuffer = dev->createBuffer(RENDER_BUFFER_VERTEX, m_instBufferCapacity * sizeof(BoxInstance), NULL);
+  }
+
+  if (!m_pInstBuffer || !dev->updateBuffer(m_pInstBuffer, m_uploadData.data(), instanceCnt * sizeof(BoxInstance)))
+  {
+    LOGE("Failed to upload %u box instances", instanceCnt);
+    m_instBufferCapacity = 0;
+    return false;
+  }
+
+  m_bBuilt = true;
+  return true;
+}
+
+
+void BoxInstancer::render(RenderDevice *dev)
+{
+  if (!m_bBuilt)
+  {
+    return;
+  }
+
+  dev->setVertexShader(m_pVs);
+  dev->setPixelShader(m_pPs);
+  dev->setInputLayout(m_pLayout);
+  dev->setPsSampler(0, m_pSampleState);
+  dev->setVertexBuffer(m_pVBuffer, sizeof(BoxVertex));
+  dev->setInstanceBuffer(m_pInstBuffer, sizeof(BoxInstance));
+  dev->setIndexBuffer(m_pIBuffer);
+  dev->setTopology(RENDER_TOPOLOGY_TRIANGLE_LIST);
+
+  for (size_t i = 0; i < m_groups.size(); i++)
+  {
+    dev->setPsTexture(0, m_groups[i].pTexture);
+    dev->drawIndexedInstanced(
+      BOX_FACES * BOX_FACE_INDICES,
+      static_cast<uint32_t>(m_groups[i].instances.size()),
+      m_groups[i].startInstance);
+  }
+}
+
+
+bool BoxInstancer::release()
+{
+  m_groups.clear();
+  m_groupIdx.clear();
+  m_uploadData.clear();
+  m_instanceCnt = 0;
+  m_bBuilt = false;
+
+  RENDER_RELEASE_NON_NULL(m_pDevice, m_pVBuffer);
+  RENDER_RELEASE_NON_NULL(m_pDevice, m_pIBuffer);
+  RENDER_RELEASE_NON_NULL(m_pDevice, m_pInstBuffer);
+  m_instBufferCapacity = 0;
+
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pVs);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pPs);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pLayout);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pSampleState);
+  m_pDevice = NULL;
+
+  return VisualModel::release();
+}
+
+
+uint32_t BoxInstancer::getInstanceCnt()
+{
+  return m_instanceCnt;
+}
+
+
+uint32_t BoxInstancer::getDrawCnt()
+{
+  return m_bBuilt ? static_cast<uint32_t>(m_groups.size()) : 0;
+}
+
+
+RenderVertexShader *BoxInstancer::getVertexShader()
+{
+  return m_pVs;
+}
+
+
+BoxInstancer::~BoxInstancer()
+{
+  release();
+}
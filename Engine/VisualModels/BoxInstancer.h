@@ -0,0 +1,87 @@
+#ifndef BOX_INSTANCER_H
+#define BOX_INSTANCER_H
+
+#include "../CommonTypes.h"
+#include "../VisualModel.h"
+#include "../ShaderCache.h"
+#include "../Math/Matrix.h"
+#include <unordered_map>
+#include <vector>
+
+// Vertex of the shared unit box. uSel and vSel pick which of an instance's UV scales (U, V, W) stretch the face's
+// texture coordinates, the same way TexBox::prepare scales each face.
+typedef struct BoxVertex_
+{
+  Vec3 pos;
+  Vec2 uv;
+  Vec3 uSel;
+  Vec3 vSel;
+} BoxVertex;
+
+typedef struct BoxInstance_
+{
+  Mat4 world;
+  Vec3 dim;
+  Vec3 uvScale;
+} BoxInstance;
+
+// Draws TexBox models as instances of one unit box mesh, instead of each box with its own vertex buffer, constant
+// buffer update and six draws. Boxes are grouped by texture, each group is one instanced draw.
+//
+// Unlike StaticBatch, instances are collected again every frame with begin()/add()/build(), so boxes can move. Only
+// a world matrix, dimensions and UV scale per box get uploaded.
+class BoxInstancer : public VisualModel
+{
+private:
+  typedef struct Group_
+  {
+    RenderTexture            *pTexture;         // Owned by the boxes, which outlive the frame they're drawn in.
+    std::vector<BoxInstance>  instances;
+    uint32_t                  startInstance;
+  } Group;
+
+  RenderDevice        *m_pDevice;
+  RenderVertexShader  *m_pVs;
+  RenderPixelShader   *m_pPs;
+  RenderInputLayout   *m_pLayout;
+  RenderSampler       *m_pSampleState;
+
+  RenderBuffer        *m_pVBuffer;
+  RenderBuffer        *m_pIBuffer;
+  RenderBuffer        *m_pInstBuffer;
+  uint32_t             m_instBufferCapacity;   // In instances.
+
+  // Groups are kept from frame to frame (and dropped once empty), so their instance lists don't reallocate.
+  std::vector<Group>                          m_groups;
+  std::unordered_map<RenderTexture*, uint32_t> m_groupIdx;
+  std::vector<BoxInstance>                    m_uploadData;
+  uint32_t                                    m_instanceCnt;
+  bool                                        m_bBuilt;
+
+  bool createShared(RenderDevice *dev);
+
+public:
+  BoxInstancer();
+  ~BoxInstancer();
+
+  // Starts collecting this frame's instances.
+  void begin();
+
+  // Adds the model as an instance at world. Only TexBox models (with their resources created) can be instanced,
+  // returns false for anything else.
+  bool add(VisualModel *pModel, const Mat4 &world);
+
+  // Uploads everything added since begin(), for render().
+  bool build(RenderDevice *dev);
+
+  void render(RenderDevice *dev);
+
+  bool release();
+
+  uint32_t getInstanceCnt();
+  uint32_t getDrawCnt();
+
+  RenderVertexShader *getVertexShader();
+};
+
+#endif
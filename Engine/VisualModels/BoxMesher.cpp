@@ -0,0 +1,406 @@
+#include "BoxMesher.h"
+#include <algorithm>
+#include <math.h>
+#include <tuple>
+
+// Coordinates closer than 1 / COORD_QUANT are the same coordinate, so faces of neighbouring blocks line up even when
+// their positions were rounded differently.
+static const double COORD_QUANT = 1024.0;
+
+// Texture mappings are compared to within 1 / UV_QUANT.
+static const double UV_QUANT = 4096.0;
+static const double UV_EPSILON = 1.0 / UV_QUANT;
+
+// The plane's two other axes, in the order Face's a and b use them.
+static const uint32_t AXIS_A[3] = { 1, 0, 0 };
+static const uint32_t AXIS_B[3] = { 2, 2, 1 };
+
+// Cover bits of a grid cell in buildPlane().
+static const uint8_t COVER_POSITIVE = 0x1;
+static const uint8_t COVER_NEGATIVE = 0x2;
+
+static float getAxis(const Vec3 &v, uint32_t axis)
+{
+  return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+
+static void setAxis(Vec3 &v, uint32_t axis, float value)
+{
+  if (axis == 0)
+  {
+    v.x = value;
+  }
+  else if (axis == 1)
+  {
+    v.y = value;
+  }
+  else
+  {
+    v.z = value;
+  }
+}
+
+
+// Only the fractional part of a texture offset matters, the sampler wraps.
+static int64_t quantizeUvOffset(double offset)
+{
+  int64_t steps = static_cast<int64_t>(UV_QUANT);
+  return llround((offset - floor(offset)) * UV_QUANT) % steps;
+}
+
+
+BoxMesher::BoxMesher()
+{
+  m_culledFaceMask = 0;
+  m_bOptimize = true;
+}
+
+
+void BoxMesher::begin(uint32_t culledFaceMask, bool bOptimize)
+{
+  m_culledFaceMask = culledFaceMask;
+  m_bOptimize = bOptimize;
+  m_faces.clear();
+  m_outputs.clear();
+  m_coordValues.clear();
+  m_stats = BoxMeshStats();
+}
+
+
+int64_t BoxMesher::quantize(float value)
+{
+  int64_t quantized = llround(value * COORD_QUANT);
+  m_coordValues.insert(std::make_pair(quantized, value));
+  return quantized;
+}
+
+
+BoxMesher::Output &BoxMesher::getOutput(uint32_t group)
+{
+  if (group >= m_outputs.size())
+  {
+    m_outputs.resize(group + 1);
+  }
+
+  return m_outputs[group];
+}
+
+
+void BoxMesher::addQuad(Output &output, const Pos3Uv2 *pCorners)
+{
+  // The strip as a triangle list, (0, 1, 2) and (2, 1, 3) keep its winding.
+  uint32_t base = static_cast<uint32_t>(output.vertices.size());
+  uint32_t quadIndices[] = { base, base + 1, base + 2, base + 2, base + 1, base + 3 };
+  output.vertices.insert(output.vertices.end(), pCorners, pCorners + 4);
+  output.indices.insert(output.indices.end(), quadIndices, quadIndices + 6);
+}
+
+
+void BoxMesher::addFace(const Pos3Uv2 *pCorners, uint32_t group)
+{
+  m_stats.trianglesIn += 2;
+  if (!m_bOptimize)
+  {
+    addQuad(getOutput(group), pCorners);
+    return;
+  }
+
+  int64_t coords[4][3];
+  for (uint32_t i = 0; i < 4; i++)
+  {
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+      coords[i][axis] = quantize(getAxis(pCorners[i].pos, axis));
+    }
+  }
+
+  // Axis aligned faces have one coordinate in common.
+  Face face;
+  uint32_t axis = 0;
+  while (axis < 3 &&
+    !(coords[0][axis] == coords[1][axis] && coords[0][axis] == coords[2][axis] && coords[0][axis] == coords[3][axis]))
+  {
+    axis++;
+  }
+
+  if (axis == 3)
+  {
+    addQuad(getOutput(group), pCorners);
+    return;
+  }
+
+  uint32_t axisA = AXIS_A[axis];
+  uint32_t axisB = AXIS_B[axis];
+  face.group = group;
+  face.axis = static_cast<uint8_t>(axis);
+  face.plane = coords[0][axis];
+  face.a0 = std::min(std::min(coords[0][axisA], coords[1][axisA]), std::min(coords[2][axisA], coords[3][axisA]));
+  face.a1 = std::max(std::max(coords[0][axisA], coords[1][axisA]), std::max(coords[2][axisA], coords[3][axisA]));
+  face.b0 = std::min(std::min(coords[0][axisB], coords[1][axisB]), std::min(coords[2][axisB], coords[3][axisB]));
+  face.b1 = std::max(std::max(coords[0][axisB], coords[1][axisB]), std::max(coords[2][axisB], coords[3][axisB]));
+
+  if (face.a0 == face.a1 || face.b0 == face.b1)
+  {
+    // No area, nothing to draw.
+    m_stats.trianglesHidden += 2;
+    return;
+  }
+
+  // A rectangle has one corner at each combination of the extents.
+  int32_t cornerAt[4] = { -1, -1, -1, -1 };
+  face.pattern = 0;
+  for (uint32_t i = 0; i < 4; i++)
+  {
+    bool bOnA = coords[i][axisA] == face.a0 || coords[i][axisA] == face.a1;
+    bool bOnB = coords[i][axisB] == face.b0 || coords[i][axisB] == face.b1;
+    uint32_t aBit = coords[i][axisA] == face.a1 ? 1 : 0;
+    uint32_t bBit = coords[i][axisB] == face.b1 ? 1 : 0;
+    if (!bOnA || !bOnB || cornerAt[aBit | (bBit << 1)] != -1)
+    {
+      addQuad(getOutput(group), pCorners);
+      return;
+    }
+
+    cornerAt[aBit | (bBit << 1)] = i;
+    face.pattern |= (aBit << (2 * i)) | (bBit << (2 * i + 1));
+  }
+
+  // Box faces wind so that (c1 - c0) x (c2 - c0) points into the box.
+  Vec3 e1 = pCorners[1].pos - pCorners[0].pos;
+  Vec3 e2 = pCorners[2].pos - pCorners[0].pos;
+  uint32_t axis1 = (axis + 1) % 3;
+  uint32_t axis2 = (axis + 2) % 3;
+  float inward = getAxis(e1, axis1) * getAxis(e2, axis2) - getAxis(e1, axis2) * getAxis(e2, axis1);
+  face.bPositive = inward < 0.0f ? 1 : 0;
+
+  // Texture coordinates as a linear function of a and b.
+  double a0 = m_coordValues[face.a0];
+  double b0 = m_coordValues[face.b0];
+  double da = m_coordValues[face.a1] - a0;
+  double db = m_coordValues[face.b1] - b0;
+  const Vec2 &uv00 = pCorners[cornerAt[0]].uv;
+  const Vec2 &uv10 = pCorners[cornerAt[1]].uv;
+  const Vec2 &uv01 = pCorners[cornerAt[2]].uv;
+  const Vec2 &uv11 = pCorners[cornerAt[3]].uv;
+
+  face.uvGrad[0] = (uv10.x - uv00.x) / da;
+  face.uvGrad[1] = (uv01.x - uv00.x) / db;
+  face.uvGrad[2] = (uv10.y - uv00.y) / da;
+  face.uvGrad[3] = (uv01.y - uv00.y) / db;
+  if (fabs(uv00.x + face.uvGrad[0] * da + face.uvGrad[1] * db - uv11.x) > UV_EPSILON ||
+    fabs(uv00.y + face.uvGrad[2] * da + face.uvGrad[3] * db - uv11.y) > UV_EPSILON)
+  {
+    addQuad(getOutput(group), pCorners);
+    return;
+  }
+
+  face.uvOrigin[0] = uv00.x - face.uvGrad[0] * a0 - face.uvGrad[1] * b0;
+  face.uvOrigin[1] = uv00.y - face.uvGrad[2] * a0 - face.uvGrad[3] * b0;
+  m_faces.push_back(face);
+}
+
+
+void BoxMesher::emitRect(const Face &face, int64_t a0, int64_t a1, int64_t b0, int64_t b1)
+{
+  uint32_t axisA = AXIS_A[face.axis];
+  uint32_t axisB = AXIS_B[face.axis];
+  float plane = m_coordValues[face.plane];
+
+  // Same corner order as the face the rectangle came from, so the winding doesn't change.
+  Pos3Uv2 corners[4];
+  for (uint32_t i = 0; i < 4; i++)
+  {
+    double a = m_coordValues[(face.pattern >> (2 * i)) & 1 ? a1 : a0];
+    double b = m_coordValues[(face.pattern >> (2 * i + 1)) & 1 ? b1 : b0];
+
+    setAxis(corners[i].pos, face.axis, plane);
+    setAxis(corners[i].pos, axisA, static_cast<float>(a));
+    setAxis(corners[i].pos, axisB, static_cast<float>(b));
+    corners[i].uv.x = static_cast<float>(face.uvOrigin[0] + face.uvGrad[0] * a + face.uvGrad[1] * b);
+    corners[i].uv.y = static_cast<float>(face.uvOrigin[1] + face.uvGrad[2] * a + face.uvGrad[3] * b);
+  }
+
+  addQuad(getOutput(face.group), corners);
+}
+
+
+void BoxMesher::buildPlane(const std::vector<uint32_t> &faceIdxs)
+{
+  // Grid of cells between every edge of every face in the plane.
+  std::vector<int64_t> aEdges;
+  std::vector<int64_t> bEdges;
+  for (size_t i = 0; i < faceIdxs.size(); i++)
+  {
+    const Face &face = m_faces[faceIdxs[i]];
+    aEdges.push_back(face.a0);
+    aEdges.push_back(face.a1);
+    bEdges.push_back(face.b0);
+    bEdges.push_back(face.b1);
+  }
+  std::sort(aEdges.begin(), aEdges.end());
+  aEdges.erase(std::unique(aEdges.begin(), aEdges.end()), aEdges.end());
+  std::sort(bEdges.begin(), bEdges.end());
+  bEdges.erase(std::unique(bEdges.begin(), bEdges.end()), bEdges.end());
+
+  uint32_t width = static_cast<uint32_t>(aEdges.size() - 1);
+  uint32_t height = static_cast<uint32_t>(bEdges.size() - 1);
+
+  auto cellRange = [&](const Face &face, uint32_t &x0, uint32_t &x1, uint32_t &y0, uint32_t &y1)
+  {
+    x0 = static_cast<uint32_t>(std::lower_bound(aEdges.begin(), aEdges.end(), face.a0) - aEdges.begin());
+    x1 = static_cast<uint32_t>(std::lower_bound(aEdges.begin(), aEdges.end(), face.a1) - aEdges.begin());
+    y0 = static_cast<uint32_t>(std::lower_bound(bEdges.begin(), bEdges.end(), face.b0) - bEdges.begin());
+    y1 = static_cast<uint32_t>(std::lower_bound(bEdges.begin(), bEdges.end(), face.b1) - bEdges.begin());
+  };
+
+  // Which way the faces covering each cell point. A cell covered both ways is between two boxes.
+  std::vector<uint8_t> cover(width * height, 0);
+  for (size_t i = 0; i < faceIdxs.size(); i++)
+  {
+    const Face &face = m_faces[faceIdxs[i]];
+    uint8_t bit = face.bPositive ? COVER_POSITIVE : COVER_NEGATIVE;
+    uint32_t x0, x1, y0, y1;
+    cellRange(face, x0, x1, y0, y1);
+    for (uint32_t y = y0; y < y1; y++)
+    {
+      for (uint32_t x = x0; x < x1; x++)
+      {
+        cover[y * width + x] |= bit;
+      }
+    }
+  }
+
+  // Faces can only merge with others facing the same way, in the same group, with the same corner order and mapping.
+  typedef std::tuple<uint8_t, uint32_t, uint8_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t> MergeKey;
+  std::map<MergeKey, std::vector<uint32_t>> merges;
+  for (size_t i = 0; i < faceIdxs.size(); i++)
+  {
+    const Face &face = m_faces[faceIdxs[i]];
+    MergeKey key(
+      face.bPositive,
+      face.group,
+      face.pattern,
+      llround(face.uvGrad[0] * UV_QUANT),
+      llround(face.uvGrad[1] * UV_QUANT),
+      llround(face.uvGrad[2] * UV_QUANT),
+      llround(face.uvGrad[3] * UV_QUANT),
+      quantizeUvOffset(face.uvOrigin[0]),
+      quantizeUvOffset(face.uvOrigin[1]));
+    merges[key].push_back(faceIdxs[i]);
+  }
+
+  std::vector<uint8_t> cells(width * height);
+  auto isRowFree = [&](uint32_t y, uint32_t x0, uint32_t x1)
+  {
+    std::vector<uint8_t>::iterator rowEnd = cells.begin() + y * width + x1;
+    return std::find(cells.begin() + y * width + x0, rowEnd, 0) == rowEnd;
+  };
+
+  for (auto it = merges.begin(); it != merges.end(); ++it)
+  {
+    const Face &first = m_faces[it->second[0]];
+    uint32_t dir = first.axis * 2 + (first.bPositive ? 0 : 1);
+    bool bCulled = (m_culledFaceMask & BOX_FACE_MASK(dir)) != 0;
+    uint8_t opposite = first.bPositive ? COVER_NEGATIVE : COVER_POSITIVE;
+
+    // Visible cells of this set of faces.
+    std::fill(cells.begin(), cells.end(), 0);
+    for (size_t i = 0; i < it->second.size(); i++)
+    {
+      bool bVisible = false;
+      uint32_t x0, x1, y0, y1;
+      cellRange(m_faces[it->second[i]], x0, x1, y0, y1);
+      for (uint32_t y = y0; y < y1 && !bCulled; y++)
+      {
+        for (uint32_t x = x0; x < x1; x++)
+        {
+          if (!(cover[y * width + x] & opposite))
+          {
+            cells[y * width + x] = 1;
+            bVisible = true;
+          }
+        }
+      }
+
+      if (!bVisible)
+      {
+        m_stats.trianglesHidden += 2;
+      }
+    }
+
+    // Greedy: grow each rectangle as far as it goes along a, then along b while whole rows are free.
+    for (uint32_t y = 0; y < height; y++)
+    {
+      for (uint32_t x = 0; x < width; x++)
+      {
+        if (!cells[y * width + x])
+        {
+          continue;
+        }
+
+        uint32_t x1 = x + 1;
+        while (x1 < width && cells[y * width + x1])
+        {
+          x1++;
+        }
+
+        uint32_t y1 = y + 1;
+        while (y1 < height && isRowFree(y1, x, x1))
+        {
+          y1++;
+        }
+
+        for (uint32_t clearY = y; clearY < y1; clearY++)
+        {
+          std::fill(cells.begin() + clearY * width + x, cells.begin() + clearY * width + x1, 0);
+        }
+
+        emitRect(first, aEdges[x], aEdges[x1], bEdges[y], bEdges[y1]);
+      }
+    }
+  }
+}
+
+
+void BoxMesher::build()
+{
+  // Faces only interact with others in the same plane.
+  std::map<std::pair<uint32_t, int64_t>, std::vector<uint32_t>> planes;
+  for (uint32_t i = 0; i < m_faces.size(); i++)
+  {
+    planes[std::make_pair(static_cast<uint32_t>(m_faces[i].axis), m_faces[i].plane)].push_back(i);
+  }
+
+  for (auto it = planes.begin(); it != planes.end(); ++it)
+  {
+    buildPlane(it->second);
+  }
+  m_faces.clear();
+
+  m_stats.trianglesOut = 0;
+  for (size_t i = 0; i < m_outputs.size(); i++)
+  {
+    m_stats.trianglesOut += static_cast<uint32_t>(m_outputs[i].indices.size() / 3);
+  }
+  m_stats.trianglesMerged =
+    static_cast<int32_t>(m_stats.trianglesIn - m_stats.trianglesHidden) - static_cast<int32_t>(m_stats.trianglesOut);
+}
+
+
+const std::vector<Pos3Uv2> &BoxMesher::getVertices(uint32_t group)
+{
+  return getOutput(group).vertices;
+}
+
+
+const std::vector<uint32_t> &BoxMesher::getIndices(uint32_t group)
+{
+  return getOutput(group).indices;
+}
+
+
+BoxMeshStats BoxMesher::getStats()
+{
+  return m_stats;
+}
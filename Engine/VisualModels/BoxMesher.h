@@ -0,0 +1,94 @@
+#ifndef BOX_MESHER_H
+#define BOX_MESHER_H
+
+#include "../CommonTypes.h"
+#include <map>
+#include <vector>
+
+// Outward direction of an axis aligned face, for BoxMesher::begin's culled face mask.
+typedef enum BoxFaceDir_
+{
+  BOX_FACE_POS_X = 0,
+  BOX_FACE_NEG_X,
+  BOX_FACE_POS_Y,
+  BOX_FACE_NEG_Y,
+  BOX_FACE_POS_Z,
+  BOX_FACE_NEG_Z,
+  BOX_FACE_DIR_COUNT
+} BoxFaceDir;
+
+#define BOX_FACE_MASK(dir)    (1u << (dir))
+
+typedef struct BoxMeshStats_
+{
+  uint32_t trianglesIn{ 0 };
+  uint32_t trianglesOut{ 0 };
+  uint32_t trianglesHidden{ 0 };    // Of faces that were entirely against another box, or facing a culled direction.
+  int32_t  trianglesMerged{ 0 };    // The rest of the saving. Negative if cutting up partly hidden faces cost more.
+} BoxMeshStats;
+
+// CPU mesh builder for level geometry made of boxes (see StaticBatch). Takes world space quads, in the 4 vertex strip
+// order TexBox uses, and turns them into one indexed triangle list per group (texture).
+//
+// When optimizing, axis aligned quads go through two passes, per plane:
+//  - Hidden face removal: where two boxes touch, the faces between them are dropped, as are faces in a culled
+//    direction (ex. ones that always face away from the camera).
+//  - Greedy meshing: what's left of the faces with the same group and the same texture mapping is merged into as few
+//    rectangles as possible. Texture mappings only have to line up modulo whole repeats, the sampler wraps.
+// Anything else (rotated boxes, non-rectangular quads) is passed through as it was.
+class BoxMesher
+{
+private:
+  typedef struct Face_
+  {
+    uint32_t group;
+    uint8_t  axis;          // Normal axis, faces lie in the plane axis = plane.
+    uint8_t  bPositive;     // Faces towards +axis.
+    uint8_t  pattern;       // Corner order, bit 2i set if corner i is at a1, bit 2i + 1 if it's at b1.
+    int64_t  plane;         // Coordinates are quantized, see quantize().
+    int64_t  a0, a1;        // Extents along the plane's two other axes, see AXIS_A/AXIS_B.
+    int64_t  b0, b1;
+    double   uvGrad[4];     // du/da, du/db, dv/da, dv/db.
+    double   uvOrigin[2];   // u, v at a = b = 0.
+  } Face;
+
+  typedef struct Output_
+  {
+    std::vector<Pos3Uv2>  vertices;
+    std::vector<uint32_t> indices;
+  } Output;
+
+  uint32_t                    m_culledFaceMask;
+  bool                        m_bOptimize;
+  std::vector<Face>           m_faces;
+  std::vector<Output>         m_outputs;
+  std::map<int64_t, float>    m_coordValues;    // First value seen for each quantized coordinate.
+  BoxMeshStats                m_stats;
+
+  int64_t quantize(float value);
+  Output &getOutput(uint32_t group);
+  void addQuad(Output &output, const Pos3Uv2 *pCorners);
+  void emitRect(const Face &face, int64_t a0, int64_t a1, int64_t b0, int64_t b1);
+  void buildPlane(const std::vector<uint32_t> &faceIdxs);
+
+public:
+  BoxMesher();
+
+  // Drops everything added so far. Faces facing any direction in culledFaceMask (see BOX_FACE_MASK) are removed,
+  // when optimizing.
+  void begin(uint32_t culledFaceMask, bool bOptimize = true);
+
+  // Adds a world space quad to group, corners in triangle strip order.
+  void addFace(const Pos3Uv2 *pCorners, uint32_t group);
+
+  // Runs the passes over everything added since begin().
+  void build();
+
+  // Triangle list of the group, valid after build().
+  const std::vector<Pos3Uv2> &getVertices(uint32_t group);
+  const std::vector<uint32_t> &getIndices(uint32_t group);
+
+  BoxMeshStats getStats();
+};
+
+#endif
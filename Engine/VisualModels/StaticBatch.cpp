@@ -0,0 +1,428 @@
+#include "StaticBatch.h"
+#include "TexBox.h"
+#include "../Logger.h"
+#include "../CommonPhysConsts.h"
+#include "../RenderResourceCache.h"
+#include "../Util.h"
+#include <algorithm>
+#include <cmath>
+
+// TexBox geometry is 6 faces, each a 4 vertex triangle strip.
+static const uint32_t BOX_FACE_VERTICES = 4;
+
+StaticBatch::StaticBatch()
+{
+  m_type              = VISUAL_MODEL_STATIC_BATCH;
+  m_pDevice           = NULL;
+  m_pVs               = NULL;
+  m_pPs               = NULL;
+  m_pLayout           = NULL;
+  m_pSampleState      = NULL;
+  m_pendingModelCnt   = 0;
+  m_modelCnt          = 0;
+  m_cellsRebuilt      = 0;
+  m_bOptimize         = true;
+  m_culledFaceMask    = 0;
+  m_bSettingsChanged  = false;
+}
+
+
+void StaticBatch::setOptimize(bool bOptimize)
+{
+  m_bSettingsChanged |= (bOptimize != m_bOptimize);
+  m_bOptimize = bOptimize;
+}
+
+
+void StaticBatch::setCulledFaces(uint32_t culledFaceMask)
+{
+  m_bSettingsChanged |= (culledFaceMask != m_culledFaceMask);
+  m_culledFaceMask = culledFaceMask;
+}
+
+
+// Same cells as LevelStreamer's chunks, models are placed by their origin like blocks are by their location.
+uint64_t StaticBatch::cellKey(const Mat4 &world)
+{
+  int32_t cellX = static_cast<int32_t>(std::floor(world.m[3][0] / LEVEL_CHUNK_SIZE));
+  int32_t cellY = static_cast<int32_t>(std::floor(world.m[3][1] / LEVEL_CHUNK_SIZE));
+  return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
+
+
+// Everything the model's batched geometry depends on. The model pointer alone isn't enough, pools hand the same
+// address to the next block that's created.
+uint64_t StaticBatch::modelSignature(TexBox *pBox, const Mat4 &world)
+{
+  const std::string &texFileName = pBox->getTexFileName();
+  const Pos3 &dim = pBox->getDimensions();
+  const Pos3 &texScale = pBox->getTexScale();
+
+  uint64_t parts[5] =
+  {
+    static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pBox)),
+    hashFnv1a(&world, sizeof(world)),
+    hashFnv1a(&dim, sizeof(dim)),
+    hashFnv1a(&texScale, sizeof(texScale)),
+    hashFnv1a(texFileName.data(), texFileName.size())
+  };
+  return hashFnv1a(parts, sizeof(parts));
+}
+
+
+void StaticBatch::begin()
+{
+  for (auto it = m_cells.begin(); it != m_cells.end(); ++it)
+  {
+    it->second.pending.clear();
+    it->second.pendingSignature = 0;
+  }
+  m_pendingModelCnt = 0;
+}
+
+
+bool StaticBatch::add(VisualModel *pModel, const Mat4 &world)
+{
+  if (!pModel || pModel->getType() != VISUAL_MODEL_TEX_BOX || pModel->getStaticScreenLoc())
+  {
+    return false;
+  }
+
+  TexBox *pBox = static_cast<TexBox*>(pModel);
+  const std::vector<Pos3Uv2> &vertices = pBox->getVertices();
+  if (vertices.empty() || vertices.size() % BOX_FACE_VERTICES)
+  {
+    return false;
+  }
+
+  auto it = m_cells.find(cellKey(world));
+  if (it == m_cells.end())
+  {
+    Cell cell;
+    cell.pendingSignature = 0;
+    cell.signature = 0;
+    cell.pVBuffer = NULL;
+    cell.pIBuffer = NULL;
+    cell.vBufferCapacity = 0;
+    cell.iBufferCapacity = 0;
+    it = m_cells.insert(std::make_pair(cellKey(world), cell)).first;
+  }
+
+  PendingModel pending = { pBox, world };
+  it->second.pending.push_back(pending);
+
+  // Summed, so the order models are added in doesn't matter. Entity stores reorder on removal.
+  it->second.pendingSignature += modelSignature(pBox, world);
+  m_pendingModelCnt++;
+  return true;
+}
+
+
+bool StaticBatch::createShared(RenderDevice *dev)
+{
+  if (m_pVs)
+  {
+    return true;
+  }
+
+  ShaderBytecode pVsBytecode = gShaderCache.getBytecode(dev, "Engine/Shaders/shaders.shader", "VShader", "vs_4_0");
+  ShaderBytecode pPsBytecode = gShaderCache.getBytecode(dev, "Engine/Shaders/shaders.shader", "PShader", "ps_4_0");
+  if (!pVsBytecode || !pPsBytecode)
+  {
+    LOGE("Failed to compile shaders for StaticBatch");
+    return false;
+  }
+
+  m_pDevice = dev;
+  m_pVs = gRenderCache.acquireVertexShader(dev, pVsBytecode);
+  m_pPs = gRenderCache.acquirePixelShader(dev, pPsBytecode);
+  m_pLayout = gRenderCache.acquireInputLayout(dev, RENDER_VERTEX_POS3_UV2, pVsBytecode);
+  m_pSampleState = gRenderCache.acquireSampler(dev, RenderSamplerDesc());
+  return true;
+}
+
+
+void StaticBatch::releaseCell(Cell &cell)
+{
+  for (size_t i = 0; i < cell.groups.size(); i++)
+  {
+    RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, cell.groups[i].pTexture);
+  }
+  cell.groups.clear();
+
+  RENDER_RELEASE_NON_NULL(m_pDevice, cell.pVBuffer);
+  RENDER_RELEASE_NON_NULL(m_pDevice, cell.pIBuffer);
+  cell.vBufferCapacity = 0;
+  cell.iBufferCapacity = 0;
+  cell.signature = 0;
+  cell.meshStats = BoxMeshStats();
+}
+
+
+void StaticBatch::releaseCells()
+{
+  for (auto it = m_cells.begin(); it != m_cells.end(); ++it)
+  {
+    releaseCell(it->second);
+  }
+  m_cells.clear();
+}
+
+
+// Meshes the cell's pending models and uploads them in place of its current geometry.
+bool StaticBatch::buildCell(RenderDevice *dev, Cell &cell)
+{
+  std::map<std::string, uint32_t> groupIds;     // Texture file -> mesher group.
+  m_mesher.begin(m_culledFaceMask, m_bOptimize);
+  for (size_t i = 0; i < cell.pending.size(); i++)
+  {
+    // Same normalization as the texture cache, so both spellings of a path share a draw.
+    std::string texFileName = cell.pending[i].pBox->getTexFileName();
+    std::replace(texFileName.begin(), texFileName.end(), '\\', '/');
+    uint32_t group = groupIds.insert(std::make_pair(texFileName, static_cast<uint32_t>(groupIds.size()))).first->second;
+
+    m_scratch = cell.pending[i].pBox->getVertices();
+    Vec3 *pPos = &m_scratch[0].pos;
+    vec3TransformCoordArray(pPos, sizeof(Pos3Uv2), pPos, sizeof(Pos3Uv2), m_scratch.size(), cell.pending[i].world);
+    for (size_t face = 0; face < m_scratch.size(); face += BOX_FACE_VERTICES)
+    {
+      m_mesher.addFace(&m_scratch[face], group);
+    }
+  }
+
+  m_mesher.build();
+  cell.meshStats = m_mesher.getStats();
+
+  // Merge the groups into one vertex and one index list. The new groups' textures are acquired before the old
+  // ones are released, so textures that stay in the cell are never dropped in between.
+  std::vector<Group> groups;
+  m_vertices.clear();
+  m_indices.clear();
+  for (auto it = groupIds.begin(); it != groupIds.end(); ++it)
+  {
+    const std::vector<Pos3Uv2> &groupVertices = m_mesher.getVertices(it->second);
+    const std::vector<uint32_t> &groupIndices = m_mesher.getIndices(it->second);
+    if (groupIndices.empty())
+    {
+      // Every face was hidden.
+      continue;
+    }
+
+    uint32_t base = static_cast<uint32_t>(m_vertices.size());
+
+    Group group;
+    group.pTexture = gRenderCache.acquireTexture(dev, it->first, std::vector<uint8_t>());
+    group.startIndex = static_cast<uint32_t>(m_indices.size());
+    group.indexCnt = static_cast<uint32_t>(groupIndices.size());
+    groups.push_back(group);
+
+    m_vertices.insert(m_vertices.end(), groupVertices.begin(), groupVertices.end());
+    for (size_t i = 0; i < groupIndices.size(); i++)
+    {
+      m_indices.push_back(base + groupIndices[i]);
+    }
+  }
+
+  for (size_t i = 0; i < cell.groups.size(); i++)
+  {
+    RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, cell.groups[i].pTexture);
+  }
+  cell.groups.swap(groups);
+  cell.signature = cell.pendingSignature;
+
+  if (m_vertices.empty())
+  {
+    return true;
+  }
+
+  // Some slack when growing, hot reload edits can add a few blocks to a cell at a time.
+  uint32_t vertexCnt = static_cast<uint32_t>(m_vertices.size());
+  if (vertexCnt > cell.vBufferCapacity)
+  {
+    RENDER_RELEASE_NON_NULL(dev, cell.pVBuffer);
+    cell.vBufferCapacity = vertexCnt + vertexCnt / 4;
+    m_vertices.resize(cell.vBufferCapacity);
+    cell.pVBuffer = dev->createBuffer(RENDER_BUFFER_VERTEX, cell.vBufferCapacity * sizeof(Pos3Uv2), m_vertices.data());
+  }
+  else
+  {
+    dev->updateBuffer(cell.pVBuffer, m_vertices.data(), vertexCnt * sizeof(Pos3Uv2));
+  }
+
+  uint32_t indexCnt = static_cast<uint32_t>(m_indices.size());
+  if (indexCnt > cell.iBufferCapacity)
+  {
+    RENDER_RELEASE_NON_NULL(dev, cell.pIBuffer);
+    cell.iBufferCapacity = indexCnt + indexCnt / 4;
+    m_indices.resize(cell.iBufferCapacity);
+    cell.pIBuffer = dev->createBuffer(RENDER_BUFFER_INDEX, cell.iBufferCapacity * sizeof(uint32_t), m_indices.data());
+  }
+  else
+  {
+    dev->updateBuffer(cell.pIBuffer, m_indices.data(), indexCnt * sizeof(uint32_t));
+  }
+
+  if (!cell.pVBuffer || !cell.pIBuffer)
+  {
+    LOGE("Failed to create StaticBatch buffers for %u vertices", vertexCnt);
+    return false;
+  }
+
+  return true;
+}
+
+
+bool StaticBatch::build(RenderDevice *dev)
+{
+  if (m_pDevice && m_pDevice != dev)
+  {
+    LOGE("StaticBatch rebuilt on a different device");
+    return false;
+  }
+
+  if (!createShared(dev))
+  {
+    return false;
+  }
+
+  m_cellsRebuilt = 0;
+  for (auto it = m_cells.begin(); it != m_cells.end(); /* No increment here */)
+  {
+    Cell &cell = it->second;
+    if (cell.pending.empty())
+    {
+      // Everything in it was removed, ex. its chunk was unloaded.
+      releaseCell(cell);
+      m_cells.erase(it++);
+      continue;
+    }
+
+    // A zero signature is never kept, so an unbuilt cell always builds.
+    if (m_bSettingsChanged || cell.signature == 0 || cell.pendingSignature != cell.signature)
+    {
+      m_cellsRebuilt++;
+      if (!buildCell(dev, cell))
+      {
+        // Render nothing rather than part of the batch, the caller falls back to drawing every model on its own.
+        releaseCells();
+        m_modelCnt = 0;
+        m_pendingModelCnt = 0;
+        return false;
+      }
+    }
+    ++it;
+  }
+
+  m_bSettingsChanged = false;
+  m_modelCnt = m_pendingModelCnt;
+  m_pendingModelCnt = 0;
+
+  // Drops the mesher's copy of the geometry.
+  m_mesher.begin(m_culledFaceMask, m_bOptimize);
+  return true;
+}
+
+
+void StaticBatch::render(RenderDevice *dev)
+{
+  if (m_cells.empty())
+  {
+    return;
+  }
+
+  dev->setVertexShader(m_pVs);
+  dev->setPixelShader(m_pPs);
+  dev->setInputLayout(m_pLayout);
+  dev->setPsSampler(0, m_pSampleState);
+  dev->setTopology(RENDER_TOPOLOGY_TRIANGLE_LIST);
+
+  for (auto it = m_cells.begin(); it != m_cells.end(); ++it)
+  {
+    const Cell &cell = it->second;
+    if (cell.groups.empty())
+    {
+      continue;
+    }
+
+    dev->setVertexBuffer(cell.pVBuffer, sizeof(Pos3Uv2));
+    dev->setIndexBuffer(cell.pIBuffer);
+    for (size_t i = 0; i < cell.groups.size(); i++)
+    {
+      dev->setPsTexture(0, cell.groups[i].pTexture);
+      dev->drawIndexed(cell.groups[i].indexCnt, cell.groups[i].startIndex);
+    }
+  }
+}
+
+
+bool StaticBatch::release()
+{
+  releaseCells();
+  m_pendingModelCnt = 0;
+  m_modelCnt = 0;
+  m_cellsRebuilt = 0;
+
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pVs);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pPs);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pLayout);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pSampleState);
+  m_pDevice = NULL;
+
+  return VisualModel::release();
+}
+
+
+uint32_t StaticBatch::getModelCnt()
+{
+  return m_modelCnt;
+}
+
+
+uint32_t StaticBatch::getDrawCnt()
+{
+  uint32_t drawCnt = 0;
+  for (auto it = m_cells.begin(); it != m_cells.end(); ++it)
+  {
+    drawCnt += static_cast<uint32_t>(it->second.groups.size());
+  }
+  return drawCnt;
+}
+
+
+uint32_t StaticBatch::getCellCnt()
+{
+  return static_cast<uint32_t>(m_cells.size());
+}
+
+
+uint32_t StaticBatch::getCellsRebuilt()
+{
+  return m_cellsRebuilt;
+}
+
+
+BoxMeshStats StaticBatch::getMeshStats()
+{
+  BoxMeshStats stats;
+  for (auto it = m_cells.begin(); it != m_cells.end(); ++it)
+  {
+    const BoxMeshStats &cellStats = it->second.meshStats;
+    stats.trianglesIn += cellStats.trianglesIn;
+    stats.trianglesOut += cellStats.trianglesOut;
+    stats.trianglesHidden += cellStats.trianglesHidden;
+    stats.trianglesMerged += cellStats.trianglesMerged;
+  }
+  return stats;
+}
+
+
+RenderVertexShader *StaticBatch::getVertexShader()
+{
+  return m_pVs;
+}
+
+
+StaticBatch::~StaticBatch()
+{
+  release();
+}
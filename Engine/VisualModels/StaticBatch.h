@@ -0,0 +1,115 @@
+#ifndef STATIC_BATCH_H
+#define STATIC_BATCH_H
+
+#include "../CommonTypes.h"
+#include "../VisualModel.h"
+#include "../ShaderCache.h"
+#include "../Math/Matrix.h"
+#include "BoxMesher.h"
+#include <map>
+#include <vector>
+
+class TexBox;
+
+// Geometry of many models that never move, merged into vertex and index buffers with the vertices already in world
+// space, so it renders with an identity world matrix. Models are grouped by texture, which costs one draw each: the
+// whole static part of a level is a handful of draws instead of a constant buffer update, rebind and six draws per
+// block.
+//
+// Models are bucketed into the same square cells LevelStreamer loads chunks by (LEVEL_CHUNK_SIZE, by the model's world
+// position), and each cell keeps its own buffers. Every build collects the full set again with begin()/add()/build()
+// (see runStaticBatchSystem), but only cells whose models changed are meshed and uploaded again, so loading or
+// unloading a streamed chunk, or a hot reload edit, only costs the cells it touched. Buffers are kept and reused as
+// long as the new geometry fits. The faces go through BoxMesher on the way, which drops the ones between touching
+// blocks in the same cell (and any the scene can never see) and merges the rest into larger quads.
+class StaticBatch : public VisualModel
+{
+private:
+  typedef struct Group_
+  {
+    RenderTexture *pTexture;
+    uint32_t       startIndex;
+    uint32_t       indexCnt;
+  } Group;
+
+  typedef struct PendingModel_
+  {
+    TexBox *pBox;
+    Mat4    world;
+  } PendingModel;
+
+  typedef struct Cell_
+  {
+    std::vector<PendingModel> pending;          // Added since begin().
+    uint64_t                  pendingSignature;
+    uint64_t                  signature;        // Of the models in the current build, 0 if there isn't one.
+
+    std::vector<Group>        groups;
+    RenderBuffer             *pVBuffer;
+    RenderBuffer             *pIBuffer;
+    uint32_t                  vBufferCapacity;  // In vertices.
+    uint32_t                  iBufferCapacity;  // In indices.
+    BoxMeshStats              meshStats;
+  } Cell;
+
+  RenderDevice        *m_pDevice;
+  RenderVertexShader  *m_pVs;
+  RenderPixelShader   *m_pPs;
+  RenderInputLayout   *m_pLayout;
+  RenderSampler       *m_pSampleState;
+
+  std::map<uint64_t, Cell>            m_cells;            // By cellKey().
+  uint32_t                            m_pendingModelCnt;
+  uint32_t                            m_modelCnt;
+  uint32_t                            m_cellsRebuilt;     // By the last build().
+
+  BoxMesher                           m_mesher;
+  bool                                m_bOptimize;
+  uint32_t                            m_culledFaceMask;
+  bool                                m_bSettingsChanged; // Every cell needs meshing again.
+  std::vector<Pos3Uv2>                m_scratch;
+  std::vector<Pos3Uv2>                m_vertices;
+  std::vector<uint32_t>               m_indices;
+
+  static uint64_t cellKey(const Mat4 &world);
+  static uint64_t modelSignature(TexBox *pBox, const Mat4 &world);
+
+  bool createShared(RenderDevice *dev);
+  bool buildCell(RenderDevice *dev, Cell &cell);
+  void releaseCell(Cell &cell);
+  void releaseCells();
+
+public:
+  StaticBatch();
+  ~StaticBatch();
+
+  // Mesher settings for the following builds. Optimizing is on by default, with no culled directions (see
+  // BOX_FACE_MASK).
+  void setOptimize(bool bOptimize);
+  void setCulledFaces(uint32_t culledFaceMask);
+
+  // Starts collecting a new set of models, the last build() keeps rendering until the next one.
+  void begin();
+
+  // Adds the model with its world transform. Only TexBox models can be batched, returns false for anything else.
+  bool add(VisualModel *pModel, const Mat4 &world);
+
+  // Replaces what's rendered with everything added since begin(), meshing and uploading only the cells that changed.
+  bool build(RenderDevice *dev);
+
+  void render(RenderDevice *dev);
+
+  bool release();
+
+  uint32_t getModelCnt();
+  uint32_t getDrawCnt();
+  uint32_t getCellCnt();
+  uint32_t getCellsRebuilt();
+
+  // Triangles before and after the mesher, over every cell as of the last build().
+  BoxMeshStats getMeshStats();
+
+  RenderVertexShader *getVertexShader();
+};
+
+#endif
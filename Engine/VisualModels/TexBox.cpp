@@ -1,15 +1,37 @@
 #include "TexBox.h"
 
+DEFINE_POOL_ALLOCATED(TexBox)
+
 
 TexBox::TexBox()
 {
   m_type = VISUAL_MODEL_TEX_BOX;
+  m_bLazyVBuffer = true;
 }
 
 
 bool TexBox::init(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
+  float width,
+  float height,
+  float depth,
+  std::string &texFileName,
+  float texScaleU,
+  float texScaleV,
+  float texScaleW,
+  bool bStaticScreenLoc)
+{
+  if (!prepare(dev, width, height, depth, texFileName, texScaleU, texScaleV, texScaleW, bStaticScreenLoc))
+  {
+    return false;
+  }
+
+  return createResources(dev);
+}
+
+
+bool TexBox::prepare(
+  RenderDevice *dev,
   float width,
   float height,
   float depth,
@@ -50,6 +72,9 @@ bool TexBox::init(
   // Default to basic UV-only faces if W isn't specified.
   texScaleW = texScaleW == 0 ? texScaleV : texScaleW;
 
+  m_dim = Pos3(width, height, depth);
+  m_texScale = Pos3(texScaleU, texScaleV, texScaleW);
+
   Pos2 uw1(texScaleU, 0.0);
   Pos2 uw2(0.0, texScaleW);
   Pos2 uw3(texScaleU, texScaleW);
@@ -96,39 +121,39 @@ bool TexBox::init(
   triList.push_back(Pos3Uv2(pt6, uw2));
   triList.push_back(Pos3Uv2(pt7, uw3));
 
-  // Default TexPoly init will handle basic storage and init. The render method needs special handling below, though,
+  // Default TexPoly prepare will handle basic storage and init. The render method needs special handling below, though,
   // since it's a list of 6 separate triangle lists.
-  return TexPoly::init(
+  return TexPoly::prepare(
     dev,
-    devcon,
     texFileName,
     triList,
     bStaticScreenLoc);
 }
 
 
-void TexBox::render(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon)
+void TexBox::render(RenderDevice *dev)
 {
+  if (!m_pVBuffer && !createVBuffer(dev))
+  {
+    return;
+  }
+
   // Set the shader objects.
-  devcon->VSSetShader(m_pVs, 0, 0);
-  devcon->PSSetShader(m_pPs, 0, 0);
+  dev->setVertexShader(m_pVs);
+  dev->setPixelShader(m_pPs);
 
-  devcon->IASetInputLayout(m_pLayout);
+  dev->setInputLayout(m_pLayout);
 
   // Set the sampler state in the pixel shader.
-  devcon->PSSetSamplers(0, 1, &m_pSampleState);
+  dev->setPsSampler(0, m_pSampleState);
 
-  devcon->PSSetShaderResources(0, 1, &m_pTexture);
+  dev->setPsTexture(0, m_pTexture);
 
   // Select which vertex buffer to display.
-  UINT stride = sizeof(Pos3Uv2);
-  UINT offset = 0;
-  devcon->IASetVertexBuffers(0, 1, &m_pVBuffer, &stride, &offset);
+  dev->setVertexBuffer(m_pVBuffer, sizeof(Pos3Uv2));
 
   // Select which primtive type we are using.
-  devcon->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+  dev->setTopology(RENDER_TOPOLOGY_TRIANGLE_STRIP);
 
   // Draw the vertex buffer to the back buffer. Need to do this once per face since vertex buffer for this class is
   // 6 separate triangle lists.
@@ -136,6 +161,18 @@ void TexBox::render(
   const int VERTICES_PER_FACE = 4;
   for (int i = 0; i < NUM_FACES; i++)
   {
-    devcon->Draw(VERTICES_PER_FACE, i * VERTICES_PER_FACE);
+    dev->draw(VERTICES_PER_FACE, i * VERTICES_PER_FACE);
   }
 }
+
+
+const Pos3 &TexBox::getDimensions()
+{
+  return m_dim;
+}
+
+
+const Pos3 &TexBox::getTexScale()
+{
+  return m_texScale;
+}
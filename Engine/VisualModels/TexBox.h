@@ -3,15 +3,34 @@
 
 #include "TexPoly.h"
 #include "TexBox.h"
+#include "../PoolAllocator.h"
 
 class TexBox : public TexPoly
 {
+protected:
+  Pos3 m_dim;
+  Pos3 m_texScale;    // U, V and W, W already defaulted.
+
 public:
+  // Every level block has one, so they come out of a pool.
+  DECLARE_POOL_ALLOCATED()
+
   TexBox();
 
   virtual bool init(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
+    float width,
+    float height,
+    float depth,
+    std::string &texFileName,
+    float texScaleU = 1.0,
+    float texScaleV = 1.0,
+    float texScaleW = 0.0,
+    bool bStaticScreenLoc = false);
+
+  // Builds the box geometry without touching the device, see TexPoly::prepare.
+  bool prepare(
+    RenderDevice *dev,
     float width,
     float height,
     float depth,
@@ -21,9 +40,12 @@ public:
     float texScaleW = 0.0,
     bool bStaticScreenLoc = false);
 
-  void render(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon);
+  // The vertex buffer is only created on the first render(), boxes drawn by the static batch or as instances (see
+  // BoxInstancer.h) never need one.
+  void render(RenderDevice *dev);
+
+  const Pos3 &getDimensions();
+  const Pos3 &getTexScale();
 };
 
 #endif
\ No newline at end of file
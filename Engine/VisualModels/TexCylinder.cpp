@@ -1,6 +1,6 @@
 #include "TexCylinder.h"
 #include <math.h>
-#include "..\CommonPhysConsts.h"
+#include "../CommonPhysConsts.h"
 
 TexCylinder::TexCylinder()
 {
@@ -10,8 +10,7 @@ TexCylinder::TexCylinder()
 
 
 bool TexCylinder::init(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   float radius,
   float height,
   std::string &texFileName,
@@ -59,7 +58,6 @@ bool TexCylinder::init(
 
   return TexPoly::init(
     dev,
-    devcon,
     texFileName,
     triList,
     bStaticScreenLoc);
@@ -67,8 +65,7 @@ bool TexCylinder::init(
 
 
 void TexCylinder::updateLength(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   float L)
 {
   for (uint32_t face = 0; face <= m_numFaces; face++)
@@ -77,6 +74,6 @@ void TexCylinder::updateLength(
     m_vertices[2 * face + 1].pos.y = L;
   }
 
-  updatePoints(dev, devcon);
+  updatePoints(dev);
 }
 
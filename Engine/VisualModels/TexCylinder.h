@@ -11,8 +11,7 @@ public:
   TexCylinder();
 
   virtual bool init(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     float radius,
     float height,
     std::string &texFileName,
@@ -22,8 +21,7 @@ public:
     bool bStaticScreenLoc = false);
 
   void updateLength(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     float L);
 };
 
@@ -1,137 +1,224 @@
 #include "TexPoly.h"
 #include "../Util.h"
 #include "../Logger.h"
+#include "../RenderResourceCache.h"
+#include <fstream>
+#include <iterator>
 
 TexPoly::TexPoly()
 {
   m_type              = VISUAL_MODEL_TEX_POLY;
+  m_pDevice           = NULL;
   m_pVs               = NULL;
   m_pPs               = NULL;
   m_pVBuffer          = NULL;
   m_pLayout           = NULL;
   m_pTexture          = NULL;
   m_pSampleState      = NULL;
+  m_bLazyVBuffer      = false;
+  m_bBoundsValid      = false;
 }
 
 
 // Texture Polygon
 bool TexPoly::init(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
+  std::string &texFileName,
+  std::vector<Pos3Uv2> &vertices,
+  bool bStaticScreenLoc)
+{
+  if (!prepare(dev, texFileName, vertices, bStaticScreenLoc))
+  {
+    return false;
+  }
+
+  return createResources(dev);
+}
+
+
+bool TexPoly::prepare(
+  RenderDevice *dev,
   std::string &texFileName,
   std::vector<Pos3Uv2> &vertices,
   bool bStaticScreenLoc)
 {
   m_bStaticScreenLoc = bStaticScreenLoc;
   m_vertices = vertices;
+  m_bBoundsValid = false;
   m_texFileName = texFileName;
 
-  // Load and compile the shaders.
-  LOGD("Begin texture load");
-  ID3D10Blob *Vs, *Ps;
-  D3DX11CompileFromFile("Engine/Shaders/shaders.shader", 0, 0, "VShader", "vs_4_0", 0, 0, 0, &Vs, 0, 0);
-  D3DX11CompileFromFile("Engine/Shaders/shaders.shader", 0, 0, "PShader", "ps_4_0", 0, 0, 0, &Ps, 0, 0);
-  LOGD("Texture load finished");
-
-  // Encapsulate both shaders into shader objects.
-  dev->CreateVertexShader(Vs->GetBufferPointer(), Vs->GetBufferSize(), NULL, &m_pVs);
-  dev->CreatePixelShader(Ps->GetBufferPointer(), Ps->GetBufferSize(), NULL, &m_pPs);
-
-  // Process texture info.
-  D3DX11CreateShaderResourceViewFromFile(dev, texFileName.c_str(), NULL, NULL, &m_pTexture, NULL);
-
-  D3D11_SAMPLER_DESC samplerDesc;
-  // Create a texture sampler state description.
-  samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-  samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
-  samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
-  samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-  samplerDesc.MipLODBias = 0.0f;
-  samplerDesc.MaxAnisotropy = 1;
-  samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
-  samplerDesc.BorderColor[0] = 0;
-  samplerDesc.BorderColor[1] = 0;
-  samplerDesc.BorderColor[2] = 0;
-  samplerDesc.BorderColor[3] = 0;
-  samplerDesc.MinLOD = 0;
-  samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
-
-  // Create the texture sampler state.
-  dev->CreateSamplerState(&samplerDesc, &m_pSampleState);
-
-  // create the input layout object
-  D3D11_INPUT_ELEMENT_DESC ied[] =
+  // Get the compiled shaders. Compiling doesn't touch device state, so this still works off the main thread.
+  m_pVsBytecode = gShaderCache.getBytecode(dev, "Engine/Shaders/shaders.shader", "VShader", "vs_4_0");
+  m_pPsBytecode = gShaderCache.getBytecode(dev, "Engine/Shaders/shaders.shader", "PShader", "ps_4_0");
+
+  if (!m_pVsBytecode || !m_pPsBytecode)
+  {
+    LOGE("Failed to compile shaders for TexPoly");
+    return false;
+  }
+
+  // Read the texture file up front, so the device only has to create the resource view from memory. Most blocks share
+  // a texture that's already loaded, those skip the read, as do blocks whose texture already failed to load.
+  m_texFileData.clear();
+  if (gRenderCache.needsTextureData(dev, texFileName))
+  {
+    std::ifstream fs(texFileName, std::ios::binary);
+    if (fs)
+    {
+      m_texFileData.assign(std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>());
+    }
+    else
+    {
+      gRenderCache.textureReadFailed(dev, texFileName);
+    }
+  }
+
+  return true;
+}
+
+
+bool TexPoly::createResources(RenderDevice *dev)
+{
+  if (!m_pVsBytecode || !m_pPsBytecode)
   {
-    { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-    { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 }
-  };
+    LOGE("TexPoly resources created before prepare");
+    return false;
+  }
 
-  dev->CreateInputLayout(ied, 2, Vs->GetBufferPointer(), Vs->GetBufferSize(), &m_pLayout);
+  m_pDevice = dev;
 
-  // Create the vertex buffer.
-  D3D11_BUFFER_DESC bd;
-  ZeroMemory(&bd, sizeof(bd));
+  // Shaders, texture, sampler and layout are shared with every other model that uses the same ones.
+  m_pVs = gRenderCache.acquireVertexShader(dev, m_pVsBytecode);
+  m_pPs = gRenderCache.acquirePixelShader(dev, m_pPsBytecode);
+  m_pTexture = gRenderCache.acquireTexture(dev, m_texFileName, m_texFileData);
+  m_pSampleState = gRenderCache.acquireSampler(dev, RenderSamplerDesc());
+  m_pLayout = gRenderCache.acquireInputLayout(dev, RENDER_VERTEX_POS3_UV2, m_pVsBytecode);
 
-  bd.Usage = D3D11_USAGE_DYNAMIC;                // Write access by CPU and GPU
-  bd.ByteWidth = m_vertices.size() * sizeof(m_vertices[0]);
-  bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;       // Use as a vertex buffer
-  bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;    // Allow CPU to write in buffer
-  dev->CreateBuffer(&bd, NULL, &m_pVBuffer);
+  if (!m_bLazyVBuffer)
+  {
+    createVBuffer(dev);
+  }
 
-  updatePoints(dev, devcon);
+  // Prepared data isn't needed once the GPU has its copy.
+  m_pVsBytecode.reset();
+  m_pPsBytecode.reset();
+  std::vector<uint8_t>().swap(m_texFileData);
 
   return true;
 }
 
 
-void TexPoly::updatePoints(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon)
+bool TexPoly::createVBuffer(RenderDevice *dev)
 {
+  // Create the vertex buffer, with the vertices already in it.
+  m_pVBuffer = dev->createBuffer(
+    RENDER_BUFFER_VERTEX,
+    static_cast<uint32_t>(m_vertices.size() * sizeof(m_vertices[0])),
+    m_vertices.data());
+
+  return m_pVBuffer != NULL;
+}
+
+
+void TexPoly::updatePoints(RenderDevice *dev)
+{
+  m_bBoundsValid = false;
+
+  if (!m_pVBuffer)
+  {
+    // Not created yet, it'll start out with the current vertices.
+    return;
+  }
+
   // Copy the vertices into their buffers.
-  D3D11_MAPPED_SUBRESOURCE ms;
-  devcon->Map(m_pVBuffer, NULL, D3D11_MAP_WRITE_DISCARD, NULL, &ms);              // map the buffer
-  memcpy(ms.pData, m_vertices.data(), m_vertices.size() * sizeof(m_vertices[0])); // copy the data
-  devcon->Unmap(m_pVBuffer, NULL);                                                // unmap the buffer  
+  dev->updateBuffer(m_pVBuffer, m_vertices.data(), static_cast<uint32_t>(m_vertices.size() * sizeof(m_vertices[0])));
 }
 
 
-void TexPoly::render(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon)
+void TexPoly::render(RenderDevice *dev)
 {
   // Set the shader objects.
-  devcon->VSSetShader(m_pVs, 0, 0);
-  devcon->PSSetShader(m_pPs, 0, 0);
+  dev->setVertexShader(m_pVs);
+  dev->setPixelShader(m_pPs);
 
-  devcon->IASetInputLayout(m_pLayout);
+  dev->setInputLayout(m_pLayout);
 
   // Set the sampler state in the pixel shader.
-  devcon->PSSetSamplers(0, 1, &m_pSampleState);
+  dev->setPsSampler(0, m_pSampleState);
 
-  devcon->PSSetShaderResources(0, 1, &m_pTexture);
+  dev->setPsTexture(0, m_pTexture);
 
   // Select which vertex buffer to display.
-  UINT stride = sizeof(Pos3Uv2);
-  UINT offset = 0;
-  devcon->IASetVertexBuffers(0, 1, &m_pVBuffer, &stride, &offset);
+  dev->setVertexBuffer(m_pVBuffer, sizeof(Pos3Uv2));
 
   // Select which primtive type we are using.
-  devcon->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+  dev->setTopology(RENDER_TOPOLOGY_TRIANGLE_STRIP);
 
   // Draw the vertex buffer to the back buffer.
-  devcon->Draw(m_vertices.size(), 0);
+  dev->draw(static_cast<uint32_t>(m_vertices.size()), 0);
+}
+
+
+const std::vector<Pos3Uv2> &TexPoly::getVertices()
+{
+  return m_vertices;
+}
+
+
+const std::string &TexPoly::getTexFileName()
+{
+  return m_texFileName;
+}
+
+
+RenderTexture *TexPoly::getTexture()
+{
+  return m_pTexture;
+}
+
+
+RenderVertexShader *TexPoly::getVertexShader()
+{
+  return m_pVs;
+}
+
+
+bool TexPoly::getLocalBounds(Vec3 &boundsMin, Vec3 &boundsMax)
+{
+  if (m_vertices.empty())
+  {
+    return false;
+  }
+
+  if (!m_bBoundsValid)
+  {
+    m_boundsMin = m_vertices[0].pos;
+    m_boundsMax = m_vertices[0].pos;
+    for (size_t i = 1; i < m_vertices.size(); i++)
+    {
+      const Vec3 &pos = m_vertices[i].pos;
+      m_boundsMin = Vec3(fminf(m_boundsMin.x, pos.x), fminf(m_boundsMin.y, pos.y), fminf(m_boundsMin.z, pos.z));
+      m_boundsMax = Vec3(fmaxf(m_boundsMax.x, pos.x), fmaxf(m_boundsMax.y, pos.y), fmaxf(m_boundsMax.z, pos.z));
+    }
+    m_bBoundsValid = true;
+  }
+
+  boundsMin = m_boundsMin;
+  boundsMax = m_boundsMax;
+  return true;
 }
 
 
 bool TexPoly::release()
 {
-  RELEASE_NON_NULL(m_pVs);
-  RELEASE_NON_NULL(m_pPs);
-  RELEASE_NON_NULL(m_pVBuffer);
-  RELEASE_NON_NULL(m_pLayout);
-  RELEASE_NON_NULL(m_pTexture);
-  RELEASE_NON_NULL(m_pSampleState);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pVs);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pPs);
+  RENDER_RELEASE_NON_NULL(m_pDevice, m_pVBuffer);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pLayout);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pTexture);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pSampleState);
+  m_pVsBytecode.reset();
+  m_pPsBytecode.reset();
 
   return VisualModel::release();
 }
@@ -3,43 +3,77 @@
 
 #include "../CommonTypes.h"
 #include "../VisualModel.h"
+#include "../ShaderCache.h"
 #include <vector>
 
 class TexPoly : public VisualModel
 {
 protected:
-  ID3D11VertexShader  *m_pVs;               // the pointer to the vertex shader
-  ID3D11PixelShader   *m_pPs;               // the pointer to the pixel shader
-  ID3D11Buffer        *m_pVBuffer;          // the pointer to the vertex buffer
-  ID3D11InputLayout   *m_pLayout;           // the pointer to the input layout
+  RenderDevice        *m_pDevice;           // the device the resources below came from
+  RenderVertexShader  *m_pVs;               // the pointer to the vertex shader
+  RenderPixelShader   *m_pPs;               // the pointer to the pixel shader
+  RenderBuffer        *m_pVBuffer;          // the pointer to the vertex buffer
+  RenderInputLayout   *m_pLayout;           // the pointer to the input layout
 
-  ID3D11ShaderResourceView  *m_pTexture;
-  ID3D11SamplerState        *m_pSampleState;
+  RenderTexture             *m_pTexture;
+  RenderSampler             *m_pSampleState;
 
   std::vector<Pos3Uv2>      m_vertices;
 
+  // Model space box around m_vertices, worked out on first use after they change.
+  Vec3                      m_boundsMin;
+  Vec3                      m_boundsMax;
+  bool                      m_bBoundsValid;
+
   std::string               m_texFileName;
 
+  // CPU-side results of prepare(), consumed (and freed) by createResources().
+  ShaderBytecode            m_pVsBytecode;
+  ShaderBytecode            m_pPsBytecode;
+  std::vector<uint8_t>      m_texFileData;
+
+  // Leaves the vertex buffer out of createResources(), the subclass creates it with createVBuffer() when first needed.
+  bool                      m_bLazyVBuffer;
+
+  bool createVBuffer(RenderDevice *dev);
+
 public:
   TexPoly();
   ~TexPoly();
 
+  // Same as prepare() followed by createResources().
   virtual bool init(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     std::string &texFileName,
     std::vector<Pos3Uv2> &vertices,
     bool bStaticScreenLoc = false);
 
-  void render(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon);
+  // Device-free part of init: stores geometry, compiles shaders and reads the texture file. Safe to run on a worker
+  // thread (see SceneLoader), compiling only needs RenderDevice::compileShader,
+  // and that only the first time (see ShaderCache).
+  bool prepare(
+    RenderDevice *dev,
+    std::string &texFileName,
+    std::vector<Pos3Uv2> &vertices,
+    bool bStaticScreenLoc = false);
+
+  // Creates the GPU resources from prepared data. Must run on the thread that owns the device context.
+  bool createResources(RenderDevice *dev);
+
+  void render(RenderDevice *dev);
 
   bool release();
 
-  void updatePoints(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon);
+  void updatePoints(RenderDevice *dev);
+
+  // Model space geometry, kept on the CPU after the GPU has its copy (see StaticBatch).
+  const std::vector<Pos3Uv2> &getVertices();
+  const std::string &getTexFileName();
+  RenderTexture *getTexture();
+  RenderVertexShader *getVertexShader();
+
+  // False if there are no vertices.
+  bool getLocalBounds(Vec3 &boundsMin, Vec3 &boundsMax);
 };
 
 #endif
\ No newline at end of file
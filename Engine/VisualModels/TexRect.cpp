@@ -8,8 +8,7 @@ TexRect::TexRect()
 
 
 bool TexRect::init(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   Pos3 topLeftPt,
   Pos3 topRightPt,
   Pos3 bottomRightPt,
@@ -30,15 +29,14 @@ bool TexRect::init(
 
   std::vector<Pos3Uv2> rectPoints = { topLeft, topRight, bottomLeft, bottomRight };
 
-  TexPoly::init(dev, devcon, texFileName, rectPoints);
+  TexPoly::init(dev, texFileName, rectPoints);
 
   return true;
 }
 
 
 bool TexRect::init(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon,
+  RenderDevice *dev,
   float width,
   float height,
   std::string &texFileName,
@@ -52,7 +50,6 @@ bool TexRect::init(
 
   return init(
     dev,
-    devcon,
     topLeft,
     topRight,
     bottomRight,
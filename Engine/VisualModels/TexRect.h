@@ -9,8 +9,7 @@ public:
   TexRect();
 
   bool init(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     Pos3 topLeftPt,
     Pos3 topRightPt,
     Pos3 bottomRightPt,
@@ -18,8 +17,7 @@ public:
     bool bStaticScreenLoc = false);
 
   bool init(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon,
+    RenderDevice *dev,
     float width,
     float height,
     std::string &texFileName,
@@ -4,10 +4,12 @@
 #include <string>
 #include "../Util.h"
 #include "../Logger.h"
+#include "../RenderResourceCache.h"
 
 TexText::TexText()
 {
   m_type = VISUAL_MODEL_TEX_TEXT;
+  m_pDevice = NULL;
   m_pVs = NULL;
   m_pPs = NULL;
   m_pVBuffer = NULL;
@@ -21,8 +23,7 @@ TexText::TexText()
 
 
 bool TexText::init(
-  ID3D11Device *dev,                // D3D Device
-  ID3D11DeviceContext *devcon,      // Device Context
+  RenderDevice *dev,                // Render Device
   std::string displayText,          // Text String
   std::string fontDescTxtFileName,  // Font Description Filename
   Pos3 position,                    // X,Y,Z location of upper left corner
@@ -31,61 +32,41 @@ bool TexText::init(
   bool bStaticScreenLoc
   )
 {
+  m_pDevice = dev;
   m_bStaticScreenLoc = bStaticScreenLoc;
   m_position = position;
   m_charHeight = charHeight;
   m_charWidth = charWidth;
 
-  // Load and compile the shaders.
-  LOGD("Begin texture load");
-  ID3D10Blob *Vs, *Ps;
-  D3DX11CompileFromFile("Engine/Shaders/shaders.shader", 0, 0, "VShader", "vs_4_0", 0, 0, 0, &Vs, 0, 0);
-  D3DX11CompileFromFile("Engine/Shaders/shaders.shader", 0, 0, "PShader", "ps_4_0", 0, 0, 0, &Ps, 0, 0);
-  LOGD("Texture load finished");
+  // Get the compiled shaders, shared with every other model.
+  ShaderBytecode pVsBytecode = gShaderCache.getBytecode(dev, "Engine/Shaders/shaders.shader", "VShader", "vs_4_0");
+  ShaderBytecode pPsBytecode = gShaderCache.getBytecode(dev, "Engine/Shaders/shaders.shader", "PShader", "ps_4_0");
+  if (!pVsBytecode || !pPsBytecode)
+  {
+    LOGE("Failed to compile shaders for TexText");
+    return false;
+  }
 
   // Encapsulate both shaders into shader objects.
-  dev->CreateVertexShader(Vs->GetBufferPointer(), Vs->GetBufferSize(), NULL, &m_pVs);
-  dev->CreatePixelShader(Ps->GetBufferPointer(), Ps->GetBufferSize(), NULL, &m_pPs);
+  m_pVs = gRenderCache.acquireVertexShader(dev, pVsBytecode);
+  m_pPs = gRenderCache.acquirePixelShader(dev, pPsBytecode);
 
   // Grab params for this particular font.
   parseDescFile(dev, fontDescTxtFileName);
 
-  D3D11_SAMPLER_DESC samplerDesc;
-  // Create a texture sampler state description.
-  samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-  samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
-  samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
-  samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-  samplerDesc.MipLODBias = 0.0f;
-  samplerDesc.MaxAnisotropy = 1;
-  samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
-  samplerDesc.BorderColor[0] = 0;
-  samplerDesc.BorderColor[1] = 0;
-  samplerDesc.BorderColor[2] = 0;
-  samplerDesc.BorderColor[3] = 0;
-  samplerDesc.MinLOD = 0;
-  samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
-
   // Create the texture sampler state.
-  dev->CreateSamplerState(&samplerDesc, &m_pSampleState);
+  m_pSampleState = gRenderCache.acquireSampler(dev, RenderSamplerDesc());
 
   // create the input layout object
-  D3D11_INPUT_ELEMENT_DESC ied[] =
-  {
-    { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-    { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 }
-  };
-
-  dev->CreateInputLayout(ied, 2, Vs->GetBufferPointer(), Vs->GetBufferSize(), &m_pLayout);
+  m_pLayout = gRenderCache.acquireInputLayout(dev, RENDER_VERTEX_POS3_UV2, pVsBytecode);
 
-  return updateText(displayText, dev, devcon);
+  return updateText(displayText, dev);
 }
 
 
 bool TexText::updateText(
   std::string &text,
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon)
+  RenderDevice *dev)
 {
   m_text = text;
   uint32_t prevVertSize = m_vertices.size();
@@ -173,32 +154,23 @@ bool TexText::updateText(
     return false;
   }
 
-  // Create the vertex buffer if it doesn't already exist at the correct size.
+  uint32_t byteWidth = static_cast<uint32_t>(m_vertices.size() * sizeof(m_vertices[0]));
+
+  // Create the vertex buffer (with the new text in it) if it doesn't already exist at the correct size.
   if (prevVertSize != m_vertices.size())
   {
-    D3D11_BUFFER_DESC bd;
-    ZeroMemory(&bd, sizeof(bd));
-
-    bd.Usage = D3D11_USAGE_DYNAMIC;                // Write access by CPU and GPU
-    bd.ByteWidth = m_vertices.size() * sizeof(m_vertices[0]);
-    bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;       // Use as a vertex buffer
-    bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;    // Allow CPU to write in buffer
-
-    RELEASE_NON_NULL(m_pVBuffer);
-    dev->CreateBuffer(&bd, NULL, &m_pVBuffer);
+    RENDER_RELEASE_NON_NULL(dev, m_pVBuffer);
+    m_pVBuffer = dev->createBuffer(RENDER_BUFFER_VERTEX, byteWidth, m_vertices.data());
 
-    return true;
+    return m_pVBuffer != NULL;
   }
 
   // Copy the vertices into their buffers.
-  D3D11_MAPPED_SUBRESOURCE ms;
-  devcon->Map(m_pVBuffer, NULL, D3D11_MAP_WRITE_DISCARD, NULL, &ms);              // map the buffer
-  memcpy(ms.pData, m_vertices.data(), m_vertices.size() * sizeof(m_vertices[0])); // copy the data
-  devcon->Unmap(m_pVBuffer, NULL);                                                // unmap the buffer
+  return dev->updateBuffer(m_pVBuffer, m_vertices.data(), byteWidth);
 }
 
 
-bool TexText::parseDescFile(ID3D11Device *dev, std::string &fontDescFileName)
+bool TexText::parseDescFile(RenderDevice *dev, std::string &fontDescFileName)
 {
   std::ifstream fs(fontDescFileName);
   std::string curLine;
@@ -235,7 +207,7 @@ bool TexText::parseDescFile(ID3D11Device *dev, std::string &fontDescFileName)
 }
 
 
-bool TexText::parseDescFileMono(ID3D11Device *dev, std::ifstream &fs)
+bool TexText::parseDescFileMono(RenderDevice *dev, std::ifstream &fs)
 {
   std::string curLine;
 
@@ -255,21 +227,18 @@ bool TexText::parseDescFileMono(ID3D11Device *dev, std::ifstream &fs)
     if (curWord == TEX_TEXT_ENTRY_FILENAME)
     {
       lineStream >> m_texFileName;
-      // Process texture info.
-      D3DX11CreateShaderResourceViewFromFile(dev, m_texFileName.c_str(), NULL, NULL, &m_pTexture, NULL);
-
-      // https://stackoverflow.com/questions/17658392/dimensions-of-id3d11shaderresourceview
-      ID3D11Resource *pResource = NULL;
-      m_pTexture->GetResource(&pResource);
-      ID3D11Texture2D *pTex2d = static_cast<ID3D11Texture2D*>(pResource);
-      D3D11_TEXTURE2D_DESC desc;
-      pTex2d->GetDesc(&desc);
-
-      texWidth = desc.Width;
-      texHeight = desc.Height;
+      // Process texture info. The cache reads the file, unless another text already has it loaded.
+      RENDER_CACHE_RELEASE_NON_NULL(dev, m_pTexture);
+      m_pTexture = gRenderCache.acquireTexture(dev, m_texFileName, std::vector<uint8_t>());
+      if (!m_pTexture)
+      {
+        continue;
+      }
 
-      RELEASE_NON_NULL(pTex2d);
-      RELEASE_NON_NULL(pResource);
+      uint32_t width = 0, height = 0;
+      dev->getTextureSize(m_pTexture, width, height);
+      texWidth = width;
+      texHeight = height;
     }
     else if (curWord == TEX_TEXT_ENTRY_SIZES)
     {
@@ -307,47 +276,55 @@ bool TexText::parseDescFileMono(ID3D11Device *dev, std::ifstream &fs)
 }
 
 
-void TexText::render(
-  ID3D11Device *dev,
-  ID3D11DeviceContext *devcon)
+void TexText::render(RenderDevice *dev)
 {
   // Set the shader objects.
-  devcon->VSSetShader(m_pVs, 0, 0);
-  devcon->PSSetShader(m_pPs, 0, 0);
+  dev->setVertexShader(m_pVs);
+  dev->setPixelShader(m_pPs);
 
-  devcon->IASetInputLayout(m_pLayout);
+  dev->setInputLayout(m_pLayout);
 
   // Set the sampler state in the pixel shader.
-  devcon->PSSetSamplers(0, 1, &m_pSampleState);
+  dev->setPsSampler(0, m_pSampleState);
 
-  devcon->PSSetShaderResources(0, 1, &m_pTexture);
+  dev->setPsTexture(0, m_pTexture);
 
   // Select which vertex buffer to display.
-  UINT stride = sizeof(Pos3Uv2);
-  UINT offset = 0;
-  devcon->IASetVertexBuffers(0, 1, &m_pVBuffer, &stride, &offset);
+  dev->setVertexBuffer(m_pVBuffer, sizeof(Pos3Uv2));
 
   // Select which primtive type we are using.
-  devcon->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+  dev->setTopology(RENDER_TOPOLOGY_TRIANGLE_LIST);
 
   // Draw the vertex buffer to the back buffer.
-  devcon->Draw(m_vertices.size(), 0);
+  dev->draw(static_cast<uint32_t>(m_vertices.size()), 0);
 }
 
 
 bool TexText::release()
 {
-  RELEASE_NON_NULL(m_pVs);
-  RELEASE_NON_NULL(m_pPs);
-  RELEASE_NON_NULL(m_pVBuffer);
-  RELEASE_NON_NULL(m_pLayout);
-  RELEASE_NON_NULL(m_pTexture);
-  RELEASE_NON_NULL(m_pSampleState);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pVs);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pPs);
+  RENDER_RELEASE_NON_NULL(m_pDevice, m_pVBuffer);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pLayout);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pTexture);
+  RENDER_CACHE_RELEASE_NON_NULL(m_pDevice, m_pSampleState);
 
   return VisualModel::release();
 }
 
 
+RenderTexture *TexText::getTexture()
+{
+  return m_pTexture;
+}
+
+
+RenderVertexShader *TexText::getVertexShader()
+{
+  return m_pVs;
+}
+
+
 TexText::~TexText()
 {
   release();
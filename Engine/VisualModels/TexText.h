@@ -3,6 +3,7 @@
 
 #include "../CommonTypes.h"
 #include "../VisualModel.h"
+#include <fstream>
 #include <vector>
 #include <map>
 
@@ -20,21 +21,22 @@ typedef enum TexTextInterp_
 class TexText : public VisualModel
 {
 private:
-  ID3D11VertexShader  *m_pVs;               // the pointer to the vertex shader
-  ID3D11PixelShader   *m_pPs;               // the pointer to the pixel shader
-  ID3D11Buffer        *m_pVBuffer;          // the pointer to the vertex buffer
-  ID3D11InputLayout   *m_pLayout;           // the pointer to the input layout
+  RenderDevice        *m_pDevice;           // the device the resources below came from
+  RenderVertexShader  *m_pVs;               // the pointer to the vertex shader
+  RenderPixelShader   *m_pPs;               // the pointer to the pixel shader
+  RenderBuffer        *m_pVBuffer;          // the pointer to the vertex buffer
+  RenderInputLayout   *m_pLayout;           // the pointer to the input layout
 
-  ID3D11ShaderResourceView  *m_pTexture;
-  ID3D11SamplerState        *m_pSampleState;
+  RenderTexture             *m_pTexture;
+  RenderSampler             *m_pSampleState;
 
   std::vector<Pos3Uv2>      m_vertices;
 
   std::string               m_text;
   std::string               m_fontDescTxtFileName;
 
-  bool parseDescFile(ID3D11Device *dev, std::string &fontDescFileName);
-  bool parseDescFileMono(ID3D11Device *dev, std::ifstream &fs);
+  bool parseDescFile(RenderDevice *dev, std::string &fontDescFileName);
+  bool parseDescFileMono(RenderDevice *dev, std::ifstream &fs);
 
   // Values from parsed description file:
   std::string               m_texFileName;
@@ -50,8 +52,7 @@ public:
   ~TexText();
 
   bool init(
-    ID3D11Device *dev,                // D3D Device
-    ID3D11DeviceContext *devcon,      // Device Context
+    RenderDevice *dev,                // Render Device
     std::string displayText,          // Text String
     std::string fontDescTxtFileName,  // Font Description Filename
     Pos3 position,                    // X,Y,Z location of upper left corner
@@ -60,16 +61,16 @@ public:
     bool bStaticScreenLoc = false
     );
 
-  void render(
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon);
+  void render(RenderDevice *dev);
 
   bool release();
 
   bool updateText(
     std::string &text,
-    ID3D11Device *dev,
-    ID3D11DeviceContext *devcon);
+    RenderDevice *dev);
+
+  RenderTexture *getTexture();
+  RenderVertexShader *getVertexShader();
 };
 
 #endif
\ No newline at end of file
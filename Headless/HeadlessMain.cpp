@@ -0,0 +1,415 @@
+// Headless simulation host. Runs a Scene through Scene::update the same way GameMgr does, but with no window, GPU or
+// sound: rendering goes to a RecordingRenderDevice, DirectSound backed classes are replaced by
+// Headless/HeadlessStubs.cpp and input comes from a script (see InputScript.h). Useful for dedicated servers and
+// performance runs in CI, including the CPU side of rendering.
+//
+// Build from the repo root with GAME_HEADLESS defined, ex. on Linux (one command, wrapped here):
+//   g++ -O2 -std=c++17 -DGAME_HEADLESS -o HeadlessSim Headless/*.cpp Scenes/*.cpp
+//     Engine/Scene.cpp Engine/ObjectManager.cpp Engine/GameObject.cpp Engine/VisualModel.cpp Engine/Objects/*.cpp
+//     Engine/GraphicsManager.cpp Engine/VisualModels/*.cpp Engine/RenderDevices/RecordingRenderDevice.cpp
+//     Engine/RenderDevices/StateFilterRenderDevice.cpp Engine/FrustumCuller.cpp
+//     Engine/PhysicsMgr.cpp Engine/PhysicsModel.cpp Engine/PhysicsModels/*.cpp Engine/PhysicsModels/*/*.cpp
+//     Engine/Ecs/*.cpp Engine/JobSystem.cpp Engine/SceneLoader.cpp Engine/SceneHotReload.cpp Engine/LevelStreamer.cpp
+//     Engine/ShaderCache.cpp Engine/RenderResourceCache.cpp Engine/MappedFile.cpp Engine/Util.cpp Engine/Logger.cpp -pthread
+//
+// Run from the repo root so scene files resolve the same way as the game:
+//   HeadlessSim [--ticks N] [--tick-ms T] [--realtime] [--input script.txt] [--report-every N] [--async-load]
+//               [--update-workers N] [--render-log commands.txt] [--shader-cache dir] [--no-static-batch]
+//               [--no-instancing] [--no-mesh-opt] [--no-culling]
+
+#include "InputScript.h"
+#include "../Engine/CommonPhysConsts.h"
+#include "../Engine/GraphicsManager.h"
+#include "../Engine/JobSystem.h"
+#include "../Engine/Logger.h"
+#include "../Engine/PhysicsMgr.h"
+#include "../Engine/RenderResourceCache.h"
+#include "../Engine/Scene.h"
+#include "../Engine/ShaderCache.h"
+#include "../Engine/SoundMgr.h"
+#include "../Engine/RenderDevices/RecordingRenderDevice.h"
+#include "../Scenes/TestScene.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+// Window size in main.cpp.
+static const float HEADLESS_VIEW_ASPECT = 960.0f / 540.0f;
+
+typedef struct HeadlessSettings_
+{
+  uint64_t    numTicks{ 600 };
+  double      tickMs{ STEP_SIZE_MS };
+  bool        bRealtime{ false };     // Pace ticks to the wall clock instead of running uncapped.
+  uint64_t    reportEvery{ 0 };       // Print intermediate throughput every N ticks, 0 to only print the summary.
+  std::string inputScript;
+  bool        bAsyncLoad{ false };    // Load the scene through the background SceneLoader, like GameMgr does.
+  int32_t     updateWorkers{ -1 };    // Object update job workers, -1 for the same default as GameMgr, 0 for serial.
+  std::string renderLog;              // Where to write the recorded render command stream, if anywhere.
+  std::string shaderCacheDir{ SHADER_CACHE_DIR };   // Empty to keep compiled shaders in memory only.
+  bool        bStaticBatch{ true };   // Draw level blocks through the scene's static batch, like the game does.
+  bool        bInstanceBoxes{ true }; // Draw the remaining boxes as instances, like the game does.
+  bool        bMeshOpt{ true };       // Remove hidden faces and merge the rest in the static batch, like the game does.
+  bool        bCull{ true };          // Skip objects outside the camera's view, like the game does.
+} HeadlessSettings;
+
+
+static void printUsage(const char *exeName)
+{
+  printf("Usage: %s [--ticks N] [--tick-ms T] [--realtime] [--input script.txt] [--report-every N] [--async-load] "
+    "[--update-workers N] [--render-log commands.txt] [--shader-cache dir] [--no-static-batch] "
+    "[--no-instancing] [--no-mesh-opt] [--no-culling]\n", exeName);
+}
+
+
+static void printReport(const char *label, uint64_t ticks, double wallMs, double simMs, const PhysicsStats &stats)
+{
+  double ticksPerSec = wallMs > 0.0 ? ticks * MS_PER_SEC / wallMs : 0.0;
+  double simSpeed = wallMs > 0.0 ? simMs / wallMs : 0.0;
+
+  printf("%-8s ticks %8llu  wall %9.1f ms  %10.1f ticks/s  %7.2fx realtime  steps %8llu  pairs %11llu  contacts %8llu\n",
+    label,
+    static_cast<unsigned long long>(ticks),
+    wallMs,
+    ticksPerSec,
+    simSpeed,
+    static_cast<unsigned long long>(stats.steps),
+    static_cast<unsigned long long>(stats.pairChecks),
+    static_cast<unsigned long long>(stats.collisions));
+}
+
+
+// Totals cover loading as well, per tick numbers are only a rough guide.
+static void printRenderReport(uint64_t ticks, const RenderStats &stats)
+{
+  double perTick = ticks > 0 ? 1.0 / ticks : 0.0;
+
+  printf("render   draws %llu (%.1f/tick)  instances %llu  verts %llu  state changes %llu of %llu sets (%.1f/tick)  "
+    "updates %llu (%.1f/tick)  uploaded %.1f KB (%.1f KB/tick)  resources %llu  compiles %llu\n",
+    static_cast<unsigned long long>(stats.draws),
+    stats.draws * perTick,
+    static_cast<unsigned long long>(stats.instancesDrawn),
+    static_cast<unsigned long long>(stats.verticesDrawn),
+    static_cast<unsigned long long>(stats.stateChanges),
+    static_cast<unsigned long long>(stats.stateSets),
+    stats.stateChanges * perTick,
+    static_cast<unsigned long long>(stats.bufferUpdates),
+    stats.bufferUpdates * perTick,
+    stats.bytesUploaded / 1024.0,
+    stats.bytesUploaded * perTick / 1024.0,
+    static_cast<unsigned long long>(stats.resourcesCreated),
+    static_cast<unsigned long long>(stats.shaderCompiles));
+}
+
+
+// Objects and entities tested against the view frustum each tick, how many were submitted, and how many world
+// matrices had to be rebuilt for them.
+static void printCullReport(uint64_t ticks, const FrustumCullStats &totals, uint64_t worldMatUpdates)
+{
+  double perTick = ticks > 0 ? 1.0 / ticks : 0.0;
+
+  printf("cull     tested %.1f/tick  visible %.1f/tick (%.1f without bounds)  world matrices rebuilt %.1f/tick\n",
+    totals.tested * perTick,
+    totals.visible * perTick,
+    totals.unbounded * perTick,
+    worldMatUpdates * perTick);
+}
+
+
+// State the models set against what reached the device, per flush (tick). The render line counts what the
+// device saw, loading included.
+static void printQueueReport(uint64_t ticks, const RenderQueueStats &totals)
+{
+  double perTick = ticks > 0 ? 1.0 / ticks : 0.0;
+
+  printf("queue    items %.1f/tick  state sets %.1f/tick -> changes %.1f/tick\n",
+    totals.items * perTick,
+    totals.stateSets * perTick,
+    totals.stateChanges * perTick);
+}
+
+
+static void printShaderCacheReport(const ShaderCacheStats &stats)
+{
+  printf("shaders  compiled %u  from disk %u  from memory %u\n", stats.compiles, stats.diskHits, stats.memoryHits);
+}
+
+
+static void printResourceCacheReport(const RenderResourceCacheStats &stats)
+{
+  printf("cache    created %u  shared %u (%u textures by content)  live %u  texture data %.1f KB\n",
+    stats.misses,
+    stats.hits,
+    stats.textureContentHits,
+    stats.liveResources,
+    stats.textureBytes / 1024.0);
+}
+
+
+// Last static batch build only.
+static void printStaticBatchReport(StaticBatch &batch)
+{
+  BoxMeshStats stats = batch.getMeshStats();
+  printf("static   models %u  cells %u (%u rebuilt)  draws %u  triangles %u -> %u  (hidden %u, merged %d)\n",
+    batch.getModelCnt(),
+    batch.getCellCnt(),
+    batch.getCellsRebuilt(),
+    batch.getDrawCnt(),
+    stats.trianglesIn,
+    stats.trianglesOut,
+    stats.trianglesHidden,
+    stats.trianglesMerged);
+}
+
+
+int main(int argc, char *argv[])
+{
+  HeadlessSettings settings;
+
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    bool bHasVal = i + 1 < argc;
+
+    if (arg == "--ticks" && bHasVal)
+    {
+      settings.numTicks = std::strtoull(argv[++i], NULL, 10);
+    }
+    else if (arg == "--tick-ms" && bHasVal)
+    {
+      settings.tickMs = std::strtod(argv[++i], NULL);
+    }
+    else if (arg == "--realtime")
+    {
+      settings.bRealtime = true;
+    }
+    else if (arg == "--input" && bHasVal)
+    {
+      settings.inputScript = argv[++i];
+    }
+    else if (arg == "--report-every" && bHasVal)
+    {
+      settings.reportEvery = std::strtoull(argv[++i], NULL, 10);
+    }
+    else if (arg == "--async-load")
+    {
+      settings.bAsyncLoad = true;
+    }
+    else if (arg == "--update-workers" && bHasVal)
+    {
+      settings.updateWorkers = std::atoi(argv[++i]);
+    }
+    else if (arg == "--render-log" && bHasVal)
+    {
+      settings.renderLog = argv[++i];
+    }
+    else if (arg == "--shader-cache" && bHasVal)
+    {
+      settings.shaderCacheDir = argv[++i];
+    }
+    else if (arg == "--no-static-batch")
+    {
+      settings.bStaticBatch = false;
+    }
+    else if (arg == "--no-instancing")
+    {
+      settings.bInstanceBoxes = false;
+    }
+    else if (arg == "--no-mesh-opt")
+    {
+      settings.bMeshOpt = false;
+    }
+    else if (arg == "--no-culling")
+    {
+      settings.bCull = false;
+    }
+    else
+    {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (settings.tickMs <= 0.0)
+  {
+    printf("Tick size must be positive\n");
+    return 1;
+  }
+
+  gLogger.init();
+  gShaderCache.setCacheDir(settings.shaderCacheDir);
+
+  InputScript inputScript;
+  if (!settings.inputScript.empty() && !inputScript.load(settings.inputScript))
+  {
+    printf("Failed to load input script: %s\n", settings.inputScript.c_str());
+    gLogger.close();
+    return 1;
+  }
+
+  RecordingRenderDevice renderDevice(!settings.renderLog.empty());
+  GraphicsManager gm;
+  PhysicsManager  pm;
+  SoundMgr        soundMgr;
+  JobSystem       jobSystem;
+  if (settings.updateWorkers != 0)
+  {
+    jobSystem.start(settings.updateWorkers < 0 ? 0 : static_cast<uint32_t>(settings.updateWorkers));
+  }
+
+  gm.initConstBuffer(&renderDevice);
+
+  // Same view as the game's window, so culling and depth sorting match.
+  gm.setPerspective(
+    PHYS_CONST_PI / 2.0f,
+    HEADLESS_VIEW_ASPECT,
+    RENDER_NEAR_DIST_M * UNITS_PER_METER,
+    RENDER_FAR_DIST_M * UNITS_PER_METER);
+
+  SceneIo sceneIo;
+  sceneIo.timeMs        = 0.0;
+  sceneIo.pGraphicsMgr  = &gm;
+  sceneIo.pPhysicsMgr   = &pm;
+  sceneIo.pSoundMgr     = &soundMgr;
+  sceneIo.pJobSystem    = &jobSystem;
+  sceneIo.camEye        = Pos3(0.0f, 0.0f, 0.0f);
+  sceneIo.camLookAt     = Pos3(0.0f, 0.0f, -1.0f);
+  sceneIo.camUp         = Pos3(0.0f, 1.0f, 0.0f);
+
+  TestScene *pScene = new TestScene();
+  if (!settings.bStaticBatch)
+  {
+    pScene->setStaticBatching(false);
+  }
+  if (!settings.bInstanceBoxes)
+  {
+    pScene->setBoxInstancing(false);
+  }
+  if (!settings.bMeshOpt)
+  {
+    pScene->setStaticMeshOptimization(false);
+  }
+  if (!settings.bCull)
+  {
+    pScene->setFrustumCulling(false);
+  }
+  auto loadStartTime = std::chrono::steady_clock::now();
+  if (settings.bAsyncLoad)
+  {
+    uint32_t pumps = 0;
+    pScene->beginLoad(&renderDevice);
+    while (!pScene->pumpLoad(&renderDevice))
+    {
+      pumps++;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    if (!pScene->isLoaded())
+    {
+      printf("Background scene load failed\n");
+      Scene::releaseScene(pScene);
+      delete pScene;
+      gLogger.close();
+      return 1;
+    }
+    printf("async load: %u pumps\n", pumps);
+  }
+  else
+  {
+    pScene->init(&renderDevice);
+  }
+  printf("load     %.1f ms\n",
+    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStartTime).count());
+  Scene::prelimUpdateScene(pScene, &renderDevice, sceneIo);
+
+  auto startTime = std::chrono::steady_clock::now();
+  auto lastReportTime = startTime;
+  PhysicsStats lastReportStats = pm.getStats();
+  RenderQueueStats queueTotals;
+  FrustumCullStats cullTotals;
+  uint64_t worldMatUpdates = 0;
+
+  for (uint64_t tick = 0; tick < settings.numTicks; tick++)
+  {
+    inputScript.getUpdate(tick, sceneIo.input);
+    sceneIo.timeMs = (tick + 1) * settings.tickMs;
+
+    // Like GameMgr::update, the dispatch result is only informational.
+    Scene::updateScene(pScene, &renderDevice, sceneIo);
+    FrustumCullStats cullStats = pScene->getCullStats();
+    cullTotals.tested += cullStats.tested;
+    cullTotals.visible += cullStats.visible;
+    cullTotals.unbounded += cullStats.unbounded;
+    worldMatUpdates += pScene->getWorldMatrixUpdates();
+
+    // Then draw the queued models, as GameMgr::update does.
+    gm.setCamera(sceneIo.camEye, sceneIo.camLookAt, sceneIo.camUp);
+    gm.flush(&renderDevice);
+    RenderQueueStats queueStats = gm.getFrameStats();
+    queueTotals.items += queueStats.items;
+    queueTotals.stateSets += queueStats.stateSets;
+    queueTotals.stateChanges += queueStats.stateChanges;
+
+    if (settings.bRealtime)
+    {
+      std::this_thread::sleep_until(startTime + std::chrono::duration<double, std::milli>(sceneIo.timeMs));
+    }
+
+    if (settings.reportEvery && (tick + 1) % settings.reportEvery == 0)
+    {
+      auto now = std::chrono::steady_clock::now();
+      PhysicsStats curStats = pm.getStats();
+      PhysicsStats deltaStats;
+      deltaStats.steps = curStats.steps - lastReportStats.steps;
+      deltaStats.pairChecks = curStats.pairChecks - lastReportStats.pairChecks;
+      deltaStats.collisions = curStats.collisions - lastReportStats.collisions;
+
+      printReport(
+        "interval",
+        settings.reportEvery,
+        std::chrono::duration<double, std::milli>(now - lastReportTime).count(),
+        settings.reportEvery * settings.tickMs,
+        deltaStats);
+
+      lastReportTime = now;
+      lastReportStats = curStats;
+    }
+  }
+
+  auto endTime = std::chrono::steady_clock::now();
+  printReport(
+    "total",
+    settings.numTicks,
+    std::chrono::duration<double, std::milli>(endTime - startTime).count(),
+    settings.numTicks * settings.tickMs,
+    pm.getStats());
+  printRenderReport(settings.numTicks, renderDevice.getStats());
+  printCullReport(settings.numTicks, cullTotals, worldMatUpdates);
+  printQueueReport(settings.numTicks, queueTotals);
+  printShaderCacheReport(gShaderCache.getStats());
+  printResourceCacheReport(gRenderCache.getStats());
+  if (settings.bStaticBatch)
+  {
+    printStaticBatchReport(pScene->getStaticBatch());
+  }
+
+  Scene::releaseScene(pScene);
+  delete pScene;
+  gm.release();
+  pm.release();
+
+  // The log covers teardown too, anything not released by now leaked.
+  if (renderDevice.getLiveResourceCnt() > 0)
+  {
+    printf("Leaked %u render resources\n", renderDevice.getLiveResourceCnt());
+  }
+
+  if (!settings.renderLog.empty() && !renderDevice.writeCommandLog(settings.renderLog))
+  {
+    printf("Failed to write render log: %s\n", settings.renderLog.c_str());
+  }
+  gLogger.close();
+  return 0;
+}
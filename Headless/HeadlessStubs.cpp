@@ -0,0 +1,41 @@
+// Stand-ins for the DirectSound backed classes, linked into the headless host instead of SoundMgr.cpp. Rendering
+// needs no stubs, it runs for real against a RecordingRenderDevice.
+
+#include "../Engine/SoundMgr.h"
+#include "../Engine/Logger.h"
+
+
+// ~~~ SoundMgr ~~~
+// Hands out handles so scenes and objects behave as if the sounds loaded.
+SoundMgr::SoundMgr()
+{
+  m_handleCnt = SOUND_MGR_INVALID_HANDLE;
+  m_pDirectSound = NULL;
+  m_pPrimaryBuffer = NULL;
+}
+
+
+SoundMgr::~SoundMgr()
+{
+}
+
+
+bool SoundMgr::release()
+{
+  m_handleToSoundMap.clear();
+  return true;
+}
+
+
+bool SoundMgr::registerSound(std::string filename, uint32_t &handle)
+{
+  handle = ++m_handleCnt;
+  m_handleToSoundMap[handle] = NULL;
+  return true;
+}
+
+
+bool SoundMgr::playSound(uint32_t handle, bool bLoop)
+{
+  return m_handleToSoundMap.find(handle) != m_handleToSoundMap.end();
+}
@@ -0,0 +1,78 @@
+#include "InputScript.h"
+#include "../Engine/Logger.h"
+#include <fstream>
+#include <sstream>
+
+bool InputScript::load(std::string filename)
+{
+  std::ifstream fs(filename);
+  if (!fs.is_open())
+  {
+    LOGE("Failed to open input script: %s", filename.c_str());
+    return false;
+  }
+
+  m_entries.clear();
+  m_curEntry = 0;
+  m_bLastSpace = false;
+
+  std::string curLine;
+  int lineCnt = 0;
+  while (std::getline(fs, curLine))
+  {
+    lineCnt++;
+
+    std::istringstream lineStream(curLine);
+    InputScriptEntry entry;
+    int space = 0, sprint = 0;
+
+    if (!(lineStream >> entry.tick))
+    {
+      // Blank line or comment.
+      continue;
+    }
+
+    if (!(lineStream >> entry.input.keyUp >> entry.input.keyRight >> entry.input.yawCw >> entry.input.pitchUp >> space >> sprint))
+    {
+      LOGE("Malformed input script line %d: %s", lineCnt, curLine.c_str());
+      return false;
+    }
+    entry.input.bSpace = (space != 0);
+    entry.input.bSprint = (sprint != 0);
+
+    if (!m_entries.empty() && entry.tick <= m_entries.back().tick)
+    {
+      LOGE("Input script ticks must increase, line %d", lineCnt);
+      return false;
+    }
+
+    m_entries.push_back(entry);
+  }
+
+  LOGI("Loaded %zu input script entries from %s", m_entries.size(), filename.c_str());
+  return true;
+}
+
+
+bool InputScript::getUpdate(uint64_t tick, InputApi &inputUpdate)
+{
+  // Advance to the last entry that has started by this tick.
+  while (m_curEntry + 1 < m_entries.size() && m_entries[m_curEntry + 1].tick <= tick)
+  {
+    m_curEntry++;
+  }
+
+  if (m_entries.empty() || m_entries[m_curEntry].tick > tick)
+  {
+    inputUpdate = InputApi();
+  }
+  else
+  {
+    inputUpdate = m_entries[m_curEntry].input;
+  }
+
+  // Space down is only set on the first tick of a press, like the keyboard path.
+  inputUpdate.bSpaceDown = inputUpdate.bSpace && !m_bLastSpace;
+  m_bLastSpace = inputUpdate.bSpace;
+  return true;
+}
@@ -0,0 +1,37 @@
+#ifndef INPUT_SCRIPT_H
+#define INPUT_SCRIPT_H
+
+#include "../Engine/InputMgr.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Scripted replacement for InputMgr in headless runs. Each line of the script sets the input state from a given tick
+// on, until the next line takes over:
+//
+//   # tick  up  right  yaw  pitch  space  sprint
+//   0       0   1      0    0      0      0
+//   90      0   1      0    0      1      0
+//
+// up/right/yaw/pitch are in -1..1 like InputApi, space/sprint are 0/1. Ticks must be increasing.
+typedef struct InputScriptEntry_
+{
+  uint64_t  tick{ 0 };
+  InputApi  input;
+} InputScriptEntry;
+
+class InputScript
+{
+private:
+  std::vector<InputScriptEntry> m_entries;
+  size_t  m_curEntry{ 0 };
+  bool    m_bLastSpace{ false };
+
+public:
+  bool load(std::string filename);
+
+  // Same contract as InputMgr::getUpdate, but driven by tick count. Ticks should be requested in order.
+  bool getUpdate(uint64_t tick, InputApi &inputUpdate);
+};
+
+#endif
@@ -11,19 +11,37 @@ TestScene::TestScene()
 {
   m_type = SCENE_TYPE_TEST;
   m_bgSoundHandle = SOUND_MGR_INVALID_HANDLE;
+  m_sceneFile = "Tools/TestOut.txt";
+  m_sceneIdOffset = NAMED_OBJECTS_COUNT;
+  m_bStreamLevel = true;
+
+  // Test level edits (Tools/MapParser.py output) show up without a restart. Debug builds only, it's a map editing aid
+  // and polls the file.
+#ifdef _DEBUG
+  m_bHotReload = true;
+#endif
+
+  // Level blocks are plain data, they're run by the ECS systems instead of as GameObjects.
+  m_objMgr.setStoreAsEntity(GAME_OBJECT_POLY_OBJ, true);
+
+  // None of the blocks move, so they all go in the static batch. The camera always looks down -z from in front of
+  // the level (see addUpdateJobs), so the blocks' back faces are never seen.
+  m_bStaticBatch = true;
+  m_staticBatch.setCulledFaces(BOX_FACE_MASK(BOX_FACE_NEG_Z));
+
+  // Anything else made of boxes (the player, blocks when batching is off) is drawn instanced.
+  m_bInstanceBoxes = true;
 }
 
 
-bool TestScene::init(ID3D11Device *dev, ID3D11DeviceContext *devcon)
+bool TestScene::init(RenderDevice *dev)
 {
   // File loading
-  m_objMgr.generateFromFile("Tools/TestOut.txt", dev, devcon, NAMED_OBJECTS_COUNT);
-
-  return true;
+  return loadSceneFile(dev);
 }
 
 
-bool TestScene::prelimUpdate(ID3D11Device *dev, ID3D11DeviceContext *devcon, SceneIo &sceneIo)
+bool TestScene::prelimUpdate(RenderDevice *dev, SceneIo &sceneIo)
 {
   SoundMgr *pSoundMgr = sceneIo.pSoundMgr;
 
@@ -41,30 +59,66 @@ bool TestScene::prelimUpdate(ID3D11Device *dev, ID3D11DeviceContext *devcon, Sce
     pSoundMgr->playSound(m_bgSoundHandle, true);
   }
 
-  return Scene::prelimUpdate(dev, devcon, sceneIo);
+  return Scene::prelimUpdate(dev, sceneIo);
 }
 
 
-bool TestScene::update(ID3D11Device *dev, ID3D11DeviceContext *devcon, SceneIo &sceneIo)
+bool TestScene::update(RenderDevice *dev, SceneIo &sceneIo)
 {
-  bool bSuccess = Scene::update(dev, devcon, sceneIo);
+  GameObject *pPlayer = m_objMgr.getObject(m_playerHandle);
+  if (!pPlayer)
+  {
+    m_playerHandle = m_objMgr.getHandle(TSO_PLAYER);
+    pPlayer = m_objMgr.getObject(m_playerHandle);
+  }
+
+  if (!pPlayer)
+  {
+    LOGE("No player object");
+    return false;
+  }
 
-  // Camera follows the controllable object (in location 0).
-  Pos3 tempPos = m_objMgr.getObject(TSO_PLAYER)->getPos();
+  // Level chunks stream in around the player.
+  m_streamer.setFocus(pPlayer->getPos());
 
-  // 2D-style camera
-  sceneIo.camEye.pos.x = tempPos.pos.x;
-  sceneIo.camEye.pos.y = tempPos.pos.y + EYE_VERT_OFFSET;
-  sceneIo.camEye.pos.z = tempPos.pos.z + 5.0;
-  sceneIo.camLookAt.pos.x = tempPos.pos.x;
-  sceneIo.camLookAt.pos.y = tempPos.pos.y + EYE_VERT_OFFSET;
-  sceneIo.camLookAt.pos.z = tempPos.pos.z;
+  bool bSuccess = Scene::update(dev, sceneIo);
 
   ///TODO: Get output from collisions and run any scene-specific collision handling
   return bSuccess;
 }
 
 
+void TestScene::addUpdateJobs(RenderDevice *dev, SceneIo &sceneIo, JobGraph &graph)
+{
+  // Camera follows the controllable object (in location 0), once its update is done. Streaming can move objects
+  // around in storage, so look it up again through its handle.
+  JobId cameraJob = graph.addJob([this, &sceneIo]()
+  {
+    GameObject *pPlayer = m_objMgr.getObject(m_playerHandle);
+    if (!pPlayer)
+    {
+      return false;
+    }
+    Pos3 tempPos = pPlayer->getPos();
+
+    // 2D-style camera
+    sceneIo.camEye.pos.x = tempPos.pos.x;
+    sceneIo.camEye.pos.y = tempPos.pos.y + EYE_VERT_OFFSET;
+    sceneIo.camEye.pos.z = tempPos.pos.z + 5.0;
+    sceneIo.camLookAt.pos.x = tempPos.pos.x;
+    sceneIo.camLookAt.pos.y = tempPos.pos.y + EYE_VERT_OFFSET;
+    sceneIo.camLookAt.pos.z = tempPos.pos.z;
+    return true;
+  });
+
+  JobId playerJob = getUpdateJob(TSO_PLAYER);
+  if (playerJob != JOB_ID_INVALID)
+  {
+    graph.addDependency(cameraJob, playerJob);
+  }
+}
+
+
 void TestScene::handleCollision(GameObject* obj, PModelOutput *pModelOut)
 {
   //LOGD("TestScene level collision handling for obj %u", obj->getUuid());
@@ -16,11 +16,14 @@ private:
   // Might move to Scene base class eventually...
   uint32_t m_bgSoundHandle;
 
+  ObjectHandle m_playerHandle;
+
 public:
   TestScene();
-  bool init(ID3D11Device *dev, ID3D11DeviceContext *devcon);
-  bool update(ID3D11Device *dev, ID3D11DeviceContext *devcon, SceneIo &sceneIo);
-  bool prelimUpdate(ID3D11Device *dev, ID3D11DeviceContext *devcon, SceneIo &sceneIo);
+  bool init(RenderDevice *dev);
+  bool update(RenderDevice *dev, SceneIo &sceneIo);
+  bool prelimUpdate(RenderDevice *dev, SceneIo &sceneIo);
+  void addUpdateJobs(RenderDevice *dev, SceneIo &sceneIo, JobGraph &graph);
 
   void handleCollision(GameObject* obj, PModelOutput *pModelOut);
 };
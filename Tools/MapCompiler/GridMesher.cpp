@@ -0,0 +1,182 @@
+#include "GridMesher.h"
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+// Take the longest run to the right of each unclaimed cell, then extend it down while whole rows match.
+static void meshRowsFirst(
+  std::vector<uint16_t> &cells,
+  uint32_t width,
+  uint32_t height,
+  uint32_t topY,
+  std::vector<MapRect> &rects)
+{
+  for (uint32_t y = 0; y < height; y++)
+  {
+    uint16_t *pRow = &cells[static_cast<size_t>(y) * width];
+    uint32_t x = 0;
+    while (x < width)
+    {
+      uint16_t sym = pRow[x];
+      if (sym == GRID_SYMBOL_EMPTY)
+      {
+        x++;
+        continue;
+      }
+
+      uint32_t dimX = 1;
+      while (x + dimX < width && pRow[x + dimX] == sym)
+      {
+        dimX++;
+      }
+
+      uint32_t dimY = 1;
+      while (y + dimY < height)
+      {
+        uint16_t *pBelow = pRow + static_cast<size_t>(dimY) * width + x;
+        if (std::find_if(pBelow, pBelow + dimX, [sym](uint16_t cell) { return cell != sym; }) != pBelow + dimX)
+        {
+          break;
+        }
+        dimY++;
+      }
+
+      for (uint32_t i = 0; i < dimY; i++)
+      {
+        uint16_t *pClaim = pRow + static_cast<size_t>(i) * width + x;
+        std::fill(pClaim, pClaim + dimX, static_cast<uint16_t>(GRID_SYMBOL_EMPTY));
+      }
+
+      MapRect rect = { x, topY + y, dimX, dimY, sym };
+      rects.push_back(rect);
+      x += dimX;
+    }
+  }
+}
+
+
+// Take the longest run below each unclaimed cell, then extend it right while whole columns match. Tall features
+// (walls, pillars) come out as single rectangles this way, where rows-first would stack slices of them.
+static void meshColumnsFirst(
+  std::vector<uint16_t> &cells,
+  uint32_t width,
+  uint32_t height,
+  uint32_t topY,
+  std::vector<MapRect> &rects)
+{
+  for (uint32_t y = 0; y < height; y++)
+  {
+    uint16_t *pRow = &cells[static_cast<size_t>(y) * width];
+    uint32_t x = 0;
+    while (x < width)
+    {
+      uint16_t sym = pRow[x];
+      if (sym == GRID_SYMBOL_EMPTY)
+      {
+        x++;
+        continue;
+      }
+
+      uint32_t dimY = 1;
+      while (y + dimY < height && pRow[static_cast<size_t>(dimY) * width + x] == sym)
+      {
+        dimY++;
+      }
+
+      uint32_t dimX = 1;
+      while (x + dimX < width)
+      {
+        bool bMatch = true;
+        for (uint32_t i = 0; i < dimY && bMatch; i++)
+        {
+          bMatch = pRow[static_cast<size_t>(i) * width + x + dimX] == sym;
+        }
+        if (!bMatch)
+        {
+          break;
+        }
+        dimX++;
+      }
+
+      for (uint32_t i = 0; i < dimY; i++)
+      {
+        uint16_t *pClaim = pRow + static_cast<size_t>(i) * width + x;
+        std::fill(pClaim, pClaim + dimX, static_cast<uint16_t>(GRID_SYMBOL_EMPTY));
+      }
+
+      MapRect rect = { x, topY + y, dimX, dimY, sym };
+      rects.push_back(rect);
+      x += dimX;
+    }
+  }
+}
+
+
+void meshGridBand(
+  std::vector<uint16_t> &cells,
+  uint32_t width,
+  uint32_t height,
+  uint32_t topY,
+  std::vector<MapRect> &rects)
+{
+  std::vector<uint16_t> cellsCopy(cells);
+  std::vector<MapRect> rowRects;
+  meshRowsFirst(cellsCopy, width, height, topY, rowRects);
+  cellsCopy = std::vector<uint16_t>();
+
+  std::vector<MapRect> colRects;
+  meshColumnsFirst(cells, width, height, topY, colRects);
+
+  std::vector<MapRect> &best = (colRects.size() < rowRects.size()) ? colRects : rowRects;
+  rects.insert(rects.end(), best.begin(), best.end());
+}
+
+
+void mergeBandSeams(std::vector<std::vector<MapRect>> &bandRects, uint32_t bandRows)
+{
+  // Rectangles reaching the bottom of the previous band, by (leftX, dimX, symbol).
+  typedef std::tuple<uint32_t, uint32_t, uint32_t> SeamKey;
+  std::map<SeamKey, MapRect*> open;
+
+  for (size_t band = 0; band < bandRects.size(); band++)
+  {
+    uint32_t bandTop = static_cast<uint32_t>(band) * bandRows;
+    uint32_t bandBottom = bandTop + bandRows;
+    std::map<SeamKey, MapRect*> nextOpen;
+    std::vector<MapRect> &rects = bandRects[band];
+
+    size_t keptCnt = 0;
+    for (size_t i = 0; i < rects.size(); i++)
+    {
+      MapRect &rect = rects[i];
+      SeamKey key(rect.leftX, rect.dimX, rect.symbol);
+      MapRect *pJoined = NULL;
+
+      if (rect.topY == bandTop)
+      {
+        auto it = open.find(key);
+        if (it != open.end())
+        {
+          pJoined = it->second;
+          pJoined->dimY += rect.dimY;
+        }
+      }
+
+      if (!pJoined)
+      {
+        rects[keptCnt] = rect;
+        pJoined = &rects[keptCnt];
+        keptCnt++;
+      }
+
+      if (pJoined->topY + pJoined->dimY == bandBottom)
+      {
+        nextOpen[key] = pJoined;
+      }
+    }
+
+    // Pointers into this band stay valid, shrinking doesn't reallocate.
+    rects.resize(keptCnt);
+    open.swap(nextOpen);
+  }
+}
@@ -0,0 +1,36 @@
+#ifndef GRID_MESHER_H
+#define GRID_MESHER_H
+
+#include <stdint.h>
+#include <vector>
+
+// Symbol 0 is an empty cell, it never ends up in a rectangle.
+#define GRID_SYMBOL_EMPTY  0
+
+// A merged group of cells, in the same terms as MapParser.py's GroupInfo: cell offsets from the top left of the map,
+// with Y growing downwards.
+typedef struct MapRect_
+{
+  uint32_t leftX;
+  uint32_t topY;
+  uint32_t dimX;
+  uint32_t dimY;
+  uint32_t symbol;
+} MapRect;
+
+// Merges the same-symbol cells of a band of map rows (row-major, width * height cells) into rectangles.
+// Runs a greedy pass growing rectangles sideways first, and one growing them downwards first, and keeps whichever
+// emits fewer rectangles. Both list rectangles by top left cell in row-major order. cells is consumed.
+void meshGridBand(
+  std::vector<uint16_t> &cells,
+  uint32_t width,
+  uint32_t height,
+  uint32_t topY,
+  std::vector<MapRect> &rects);
+
+// Joins rectangles that were cut by band boundaries: a rectangle ending on a boundary is extended by a rectangle of
+// the same columns and symbol starting there. bandRects are in map order, with global symbols, and are meshed from
+// bands of bandRows rows. Joined rectangles are removed, the remaining order is unchanged.
+void mergeBandSeams(std::vector<std::vector<MapRect>> &bandRects, uint32_t bandRows);
+
+#endif
@@ -0,0 +1,646 @@
+// Native replacement for Tools/MapParser.py: compiles a block-by-block text map into a 'P'/'B' text scene and/or a
+// binary scene (see Engine/SceneBin.h). Reads the same map format, with the same row/column to location mapping and
+// the same '.<identifier>' texture settings, but merges cells with a greedy mesher (see GridMesher.h) that emits
+// fewer blocks than MapParser.py's group splitting. The map is cut into bands of rows that are parsed and meshed in
+// parallel, rectangles cut by band edges are joined back up afterwards.
+//
+// Differences from MapParser.py:
+//   - Output is ordered (players first, then blocks by top left cell), so the same map always compiles to the same
+//     file. Binary block IDs are the text scene line numbers, same as Tools/SceneBinConverter.py.
+//   - Blocks whose texture identifier was never defined are skipped with a warning instead of stopping the export.
+//   - A map row starting with a lone '.' is a row, not an (empty) texture definition.
+//
+// Build from the repo root, ex. on Linux (one command, wrapped here):
+//   g++ -O2 -std=c++17 -pthread -o Tools/MapCompiler/MapCompiler Tools/MapCompiler/*.cpp Engine/MappedFile.cpp
+//     Engine/Logger.cpp
+// Tools/MapCompilerTests.py runs the executable from there.
+//
+// Usage:
+//   MapCompiler -i map.txt [-o scene.txt] [-b scene.bin] [--threads N] [--band-rows R]
+
+#include "GridMesher.h"
+#include "../../Engine/MappedFile.h"
+#include "../../Engine/SceneBin.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Setting prefix for block textures, ex. '.1 Textures/cat.dds' defines it and 'B.1' uses it. Matches
+// BLOCK_SYMBOL_PREFIXES in MapParser.py.
+static const char TEXTURE_PREFIX = '.';
+
+// Map cells with this type are empty space.
+static const char EMPTY_TYPE[] = ".";
+
+typedef struct MapCompilerSettings_
+{
+  std::string inputPath;
+  std::string textPath;
+  std::string binPath;
+  uint32_t    numThreads{ 0 };    // 0 picks the hardware thread count.
+  uint32_t    bandRows{ 256 };
+} MapCompilerSettings;
+
+typedef struct MapLine_
+{
+  std::string_view text;
+  int32_t          defaultTex{ -1 };    // Index into MapInfo::texIdents, -1 if no texture was defined yet.
+  bool             bDefinition{ false };
+} MapLine;
+
+typedef struct MapInfo_
+{
+  std::vector<MapLine> lines;
+  std::vector<std::string> texIdents;                   // In definition order, duplicates allowed.
+  std::map<std::string, std::string> texPaths;          // Identifier -> latest path defined for it.
+} MapInfo;
+
+// A cell type with its resolved texture identifier.
+typedef struct MapSymbol_
+{
+  std::string type;
+  std::string texIdent;
+  bool        bHasTex{ false };
+} MapSymbol;
+
+typedef struct MapBand_
+{
+  uint32_t topY{ 0 };
+  uint32_t height{ 0 };
+  uint32_t width{ 0 };
+  std::vector<MapSymbol> symbols;   // Band-local, index 0 is GRID_SYMBOL_EMPTY.
+  std::vector<MapRect> rects;
+  bool bFailed{ false };
+} MapBand;
+
+
+// Identifies a symbol across bands. An explicit texture identifier never matches "no texture".
+static std::string symbolKey(const MapSymbol &sym)
+{
+  std::string key(sym.type);
+  key += '\0';
+  key += sym.bHasTex ? '+' : '-';
+  key += sym.texIdent;
+  return key;
+}
+
+
+static bool isSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+
+// Calls fn for each whitespace separated token in the line, stops early if fn returns false.
+template <typename Fn>
+static void forEachToken(std::string_view line, Fn fn)
+{
+  size_t pos = 0;
+  while (pos < line.size())
+  {
+    while (pos < line.size() && isSpace(line[pos]))
+    {
+      pos++;
+    }
+
+    size_t start = pos;
+    while (pos < line.size() && !isSpace(line[pos]))
+    {
+      pos++;
+    }
+
+    if (pos > start && !fn(line.substr(start, pos - start)))
+    {
+      return;
+    }
+  }
+}
+
+
+// Splits settings off the end of a token, same as MapParser.lineStrToSymbolList: '<prefix><value>' pairs are peeled
+// off the right, each with at least one character of value, and the leftmost one wins. What's left is the type.
+static void parseToken(std::string_view token, std::string_view &type, std::string_view &texIdent, bool &bHasTex)
+{
+  bHasTex = false;
+  while (token.size() > 1)
+  {
+    size_t prefixPos = token.find_last_of(TEXTURE_PREFIX, token.size() - 2);
+    if (prefixPos == std::string_view::npos)
+    {
+      break;
+    }
+
+    texIdent = token.substr(prefixPos + 1);
+    bHasTex = true;
+    token = token.substr(0, prefixPos);
+  }
+  type = token;
+}
+
+
+// Splits the map into lines and collects texture definitions, so bands know which default texture applies to each
+// of their rows without parsing anything before them.
+static void scanMap(const char *pData, size_t size, MapInfo &info)
+{
+  int32_t curDefault = -1;
+  size_t pos = 0;
+  while (pos < size)
+  {
+    const char *pEnd = static_cast<const char*>(memchr(pData + pos, '\n', size - pos));
+    size_t lineEnd = pEnd ? static_cast<size_t>(pEnd - pData) : size;
+
+    MapLine line;
+    line.text = std::string_view(pData + pos, lineEnd - pos);
+
+    std::string_view first;
+    forEachToken(line.text, [&](std::string_view token)
+    {
+      first = token;
+      return false;
+    });
+
+    if (first.size() > 1 && first[0] == TEXTURE_PREFIX)
+    {
+      // Definition line: '.<identifier> <path>'. The path is the rest of the line, single spaced.
+      std::string ident(first.substr(1));
+      std::string path;
+      bool bFirst = true;
+      forEachToken(line.text, [&](std::string_view token)
+      {
+        if (bFirst)
+        {
+          bFirst = false;
+          return true;
+        }
+        if (!path.empty())
+        {
+          path += ' ';
+        }
+        path.append(token.data(), token.size());
+        return true;
+      });
+
+      info.texPaths[ident] = path;
+      info.texIdents.push_back(ident);
+      curDefault = static_cast<int32_t>(info.texIdents.size() - 1);
+      line.bDefinition = true;
+    }
+
+    // The most recent definition is the default for the lines after it.
+    line.defaultTex = line.bDefinition ? -1 : curDefault;
+    info.lines.push_back(line);
+    pos = lineEnd + 1;
+  }
+}
+
+
+// Parses and meshes one band of rows. Only touches the band and read-only map info, so bands can run in parallel.
+static void compileBand(const MapInfo &info, MapBand &band)
+{
+  uint32_t rowEnd = band.topY + band.height;
+
+  band.width = 0;
+  for (uint32_t y = band.topY; y < rowEnd; y++)
+  {
+    const MapLine &line = info.lines[y];
+    if (line.bDefinition)
+    {
+      continue;
+    }
+
+    uint32_t cnt = 0;
+    forEachToken(line.text, [&cnt](std::string_view token)
+    {
+      cnt++;
+      return true;
+    });
+    band.width = std::max(band.width, cnt);
+  }
+
+  std::vector<uint16_t> cells(static_cast<size_t>(band.width) * band.height, GRID_SYMBOL_EMPTY);
+  band.symbols.assign(1, MapSymbol());
+
+  // Tokens resolve to the same symbol until the default texture changes, which most maps only do once at the top.
+  std::unordered_map<std::string_view, uint16_t> tokenSymbols;
+  std::unordered_map<std::string, uint16_t> keySymbols;
+  int32_t tokenDefault = -1;
+
+  for (uint32_t y = band.topY; y < rowEnd && !band.bFailed; y++)
+  {
+    const MapLine &line = info.lines[y];
+    if (line.bDefinition)
+    {
+      continue;
+    }
+
+    if (line.defaultTex != tokenDefault)
+    {
+      tokenSymbols.clear();
+      tokenDefault = line.defaultTex;
+    }
+
+    uint16_t *pRow = &cells[static_cast<size_t>(y - band.topY) * band.width];
+    std::string_view lastToken;
+    uint16_t lastSym = GRID_SYMBOL_EMPTY;
+    forEachToken(line.text, [&](std::string_view token)
+    {
+      if (token != lastToken)
+      {
+        auto it = tokenSymbols.find(token);
+        if (it != tokenSymbols.end())
+        {
+          lastSym = it->second;
+        }
+        else
+        {
+          MapSymbol sym;
+          std::string_view type, texIdent;
+          parseToken(token, type, texIdent, sym.bHasTex);
+          sym.type.assign(type.data(), type.size());
+          if (sym.bHasTex)
+          {
+            sym.texIdent.assign(texIdent.data(), texIdent.size());
+          }
+          else if (tokenDefault >= 0)
+          {
+            sym.texIdent = info.texIdents[tokenDefault];
+            sym.bHasTex = true;
+          }
+
+          if (sym.type == EMPTY_TYPE)
+          {
+            lastSym = GRID_SYMBOL_EMPTY;
+          }
+          else
+          {
+            std::string key = symbolKey(sym);
+            auto keyIt = keySymbols.find(key);
+            if (keyIt != keySymbols.end())
+            {
+              lastSym = keyIt->second;
+            }
+            else if (band.symbols.size() > UINT16_MAX)
+            {
+              fprintf(stderr, "Too many distinct cell types in rows %u-%u\n", band.topY, rowEnd - 1);
+              band.bFailed = true;
+              return false;
+            }
+            else
+            {
+              lastSym = static_cast<uint16_t>(band.symbols.size());
+              band.symbols.push_back(sym);
+              keySymbols[key] = lastSym;
+            }
+          }
+          tokenSymbols[token] = lastSym;
+        }
+        lastToken = token;
+      }
+
+      *pRow++ = lastSym;
+      return true;
+    });
+  }
+
+  if (!band.bFailed)
+  {
+    meshGridBand(cells, band.width, band.height, band.topY, band.rects);
+  }
+}
+
+
+static void appendHalves(std::string &out, uint64_t halves, bool bNegative)
+{
+  // MapParser.py prints these as Python floats, ex. '3.5', '-2.0'.
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%s%llu.%c", bNegative ? "-" : "", static_cast<unsigned long long>(halves / 2),
+    (halves % 2) ? '5' : '0');
+  out += buf;
+}
+
+
+// Location of a rectangle's center, as MapParser.py computes it: X grows right, Y grows up from the top row, Z is 0.
+static void appendLoc(std::string &out, const MapRect &rect)
+{
+  appendHalves(out, 2ull * rect.leftX + rect.dimX, false);
+  out += ' ';
+  appendHalves(out, 2ull * rect.topY + rect.dimY, true);
+  out += " 0";
+}
+
+
+static void rectLoc(const MapRect &rect, float loc[3])
+{
+  loc[0] = rect.leftX + rect.dimX * 0.5f;
+  loc[1] = -(rect.topY + rect.dimY * 0.5f);
+  loc[2] = 0.0f;
+}
+
+
+static bool writeFile(const std::string &path, const void *pData, size_t size)
+{
+  FILE *pFile = fopen(path.c_str(), "wb");
+  if (!pFile)
+  {
+    fprintf(stderr, "Can't open %s for writing\n", path.c_str());
+    return false;
+  }
+
+  bool bOk = fwrite(pData, 1, size, pFile) == size;
+  bOk = (fclose(pFile) == 0) && bOk;
+  if (!bOk)
+  {
+    fprintf(stderr, "Failed writing %s\n", path.c_str());
+  }
+  return bOk;
+}
+
+
+static void printUsage()
+{
+  printf("Usage: MapCompiler -i map.txt [-o scene.txt] [-b scene.bin] [--threads N] [--band-rows R]\n");
+}
+
+
+static bool parseArgs(int argc, char **argv, MapCompilerSettings &settings)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    bool bHasVal = (i + 1 < argc);
+    if ((!strcmp(argv[i], "-i") || !strcmp(argv[i], "--input")) && bHasVal)
+    {
+      settings.inputPath = argv[++i];
+    }
+    else if ((!strcmp(argv[i], "-o") || !strcmp(argv[i], "--output")) && bHasVal)
+    {
+      settings.textPath = argv[++i];
+    }
+    else if ((!strcmp(argv[i], "-b") || !strcmp(argv[i], "--bin")) && bHasVal)
+    {
+      settings.binPath = argv[++i];
+    }
+    else if (!strcmp(argv[i], "--threads") && bHasVal)
+    {
+      settings.numThreads = static_cast<uint32_t>(atoi(argv[++i]));
+    }
+    else if (!strcmp(argv[i], "--band-rows") && bHasVal)
+    {
+      settings.bandRows = static_cast<uint32_t>(atoi(argv[++i]));
+    }
+    else
+    {
+      printUsage();
+      return false;
+    }
+  }
+
+  if (settings.inputPath.empty() || (settings.textPath.empty() && settings.binPath.empty()) || settings.bandRows == 0)
+  {
+    printUsage();
+    return false;
+  }
+
+  if (settings.numThreads == 0)
+  {
+    settings.numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  return true;
+}
+
+
+int main(int argc, char **argv)
+{
+  MapCompilerSettings settings;
+  if (!parseArgs(argc, argv, settings))
+  {
+    return 1;
+  }
+
+  auto startTime = std::chrono::steady_clock::now();
+
+  MappedFile file;
+  if (!file.open(settings.inputPath))
+  {
+    fprintf(stderr, "Can't read map %s\n", settings.inputPath.c_str());
+    return 1;
+  }
+
+  MapInfo info;
+  scanMap(reinterpret_cast<const char*>(file.data()), file.size(), info);
+
+  // Parse and mesh bands in parallel.
+  uint32_t numRows = static_cast<uint32_t>(info.lines.size());
+  std::vector<MapBand> bands((numRows + settings.bandRows - 1) / settings.bandRows);
+  for (size_t i = 0; i < bands.size(); i++)
+  {
+    bands[i].topY = static_cast<uint32_t>(i) * settings.bandRows;
+    bands[i].height = std::min(settings.bandRows, numRows - bands[i].topY);
+  }
+
+  std::atomic<size_t> nextBand(0);
+  auto worker = [&]()
+  {
+    for (size_t i = nextBand++; i < bands.size(); i = nextBand++)
+    {
+      compileBand(info, bands[i]);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  uint32_t numThreads = std::min<uint32_t>(settings.numThreads, static_cast<uint32_t>(bands.size()));
+  for (uint32_t i = 1; i < numThreads; i++)
+  {
+    threads.push_back(std::thread(worker));
+  }
+  worker();
+  for (size_t i = 0; i < threads.size(); i++)
+  {
+    threads[i].join();
+  }
+
+  // Give band-local symbols global IDs, so rectangles can be joined across bands.
+  std::vector<MapSymbol> symbols(1);
+  std::unordered_map<std::string, uint32_t> keySymbols;
+  std::vector<std::vector<MapRect>> bandRects(bands.size());
+  uint32_t width = 0;
+  for (size_t i = 0; i < bands.size(); i++)
+  {
+    MapBand &band = bands[i];
+    if (band.bFailed)
+    {
+      return 1;
+    }
+    width = std::max(width, band.width);
+
+    std::vector<uint32_t> remap(band.symbols.size(), GRID_SYMBOL_EMPTY);
+    for (size_t s = 1; s < band.symbols.size(); s++)
+    {
+      const MapSymbol &sym = band.symbols[s];
+      std::string key = symbolKey(sym);
+      auto it = keySymbols.find(key);
+      if (it == keySymbols.end())
+      {
+        it = keySymbols.insert(std::make_pair(key, static_cast<uint32_t>(symbols.size()))).first;
+        symbols.push_back(sym);
+      }
+      remap[s] = it->second;
+    }
+
+    for (auto it = band.rects.begin(); it != band.rects.end(); ++it)
+    {
+      it->symbol = remap[it->symbol];
+    }
+    bandRects[i].swap(band.rects);
+  }
+  bands = std::vector<MapBand>();
+
+  mergeBandSeams(bandRects, settings.bandRows);
+
+  // Sort out what each symbol turns into. Anything that isn't a player or a textured block is dropped.
+  std::vector<const std::string*> symbolTex(symbols.size(), NULL);
+  std::vector<bool> symbolPlayer(symbols.size(), false);
+  for (size_t s = 1; s < symbols.size(); s++)
+  {
+    const MapSymbol &sym = symbols[s];
+    if (sym.type == "P")
+    {
+      symbolPlayer[s] = true;
+    }
+    else if (sym.type == "B")
+    {
+      auto it = sym.bHasTex ? info.texPaths.find(sym.texIdent) : info.texPaths.end();
+      if (it == info.texPaths.end())
+      {
+        fprintf(stderr, "No texture defined for '%s%c%s', skipping those blocks\n",
+          sym.type.c_str(), TEXTURE_PREFIX, sym.texIdent.c_str());
+        continue;
+      }
+      symbolTex[s] = &it->second;
+    }
+    else
+    {
+      fprintf(stderr, "Unexpected type: %s\n", sym.type.c_str());
+    }
+  }
+
+  std::vector<const MapRect*> players;
+  std::vector<const MapRect*> blocks;
+  for (auto bandIt = bandRects.begin(); bandIt != bandRects.end(); ++bandIt)
+  {
+    for (auto it = bandIt->begin(); it != bandIt->end(); ++it)
+    {
+      if (symbolPlayer[it->symbol])
+      {
+        players.push_back(&*it);
+      }
+      else if (symbolTex[it->symbol])
+      {
+        blocks.push_back(&*it);
+      }
+    }
+  }
+
+  bool bOk = true;
+  if (!settings.textPath.empty())
+  {
+    std::string out;
+    out.reserve((players.size() + blocks.size()) * 48);
+    for (auto it = players.begin(); it != players.end(); ++it)
+    {
+      out += "P ";
+      appendLoc(out, **it);
+      out += '\n';
+    }
+
+    char buf[64];
+    for (auto it = blocks.begin(); it != blocks.end(); ++it)
+    {
+      const MapRect &rect = **it;
+      out += "B ";
+      appendLoc(out, rect);
+      snprintf(buf, sizeof(buf), " %u %u 1.0 ", rect.dimX, rect.dimY);
+      out += buf;
+      out += *symbolTex[rect.symbol];
+      out += '\n';
+    }
+    bOk = writeFile(settings.textPath, out.data(), out.size()) && bOk;
+  }
+
+  if (!settings.binPath.empty())
+  {
+    // Same layout Tools/SceneBinConverter.py writes for the text scene, block IDs are their text line numbers.
+    std::vector<SceneBinObject> objects;
+    objects.reserve(players.size() + blocks.size());
+    std::string stringTable;
+    std::unordered_map<const std::string*, uint32_t> stringOffsets;
+
+    for (auto it = players.begin(); it != players.end(); ++it)
+    {
+      SceneBinObject obj = {};
+      obj.type = SCENE_BIN_OBJ_PLAYER;
+      rectLoc(**it, obj.loc);
+      objects.push_back(obj);
+    }
+
+    uint32_t lineNum = static_cast<uint32_t>(players.size());
+    for (auto it = blocks.begin(); it != blocks.end(); ++it)
+    {
+      const MapRect &rect = **it;
+      const std::string *pTex = symbolTex[rect.symbol];
+      auto strIt = stringOffsets.find(pTex);
+      if (strIt == stringOffsets.end())
+      {
+        strIt = stringOffsets.insert(std::make_pair(pTex, static_cast<uint32_t>(stringTable.size()))).first;
+        stringTable.append(pTex->c_str(), pTex->size() + 1);
+      }
+
+      SceneBinObject obj = {};
+      obj.type = SCENE_BIN_OBJ_BLOCK;
+      obj.id = ++lineNum;
+      rectLoc(rect, obj.loc);
+      obj.dim[0] = static_cast<float>(rect.dimX);
+      obj.dim[1] = static_cast<float>(rect.dimY);
+      obj.dim[2] = 1.0f;
+      obj.textureOffset = strIt->second;
+      objects.push_back(obj);
+    }
+
+    // Keep the string table non-empty so offset 0 is always valid.
+    if (stringTable.empty())
+    {
+      stringTable.push_back('\0');
+    }
+
+    SceneBinHeader header = {};
+    header.magic = SCENE_BIN_MAGIC;
+    header.version = SCENE_BIN_VERSION;
+    header.headerSize = sizeof(SceneBinHeader);
+    header.objectCount = static_cast<uint32_t>(objects.size());
+    header.objectTableOffset = sizeof(SceneBinHeader);
+    header.stringTableOffset = static_cast<uint32_t>(header.objectTableOffset + objects.size() * sizeof(SceneBinObject));
+    header.stringTableSize = static_cast<uint32_t>(stringTable.size());
+
+    std::vector<uint8_t> data(header.stringTableOffset + stringTable.size());
+    memcpy(&data[0], &header, sizeof(header));
+    if (!objects.empty())
+    {
+      memcpy(&data[header.objectTableOffset], &objects[0], objects.size() * sizeof(SceneBinObject));
+    }
+    memcpy(&data[header.stringTableOffset], stringTable.data(), stringTable.size());
+    bOk = writeFile(settings.binPath, &data[0], data.size()) && bOk;
+  }
+
+  double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+  printf("Compiled %s: %u x %u cells -> %zu blocks, %zu players, %u threads, %.1f ms\n",
+    settings.inputPath.c_str(), width, numRows, blocks.size(), players.size(), numThreads, totalMs);
+  return bOk ? 0 : 1;
+}
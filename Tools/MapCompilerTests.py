@@ -0,0 +1,156 @@
+import os
+import random
+import subprocess
+import tempfile
+import traceback
+import unittest
+
+import MapParser
+import SceneBinConverter as sbc
+
+# Tests for the native map compiler. Build it first (see the top of MapCompiler/MapCompiler.cpp), and point
+# MAP_COMPILER at the executable if it isn't in MapCompiler/ next to this file.
+MAP_COMPILER = os.environ.get('MAP_COMPILER',
+    os.path.join(os.path.dirname(os.path.abspath(__file__)), 'MapCompiler', 'MapCompiler'))
+if os.name == 'nt' and not MAP_COMPILER.endswith('.exe'):
+    MAP_COMPILER += '.exe'
+
+@unittest.skipUnless(os.path.isfile(MAP_COMPILER), 'MapCompiler not built: {}'.format(MAP_COMPILER))
+class TestMapCompiler(unittest.TestCase):
+
+    def setUp(self):
+        self.tmpDir = tempfile.TemporaryDirectory()
+
+    def tearDown(self):
+        self.tmpDir.cleanup()
+
+    def _compile(self, mapLines, extraArgs=None):
+        mapPath = os.path.join(self.tmpDir.name, 'map.txt')
+        textPath = os.path.join(self.tmpDir.name, 'scene.txt')
+        binPath = os.path.join(self.tmpDir.name, 'scene.bin')
+        with open(mapPath, 'w') as f:
+            f.write('\n'.join(mapLines) + '\n')
+
+        subprocess.run([MAP_COMPILER, '-i', mapPath, '-o', textPath, '-b', binPath] + (extraArgs or []),
+            check=True, stdout=subprocess.DEVNULL)
+
+        with open(textPath, 'r') as f:
+            textObjects = sbc.parseTextScene(f.readlines())
+        with open(binPath, 'rb') as f:
+            binObjects = sbc.readBinScene(f.read())
+        return textObjects, binObjects
+
+    # Integer symbols become blocks with a texture per symbol. Definitions take up the first map rows.
+    def _arrayToMap(self, array):
+        symbols = sorted(set(sym for row in array for sym in row))
+        lines = ['.{} Textures/{}.dds'.format(sym, sym) for sym in symbols]
+        lines += [' '.join('B.{}'.format(sym) for sym in row) for row in array]
+        return lines, len(symbols)
+
+    # Inverse of the location/dimension math in MapParser.MapFileToSetFile.
+    def _objectsToArray(self, objects, rowOffset):
+        groups = []
+        for obj in objects:
+            self.assertEqual(obj.type, sbc.OBJ_TYPE_BLOCK)
+            dimX, dimY = int(obj.dim[0]), int(obj.dim[1])
+            leftX = int(obj.loc[0] - dimX * 0.5)
+            topY = int(-obj.loc[1] - dimY * 0.5) - rowOffset
+            symbol = int(obj.texture[len('Textures/'):-len('.dds')])
+            groups.append(MapParser.GroupInfo(symbol=symbol, leftX=leftX, topY=topY, dimX=dimX, dimY=dimY))
+        return MapParser.MapParser().setToArray(groups)
+
+    def _runTestIteration(self, name, input, extraArgs=None):
+        print('\nRunning Test: {}'.format(name))
+        try:
+            lines, rowOffset = self._arrayToMap(input)
+            textObjects, binObjects = self._compile(lines, extraArgs)
+            self.assertEqual(self._objectsToArray(textObjects, rowOffset), input)
+
+            # Binary scene holds the same objects, with blocks numbered by their text line.
+            self.assertEqual(binObjects, textObjects)
+            return len(textObjects)
+        except:
+            self.assertTrue(False, 'EXCEPTION: {}'.format(traceback.format_exc()))
+
+    def test_standard(self):
+        # Same cases as MapParserTests.TestGrouping.
+        STANDARD_TESTS = [
+            ('Empty', []),
+            ('OneEntry', [[0]]),
+            ('OneRowSame', [[0, 0]]),
+            ('OneRowDiff', [[1, 2]]),
+            ('OneColumnSame', [[0], [0]]),
+            ('OneColumnDiff', [[3], [1]]),
+            ('2x2Same', [[0, 0], [0,0]]),
+            ('2x2Diff', [[0, 1], [2,3]]),
+            ('2x2Column', [[0,1], [0,2]]),
+            ('3x3Overhang',  [[0, 0, 0], [1, 0, 2], [3, 2, 0]]),
+            ('3x3Underhang',  [[3, 2, 0], [1, 0, 2], [0, 0, 0]])
+        ]
+
+        for name, input in STANDARD_TESTS:
+            self._runTestIteration(name, input)
+
+    def test_random(self):
+        # Same inputs as MapParserTests.TestGrouping. The compiler should never need more blocks in total.
+        RANDOM_SEED = 42
+        NUM_RAND_GROUP_TESTS = 100
+
+        random.seed(RANDOM_SEED)
+        compilerCnt = 0
+        parserCnt = 0
+        for idx in range(NUM_RAND_GROUP_TESTS):
+            name = 'RandInput_{}'.format(idx)
+            width = random.randint(1,10)
+            height = random.randint(1,10)
+            input = []
+            for h in range(height):
+                input.append([random.randint(0,9) for w in range(width)])
+            compilerCnt += self._runTestIteration(name, input)
+            parserCnt += len(MapParser.MapParser().arrayToSet(input))
+
+        print('\nBlocks: compiler {}, MapParser {}'.format(compilerCnt, parserCnt))
+        self.assertLessEqual(compilerCnt, parserCnt)
+
+    def test_bandSeams(self):
+        # Bands of 2 rows over few symbols, so rectangles regularly cross band edges and have to be joined.
+        random.seed(7)
+        for idx in range(20):
+            input = [[random.randint(0,1) for w in range(8)] for h in range(random.randint(1,12))]
+            self._runTestIteration('Bands_{}'.format(idx), input, ['--band-rows', '2', '--threads', '4'])
+
+        # A solid map must still come out as one block.
+        self.assertEqual(self._runTestIteration('BandsSolid', [[0] * 5] * 9, ['--band-rows', '2']), 1)
+
+    def test_testMap(self):
+        # Cells covered by each texture/type must match MapParser.py's output for the same map.
+        mp = MapParser.MapParser()
+        groups = mp.MapFileToSet(os.path.join(os.path.dirname(os.path.abspath(__file__)), 'TestMap.txt'))
+        with open(os.path.join(os.path.dirname(os.path.abspath(__file__)), 'TestMap.txt'), 'r') as f:
+            textObjects, binObjects = self._compile(f.read().splitlines())
+
+        def cells(objects):
+            covered = set()
+            for obj in objects:
+                if obj.type == sbc.OBJ_TYPE_PLAYER:
+                    covered.add(('P', obj.loc))
+                    continue
+                for x in range(int(obj.dim[0])):
+                    for y in range(int(obj.dim[1])):
+                        covered.add((obj.texture, obj.loc[0] - obj.dim[0] * 0.5 + x, -obj.loc[1] - obj.dim[1] * 0.5 + y))
+            return covered
+
+        expected = set()
+        for group in groups:
+            if group.symbol.type == 'P':
+                expected.add(('P', (group.leftX + group.dimX * 0.5, -group.topY - group.dimY * 0.5, 0.0)))
+            elif group.symbol.type == 'B':
+                texture = mp.settingsMap['.'][group.symbol.settings['.']]
+                for x in range(group.dimX):
+                    for y in range(group.dimY):
+                        expected.add((texture, group.leftX + x, group.topY + y))
+
+        self.assertEqual(cells(textObjects), expected)
+
+if __name__ == '__main__':
+    unittest.main()
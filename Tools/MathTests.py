@@ -0,0 +1,20 @@
+import os
+import subprocess
+import unittest
+
+# Runs the native math library checks. Build them first (see the top of MathTests/MathTests.cpp), and point MATH_TESTS
+# at the executable if it isn't in MathTests/ next to this file.
+MATH_TESTS = os.environ.get('MATH_TESTS',
+    os.path.join(os.path.dirname(os.path.abspath(__file__)), 'MathTests', 'MathTests'))
+if os.name == 'nt' and not MATH_TESTS.endswith('.exe'):
+    MATH_TESTS += '.exe'
+
+@unittest.skipUnless(os.path.isfile(MATH_TESTS), 'MathTests not built: {}'.format(MATH_TESTS))
+class TestMath(unittest.TestCase):
+
+    def test_native(self):
+        result = subprocess.run([MATH_TESTS], stdout=subprocess.PIPE, universal_newlines=True)
+        self.assertEqual(result.returncode, 0, result.stdout)
+
+if __name__ == '__main__':
+    unittest.main()
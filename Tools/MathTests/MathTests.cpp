@@ -0,0 +1,166 @@
+// Checks for the header-only math library (see Engine/Math). Quaternion results are compared against the matrix
+// helpers they have to agree with, which in turn follow the D3DX conventions. Prints each failed check and exits with
+// 1 if there were any. Run by Tools/MathTests.py.
+//
+// Build from the repo root, ex. on Linux (add -DGAME_MATH_NO_SIMD to check the scalar fallback):
+//   g++ -O2 -std=c++17 -o MathTests Tools/MathTests/MathTests.cpp
+
+#include "../../Engine/Math/Matrix.h"
+#include "../../Engine/Math/Quaternion.h"
+#include "../../Engine/Math/Vector.h"
+#include <cstdio>
+
+static const float MATH_TEST_EPS = 1.0e-5f;
+static const float PI = 3.14159265f;
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                 \
+{                                                                   \
+  if (!(cond))                                                      \
+  {                                                                 \
+    printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+    g_failures++;                                                   \
+  }                                                                 \
+}
+
+
+static bool nearlyEqual(float a, float b)
+{
+  return fabsf(a - b) <= MATH_TEST_EPS;
+}
+
+
+static bool nearlyEqual(const Vec3 &a, const Vec3 &b)
+{
+  return nearlyEqual(a.x, b.x) && nearlyEqual(a.y, b.y) && nearlyEqual(a.z, b.z);
+}
+
+
+static bool nearlyEqual(const Mat4 &a, const Mat4 &b)
+{
+  for (int row = 0; row < 4; row++)
+  {
+    for (int col = 0; col < 4; col++)
+    {
+      if (!nearlyEqual(a.m[row][col], b.m[row][col]))
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+
+// q and -q are the same rotation.
+static bool sameRotation(const Quat &a, const Quat &b)
+{
+  return nearlyEqual(fabsf(quaternionDot(a, b)), 1.0f);
+}
+
+
+static void testVectors()
+{
+  Vec3 x(1.0f, 0.0f, 0.0f);
+  Vec3 y(0.0f, 1.0f, 0.0f);
+
+  CHECK(vec3Cross(x, y) == Vec3(0.0f, 0.0f, 1.0f));
+  CHECK(vec3Dot(Vec3(1.0f, 2.0f, 3.0f), Vec3(4.0f, 5.0f, 6.0f)) == 32.0f);
+  CHECK(nearlyEqual(vec3Length(vec3Normalize(Vec3(3.0f, -4.0f, 12.0f))), 1.0f));
+  CHECK(vec3Normalize(Vec3()) == Vec3());
+  CHECK(vec3Lerp(x, y, 0.5f) == Vec3(0.5f, 0.5f, 0.0f));
+}
+
+
+static void testMatrices()
+{
+  Mat4 m = matrixMultiply(matrixScaling(2.0f, 3.0f, 4.0f), matrixTranslation(1.0f, 2.0f, 3.0f));
+
+  // Row vectors: scaled first, then translated.
+  CHECK(nearlyEqual(vec3TransformCoord(Vec3(1.0f, 1.0f, 1.0f), m), Vec3(3.0f, 5.0f, 7.0f)));
+  CHECK(nearlyEqual(vec3TransformNormal(Vec3(1.0f, 1.0f, 1.0f), m), Vec3(2.0f, 3.0f, 4.0f)));
+  CHECK(nearlyEqual(matrixMultiply(m, matrixIdentity()), m));
+  CHECK(nearlyEqual(matrixTranspose(matrixTranspose(m)), m));
+
+  // Right-handed rotation, +x goes to +y around z.
+  CHECK(nearlyEqual(vec3TransformNormal(Vec3(1.0f, 0.0f, 0.0f), matrixRotationZ(PI / 2.0f)), Vec3(0.0f, 1.0f, 0.0f)));
+
+  Vec3 points[3] = { Vec3(0.0f, 0.0f, 0.0f), Vec3(1.0f, -2.0f, 0.5f), Vec3(-3.0f, 4.0f, 2.0f) };
+  Vec3 transformed[3];
+  vec3TransformCoordArray(transformed, sizeof(Vec3), points, sizeof(Vec3), 3, m);
+  for (int i = 0; i < 3; i++)
+  {
+    CHECK(nearlyEqual(transformed[i], vec3TransformCoord(points[i], m)));
+  }
+}
+
+
+static void testQuaternions()
+{
+  float angle = 0.7f;
+
+  CHECK(nearlyEqual(matrixRotationQuaternion(quaternionIdentity()), matrixIdentity()));
+
+  // Axis rotations match the matrix helpers.
+  CHECK(nearlyEqual(
+    matrixRotationQuaternion(quaternionRotationAxis(Vec3(1.0f, 0.0f, 0.0f), angle)),
+    matrixRotationX(angle)));
+  CHECK(nearlyEqual(
+    matrixRotationQuaternion(quaternionRotationAxis(Vec3(0.0f, 2.0f, 0.0f), angle)),
+    matrixRotationY(angle)));
+  CHECK(nearlyEqual(
+    matrixRotationQuaternion(quaternionRotationAxis(Vec3(0.0f, 0.0f, 1.0f), angle)),
+    matrixRotationZ(angle)));
+
+  // Multiply is q1 followed by q2, like the row vector matrices.
+  Quat q1 = quaternionRotationAxis(Vec3(1.0f, 2.0f, 3.0f), 0.4f);
+  Quat q2 = quaternionRotationAxis(Vec3(-2.0f, 0.5f, 1.0f), 1.3f);
+  CHECK(nearlyEqual(
+    matrixRotationQuaternion(quaternionMultiply(q1, q2)),
+    matrixMultiply(matrixRotationQuaternion(q1), matrixRotationQuaternion(q2))));
+  CHECK(sameRotation(quaternionMultiply(q1, quaternionConjugate(q1)), quaternionIdentity()));
+
+  // Roll, then pitch, then yaw.
+  float yaw = 0.3f, pitch = -0.8f, roll = 1.1f;
+  CHECK(nearlyEqual(
+    matrixRotationQuaternion(quaternionRotationYawPitchRoll(yaw, pitch, roll)),
+    matrixMultiply(matrixMultiply(matrixRotationZ(roll), matrixRotationX(pitch)), matrixRotationY(yaw))));
+
+  Quat scaled(q1.x * 3.0f, q1.y * 3.0f, q1.z * 3.0f, q1.w * 3.0f);
+  CHECK(nearlyEqual(quaternionDot(quaternionNormalize(scaled), q1), 1.0f));
+  CHECK(sameRotation(quaternionNormalize(Quat(0.0f, 0.0f, 0.0f, 0.0f)), quaternionIdentity()));
+
+  // Slerp ends on its inputs and turns at a constant rate in between.
+  Quat a = quaternionRotationAxis(Vec3(0.0f, 0.0f, 1.0f), 0.2f);
+  Quat b = quaternionRotationAxis(Vec3(0.0f, 0.0f, 1.0f), 1.4f);
+  CHECK(sameRotation(quaternionSlerp(a, b, 0.0f), a));
+  CHECK(sameRotation(quaternionSlerp(a, b, 1.0f), b));
+  CHECK(sameRotation(quaternionSlerp(a, b, 0.25f), quaternionRotationAxis(Vec3(0.0f, 0.0f, 1.0f), 0.5f)));
+
+  // Takes the short way round when the inputs are in opposite hemispheres.
+  Quat negB(-b.x, -b.y, -b.z, -b.w);
+  CHECK(sameRotation(quaternionSlerp(a, negB, 0.5f), quaternionRotationAxis(Vec3(0.0f, 0.0f, 1.0f), 0.8f)));
+
+  // Nearly parallel inputs fall back to a lerp, the result still has to be a unit rotation between the two.
+  Quat c = quaternionRotationAxis(Vec3(0.0f, 0.0f, 1.0f), 0.2001f);
+  CHECK(nearlyEqual(quaternionDot(quaternionSlerp(a, c, 0.5f), quaternionSlerp(a, c, 0.5f)), 1.0f));
+}
+
+
+int main()
+{
+  testVectors();
+  testMatrices();
+  testQuaternions();
+
+  if (g_failures)
+  {
+    printf("%d check(s) failed\n", g_failures);
+    return 1;
+  }
+
+  printf("All math checks passed\n");
+  return 0;
+}
@@ -0,0 +1,216 @@
+#include "BenchLevels.h"
+#include "../../Engine/CommonPhysConsts.h"
+#include "../../Engine/PhysicsModel.h"
+#include "../../Engine/PhysicsModels/CollisionModels/AABB.h"
+#include "../../Engine/PhysicsModels/CollisionModels/AABBControllable.h"
+#include "../../Engine/PhysicsModels/PhysicsUpdateModels/GravityModel.h"
+#include "../../Engine/Util.h"
+#include <cmath>
+#include <random>
+#include <set>
+
+static const char* BENCH_LAYOUT_NAMES[BENCH_LAYOUT_COUNT] =
+{
+  "sparse",
+  "corridors",
+  "towers"
+};
+
+// Corridor floor to ceiling gap, in blocks. Tall enough for a mover to walk through.
+static const int CORRIDOR_GAP = 3;
+// Vertical spacing between stacked corridors.
+static const int CORRIDOR_PITCH = CORRIDOR_GAP + 3;
+static const int TOWER_HEIGHT = 16;
+static const int TOWER_SPACING = 3;
+
+
+const char* benchLayoutName(BenchLayout layout)
+{
+  return (layout < BENCH_LAYOUT_COUNT) ? BENCH_LAYOUT_NAMES[layout] : "unknown";
+}
+
+
+bool benchLayoutFromName(const std::string &name, BenchLayout &layout)
+{
+  for (int i = 0; i < BENCH_LAYOUT_COUNT; i++)
+  {
+    if (name == BENCH_LAYOUT_NAMES[i])
+    {
+      layout = static_cast<BenchLayout>(i);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+// Unit block, same setup as the 'B' entries from ObjectManager::generateFromFile.
+static void addBlock(std::vector<BenchBody> &bodies, float x, float y)
+{
+  BenchBody body;
+  body.uuid = bodies.size();
+  body.pModel = new PhysicsModel;
+  body.pModel->setCollisionModel(new AABB(1.0f, 1.0f, 1.0f));
+  body.pModel->getCollisionModel()->setType(COLLISION_MODEL_AABB_IMMOBILE);
+  body.pos = Pos3(x, y, 0.0f);
+  body.bMover = false;
+  bodies.push_back(body);
+}
+
+
+// Player-like mover, same models as ControllableObj. (x, y) is the location of the bottom of the hitbox.
+static void addMover(std::vector<BenchBody> &bodies, float x, float y, float dirX)
+{
+  BenchBody body;
+  body.uuid = bodies.size();
+  body.pModel = new PhysicsModel;
+  body.pModel->setCollisionModel(new AABBControllable(PLAYER_HITBOX_W, PLAYER_HITBOX_H, PLAYER_HITBOX_D));
+  body.pModel->setPuModel(new GravityModel);
+  body.pos = Pos3(x, y + PLAYER_HITBOX_H / 2, 0.0f);
+  body.vel = Pos3(dirX * MAX_MOVEMENT_VEL_MPS * MPS_TO_UNITS_PER_STEP, 0.0f, 0.0f);
+  body.bMover = true;
+  bodies.push_back(body);
+}
+
+
+static void generateSparse(uint32_t numBlocks, uint32_t numMovers, std::mt19937 &rng, std::vector<BenchBody> &bodies)
+{
+  // Roughly 1 in 16 grid cells is occupied, with rows 4 blocks apart so movers have room to land.
+  int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(numBlocks)))) * 4;
+  std::uniform_int_distribution<int> xDist(0, side - 1);
+  std::uniform_int_distribution<int> rowDist(0, side / 4 - 1);
+
+  std::set<std::pair<int, int>> used;
+  std::vector<std::pair<int, int>> cells;
+  while (cells.size() < numBlocks)
+  {
+    std::pair<int, int> cell(xDist(rng), rowDist(rng) * 4);
+    if (used.insert(cell).second)
+    {
+      cells.push_back(cell);
+    }
+  }
+
+  for (auto it = cells.begin(); it != cells.end(); ++it)
+  {
+    addBlock(bodies, it->first + 0.5f, it->second + 0.5f);
+  }
+
+  std::uniform_int_distribution<size_t> cellDist(0, cells.empty() ? 0 : cells.size() - 1);
+  for (uint32_t i = 0; i < numMovers; i++)
+  {
+    std::pair<int, int> cell = cells.empty() ? std::pair<int, int>(0, 0) : cells[cellDist(rng)];
+    addMover(bodies, cell.first + 0.5f, cell.second + 2.0f, (i % 2) ? 1.0f : -1.0f);
+  }
+}
+
+
+static void generateCorridors(uint32_t numBlocks, uint32_t numMovers, std::mt19937 &rng, std::vector<BenchBody> &bodies)
+{
+  // Square-ish overall footprint: corridor count ~ sqrt of the blocks per corridor wall.
+  uint32_t numCorridors = static_cast<uint32_t>(std::ceil(std::sqrt(numBlocks / 2.0f / CORRIDOR_PITCH)));
+  numCorridors = numCorridors ? numCorridors : 1;
+  uint32_t length = (numBlocks / 2 + numCorridors - 1) / numCorridors;
+
+  uint32_t placed = 0;
+  for (uint32_t c = 0; c < numCorridors && placed < numBlocks; c++)
+  {
+    int floorY = c * CORRIDOR_PITCH;
+    for (uint32_t x = 0; x < length && placed < numBlocks; x++)
+    {
+      addBlock(bodies, x + 0.5f, floorY + 0.5f);
+      placed++;
+      if (placed < numBlocks)
+      {
+        addBlock(bodies, x + 0.5f, floorY + CORRIDOR_GAP + 1.5f);
+        placed++;
+      }
+    }
+  }
+
+  std::uniform_int_distribution<uint32_t> corridorDist(0, numCorridors - 1);
+  std::uniform_int_distribution<uint32_t> xDist(0, length ? length - 1 : 0);
+  for (uint32_t i = 0; i < numMovers; i++)
+  {
+    addMover(bodies, xDist(rng) + 0.5f, corridorDist(rng) * CORRIDOR_PITCH + 1.0f, (i % 2) ? 1.0f : -1.0f);
+  }
+}
+
+
+static void generateTowers(uint32_t numBlocks, uint32_t numMovers, std::mt19937 &rng, std::vector<BenchBody> &bodies)
+{
+  uint32_t numTowers = (numBlocks + TOWER_HEIGHT - 1) / TOWER_HEIGHT;
+  numTowers = numTowers ? numTowers : 1;
+
+  uint32_t placed = 0;
+  for (uint32_t t = 0; t < numTowers; t++)
+  {
+    for (int y = 0; y < TOWER_HEIGHT && placed < numBlocks; y++)
+    {
+      addBlock(bodies, t * TOWER_SPACING + 0.5f, y + 0.5f);
+      placed++;
+    }
+  }
+
+  // Movers stand still on top of the towers, so they only exercise resting contacts.
+  std::uniform_int_distribution<uint32_t> towerDist(0, numTowers - 1);
+  for (uint32_t i = 0; i < numMovers; i++)
+  {
+    addMover(bodies, towerDist(rng) * TOWER_SPACING + 0.5f, static_cast<float>(TOWER_HEIGHT), 0.0f);
+  }
+}
+
+
+void generateBenchLevel(
+  BenchLayout layout,
+  uint32_t numBlocks,
+  uint32_t numMovers,
+  uint32_t seed,
+  std::vector<BenchBody> &bodies)
+{
+  std::mt19937 rng(seed);
+  bodies.clear();
+  bodies.reserve(numBlocks + numMovers);
+
+  switch (layout)
+  {
+    case BENCH_LAYOUT_SPARSE:
+    {
+      generateSparse(numBlocks, numMovers, rng, bodies);
+      break;
+    }
+    case BENCH_LAYOUT_CORRIDORS:
+    {
+      generateCorridors(numBlocks, numMovers, rng, bodies);
+      break;
+    }
+    case BENCH_LAYOUT_TOWERS:
+    {
+      generateTowers(numBlocks, numMovers, rng, bodies);
+      break;
+    }
+    default:
+    {
+      break;
+    }
+  }
+}
+
+
+void releaseBenchLevel(std::vector<BenchBody> &bodies)
+{
+  for (auto it = bodies.begin(); it != bodies.end(); ++it)
+  {
+    if (!it->pModel)
+    {
+      continue;
+    }
+
+    // PhysicsModel::release() frees the update and collision models.
+    it->pModel->release();
+    DELETE_AND_NULL(it->pModel);
+  }
+
+  bodies.clear();
+}
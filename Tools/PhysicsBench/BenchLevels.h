@@ -0,0 +1,44 @@
+#ifndef BENCH_LEVELS_H
+#define BENCH_LEVELS_H
+
+#include "../../Engine/CommonTypes.h"
+#include <string>
+#include <vector>
+
+class PhysicsModel;
+
+typedef enum BenchLayout_
+{
+  BENCH_LAYOUT_SPARSE = 0,  // Blocks scattered over a large area, movers dropped on top of them.
+  BENCH_LAYOUT_CORRIDORS,   // Long floor/ceiling runs of unit blocks, movers walking through them.
+  BENCH_LAYOUT_TOWERS,      // Columns of stacked unit blocks, movers standing on top.
+  BENCH_LAYOUT_COUNT
+} BenchLayout;
+
+// The physics-relevant part of a GameObject.
+typedef struct BenchBody_
+{
+  uint64_t      uuid;
+  PhysicsModel  *pModel;
+  Pos3          pos;
+  Pos3          vel;
+  Pos3          rot;
+  Pos3          rotVel;
+  bool          bMover;
+} BenchBody;
+
+const char* benchLayoutName(BenchLayout layout);
+bool benchLayoutFromName(const std::string &name, BenchLayout &layout);
+
+// Generate numBlocks immobile AABB blocks plus numMovers AABBControllable movers (with gravity) in the given layout.
+// The same seed always generates the same level. Bodies own their models, free them with releaseBenchLevel().
+void generateBenchLevel(
+  BenchLayout layout,
+  uint32_t numBlocks,
+  uint32_t numMovers,
+  uint32_t seed,
+  std::vector<BenchBody> &bodies);
+
+void releaseBenchLevel(std::vector<BenchBody> &bodies);
+
+#endif
@@ -0,0 +1,289 @@
+// Headless benchmark for the physics/collision path. Generates synthetic levels (see BenchLevels.h) and drives
+// PhysicsManager::run the same way Scene::update does, without any D3D dependencies.
+//
+// Build from the repo root, ex. on Linux (one command, wrapped here):
+//   g++ -O2 -std=c++17 -o PhysicsBench Tools/PhysicsBench/*.cpp Engine/PhysicsMgr.cpp Engine/PhysicsModel.cpp
+//     Engine/PhysicsModels/*.cpp Engine/PhysicsModels/*/*.cpp Engine/Util.cpp Engine/Logger.cpp
+//
+// Usage:
+//   PhysicsBench [--blocks N] [--movers M] [--frames F] [--layout sparse|corridors|towers|all] [--seed S] [--lod]
+//     [--freeze F]
+//
+// --freeze parks the LOD focus out of range of the whole level for the first F frames (and the warm-up frame), then
+// lets it follow the mover again, to check how bodies catch up after being frozen.
+
+#include "BenchLevels.h"
+#include "../../Engine/CommonPhysConsts.h"
+#include "../../Engine/PhysicsMgr.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// ~~~ Heap tracking ~~~
+// Every allocation gets a small header holding its size, so we can keep current/peak byte counts.
+static size_t g_heapCurBytes = 0;
+static size_t g_heapPeakBytes = 0;
+static const size_t HEAP_HEADER_SIZE = alignof(std::max_align_t);
+
+void* operator new(size_t size)
+{
+  unsigned char *p = static_cast<unsigned char*>(std::malloc(size + HEAP_HEADER_SIZE));
+  if (!p)
+  {
+    throw std::bad_alloc();
+  }
+
+  *reinterpret_cast<size_t*>(p) = size;
+  g_heapCurBytes += size;
+  g_heapPeakBytes = g_heapCurBytes > g_heapPeakBytes ? g_heapCurBytes : g_heapPeakBytes;
+  return p + HEAP_HEADER_SIZE;
+}
+
+void operator delete(void *ptr) noexcept
+{
+  if (!ptr)
+  {
+    return;
+  }
+
+  unsigned char *p = static_cast<unsigned char*>(ptr) - HEAP_HEADER_SIZE;
+  g_heapCurBytes -= *reinterpret_cast<size_t*>(p);
+  std::free(p);
+}
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  operator delete(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+
+typedef struct BenchSettings_
+{
+  uint32_t  numBlocks{ 2000 };
+  uint32_t  numMovers{ 16 };
+  uint32_t  numFrames{ 600 };
+  uint32_t  seed{ 42 };
+  bool      bLod{ false };
+  uint32_t  freezeFrames{ 0 };
+  bool      bAllLayouts{ true };
+  BenchLayout layout{ BENCH_LAYOUT_SPARSE };
+} BenchSettings;
+
+
+typedef struct BenchResult_
+{
+  double    wallMs{ 0.0 };
+  uint64_t  steps{ 0 };
+  uint64_t  pairChecks{ 0 };
+  uint64_t  collisions{ 0 };
+  uint64_t  modelSteps{ 0 };
+  uint64_t  lodResets{ 0 };
+  size_t    levelBytes{ 0 };
+  size_t    peakBytes{ 0 };
+} BenchResult;
+
+
+// Far outside any generated level, every body is in the frozen LOD tier.
+static const Pos3 FROZEN_LOD_FOCUS(-1.0e7f, 0.0f, 0.0f);
+
+
+// One frame of Scene::update's physics handling: register, run, read back.
+static void runFrame(PhysicsManager &pm, std::vector<BenchBody> &bodies, double timeMs, bool bLod, bool bFrozen)
+{
+  PModelInput tempPmIn;
+  for (auto it = bodies.begin(); it != bodies.end(); ++it)
+  {
+    // Movers keep walking, like a player holding a direction.
+    if (it->bMover && it->vel.pos.x != 0.0f)
+    {
+      it->vel.pos.x = (it->vel.pos.x > 0.0f ? 1.0f : -1.0f) * MAX_MOVEMENT_VEL_MPS * MPS_TO_UNITS_PER_STEP;
+    }
+
+    tempPmIn.pModel = it->pModel;
+    tempPmIn.pos    = it->pos;
+    tempPmIn.vel    = it->vel;
+    tempPmIn.rot    = it->rot;
+    tempPmIn.rotVel = it->rotVel;
+    pm.registerModel(it->uuid, &tempPmIn);
+  }
+
+  // Camera follows one of the movers (the last body), like TestScene following the player.
+  if (bLod && !bodies.empty())
+  {
+    pm.setLodFocus(bFrozen ? FROZEN_LOD_FOCUS : bodies.back().pos);
+  }
+
+  pm.run(timeMs);
+
+  PModelOutput tempPmOut;
+  for (auto it = bodies.begin(); it != bodies.end(); ++it)
+  {
+    pm.getResult(it->uuid, &tempPmOut);
+    it->pos     = tempPmOut.pos;
+    it->vel     = tempPmOut.vel;
+    it->rot     = tempPmOut.rot;
+    it->rotVel  = tempPmOut.rotVel;
+  }
+}
+
+
+static BenchResult runBench(BenchLayout layout, BenchSettings &settings)
+{
+  BenchResult result;
+  size_t heapBaseBytes = g_heapCurBytes;
+
+  std::vector<BenchBody> bodies;
+  generateBenchLevel(layout, settings.numBlocks, settings.numMovers, settings.seed, bodies);
+
+  {
+    PhysicsManager pm;
+    double timeMs = 0.0;
+
+    // Warm-up frame: populates the physics manager's model map.
+    timeMs += STEP_SIZE_MS;
+    runFrame(pm, bodies, timeMs, settings.bLod, settings.freezeFrames > 0);
+    result.levelBytes = g_heapCurBytes - heapBaseBytes;
+    g_heapPeakBytes = g_heapCurBytes;
+    pm.resetStats();
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < settings.numFrames; frame++)
+    {
+      timeMs += STEP_SIZE_MS;
+      runFrame(pm, bodies, timeMs, settings.bLod, frame < settings.freezeFrames);
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    result.wallMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    result.steps = pm.getStats().steps;
+    result.pairChecks = pm.getStats().pairChecks;
+    result.collisions = pm.getStats().collisions;
+    result.modelSteps = pm.getStats().modelSteps;
+    result.lodResets = pm.getStats().lodResets;
+    result.peakBytes = g_heapPeakBytes - heapBaseBytes;
+
+    pm.release();
+  }
+
+  releaseBenchLevel(bodies);
+  return result;
+}
+
+
+static void printResult(BenchLayout layout, BenchSettings &settings, BenchResult &result)
+{
+  double stepsPerSec = result.wallMs > 0.0 ? result.steps * MS_PER_SEC / result.wallMs : 0.0;
+  double nsPerPair = result.pairChecks ? result.wallMs * 1.0e6 / result.pairChecks : 0.0;
+
+  printf("%-10s %7u %7u %7llu %10.1f %12llu %9.2f %10llu %10llu %7llu %9.2f %9.2f\n",
+    benchLayoutName(layout),
+    settings.numBlocks,
+    settings.numMovers,
+    static_cast<unsigned long long>(result.steps),
+    stepsPerSec,
+    static_cast<unsigned long long>(result.pairChecks),
+    nsPerPair,
+    static_cast<unsigned long long>(result.collisions),
+    static_cast<unsigned long long>(result.modelSteps),
+    static_cast<unsigned long long>(result.lodResets),
+    result.levelBytes / (1024.0 * 1024.0),
+    result.peakBytes / (1024.0 * 1024.0));
+}
+
+
+static void printUsage(const char *exeName)
+{
+  printf("Usage: %s [--blocks N] [--movers M] [--frames F] [--layout sparse|corridors|towers|all] [--seed S] [--lod]"
+    " [--freeze F]\n",
+    exeName);
+}
+
+
+int main(int argc, char *argv[])
+{
+  BenchSettings settings;
+
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    bool bHasVal = i + 1 < argc;
+
+    if (arg == "--blocks" && bHasVal)
+    {
+      settings.numBlocks = std::strtoul(argv[++i], NULL, 10);
+    }
+    else if (arg == "--movers" && bHasVal)
+    {
+      settings.numMovers = std::strtoul(argv[++i], NULL, 10);
+    }
+    else if (arg == "--frames" && bHasVal)
+    {
+      settings.numFrames = std::strtoul(argv[++i], NULL, 10);
+    }
+    else if (arg == "--seed" && bHasVal)
+    {
+      settings.seed = std::strtoul(argv[++i], NULL, 10);
+    }
+    else if (arg == "--layout" && bHasVal)
+    {
+      std::string name = argv[++i];
+      settings.bAllLayouts = (name == "all");
+      if (!settings.bAllLayouts && !benchLayoutFromName(name, settings.layout))
+      {
+        printf("Unknown layout: %s\n", name.c_str());
+        printUsage(argv[0]);
+        return 1;
+      }
+    }
+    else if (arg == "--lod")
+    {
+      settings.bLod = true;
+    }
+    else if (arg == "--freeze" && bHasVal)
+    {
+      settings.freezeFrames = std::strtoul(argv[++i], NULL, 10);
+    }
+    else
+    {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  printf("%-10s %7s %7s %7s %10s %12s %9s %10s %10s %7s %9s %9s\n",
+    "layout", "blocks", "movers", "steps", "steps/s", "pairs", "ns/pair", "contacts", "updates", "resets", "levelMB",
+    "peakMB");
+
+  for (int layout = 0; layout < BENCH_LAYOUT_COUNT; layout++)
+  {
+    if (!settings.bAllLayouts && layout != settings.layout)
+    {
+      continue;
+    }
+
+    BenchResult result = runBench(static_cast<BenchLayout>(layout), settings);
+    printResult(static_cast<BenchLayout>(layout), settings, result);
+  }
+
+  return 0;
+}
@@ -0,0 +1,50 @@
+import os
+import subprocess
+import unittest
+
+# Tests for the physics LOD, run through the physics benchmark. Build it first (see the top of
+# PhysicsBench/PhysicsBench.cpp), and point PHYSICS_BENCH at the executable if it isn't in PhysicsBench/ next to this file.
+PHYSICS_BENCH = os.environ.get('PHYSICS_BENCH',
+    os.path.join(os.path.dirname(os.path.abspath(__file__)), 'PhysicsBench', 'PhysicsBench'))
+if os.name == 'nt' and not PHYSICS_BENCH.endswith('.exe'):
+    PHYSICS_BENCH += '.exe'
+
+# Must match PHYS_LOD_MAX_BANKED_STEPS in Engine/CommonPhysConsts.h.
+MAX_BANKED_STEPS = 5 * 60
+
+@unittest.skipUnless(os.path.isfile(PHYSICS_BENCH), 'PhysicsBench not built: {}'.format(PHYSICS_BENCH))
+class TestPhysicsLod(unittest.TestCase):
+
+    # Two towers with a mover standing on each, small enough that every body is in the active tier around the mover.
+    MOVERS = 2
+
+    def _run(self, frames, freeze):
+        out = subprocess.run([PHYSICS_BENCH, '--layout', 'towers', '--blocks', '32', '--movers', str(self.MOVERS),
+            '--frames', str(frames), '--freeze', str(freeze), '--lod'],
+            check=True, stdout=subprocess.PIPE, universal_newlines=True).stdout
+        lines = out.strip().splitlines()
+        return dict(zip(lines[0].split(), lines[-1].split()))
+
+    # Under the limit, the whole backlog is worked off once the movers are back in range: the warm-up frame and every
+    # frozen frame get simulated too.
+    def test_shortFreezeCatchesUp(self):
+        frames = 400
+        freeze = MAX_BANKED_STEPS // 2
+        result = self._run(frames, freeze)
+
+        self.assertEqual(int(result['resets']), 0)
+        self.assertEqual(int(result['updates']), self.MOVERS * (int(result['steps']) + 1))
+
+    # Frozen for over twice the limit: each mover drops its backlog exactly once, and simulates nothing but the frames
+    # after it comes back.
+    def test_longFreezeResumes(self):
+        frames = 2 * MAX_BANKED_STEPS + 200
+        freeze = 2 * MAX_BANKED_STEPS + 50
+        result = self._run(frames, freeze)
+
+        self.assertEqual(int(result['resets']), self.MOVERS)
+        self.assertLessEqual(int(result['updates']), self.MOVERS * (frames - freeze))
+        self.assertGreaterEqual(int(result['updates']), self.MOVERS * (frames - freeze - 1))
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,127 @@
+import argparse
+import struct
+import sys
+
+# Converts 'P'/'B' text scenes (the MapParser.py output format) into the binary scene format read by
+# ObjectManager::generateFromBinFile. Keep in sync with Engine/SceneBin.h.
+
+SCENE_BIN_MAGIC = 0x4E435344    # "DSCN"
+SCENE_BIN_VERSION = 1
+
+HEADER_FORMAT = '<8I'           # magic, version, headerSize, objectCount, objectTableOffset, stringTableOffset, stringTableSize, reserved
+OBJECT_FORMAT = '<2I6f2I'       # type, id, loc[3], dim[3], textureOffset, reserved
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+OBJECT_SIZE = struct.calcsize(OBJECT_FORMAT)
+
+OBJ_TYPE_PLAYER = 0
+OBJ_TYPE_BLOCK = 1
+
+class SceneObject:
+    def __init__(self, type=None, id=0, loc=None, dim=None, texture=''):
+        self.type = type
+        self.id = id                            # Blocks use their (1-based) text line number, same as the text loader.
+        self.loc = loc or (0.0, 0.0, 0.0)
+        self.dim = dim or (0.0, 0.0, 0.0)
+        self.texture = texture
+
+    def __repr__(self):
+        return "%s(%r)" % (self.__class__, self.__dict__)
+
+    def __eq__(self, other):
+        return (self.type == other.type) and (self.id == other.id) and (self.loc == other.loc) and \
+            (self.dim == other.dim) and (self.texture == other.texture)
+
+# Parse text scene lines into objects. Unknown line types are skipped, like ObjectManager::generateFromFile.
+def parseTextScene(lines):
+    objects = []
+    for lineNum, line in enumerate(lines, 1):
+        words = line.split()
+        if not words:
+            continue
+
+        if words[0] == 'P':     # Player: 'P {loc}'
+            if len(words) < 4:
+                raise ValueError('Line {}: expected "P x y z", got "{}"'.format(lineNum, line.strip()))
+            loc = tuple(float(w) for w in words[1:4])
+            objects.append(SceneObject(type=OBJ_TYPE_PLAYER, id=0, loc=loc))
+        elif words[0] == 'B':   # Block: 'B {loc} {dim} {texture}'
+            if len(words) < 8:
+                raise ValueError('Line {}: expected "B x y z w h d texture", got "{}"'.format(lineNum, line.strip()))
+            loc = tuple(float(w) for w in words[1:4])
+            dim = tuple(float(w) for w in words[4:7])
+            objects.append(SceneObject(type=OBJ_TYPE_BLOCK, id=lineNum, loc=loc, dim=dim, texture=words[7]))
+
+    return objects
+
+# Pack objects into the binary scene layout. Texture paths are deduplicated in the string table.
+def buildBinScene(objects):
+    stringTable = bytearray()
+    stringOffsets = {}
+    objectTable = bytearray()
+
+    for obj in objects:
+        texOffset = 0
+        if obj.type == OBJ_TYPE_BLOCK:
+            if obj.texture not in stringOffsets:
+                stringOffsets[obj.texture] = len(stringTable)
+                stringTable += obj.texture.encode('utf-8') + b'\0'
+            texOffset = stringOffsets[obj.texture]
+
+        objectTable += struct.pack(OBJECT_FORMAT, obj.type, obj.id, *(obj.loc + obj.dim + (texOffset, 0)))
+
+    # Keep the string table non-empty so offset 0 is always valid.
+    if not stringTable:
+        stringTable = bytearray(b'\0')
+
+    objectTableOffset = HEADER_SIZE
+    stringTableOffset = objectTableOffset + len(objectTable)
+    header = struct.pack(
+        HEADER_FORMAT,
+        SCENE_BIN_MAGIC,
+        SCENE_BIN_VERSION,
+        HEADER_SIZE,
+        len(objects),
+        objectTableOffset,
+        stringTableOffset,
+        len(stringTable),
+        0)
+
+    return bytes(header + objectTable + stringTable)
+
+# Unpack a binary scene back into objects, mostly for tests and inspecting files.
+def readBinScene(data):
+    magic, version, headerSize, count, objOffset, strOffset, strSize, _ = struct.unpack_from(HEADER_FORMAT, data, 0)
+    if magic != SCENE_BIN_MAGIC or version != SCENE_BIN_VERSION:
+        raise ValueError('Not a version {} binary scene'.format(SCENE_BIN_VERSION))
+
+    stringTable = data[strOffset:strOffset + strSize]
+    objects = []
+    for idx in range(count):
+        fields = struct.unpack_from(OBJECT_FORMAT, data, objOffset + idx * OBJECT_SIZE)
+        obj = SceneObject(type=fields[0], id=fields[1], loc=tuple(fields[2:5]), dim=tuple(fields[5:8]))
+        if obj.type == OBJ_TYPE_BLOCK:
+            texEnd = stringTable.index(b'\0', fields[8])
+            obj.texture = stringTable[fields[8]:texEnd].decode('utf-8')
+        objects.append(obj)
+
+    return objects
+
+def convertFile(inputFilePath, outputFilePath):
+    with open(inputFilePath, 'r') as f:
+        objects = parseTextScene(f.readlines())
+    with open(outputFilePath, 'wb') as f:
+        f.write(buildBinScene(objects))
+    return objects
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Convert a text scene (MapParser.py output) into a binary scene')
+    parser.add_argument('-i', '--input', help='Text scene file')
+    parser.add_argument('-o', '--output', help='Binary scene file')
+    args = parser.parse_args()
+
+    if not all([args.input, args.output]):
+        print("Please provide an input and output file (run with '--help' for details)")
+        sys.exit()
+
+    objects = convertFile(args.input, args.output)
+    print('Wrote {} objects to {}'.format(len(objects), args.output))
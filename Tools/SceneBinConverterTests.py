@@ -0,0 +1,57 @@
+import struct
+import unittest
+
+import SceneBinConverter as sbc
+
+class TestSceneBinConverter(unittest.TestCase):
+
+    def test_layout(self):
+        # Sizes must match the static_asserts in Engine/SceneBin.h.
+        self.assertEqual(sbc.HEADER_SIZE, 32)
+        self.assertEqual(sbc.OBJECT_SIZE, 40)
+
+    def test_parse(self):
+        lines = [
+            'P 1 2 0\n',
+            '\n',
+            'B 18.5 -10.5 0 1 1 1.0 Textures/cat.dds\n',
+            'X ignored line\n',
+            'B 0.5 -7.5 0 1 13 1.0 Textures/dog.dds\n',
+        ]
+        objects = sbc.parseTextScene(lines)
+        expected = [
+            sbc.SceneObject(type=sbc.OBJ_TYPE_PLAYER, id=0, loc=(1.0, 2.0, 0.0)),
+            sbc.SceneObject(type=sbc.OBJ_TYPE_BLOCK, id=3, loc=(18.5, -10.5, 0.0), dim=(1.0, 1.0, 1.0), texture='Textures/cat.dds'),
+            sbc.SceneObject(type=sbc.OBJ_TYPE_BLOCK, id=5, loc=(0.5, -7.5, 0.0), dim=(1.0, 13.0, 1.0), texture='Textures/dog.dds'),
+        ]
+        self.assertEqual(objects, expected)
+
+    def test_malformed(self):
+        with self.assertRaises(ValueError):
+            sbc.parseTextScene(['B 1 2 3\n'])
+
+    def test_roundTrip(self):
+        with open('TestOut.txt', 'r') as f:
+            objects = sbc.parseTextScene(f.readlines())
+        data = sbc.buildBinScene(objects)
+        self.assertEqual(sbc.readBinScene(data), objects)
+
+        magic, version, headerSize, count, objOffset, strOffset, strSize, _ = struct.unpack_from(sbc.HEADER_FORMAT, data, 0)
+        self.assertEqual(magic, sbc.SCENE_BIN_MAGIC)
+        self.assertEqual(count, len(objects))
+        self.assertEqual(objOffset % 4, 0)
+        self.assertEqual(strOffset + strSize, len(data))
+        self.assertEqual(data[-1:], b'\0')
+
+    def test_stringDedup(self):
+        objects = [sbc.SceneObject(type=sbc.OBJ_TYPE_BLOCK, id=i, texture='Textures/cat.dds') for i in range(10)]
+        data = sbc.buildBinScene(objects)
+        strSize = struct.unpack_from(sbc.HEADER_FORMAT, data, 0)[6]
+        self.assertEqual(strSize, len('Textures/cat.dds') + 1)
+
+    def test_empty(self):
+        data = sbc.buildBinScene([])
+        self.assertEqual(sbc.readBinScene(data), [])
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,312 @@
+// Scene load-time benchmark: text scene vs binary scene (see Engine/SceneBin.h) through ObjectManager::generateFromFile.
+// Generates a synthetic block scene in both formats, then times repeated loads of each. Runs headless against a
+// RecordingRenderDevice, so the numbers cover file reading/parsing, object construction and the CPU side of render
+// resource creation (texture reads included, shaders come out of gShaderCache after the first load), but not the
+// driver's work.
+//
+// Loads are timed with no block allocator pools (see Engine/PoolAllocator.h), with each pool on its own, and with all
+// of them, so each pool's share of the load and teardown time shows.
+//
+// Build from the repo root, ex. on Linux (one command, wrapped here):
+//   g++ -O2 -std=c++17 -DGAME_HEADLESS -o SceneLoadBench Tools/SceneLoadBench/*.cpp Headless/HeadlessStubs.cpp
+//     Engine/ObjectManager.cpp Engine/GameObject.cpp Engine/VisualModel.cpp Engine/Objects/*.cpp Engine/MappedFile.cpp
+//     Engine/PhysicsModel.cpp Engine/PhysicsModels/*.cpp Engine/PhysicsModels/*/*.cpp Engine/Ecs/EntityRegistry.cpp
+//     Engine/VisualModels/*.cpp Engine/RenderDevices/RecordingRenderDevice.cpp Engine/ShaderCache.cpp
+//     Engine/RenderResourceCache.cpp Engine/GraphicsManager.cpp Engine/RenderDevices/StateFilterRenderDevice.cpp
+//     Engine/Util.cpp Engine/Logger.cpp
+//
+// Run it from the repo root too, so shaders and textures resolve.
+//
+// Usage:
+//   SceneLoadBench [--blocks N] [--iters I] [--text path] [--bin path]
+
+#include "../../Engine/ObjectManager.h"
+#include "../../Engine/SceneBin.h"
+#include "../../Engine/PhysicsModels/CollisionModels/AABB.h"
+#include "../../Engine/VisualModels/TexBox.h"
+#include "../../Engine/RenderDevices/RecordingRenderDevice.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef struct LoadBenchSettings_
+{
+  uint32_t    numBlocks{ 20000 };
+  uint32_t    numIters{ 5 };
+  std::string textPath{ "SceneLoadBench.txt" };
+  std::string binPath{ "SceneLoadBench.bin" };
+} LoadBenchSettings;
+
+// Both are in the repo, so no block ends up timing a failed file open.
+static const char* BENCH_TEXTURES[] = { "Textures/cat.dds", "Textures/TestPattern.dds" };
+
+
+// Same content in both formats: a player line, then one block per line. Writes the binary file the same way
+// Tools/SceneBinConverter.py does.
+static bool writeScenes(const LoadBenchSettings &settings)
+{
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> posDist(-500.0f, 500.0f);
+  std::uniform_int_distribution<int> dimDist(1, 8);
+
+  std::ofstream textFs(settings.textPath);
+  if (!textFs)
+  {
+    printf("Failed to write %s\n", settings.textPath.c_str());
+    return false;
+  }
+
+  std::vector<SceneBinObject> objs;
+  SceneBinObject player;
+  memset(&player, 0, sizeof(player));
+  player.type = SCENE_BIN_OBJ_PLAYER;
+  objs.push_back(player);
+  textFs << "P 0 0 0\n";
+
+  // String table: textures back to back, each NUL-terminated.
+  std::string stringTable;
+  std::vector<uint32_t> texOffsets;
+  for (size_t i = 0; i < sizeof(BENCH_TEXTURES) / sizeof(BENCH_TEXTURES[0]); i++)
+  {
+    texOffsets.push_back(static_cast<uint32_t>(stringTable.size()));
+    stringTable += BENCH_TEXTURES[i];
+    stringTable += '\0';
+  }
+
+  for (uint32_t i = 0; i < settings.numBlocks; i++)
+  {
+    SceneBinObject obj;
+    memset(&obj, 0, sizeof(obj));
+    uint32_t texIdx = i % texOffsets.size();
+    obj.type = SCENE_BIN_OBJ_BLOCK;
+    obj.id = i + 2;   // Text line number.
+    obj.loc[0] = posDist(rng);
+    obj.loc[1] = posDist(rng);
+    obj.loc[2] = 0.0f;
+    obj.dim[0] = static_cast<float>(dimDist(rng));
+    obj.dim[1] = static_cast<float>(dimDist(rng));
+    obj.dim[2] = 1.0f;
+    obj.textureOffset = texOffsets[texIdx];
+    objs.push_back(obj);
+
+    textFs << "B " << obj.loc[0] << " " << obj.loc[1] << " " << obj.loc[2] << " "
+      << obj.dim[0] << " " << obj.dim[1] << " " << obj.dim[2] << " " << BENCH_TEXTURES[texIdx] << "\n";
+  }
+
+  SceneBinHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = SCENE_BIN_MAGIC;
+  header.version = SCENE_BIN_VERSION;
+  header.headerSize = sizeof(SceneBinHeader);
+  header.objectCount = static_cast<uint32_t>(objs.size());
+  header.objectTableOffset = sizeof(SceneBinHeader);
+  header.stringTableOffset = header.objectTableOffset + header.objectCount * sizeof(SceneBinObject);
+  header.stringTableSize = static_cast<uint32_t>(stringTable.size());
+
+  std::ofstream binFs(settings.binPath, std::ios::binary);
+  if (!binFs)
+  {
+    printf("Failed to write %s\n", settings.binPath.c_str());
+    return false;
+  }
+  binFs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  binFs.write(reinterpret_cast<const char*>(objs.data()), objs.size() * sizeof(SceneBinObject));
+  binFs.write(stringTable.data(), stringTable.size());
+  return true;
+}
+
+
+static void printPoolStats(const char *name, const PoolAllocatorStats &stats)
+{
+  printf("  %-14s slabs %5u  capacity %8u  live %8u  used %5.1f%%  allocs %10llu  slabAllocs %6llu\n",
+    name,
+    stats.slabs,
+    stats.capacity,
+    stats.liveItems,
+    stats.capacity ? stats.liveItems * 100.0 / stats.capacity : 0.0,
+    static_cast<unsigned long long>(stats.allocs),
+    static_cast<unsigned long long>(stats.slabAllocs));
+}
+
+
+// Block allocator pool usage. A loaded scene should sit in a handful of mostly full slabs.
+static void printAllPoolStats(const char *label)
+{
+  printf("%s\n", label);
+  printPoolStats("TexBox", TexBox::getPoolStats());
+  printPoolStats("PhysicsModel", PhysicsModel::getPoolStats());
+  printPoolStats("AABB", AABB::getPoolStats());
+}
+
+
+// Which block allocator pools are on for a run. The runs with a single pool on show what each one is worth.
+typedef enum PoolConfig_
+{
+  POOL_CONFIG_NONE = 0,
+  POOL_CONFIG_TEX_BOX,
+  POOL_CONFIG_PHYSICS_MODEL,
+  POOL_CONFIG_AABB,
+  POOL_CONFIG_ALL,
+  POOL_CONFIG_COUNT
+} PoolConfig;
+
+static const char* POOL_CONFIG_NAMES[POOL_CONFIG_COUNT] =
+{
+  "none",
+  "TexBox",
+  "PhysicsModel",
+  "AABB",
+  "all"
+};
+
+
+// Only works with nothing allocated from the pools, i.e. between loads.
+static bool setPoolConfig(PoolConfig config)
+{
+  bool bSuccess = true;
+  bSuccess &= TexBox::setPoolEnabled(config == POOL_CONFIG_ALL || config == POOL_CONFIG_TEX_BOX);
+  bSuccess &= PhysicsModel::setPoolEnabled(config == POOL_CONFIG_ALL || config == POOL_CONFIG_PHYSICS_MODEL);
+  bSuccess &= AABB::setPoolEnabled(config == POOL_CONFIG_ALL || config == POOL_CONFIG_AABB);
+  return bSuccess;
+}
+
+
+// Returns the best load time in ms over all iterations, and the best teardown (ObjectManager::release) time.
+static double timeLoads(
+  const std::string &path,
+  uint32_t numIters,
+  bool bPrintPools,
+  size_t &numObjs,
+  double &bestReleaseMs)
+{
+  double bestMs = 0.0;
+  for (uint32_t iter = 0; iter < numIters; iter++)
+  {
+    RecordingRenderDevice renderDevice;
+    ObjectManager objMgr;
+
+    auto startTime = std::chrono::steady_clock::now();
+    objMgr.generateFromFile(path, &renderDevice, 1);
+    auto endTime = std::chrono::steady_clock::now();
+
+    double ms = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    bestMs = (iter == 0 || ms < bestMs) ? ms : bestMs;
+
+    numObjs = objMgr.size();
+    if (bPrintPools && iter == numIters - 1)
+    {
+      printAllPoolStats(("pools after loading " + path).c_str());
+    }
+
+    startTime = std::chrono::steady_clock::now();
+    objMgr.release();
+    endTime = std::chrono::steady_clock::now();
+
+    ms = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    bestReleaseMs = (iter == 0 || ms < bestReleaseMs) ? ms : bestReleaseMs;
+  }
+
+  return bestMs;
+}
+
+
+static size_t fileSize(const std::string &path)
+{
+  std::ifstream fs(path, std::ios::binary | std::ios::ate);
+  return fs ? static_cast<size_t>(fs.tellg()) : 0;
+}
+
+
+static void printUsage(const char *exeName)
+{
+  printf("Usage: %s [--blocks N] [--iters I] [--text path] [--bin path]\n", exeName);
+}
+
+
+int main(int argc, char *argv[])
+{
+  LoadBenchSettings settings;
+
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    bool bHasVal = i + 1 < argc;
+
+    if (arg == "--blocks" && bHasVal)
+    {
+      settings.numBlocks = std::strtoul(argv[++i], NULL, 10);
+    }
+    else if (arg == "--iters" && bHasVal)
+    {
+      settings.numIters = std::strtoul(argv[++i], NULL, 10);
+    }
+    else if (arg == "--text" && bHasVal)
+    {
+      settings.textPath = argv[++i];
+    }
+    else if (arg == "--bin" && bHasVal)
+    {
+      settings.binPath = argv[++i];
+    }
+    else
+    {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (settings.numIters == 0 || !writeScenes(settings))
+  {
+    return 1;
+  }
+
+  // Each pool on its own first, then all of them, which is what the game runs with.
+  size_t textObjs = 0, binObjs = 0;
+  double textMs = 0.0, binMs = 0.0;
+  double textReleaseMs = 0.0, binReleaseMs = 0.0;
+  std::string poolTable;
+  for (uint32_t config = 0; config < POOL_CONFIG_COUNT; config++)
+  {
+    bool bAll = config == POOL_CONFIG_ALL;
+    if (!setPoolConfig(static_cast<PoolConfig>(config)))
+    {
+      printf("Couldn't switch pools with objects still allocated\n");
+      return 1;
+    }
+
+    textMs = timeLoads(settings.textPath, settings.numIters, bAll, textObjs, textReleaseMs);
+    binMs = timeLoads(settings.binPath, settings.numIters, bAll, binObjs, binReleaseMs);
+
+    char row[128];
+    snprintf(row, sizeof(row), "%-14s %10.2f %10.2f %10.2f %10.2f\n",
+      POOL_CONFIG_NAMES[config], textMs, textReleaseMs, binMs, binReleaseMs);
+    poolTable += row;
+  }
+
+  printf("%-14s %10s %10s %10s %10s\n", "pools", "textMs", "releaseMs", "binaryMs", "releaseMs");
+  printf("%s", poolTable.c_str());
+
+  printf("%-8s %9s %10s %10s %12s %10s\n", "format", "objects", "sizeKB", "bestMs", "objects/s", "releaseMs");
+  printf("%-8s %9zu %10.1f %10.2f %12.0f %10.2f\n", "text", textObjs, fileSize(settings.textPath) / 1024.0, textMs,
+    textMs > 0.0 ? textObjs * 1000.0 / textMs : 0.0, textReleaseMs);
+  printf("%-8s %9zu %10.1f %10.2f %12.0f %10.2f\n", "binary", binObjs, fileSize(settings.binPath) / 1024.0, binMs,
+    binMs > 0.0 ? binObjs * 1000.0 / binMs : 0.0, binReleaseMs);
+  printf("speedup  %.2fx\n", binMs > 0.0 ? textMs / binMs : 0.0);
+
+  uint32_t trimmedSlabs = ObjectManager::trimPools();
+  printf("trim released %u slabs\n", trimmedSlabs);
+  printAllPoolStats("pools after trim");
+
+  if (textObjs != binObjs)
+  {
+    printf("Object count mismatch between formats\n");
+    return 1;
+  }
+
+  return 0;
+}
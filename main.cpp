@@ -6,6 +6,7 @@
 #include "Engine/Util.h"
 #include "Engine/Logger.h"
 #include "Engine/GameMgr.h"
+#include "Engine/RenderDevices/D3D11RenderDevice.h"
 #include "Scenes/TestScene.h"
 
 // Include the Direct3D Library file.
@@ -29,6 +30,9 @@ ID3D11DepthStencilView *pDepthStencilView = NULL;
 
 ID3D11RasterizerState* pRasterState = NULL;
 
+// What the engine renders through, wraps dev and devcon.
+D3D11RenderDevice g_renderDevice;
+
 GameMgr g_gameMgr;
 
 // Prototypes
@@ -311,9 +315,10 @@ bool InitD3D(HWND hWnd)
 
 bool InitGame(HINSTANCE hInstance, HWND hWnd)
 {
+  g_renderDevice.init(dev, devcon);
+
   TestScene *pStartingScene = new TestScene();
-  pStartingScene->init(dev, devcon);
-  g_gameMgr.init(hInstance, hWnd, dev, devcon, pStartingScene, S_WIDTH, S_HEIGHT);
+  g_gameMgr.init(hInstance, hWnd, &g_renderDevice, pStartingScene, S_WIDTH, S_HEIGHT);
 
   return true;
 }
@@ -327,7 +332,7 @@ bool RenderFrame(void)
   // Clear the depth buffer.
   devcon->ClearDepthStencilView(pDepthStencilView, D3D11_CLEAR_DEPTH, 1.0f, 0);
 
-  if (!g_gameMgr.update(dev, devcon))
+  if (!g_gameMgr.update(&g_renderDevice))
   {
     LOGE("Game Mgr update failed");
     return false;